@@ -0,0 +1,248 @@
+/**
+ * @file bench_hash_containers.c
+ * @brief Benchmarks the SwissTable-based Int64HashMap and TierPositionHashSet
+ * against the previous linear-probing implementation, which is reproduced
+ * below for reference.
+ *
+ * Usage: bench_hash_containers [total_ops]
+ *
+ * Tables of 32, 4096, and 1M keys are each built and queried until about
+ * total_ops insertions have been made.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "core/data_structures/swiss_table.h"
+#include "core/gamesman_memory.h"
+#include "core/misc.h"
+
+// ================ Legacy linear-probing map (pre-SwissTable) ================
+
+typedef struct LegacyEntry {
+    int64_t key[2];
+    int64_t value;
+    bool used;
+} LegacyEntry;
+
+typedef struct LegacyMap {
+    LegacyEntry *entries;
+    int64_t capacity;
+    int64_t size;
+    int key_words;
+} LegacyMap;
+
+static int64_t LegacyHash(const LegacyMap *map, const int64_t *key) {
+    if (map->key_words == 1) {
+        return (int64_t)(((uint64_t)key[0]) % map->capacity);
+    }
+
+    // Cantor pairing, as used by the old TierPositionHashSet.
+    uint64_t a = (uint64_t)key[0], b = (uint64_t)key[1];
+    return (int64_t)(((a + b) * (a + b + 1) / 2 + a) % map->capacity);
+}
+
+static bool LegacyKeyEquals(const LegacyMap *map, const LegacyEntry *entry,
+                            const int64_t *key) {
+    return entry->key[0] == key[0] &&
+           (map->key_words == 1 || entry->key[1] == key[1]);
+}
+
+static LegacyEntry *LegacyFind(const LegacyMap *map, const int64_t *key) {
+    if (map->capacity == 0) return NULL;
+    int64_t index = LegacyHash(map, key);
+    while (map->entries[index].used) {
+        if (LegacyKeyEquals(map, &map->entries[index], key)) {
+            return &map->entries[index];
+        }
+        index = (index + 1) % map->capacity;
+    }
+
+    return NULL;
+}
+
+static bool LegacyExpand(LegacyMap *map) {
+    LegacyMap new_map = {.capacity = NextPrime(map->capacity * 2),
+                         .size = map->size,
+                         .key_words = map->key_words};
+    new_map.entries = (LegacyEntry *)GamesmanCallocWhole(new_map.capacity,
+                                                         sizeof(LegacyEntry));
+    if (new_map.entries == NULL) return false;
+    for (int64_t i = 0; i < map->capacity; ++i) {
+        if (!map->entries[i].used) continue;
+        int64_t index = LegacyHash(&new_map, map->entries[i].key);
+        while (new_map.entries[index].used) {
+            index = (index + 1) % new_map.capacity;
+        }
+        new_map.entries[index] = map->entries[i];
+    }
+    GamesmanFree(map->entries);
+    *map = new_map;
+
+    return true;
+}
+
+static bool LegacySet(LegacyMap *map, const int64_t *key, int64_t value) {
+    if (map->capacity == 0 ||
+        (double)(map->size + 1) / (double)map->capacity > 0.5) {
+        if (!LegacyExpand(map)) return false;
+    }
+    int64_t index = LegacyHash(map, key);
+    while (map->entries[index].used) {
+        if (LegacyKeyEquals(map, &map->entries[index], key)) {
+            map->entries[index].value = value;
+            return true;
+        }
+        index = (index + 1) % map->capacity;
+    }
+    map->entries[index].key[0] = key[0];
+    map->entries[index].key[1] = key[1];
+    map->entries[index].value = value;
+    map->entries[index].used = true;
+    ++map->size;
+
+    return true;
+}
+
+// ================================== Harness ==================================
+
+static double Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t Splitmix(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+typedef struct Workload {
+    const char *name;
+    int key_words;
+    int64_t n;       // Number of keys per table.
+    int64_t rounds;  // Number of tables built and queried.
+    int64_t *keys;   // [n][2], keys inserted.
+    int64_t *probes; // [n][2], half hits and half misses.
+} Workload;
+
+static void Report(const Workload *w, const char *op, double legacy,
+                   double swiss) {
+    double ops = (double)(w->n * w->rounds);
+    printf("%-16s n=%-8" PRId64 " %-6s legacy %8.2f ns/op   swiss %8.2f "
+           "ns/op   x%.2f\n",
+           w->name, w->n, op, legacy * 1e9 / ops, swiss * 1e9 / ops,
+           legacy / swiss);
+}
+
+static int Run(const Workload *w) {
+    double legacy_insert = 0, legacy_find = 0, swiss_insert = 0, swiss_find = 0;
+    int64_t sink = 0;
+    for (int64_t r = 0; r < w->rounds; ++r) {
+        // Each round builds a fresh table, like the per-position child
+        // deduplication sets in the solvers when n is small.
+        LegacyMap legacy = {.key_words = w->key_words};
+        double t0 = Now();
+        for (int64_t i = 0; i < w->n; ++i) {
+            if (!LegacySet(&legacy, &w->keys[2 * i], i)) return 1;
+        }
+        double t1 = Now();
+        for (int64_t i = 0; i < w->n; ++i) {
+            const LegacyEntry *entry = LegacyFind(&legacy, &w->probes[2 * i]);
+            sink += entry ? entry->value : -1;
+        }
+        double t2 = Now();
+        GamesmanFree(legacy.entries);
+        legacy_insert += t1 - t0;
+        legacy_find += t2 - t1;
+
+        SwissTable swiss;
+        SwissTableInit(&swiss, w->key_words, 1, 0.5);
+        t0 = Now();
+        for (int64_t i = 0; i < w->n; ++i) {
+            int64_t index = SwissTableInsert(&swiss, &w->keys[2 * i], NULL);
+            if (index < 0) return 1;
+            SwissTableSlot(&swiss, index)[w->key_words] = i;
+        }
+        t1 = Now();
+        for (int64_t i = 0; i < w->n; ++i) {
+            int64_t index = SwissTableFind(&swiss, &w->probes[2 * i]);
+            sink -= index >= 0 ? SwissTableSlot(&swiss, index)[w->key_words]
+                               : -1;
+        }
+        t2 = Now();
+        SwissTableDestroy(&swiss);
+        swiss_insert += t1 - t0;
+        swiss_find += t2 - t1;
+    }
+    Report(w, "insert", legacy_insert, swiss_insert);
+    Report(w, "find", legacy_find, swiss_find);
+
+    // Both implementations must agree on every lookup.
+    return sink != 0;
+}
+
+static void GenerateKeys(int type, int64_t n, int64_t *keys, int64_t *probes,
+                         uint64_t *state) {
+    for (int64_t i = 0; i < n; ++i) {
+        switch (type) {
+            case 0:  // Dense keys, e.g. tiers or hashed positions.
+                keys[2 * i] = i;
+                keys[2 * i + 1] = 0;
+                break;
+            case 1:
+                keys[2 * i] = (int64_t)(Splitmix(state) >> 1);
+                keys[2 * i + 1] = 0;
+                break;
+            case 2:  // Few tiers, many positions per tier.
+                keys[2 * i] = i % 64;
+                keys[2 * i + 1] = (int64_t)(Splitmix(state) % (n * 4));
+                break;
+        }
+    }
+    for (int64_t i = 0; i < n; ++i) {
+        int64_t j = (int64_t)(Splitmix(state) % n);
+        probes[2 * i] = keys[2 * j];
+        probes[2 * i + 1] = keys[2 * j + 1];
+        if (i & 1) probes[2 * i] = -1 - probes[2 * i];  // Miss.
+    }
+}
+
+int main(int argc, char **argv) {
+    int64_t total = argc > 1 ? strtoll(argv[1], NULL, 10) : 1 << 22;
+    static const char *const kNames[3] = {"int64 sequential", "int64 random",
+                                          "tier-position"};
+    static const int kKeyWords[3] = {1, 1, 2};
+    static const int64_t kSizes[3] = {32, 1 << 12, 1 << 20};
+    int64_t *keys = (int64_t *)GamesmanMalloc(sizeof(int64_t) * 2 * total);
+    int64_t *probes = (int64_t *)GamesmanMalloc(sizeof(int64_t) * 2 * total);
+    if (keys == NULL || probes == NULL) return EXIT_FAILURE;
+
+    uint64_t state = 42;
+    for (int s = 0; s < 3; ++s) {
+        int64_t n = kSizes[s] < total ? kSizes[s] : total;
+        for (int type = 0; type < 3; ++type) {
+            GenerateKeys(type, n, keys, probes, &state);
+            Workload w = {.name = kNames[type],
+                          .key_words = kKeyWords[type],
+                          .n = n,
+                          .rounds = total / n,
+                          .keys = keys,
+                          .probes = probes};
+            if (Run(&w)) {
+                fprintf(stderr, "%s: implementations disagree\n", w.name);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    GamesmanFree(keys);
+    GamesmanFree(probes);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file bench_json_writer.c
+ * @brief Benchmarks HeadlessJsonWriter against the json_object tree that
+ * headless query responses used to be built from and serialized with.
+ *
+ * Usage: bench_json_writer [num_responses]
+ *
+ * Responses are synthesized with the shape of a quixo query: a parent position
+ * with its value and remoteness, followed by a "moves" array of children with
+ * formal and AutoGUI positions and moves. Responses with 9 children (mttt), 44
+ * children (quixo) and 200 children are measured. The two implementations must
+ * produce byte-identical output.
+ */
+
+#include <json-c/json_object.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "core/constants.h"
+#include "core/headless/hjson.h"
+#include "core/types/gamesman_types.h"
+
+enum { kMaxChildren = 200 };
+
+typedef struct Child {
+    char position[64];
+    char autogui_position[64];
+    char move[16];
+    char autogui_move[32];
+    Value value;
+    int remoteness;
+} Child;
+
+static double Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void MakeChildren(Child *children, int n) {
+    for (int i = 0; i < n; ++i) {
+        Child *c = &children[i];
+        snprintf(c->position, sizeof(c->position), "1_%-25.25s",
+                 "-x-o--xx-oo-x--o-x-ox-o--");
+        c->position[2 + i % 25] = 'x';
+        snprintf(c->autogui_position, sizeof(c->autogui_position), "%c_%s",
+                 '1' + i % 2, c->position + 2);
+        snprintf(c->move, sizeof(c->move), "%d %d", i % 25, (i * 7) % 25);
+        snprintf(c->autogui_move, sizeof(c->autogui_move), "M_%d_%d_x",
+                 i % 25, 25 + (i * 7) % 25);
+        c->value = (Value)(1 + i % 3);
+        c->remoteness = i % 17;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// The removed implementation, kept verbatim for comparison.
+
+static int AddStringHelper(json_object *dest, ReadOnlyString key,
+                           ReadOnlyString value) {
+    json_object *position_obj = json_object_new_string(value);
+    if (position_obj == NULL) return kMallocFailureError;
+
+    return json_object_object_add(dest, key, position_obj);
+}
+
+static int LegacyAddValue(json_object *dest, Value value) {
+    ReadOnlyString value_string = value < 0 ? "unsolved" : kValueStrings[value];
+
+    return AddStringHelper(dest, "positionValue", value_string);
+}
+
+static int LegacyAddRemoteness(json_object *dest, int remoteness) {
+    json_object *remoteness_obj = json_object_new_int(remoteness);
+    if (remoteness_obj == NULL) return kMallocFailureError;
+
+    return json_object_object_add(dest, "remoteness", remoteness_obj);
+}
+
+// -----------------------------------------------------------------------------
+
+static size_t LegacyResponse(const Child *children, int n, char *out) {
+    json_object *response = json_object_new_object();
+    AddStringHelper(response, "position", children[0].position);
+    AddStringHelper(response, "autoguiPosition", children[0].autogui_position);
+    LegacyAddValue(response, kWin);
+    LegacyAddRemoteness(response, 11);
+    json_object *moves = json_object_new_array_ext(n);
+    for (int i = 0; i < n; ++i) {
+        json_object *child = json_object_new_object();
+        AddStringHelper(child, "position", children[i].position);
+        AddStringHelper(child, "autoguiPosition", children[i].autogui_position);
+        AddStringHelper(child, "move", children[i].move);
+        AddStringHelper(child, "autoguiMove", children[i].autogui_move);
+        LegacyAddValue(child, children[i].value);
+        LegacyAddRemoteness(child, children[i].remoteness);
+        json_object_array_add(moves, child);
+    }
+    json_object_object_add(response, "moves", moves);
+    const char *str = json_object_to_json_string(response);
+    size_t length = strlen(str);
+    memcpy(out, str, length + 1);
+    json_object_put(response);
+
+    return length;
+}
+
+static size_t WriterResponse(const Child *children, int n,
+                             HeadlessJsonWriter *writer, char *out) {
+    HeadlessJsonWriterClear(writer);
+    HeadlessJsonWriterBeginObject(writer, NULL);
+    HeadlessJsonAddPosition(writer, children[0].position);
+    HeadlessJsonAddAutoGuiPosition(writer, children[0].autogui_position);
+    HeadlessJsonAddValue(writer, kWin);
+    HeadlessJsonAddRemoteness(writer, 11);
+    HeadlessJsonBeginMovesArray(writer);
+    for (int i = 0; i < n; ++i) {
+        HeadlessJsonWriterBeginObject(writer, NULL);
+        HeadlessJsonAddPosition(writer, children[i].position);
+        HeadlessJsonAddAutoGuiPosition(writer, children[i].autogui_position);
+        HeadlessJsonAddMove(writer, children[i].move);
+        HeadlessJsonAddAutoGuiMove(writer, children[i].autogui_move);
+        HeadlessJsonAddValue(writer, children[i].value);
+        HeadlessJsonAddRemoteness(writer, children[i].remoteness);
+        HeadlessJsonWriterEndObject(writer);
+    }
+    HeadlessJsonWriterEndArray(writer);
+    HeadlessJsonWriterEndObject(writer);
+    memcpy(out, writer->buffer, writer->length + 1);
+
+    return (size_t)writer->length;
+}
+
+static int Run(int n, int64_t num_responses) {
+    static Child children[kMaxChildren];
+    static char legacy_out[1 << 16], writer_out[1 << 16];
+    MakeChildren(children, n);
+
+    HeadlessJsonWriter writer;
+    HeadlessJsonWriterInit(&writer);
+    size_t legacy_bytes = 0, writer_bytes = 0;
+    double t0 = Now();
+    for (int64_t i = 0; i < num_responses; ++i) {
+        legacy_bytes += LegacyResponse(children, n, legacy_out);
+    }
+    double t1 = Now();
+    for (int64_t i = 0; i < num_responses; ++i) {
+        writer_bytes += WriterResponse(children, n, &writer, writer_out);
+    }
+    double t2 = Now();
+    HeadlessJsonWriterDestroy(&writer);
+
+    double legacy_rate = (double)num_responses / (t1 - t0);
+    double writer_rate = (double)num_responses / (t2 - t1);
+    printf("%4d children  json-c %10.3f Kresp/s   writer %10.3f Kresp/s   "
+           "x%.2f\n",
+           n, legacy_rate * 1e-3, writer_rate * 1e-3,
+           writer_rate / legacy_rate);
+
+    return legacy_bytes != writer_bytes || strcmp(legacy_out, writer_out) != 0;
+}
+
+int main(int argc, char **argv) {
+    int64_t num_responses = argc > 1 ? strtoll(argv[1], NULL, 10) : 1 << 16;
+    static const int kSizes[3] = {9, 44, kMaxChildren};
+    for (int i = 0; i < 3; ++i) {
+        int64_t responses = num_responses * 9 / kSizes[i];
+        if (Run(kSizes[i], responses)) {
+            fprintf(stderr, "implementations disagree at n = %d\n", kSizes[i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file bench_tier_position_dedup.c
+ * @brief Benchmarks TierPositionDedup against the per-position
+ * TierPositionHashSet that the default canonical child generators of the tier
+ * and regular solvers used to allocate.
+ *
+ * Usage: bench_tier_position_dedup [num_parents]
+ *
+ * Child arrays are synthesized with the sizes and duplicate ratios of games
+ * that rely on the default generators: 9 children with symmetric duplicates
+ * (mttt), 28 children (a mid-game fsvp position), and 200 and 1024 children for
+ * games with large branching factors.
+ */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "core/types/base.h"
+#include "core/types/tier_position_dedup.h"
+#include "core/types/tier_position_hash_set.h"
+
+enum { kMaxChildren = 1024 };
+
+static double Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t Splitmix(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/** @brief The removed implementation, kept verbatim for comparison. */
+static int LegacyDedup(const TierPosition *raw, int n, TierPosition *children) {
+    TierPositionHashSet dedup;
+    TierPositionHashSetInit(&dedup, 0.5);
+    int ret = 0;
+    for (int i = 0; i < n; ++i) {
+        if (!TierPositionHashSetContains(&dedup, raw[i])) {
+            TierPositionHashSetAdd(&dedup, raw[i]);
+            children[ret++] = raw[i];
+        }
+    }
+    TierPositionHashSetDestroy(&dedup);
+
+    return ret;
+}
+
+static int Run(int n, int distinct, int64_t num_parents) {
+    TierPosition *raw = malloc(sizeof(TierPosition) * kMaxChildren * 64);
+    TierPosition children[kMaxChildren];
+    if (raw == NULL) return 1;
+
+    // 64 parents' worth of children, reused round robin.
+    uint64_t state = (uint64_t)n;
+    for (int p = 0; p < 64; ++p) {
+        for (int i = 0; i < n; ++i) {
+            int64_t child = (int64_t)(Splitmix(&state) % (uint64_t)distinct);
+            raw[p * n + i] = (TierPosition){.tier = 3, .position = child * 977};
+        }
+    }
+
+    int64_t legacy_sum = 0, dedup_sum = 0;
+    double t0 = Now();
+    for (int64_t p = 0; p < num_parents; ++p) {
+        legacy_sum += LegacyDedup(&raw[(p & 63) * n], n, children);
+    }
+    double t1 = Now();
+    for (int64_t p = 0; p < num_parents; ++p) {
+        memcpy(children, &raw[(p & 63) * n], sizeof(TierPosition) * n);
+        dedup_sum += TierPositionDedup(children, n);
+    }
+    double t2 = Now();
+    free(raw);
+
+    double legacy_rate = (double)num_parents / (t1 - t0);
+    double dedup_rate = (double)num_parents / (t2 - t1);
+    printf("%4d children  legacy %10.3f Mpos/s   dedup %10.3f Mpos/s   x%.2f\n",
+           n, legacy_rate * 1e-6, dedup_rate * 1e-6, dedup_rate / legacy_rate);
+
+    return legacy_sum != dedup_sum;
+}
+
+int main(int argc, char **argv) {
+    int64_t num_parents = argc > 1 ? strtoll(argv[1], NULL, 10) : 1 << 20;
+    static const int kSizes[4] = {9, 28, 200, kMaxChildren};
+    for (int i = 0; i < 4; ++i) {
+        // About a quarter of the children are symmetric duplicates.
+        int distinct = kSizes[i] * 3 / 4 + 1;
+        int64_t parents = num_parents * 9 / kSizes[i];
+        if (Run(kSizes[i], distinct, parents)) {
+            fprintf(stderr, "implementations disagree at n = %d\n", kSizes[i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -27,15 +27,20 @@
 #include "core/analysis/stat_manager.h"
 
 #include <assert.h>    // assert
-#include <fcntl.h>     // open, O_RDONLY, O_WRONLY, O_CREAT
+#include <errno.h>     // errno, ENOENT
+#include <fcntl.h>     // open, O_RDONLY, O_WRONLY, O_CREAT, O_TRUNC
+#include <stdbool.h>   // bool
 #include <stddef.h>    // NULL, size_t
-#include <stdio.h>     // fprintf, stderr, SEEK_SET, fopen
+#include <stdio.h>     // fprintf, stderr, SEEK_SET, fopen, fileno
 #include <string.h>    // strlen, memset
 #include <sys/stat.h>  // S_IRWXU, S_IRWXG, S_IRWXO
+#include <unistd.h>    // access, F_OK, fdatasync
 #include <zlib.h>      // gzread, gzFile, Z_NULL
 
 #include "core/analysis/analysis.h"
+#include "core/concurrency.h"
 #include "core/constants.h"
+#include "core/data_structures/compressed_bitmap.h"
 #include "core/data_structures/concurrent_bitset.h"
 #include "core/gamesman_memory.h"
 #include "core/misc.h"
@@ -47,8 +52,27 @@ static char *sandbox_path;
 static char *SetupStatPath(ReadOnlyString game_name, int variant,
                            ReadOnlyString data_path);
 
+static int SaveAnalysisTo(char *filename, const Analysis *analysis);
+static int LoadAnalysisFrom(char *filename, Analysis *dest);
+static int LoadMapFrom(char *filename, Tier tier, int64_t size,
+                       GamesmanAllocator *allocator, ConcurrentBitset **dest);
+static int SaveMapTo(const ConcurrentBitset *s, char *filename);
+static int LoadCompressedMapFrom(char *filename, Tier tier, int64_t size,
+                                 GamesmanAllocator *allocator,
+                                 CompressedBitmap **dest);
+static int SaveCompressedMapTo(const CompressedBitmap *s,
+                               GamesmanAllocator *allocator, char *filename);
+static int LoadDiscoveryMapForUpdate(Tier tier, int64_t size,
+                                     GamesmanAllocator *allocator,
+                                     CompressedBitmap **dest);
+static int RemoveIfExists(char *filename);
+
 static char *GetPathToTierAnalysis(Tier tier);
+static char *GetPathToTierHistogram(Tier tier);
 static char *GetPathToTierDiscoveryMap(Tier tier);
+static char *GetPathToTierLegacyDiscoveryMap(Tier tier);
+static char *GetPathToTierReachableMap(Tier tier);
+static char *GetPathToTierRestrictedMark(Tier tier);
 static char *GetPathTo(Tier tier, ReadOnlyString extension);
 
 // -----------------------------------------------------------------------------
@@ -93,18 +117,7 @@ int StatManagerSaveAnalysis(Tier tier, const Analysis *analysis) {
         return kUseBeforeInitializationError;
     }
 
-    char *filename = GetPathToTierAnalysis(tier);
-    if (filename == NULL) return kMallocFailureError;
-    mode_t mode = S_IRWXU | S_IRWXG | S_IRWXO;  // This sets permissions to 0777
-    int stat_fd = open(filename, O_CREAT | O_WRONLY, mode);
-    GamesmanFree(filename);
-    if (stat_fd < 0) return kFileSystemError;
-
-    int error = AnalysisWrite(analysis, stat_fd);
-    if (error != 0) return error;
-
-    error = GuardedClose(stat_fd);
-    return error;
+    return SaveAnalysisTo(GetPathToTierAnalysis(tier), analysis);
 }
 
 int StatManagerLoadAnalysis(Analysis *dest, Tier tier) {
@@ -113,26 +126,227 @@ int StatManagerLoadAnalysis(Analysis *dest, Tier tier) {
         return kUseBeforeInitializationError;
     }
 
-    char *filename = GetPathToTierAnalysis(tier);
-    if (filename == NULL) return kMallocFailureError;
+    return LoadAnalysisFrom(GetPathToTierAnalysis(tier), dest);
+}
 
-    int stat_fd = GuardedOpen(filename, O_RDONLY);
-    GamesmanFree(filename);
-    if (stat_fd < 0) return kFileSystemError;
+int StatManagerSaveHistogram(Tier tier, const Analysis *histogram) {
+    if (sandbox_path == NULL) {
+        fprintf(stderr,
+                "StatManagerSaveHistogram: StatManager uninitialized\n");
+        return kUseBeforeInitializationError;
+    }
 
-    int error = AnalysisRead(dest, stat_fd);
-    if (error != 0) return error;
+    return SaveAnalysisTo(GetPathToTierHistogram(tier), histogram);
+}
 
-    error = GuardedClose(stat_fd);
-    return error;
+int StatManagerLoadHistogram(Analysis *dest, Tier tier) {
+    if (sandbox_path == NULL) {
+        fprintf(stderr,
+                "StatManagerLoadHistogram: StatManager uninitialized\n");
+        return kUseBeforeInitializationError;
+    }
+
+    char *filename = GetPathToTierHistogram(tier);
+    if (filename == NULL) return kMallocFailureError;
+    if (access(filename, F_OK) != 0) {
+        GamesmanFree(filename);
+        return kFileSystemError;
+    }
+
+    return LoadAnalysisFrom(filename, dest);
+}
+
+int StatManagerRemoveHistogram(Tier tier) {
+    // A missing histogram is not an error.
+    return RemoveIfExists(GetPathToTierHistogram(tier));
 }
 
 int StatManagerLoadDiscoveryMap(Tier tier, int64_t size,
                                 GamesmanAllocator *allocator,
                                 ConcurrentBitset **dest) {
+    CompressedBitmap *map = NULL;
+    int error = LoadCompressedMapFrom(GetPathToTierDiscoveryMap(tier), tier,
+                                      size, allocator, &map);
+    if (error == kFileSystemError) {
+        // Fall back to maps saved in the legacy format.
+        return LoadMapFrom(GetPathToTierLegacyDiscoveryMap(tier), tier, size,
+                           allocator, dest);
+    }
+    if (error != kNoError) return error;
+
+    ConcurrentBitset *s = ConcurrentBitsetCreateAllocator(size, allocator);
+    if (s == NULL) {
+        CompressedBitmapDestroy(map);
+        return kMallocFailureError;
+    }
+    CompressedBitmapToBitset(map, s);
+    CompressedBitmapDestroy(map);
+    *dest = s;
+
+    return kNoError;
+}
+
+size_t StatManagerAddToDiscoveryMapMemRequired(int64_t size) {
+    // The map being updated coexists with either the buffer it is deserialized
+    // from and serialized to, or the containers being converted by each thread.
+    size_t map_size = CompressedBitmapMemRequiredMax(size);
+    size_t conversion_size =
+        ConcurrencyGetOmpNumThreads() * kCompressedBitmapConversionMax;
+    size_t buf_size = CompressedBitmapGetSerializedSizeMax(size);
+    size_t ret = map_size + (buf_size > conversion_size ? buf_size
+                                                        : conversion_size);
+
+    // A legacy map is decompressed into a buffer before it is converted.
+    size_t bitset_size = ConcurrentBitsetMemRequired(size);
+    size_t legacy_size =
+        bitset_size + (bitset_size > map_size ? bitset_size : map_size);
+
+    return ret > legacy_size ? ret : legacy_size;
+}
+
+int StatManagerAddToDiscoveryMap(const CompressedBitmap *s, Tier tier,
+                                 GamesmanAllocator *allocator) {
+    if (CompressedBitmapCount(s) == 0) return kNoError;
+
+    CompressedBitmap *map = NULL;
+    int error = LoadDiscoveryMapForUpdate(tier, CompressedBitmapGetNumBits(s),
+                                          allocator, &map);
+    if (error != kNoError) return error;
+
+    if (!CompressedBitmapOr(map, s)) {
+        CompressedBitmapDestroy(map);
+        return kMallocFailureError;
+    }
+    error =
+        SaveCompressedMapTo(map, allocator, GetPathToTierDiscoveryMap(tier));
+    CompressedBitmapDestroy(map);
+    if (error != kNoError) return error;
+
+    // The legacy map, if any, has been merged into the new one.
+    return RemoveIfExists(GetPathToTierLegacyDiscoveryMap(tier));
+}
+
+int StatManagerRemoveDiscoveryMap(Tier tier) {
+    int error = RemoveIfExists(GetPathToTierDiscoveryMap(tier));
+    if (error != kNoError) return error;
+
+    return RemoveIfExists(GetPathToTierLegacyDiscoveryMap(tier));
+}
+
+int StatManagerLoadReachableMap(Tier tier, int64_t size,
+                                GamesmanAllocator *allocator,
+                                ConcurrentBitset **dest) {
+    return LoadMapFrom(GetPathToTierReachableMap(tier), tier, size, allocator,
+                       dest);
+}
+
+int StatManagerSaveReachableMap(const ConcurrentBitset *s, Tier tier) {
+    return SaveMapTo(s, GetPathToTierReachableMap(tier));
+}
+
+int StatManagerRemoveReachableMap(Tier tier) {
+    // A missing map is not an error.
+    return RemoveIfExists(GetPathToTierReachableMap(tier));
+}
+
+int StatManagerSaveRestrictedMark(Tier tier, TierPosition root) {
+    char *filename = GetPathToTierRestrictedMark(tier);
+    if (filename == NULL) return kMallocFailureError;
+
+    FILE *file = GuardedFopen(filename, "wb");
+    GamesmanFree(filename);
+    if (file == NULL) return kFileSystemError;
+
+    int error = GuardedFwrite(&root.tier, sizeof(root.tier), 1, file);
+    if (error == 0) {
+        error = GuardedFwrite(&root.position, sizeof(root.position), 1, file);
+    }
+    if (error != 0) return BailOutFclose(file, kFileSystemError);
+
+    // The mark must reach storage before the records of the tier do.
+    if (fflush(file) != 0 || fdatasync(fileno(file)) != 0) {
+        perror("fdatasync");
+        return BailOutFclose(file, kFileSystemError);
+    }
+
+    return GuardedFclose(file) == 0 ? kNoError : kFileSystemError;
+}
+
+bool StatManagerHasRestrictedMark(Tier tier) {
+    char *filename = GetPathToTierRestrictedMark(tier);
+    bool ret = filename != NULL && FileExists(filename);
+    GamesmanFree(filename);
+
+    return ret;
+}
+
+int StatManagerLoadRestrictedMark(Tier tier, TierPosition *root) {
+    char *filename = GetPathToTierRestrictedMark(tier);
+    if (filename == NULL) return kMallocFailureError;
+
+    // A missing mark is reported without an error message.
+    FILE *file = fopen(filename, "rb");
+    GamesmanFree(filename);
+    if (file == NULL) return kFileSystemError;
+
+    TierPosition loaded;
+    int error = GuardedFread(&loaded.tier, sizeof(loaded.tier), 1, file, false);
+    if (error == 0) {
+        error = GuardedFread(&loaded.position, sizeof(loaded.position), 1, file,
+                             false);
+    }
+    if (error != 0) return BailOutFclose(file, kFileSystemError);
+    if (GuardedFclose(file) != 0) return kFileSystemError;
+    *root = loaded;
+
+    return kNoError;
+}
+
+int StatManagerRemoveRestrictedMark(Tier tier) {
+    return RemoveIfExists(GetPathToTierRestrictedMark(tier));
+}
+
+// -----------------------------------------------------------------------------
+
+static char *SetupStatPath(ReadOnlyString game_name, int variant,
+                           ReadOnlyString data_path) {
+    // path = "<data_path>/<game_name>/<variant>/analysis/"
+    if (data_path == NULL) data_path = "data";
+    static ConstantReadOnlyString kAnalysisDirName = "analysis";
+    char *path = NULL;
+
+    int path_length = (int)strlen(data_path) + 1;  // +1 for '/'.
+    path_length += (int)strlen(game_name) + 1;
+    path_length += kInt32Base10StringLengthMax + 1;
+    path_length += (int)strlen(kAnalysisDirName) + 1;
+    path = (char *)GamesmanCallocWhole((path_length + 1), sizeof(char));
+    if (path == NULL) {
+        fprintf(stderr, "SetupStatPath: failed to calloc path.\n");
+        return NULL;
+    }
+    int actual_length = snprintf(path, path_length, "%s/%s/%d/%s/", data_path,
+                                 game_name, variant, kAnalysisDirName);
+    if (actual_length >= path_length) {
+        fprintf(stderr,
+                "SetupStatPath: (BUG) not enough space was allocated for "
+                "path. Please check the implementation of this function.\n");
+        GamesmanFree(path);
+        return NULL;
+    }
+    if (MkdirRecursive(path) != 0) {
+        fprintf(stderr,
+                "SetupStatPath: failed to create path in the file system.\n");
+        GamesmanFree(path);
+        return NULL;
+    }
+    return path;
+}
+
+// Loads the map of TIER of SIZE bits from FILENAME, which is freed.
+static int LoadMapFrom(char *filename, Tier tier, int64_t size,
+                       GamesmanAllocator *allocator, ConcurrentBitset **dest) {
     int error = kNoError;
     void *buf = NULL;  // Deserialization buffer
-    char *filename = GetPathToTierDiscoveryMap(tier);
     ConcurrentBitset *s = ConcurrentBitsetCreateAllocator(size, allocator);
     if (filename == NULL || s == NULL) {
         error = kMallocFailureError;
@@ -158,15 +372,15 @@ int StatManagerLoadDiscoveryMap(Tier tier, int64_t size,
             goto _bailout;
         case -3:
             fprintf(stderr,
-                    "StatManagerLoadDiscoveryMap: discovery map appears to be "
-                    "corrupt for tier %" PRITier "\n",
-                    tier);
+                    "LoadMapFrom: map file %s appears to be corrupt for tier "
+                    "%" PRITier "\n",
+                    filename, tier);
             error = kRuntimeError;
             goto _bailout;
         case -4:
             NotReached(
-                "StatManagerLoadDiscoveryMap: not enough space for "
-                "destination bit stream allocated, likely a bug\n");
+                "LoadMapFrom: not enough space for destination bit stream "
+                "allocated, likely a bug\n");
             error = kRuntimeError;
             goto _bailout;
         default:
@@ -185,14 +399,17 @@ _bailout:
     return error;
 }
 
-int StatManagerSaveDiscoveryMap(const ConcurrentBitset *s, Tier tier) {
-    char *filename = GetPathToTierDiscoveryMap(tier);
+// Compresses and saves S to FILENAME, which is freed.
+static int SaveMapTo(const ConcurrentBitset *s, char *filename) {
     if (filename == NULL) return kMallocFailureError;
 
     // Serialize the bitset
     size_t buf_size = ConcurrentBitsetGetSerializedSize(s);
     void *buf = GamesmanMalloc(buf_size);
-    if (buf == NULL) return kMallocFailureError;
+    if (buf == NULL) {
+        GamesmanFree(filename);
+        return kMallocFailureError;
+    }
     ConcurrentBitsetSerialize(s, buf);
 
     int64_t res = Lz4UtilsCompressStream(buf, buf_size, 0, filename);
@@ -212,51 +429,158 @@ int StatManagerSaveDiscoveryMap(const ConcurrentBitset *s, Tier tier) {
     return kNoError;
 }
 
-int StatManagerRemoveDiscoveryMap(Tier tier) {
-    char *filename = GetPathToTierDiscoveryMap(tier);
+// Loads the compressed map of TIER of SIZE bits from FILENAME, which is freed.
+// Returns kFileSystemError if FILENAME does not exist.
+static int LoadCompressedMapFrom(char *filename, Tier tier, int64_t size,
+                                 GamesmanAllocator *allocator,
+                                 CompressedBitmap **dest) {
     if (filename == NULL) return kMallocFailureError;
 
-    int error = GuardedRemove(filename);
+    // A missing map is reported to the caller without a message.
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        GamesmanFree(filename);
+        return kFileSystemError;
+    }
+
+    // Read the header for the size of the map, and then the rest of it.
+    int error = kRuntimeError;
+    void *buf = NULL;
+    char header[kCompressedBitmapHeaderSize];
+    size_t buf_size = 0;
+    if (GuardedFread(header, sizeof(header), 1, file, false) == 0) {
+        buf_size = CompressedBitmapGetSerializedSizeFromHeader(header);
+    }
+    if (buf_size > 0) {
+        buf = GamesmanAllocatorAllocate(allocator, buf_size);
+        if (buf == NULL) error = kMallocFailureError;
+    }
+    if (buf != NULL) {
+        memcpy(buf, header, sizeof(header));
+        if (GuardedFread((char *)buf + sizeof(header), 1,
+                         buf_size - sizeof(header), file, false) == 0) {
+            error = kNoError;
+        }
+    }
+    if (GuardedFclose(file) != 0 && error == kNoError) {
+        error = kFileSystemError;
+    }
+
+    if (error == kNoError) {
+        *dest = CompressedBitmapDeserialize(buf, buf_size, size, allocator);
+        if (*dest == NULL) error = kRuntimeError;
+    }
+    if (error == kRuntimeError) {
+        fprintf(stderr,
+                "LoadCompressedMapFrom: map file %s appears to be corrupt for "
+                "tier %" PRITier "\n",
+                filename, tier);
+    }
     GamesmanFree(filename);
-    if (error != 0) return kFileSystemError;
+    GamesmanAllocatorDeallocate(allocator, buf);
 
-    return kNoError;
+    return error;
 }
 
-// -----------------------------------------------------------------------------
-
-static char *SetupStatPath(ReadOnlyString game_name, int variant,
-                           ReadOnlyString data_path) {
-    // path = "<data_path>/<game_name>/<variant>/analysis/"
-    if (data_path == NULL) data_path = "data";
-    static ConstantReadOnlyString kAnalysisDirName = "analysis";
-    char *path = NULL;
+// Saves S to FILENAME, which is freed, using ALLOCATOR for the serialization
+// buffer. FILENAME is replaced only once S has been written in full.
+static int SaveCompressedMapTo(const CompressedBitmap *s,
+                               GamesmanAllocator *allocator, char *filename) {
+    if (filename == NULL) return kMallocFailureError;
 
-    int path_length = (int)strlen(data_path) + 1;  // +1 for '/'.
-    path_length += (int)strlen(game_name) + 1;
-    path_length += kInt32Base10StringLengthMax + 1;
-    path_length += (int)strlen(kAnalysisDirName) + 1;
-    path = (char *)GamesmanCallocWhole((path_length + 1), sizeof(char));
-    if (path == NULL) {
-        fprintf(stderr, "SetupStatPath: failed to calloc path.\n");
-        return NULL;
-    }
-    int actual_length = snprintf(path, path_length, "%s/%s/%d/%s/", data_path,
-                                 game_name, variant, kAnalysisDirName);
-    if (actual_length >= path_length) {
-        fprintf(stderr,
-                "SetupStatPath: (BUG) not enough space was allocated for "
-                "path. Please check the implementation of this function.\n");
-        GamesmanFree(path);
-        return NULL;
+    size_t tmp_filename_size = strlen(filename) + sizeof(".tmp");
+    char *tmp_filename = (char *)GamesmanMalloc(tmp_filename_size);
+    size_t buf_size = CompressedBitmapGetSerializedSize(s);
+    void *buf = GamesmanAllocatorAllocate(allocator, buf_size);
+    FILE *file = NULL;
+    int error = kMallocFailureError;
+    if (tmp_filename == NULL || buf == NULL) goto _bailout;
+    snprintf(tmp_filename, tmp_filename_size, "%s.tmp", filename);
+    CompressedBitmapSerialize(s, buf);
+
+    error = kFileSystemError;
+    file = GuardedFopen(tmp_filename, "wb");
+    if (file == NULL) goto _bailout;
+    if (GuardedFwrite(buf, 1, buf_size, file) != 0) {
+        BailOutFclose(file, error);
+        goto _bailout;
     }
-    if (MkdirRecursive(path) != 0) {
-        fprintf(stderr,
-                "SetupStatPath: failed to create path in the file system.\n");
-        GamesmanFree(path);
-        return NULL;
+    if (GuardedFclose(file) != 0) goto _bailout;
+    if (GuardedRename(tmp_filename, filename) == 0) error = kNoError;
+
+_bailout:
+    if (error == kFileSystemError) remove(tmp_filename);
+    GamesmanAllocatorDeallocate(allocator, buf);
+    GamesmanFree(tmp_filename);
+    GamesmanFree(filename);
+
+    return error;
+}
+
+// Loads the discovery map of TIER of SIZE bits as a CompressedBitmap for
+// positions to be added to it using ALLOCATOR, converting a legacy map if
+// necessary. Creates an empty map if none has been stored for TIER.
+static int LoadDiscoveryMapForUpdate(Tier tier, int64_t size,
+                                     GamesmanAllocator *allocator,
+                                     CompressedBitmap **dest) {
+    int error = LoadCompressedMapFrom(GetPathToTierDiscoveryMap(tier), tier,
+                                      size, allocator, dest);
+    if (error != kFileSystemError) return error;
+
+    ConcurrentBitset *legacy = NULL;
+    error = LoadMapFrom(GetPathToTierLegacyDiscoveryMap(tier), tier, size,
+                        allocator, &legacy);
+    if (error == kFileSystemError) {
+        *dest = CompressedBitmapCreate(size, allocator);
+    } else if (error == kNoError) {
+        *dest = CompressedBitmapCreateFromBitset(legacy, allocator);
+        ConcurrentBitsetDestroy(legacy);
+    } else {
+        return error;
     }
-    return path;
+
+    return *dest == NULL ? kMallocFailureError : kNoError;
+}
+
+// Removes FILENAME, which is freed. A missing file is not an error.
+static int RemoveIfExists(char *filename) {
+    if (filename == NULL) return kMallocFailureError;
+
+    int error = remove(filename);
+    GamesmanFree(filename);
+    if (error != 0 && errno != ENOENT) return kFileSystemError;
+
+    return kNoError;
+}
+
+// Saves ANALYSIS to FILENAME, which is freed.
+static int SaveAnalysisTo(char *filename, const Analysis *analysis) {
+    if (filename == NULL) return kMallocFailureError;
+    mode_t mode = S_IRWXU | S_IRWXG | S_IRWXO;  // This sets permissions to 0777
+    int stat_fd = open(filename, O_CREAT | O_WRONLY | O_TRUNC, mode);
+    GamesmanFree(filename);
+    if (stat_fd < 0) return kFileSystemError;
+
+    int error = AnalysisWrite(analysis, stat_fd);
+    if (error != 0) return BailOutClose(stat_fd, error);
+
+    error = GuardedClose(stat_fd);
+    return error;
+}
+
+// Loads DEST from FILENAME, which is freed.
+static int LoadAnalysisFrom(char *filename, Analysis *dest) {
+    if (filename == NULL) return kMallocFailureError;
+
+    int stat_fd = GuardedOpen(filename, O_RDONLY);
+    GamesmanFree(filename);
+    if (stat_fd < 0) return kFileSystemError;
+
+    int error = AnalysisRead(dest, stat_fd);
+    if (error != 0) return error;
+
+    error = GuardedClose(stat_fd);
+    return error;
 }
 
 static char *GetPathToTierAnalysis(Tier tier) {
@@ -265,12 +589,36 @@ static char *GetPathToTierAnalysis(Tier tier) {
     return GetPathTo(tier, kAnalysisExtension);
 }
 
+static char *GetPathToTierHistogram(Tier tier) {
+    // path = "<path>/<tier>.hist"
+    static ConstantReadOnlyString kHistogramExtension = ".hist";
+    return GetPathTo(tier, kHistogramExtension);
+}
+
 static char *GetPathToTierDiscoveryMap(Tier tier) {
-    // path = "<path>/<tier>.map"
-    static ConstantReadOnlyString kMapExtension = ".map.lz4";
+    // path = "<path>/<tier>.cmap"
+    static ConstantReadOnlyString kMapExtension = ".cmap";
     return GetPathTo(tier, kMapExtension);
 }
 
+static char *GetPathToTierLegacyDiscoveryMap(Tier tier) {
+    // path = "<path>/<tier>.map.lz4"
+    static ConstantReadOnlyString kLegacyMapExtension = ".map.lz4";
+    return GetPathTo(tier, kLegacyMapExtension);
+}
+
+static char *GetPathToTierReachableMap(Tier tier) {
+    // path = "<path>/<tier>.reach.lz4"
+    static ConstantReadOnlyString kReachableMapExtension = ".reach.lz4";
+    return GetPathTo(tier, kReachableMapExtension);
+}
+
+static char *GetPathToTierRestrictedMark(Tier tier) {
+    // path = "<path>/<tier>.restricted"
+    static ConstantReadOnlyString kRestrictedMarkExtension = ".restricted";
+    return GetPathTo(tier, kRestrictedMarkExtension);
+}
+
 static char *GetPathTo(Tier tier, ReadOnlyString extension) {
     // path = "<sandbox_path>/<tier><extension>"
     // file_name = "<tier><extension>"
@@ -27,7 +27,11 @@
 #ifndef GAMESMANONE_CORE_ANALYSIS_STAT_MANAGER_H_
 #define GAMESMANONE_CORE_ANALYSIS_STAT_MANAGER_H_
 
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+
 #include "core/analysis/analysis.h"
+#include "core/data_structures/compressed_bitmap.h"
 #include "core/data_structures/concurrent_bitset.h"
 #include "core/types/gamesman_types.h"
 
@@ -85,6 +89,33 @@ int StatManagerSaveAnalysis(Tier tier, const Analysis *analysis);
  */
 int StatManagerLoadAnalysis(Analysis *dest, Tier tier);
 
+/**
+ * @brief Stores the \p histogram for \p tier to disk.
+ * @details A histogram holds the value and remoteness counts and the example
+ * positions of all legal positions in \p tier, recorded by the solver while the
+ * tier was still in memory. The analyzer uses it in place of a scan of the
+ * tier's database if every legal position in \p tier turns out reachable.
+ *
+ * @return \c kNoError on success,
+ * @return non-zero error code otherwise.
+ */
+int StatManagerSaveHistogram(Tier tier, const Analysis *histogram);
+
+/**
+ * @brief Loads the histogram for \p tier to DEST.
+ * @return \c kNoError on success,
+ * @return \c kFileSystemError if no histogram has been stored for \p tier, or
+ * @return another non-zero error code otherwise.
+ */
+int StatManagerLoadHistogram(Analysis *dest, Tier tier);
+
+/**
+ * @brief Removes the histogram of \p tier from disk if it exists.
+ * @return \c kNoError on success,
+ * @return non-zero error code otherwise.
+ */
+int StatManagerRemoveHistogram(Tier tier);
+
 /**
  * @brief Loads the discovery map for \p tier as a ConcurrentBitset from disk.
  * @details A discovery map is a bitset of length equal to the size of
@@ -96,29 +127,44 @@ int StatManagerLoadAnalysis(Analysis *dest, Tier tier);
  * @param allocator Memory allocator to use for \p dest.
  * @param dest Pointer to the pointer that will be modified to point to the
  * destination bitset on success. Not modified on failure.
- * @return \c kNoError on success, or
- * @return non-zero error code otherwise.
+ * @return \c kNoError on success,
+ * @return \c kFileSystemError if no discovery map has been stored for
+ * \p tier, or
+ * @return another non-zero error code otherwise.
  */
 int StatManagerLoadDiscoveryMap(Tier tier, int64_t size,
                                 GamesmanAllocator *allocator,
                                 ConcurrentBitset **dest);
 
 /**
- * @brief Compresses and saves the discovery map of \p tier as a
- * ConcurrentBitset to disk.
- * @details A discovery map is a bit stream of length equal to the size of
- * \p tier, with the i-th bit turned on if and only if the position i has been
- * discovered as reachable in \p tier.
+ * @brief Returns the largest amount of memory in bytes that
+ * StatManagerAddToDiscoveryMap may allocate from its allocator to add
+ * positions to the discovery map of a tier of size \p size.
+ */
+size_t StatManagerAddToDiscoveryMapMemRequired(int64_t size);
+
+/**
+ * @brief Adds the positions in \p s to the discovery map of \p tier on disk.
+ * @details Discovery maps are stored on disk as CompressedBitmaps, so the
+ * maps of large tiers that are only sparsely discovered take little space.
+ * Maps left in the older lz4-compressed bitset format are converted the first
+ * time positions are added to them. The updated map is written to a temporary
+ * file which then replaces the map on disk.
  *
- * @param stream Discovery map of \p tier as a ConcurrentBitset.
+ * @param s Positions discovered in \p tier.
  * @param tier Tier being discovered.
+ * @param allocator Memory allocator to use for the map being updated, or
+ * \c NULL to use the default allocation functions. See
+ * StatManagerAddToDiscoveryMapMemRequired for how much memory it may need.
  * @return \c kNoError on success,
- * @return non-zero error code otherwise.
+ * @return non-zero error code otherwise, in which case the discovery map of
+ * \p tier on disk is unchanged.
  */
-int StatManagerSaveDiscoveryMap(const ConcurrentBitset *s, Tier tier);
+int StatManagerAddToDiscoveryMap(const CompressedBitmap *s, Tier tier,
+                                 GamesmanAllocator *allocator);
 
 /**
- * @brief Removes the discovery map of \p tier from disk.
+ * @brief Removes the discovery map of \p tier from disk if it exists.
  *
  * @param tier Tier whose discovery map should be removed.
  * @return \c kNoError on success,
@@ -126,4 +172,76 @@ int StatManagerSaveDiscoveryMap(const ConcurrentBitset *s, Tier tier);
  */
 int StatManagerRemoveDiscoveryMap(Tier tier);
 
+/**
+ * @brief Loads the reachable map for \p tier as a ConcurrentBitset from disk.
+ * @details A reachable map is a bitset of length equal to the size of \p tier
+ * with the i-th bit turned on if and only if position i is canonical and some
+ * position symmetric to it is reachable from the initial position. Reachable
+ * maps restrict the positions the solver visits.
+ *
+ * @param tier Tier to load.
+ * @param size Size of \p tier.
+ * @param allocator Memory allocator to use for \p dest, or \c NULL to use the
+ * default allocation functions.
+ * @param dest Pointer to the pointer that will be modified to point to the
+ * destination bitset on success. Not modified on failure.
+ * @return \c kNoError on success,
+ * @return \c kFileSystemError if no reachable map has been stored for \p tier,
+ * or
+ * @return another non-zero error code otherwise.
+ */
+int StatManagerLoadReachableMap(Tier tier, int64_t size,
+                                GamesmanAllocator *allocator,
+                                ConcurrentBitset **dest);
+
+/**
+ * @brief Compresses and saves the reachable map of \p tier to disk.
+ * @return \c kNoError on success,
+ * @return non-zero error code otherwise.
+ */
+int StatManagerSaveReachableMap(const ConcurrentBitset *s, Tier tier);
+
+/**
+ * @brief Removes the reachable map of \p tier from disk if it exists.
+ * @return \c kNoError on success,
+ * @return non-zero error code otherwise.
+ */
+int StatManagerRemoveReachableMap(Tier tier);
+
+/**
+ * @brief Marks \p tier as solved for the positions in its reachable map only,
+ * which leaves the other positions of \p tier undecided in the database, and
+ * records the \p root position the reachable positions were discovered from.
+ * @details The mark must be saved before the records of \p tier are stored,
+ * and is removed only after \p tier has been stored again with all of its
+ * legal positions solved, so that a restricted tier is never mistaken for a
+ * fully solved one, even if the solve is interrupted.
+ * @return \c kNoError on success,
+ * @return non-zero error code otherwise.
+ */
+int StatManagerSaveRestrictedMark(Tier tier, TierPosition root);
+
+/** @brief Returns whether \p tier has been marked as restricted. */
+bool StatManagerHasRestrictedMark(Tier tier);
+
+/**
+ * @brief Loads the root position recorded in the restricted mark of \p tier.
+ *
+ * @param tier Tier whose restricted mark should be loaded.
+ * @param root (Output parameter) Set to the root position recorded in the mark
+ * on success. Not modified on failure.
+ * @return \c kNoError on success,
+ * @return \c kFileSystemError if \p tier has no restricted mark or the mark
+ * cannot be read, or
+ * @return another non-zero error code otherwise.
+ */
+int StatManagerLoadRestrictedMark(Tier tier, TierPosition *root);
+
+/**
+ * @brief Removes the restricted mark of \p tier from disk if it exists.
+ * @return \c kNoError on success,
+ * @return non-zero error code otherwise.
+ */
+int StatManagerRemoveRestrictedMark(Tier tier);
+
 #endif  // GAMESMANONE_CORE_ANALYSIS_STAT_MANAGER_H_
@@ -0,0 +1,885 @@
+/**
+ * @file compressed_bitmap.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the container-adaptive compressed bitmap.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/data_structures/compressed_bitmap.h"
+
+#include <assert.h>     // assert
+#include <stdatomic.h>  // atomic_flag, _Atomic, atomic_*
+#include <stdbool.h>    // bool, true, false
+#include <stddef.h>     // NULL, size_t
+#include <stdint.h>     // int64_t, int32_t, uint16_t, uint32_t, uint64_t
+#include <string.h>     // memcpy, memmove, memset
+
+#include "core/concurrency.h"
+#include "core/data_structures/concurrent_bitset.h"
+#include "core/gamesman_memory.h"
+
+enum {
+    kChunkBits = 1 << 16,  // Number of bits covered by each container.
+    kBitmapWords = kChunkBits / 64,
+    kBitmapBytes = kBitmapWords * (int)sizeof(uint64_t),
+
+    // An array container of this many values is as large as a bitmap.
+    kArrayMax = kBitmapBytes / (int)sizeof(uint16_t),
+    kArrayInitialCapacity = 16,
+    kRunMax = kChunkBits / 2,
+
+    // Upper bound on the per-allocation overhead of a GamesmanAllocator.
+    kAllocationOverhead = 128,
+};
+
+typedef enum {
+    kContainerEmpty,
+    kContainerArray,
+    kContainerBitmap,
+    kContainerRun,
+} ContainerType;
+
+// The bits in [start, start + length_minus_one] of a chunk are all set.
+typedef struct {
+    uint16_t start;
+    uint16_t length_minus_one;
+} Run;
+
+typedef struct {
+    atomic_flag lock;  // Guards the container while bits are being added.
+    _Atomic int type;  // ContainerType.
+    int32_t size;      // Number of values in an array or of runs in a run list.
+    int32_t capacity;  // Number of values an array container can hold.
+
+    // Sorted uint16_t values, kBitmapWords _Atomic uint64_t words, or sorted
+    // Runs, depending on the type.
+    void *data;
+} Container;
+
+struct CompressedBitmap {
+    GamesmanAllocator *allocator;
+    int64_t num_bits;
+    int64_t num_chunks;
+    Container containers[];
+};
+
+// Serialized layout, all integers in host byte order:
+//   header: magic, total size in bytes, number of bits, number of non-empty
+//           containers, each a uint64_t;
+//   one Descriptor per non-empty container in increasing order of chunks;
+//   the payload of each container in the same order, padded to 8 bytes.
+static const uint64_t kMagic = 0x3150414D42434D47ULL;  // "GMCBMAP1"
+
+typedef struct {
+    uint32_t chunk;
+    uint32_t type;
+    uint32_t size;
+    uint32_t reserved;
+} Descriptor;
+
+static int64_t NumChunks(int64_t num_bits);
+static int64_t ChunkLength(const CompressedBitmap *b, int64_t chunk);
+static int GetType(const Container *c);
+static void *Allocate(CompressedBitmap *b, size_t size);
+static void Deallocate(CompressedBitmap *b, void *ptr);
+static void InitContainer(Container *c);
+static void ClearContainer(CompressedBitmap *b, Container *c);
+static void Lock(Container *c);
+static void Unlock(Container *c);
+static _Atomic uint64_t *AllocateBitmap(CompressedBitmap *b);
+static void BitmapSet(Container *c, int value);
+static int LowerBound(const uint16_t *values, int32_t size, uint16_t value);
+static void SetRange(uint64_t *words, int begin, int end);
+static void ToWords(const Container *c, uint64_t *words);
+static bool FromWords(CompressedBitmap *b, Container *c,
+                      const uint64_t *words);
+static bool ConvertToBitmap(CompressedBitmap *b, Container *c);
+static bool AddLocked(CompressedBitmap *b, Container *c, uint16_t value);
+static size_t PayloadSize(const Container *c);
+static size_t Pad(size_t size);
+
+// -----------------------------------------------------------------------------
+
+size_t CompressedBitmapMemRequired(int64_t num_bits) {
+    if (num_bits < 0) num_bits = 0;
+    return sizeof(CompressedBitmap) + NumChunks(num_bits) * sizeof(Container);
+}
+
+size_t CompressedBitmapMemRequiredMax(int64_t num_bits) {
+    if (num_bits < 0) num_bits = 0;
+    return CompressedBitmapMemRequired(num_bits) +
+           NumChunks(num_bits) * (kBitmapBytes + kAllocationOverhead);
+}
+
+CompressedBitmap *CompressedBitmapCreate(int64_t num_bits,
+                                         GamesmanAllocator *allocator) {
+    if (num_bits < 0) num_bits = 0;
+    CompressedBitmap *ret = (CompressedBitmap *)GamesmanAllocatorAllocate(
+        allocator, CompressedBitmapMemRequired(num_bits));
+    if (ret == NULL) return NULL;
+
+    ret->num_bits = num_bits;
+    ret->num_chunks = NumChunks(num_bits);
+    for (int64_t i = 0; i < ret->num_chunks; ++i) {
+        InitContainer(&ret->containers[i]);
+    }
+
+    // Create a new reference of the allocator.
+    GamesmanAllocatorAddRef(allocator);
+    ret->allocator = allocator;
+
+    return ret;
+}
+
+CompressedBitmap *CompressedBitmapCreateFromBitset(
+    ConcurrentBitset *s, GamesmanAllocator *allocator) {
+    //
+    CompressedBitmap *ret =
+        CompressedBitmapCreate(ConcurrentBitsetGetNumBits(s), allocator);
+    if (ret == NULL) return NULL;
+
+    ConcurrentBool success;
+    ConcurrentBoolInit(&success, true);
+    PRAGMA_OMP_PARALLEL_FOR_SCHEDULE_DYNAMIC(16)
+    for (int64_t chunk = 0; chunk < ret->num_chunks; ++chunk) {
+        if (!ConcurrentBoolLoad(&success)) continue;  // Fail fast.
+        uint64_t words[kBitmapWords];
+        memset(words, 0, sizeof(words));
+        bool empty = true;
+        int64_t begin = chunk * kChunkBits, end = begin + kChunkBits;
+        for (int64_t i = ConcurrentBitsetFindNextSet(s, begin, end,
+                                                     memory_order_relaxed);
+             i < end;
+             i = ConcurrentBitsetFindNextSet(s, i + 1, end,
+                                             memory_order_relaxed)) {
+            words[(i - begin) / 64] |= 1ULL << ((i - begin) % 64);
+            empty = false;
+        }
+        if (empty) continue;
+        if (!FromWords(ret, &ret->containers[chunk], words)) {
+            ConcurrentBoolStore(&success, false);
+        }
+    }
+    if (!ConcurrentBoolLoad(&success)) {
+        CompressedBitmapDestroy(ret);
+        return NULL;
+    }
+
+    return ret;
+}
+
+void CompressedBitmapDestroy(CompressedBitmap *b) {
+    if (b == NULL) return;
+    for (int64_t i = 0; i < b->num_chunks; ++i) {
+        Deallocate(b, b->containers[i].data);
+    }
+    GamesmanAllocator *allocator = b->allocator;
+    GamesmanAllocatorDeallocate(allocator, b);
+    GamesmanAllocatorRelease(allocator);
+}
+
+int64_t CompressedBitmapGetNumBits(const CompressedBitmap *b) {
+    return b->num_bits;
+}
+
+bool CompressedBitmapAdd(CompressedBitmap *b, int64_t bit_index) {
+    assert(bit_index >= 0 && bit_index < b->num_bits);
+    Container *c = &b->containers[bit_index / kChunkBits];
+    uint16_t value = (uint16_t)(bit_index % kChunkBits);
+
+    // Bitmap containers are never converted back while bits are being added,
+    // so setting a bit in one does not need the lock.
+    if (atomic_load_explicit(&c->type, memory_order_acquire) ==
+        kContainerBitmap) {
+        BitmapSet(c, value);
+        return true;
+    }
+
+    Lock(c);
+    bool success = AddLocked(b, c, value);
+    Unlock(c);
+
+    return success;
+}
+
+bool CompressedBitmapContains(const CompressedBitmap *b, int64_t bit_index) {
+    assert(bit_index >= 0 && bit_index < b->num_bits);
+    const Container *c = &b->containers[bit_index / kChunkBits];
+    uint16_t value = (uint16_t)(bit_index % kChunkBits);
+    switch (GetType(c)) {
+        case kContainerArray: {
+            const uint16_t *values = (const uint16_t *)c->data;
+            int i = LowerBound(values, c->size, value);
+            return i < c->size && values[i] == value;
+        }
+
+        case kContainerBitmap: {
+            _Atomic uint64_t *words = (_Atomic uint64_t *)c->data;
+            uint64_t word =
+                atomic_load_explicit(&words[value / 64], memory_order_relaxed);
+            return (word >> (value % 64)) & 1;
+        }
+
+        case kContainerRun: {
+            // Find the last run that starts at or before value.
+            const Run *runs = (const Run *)c->data;
+            int lo = 0, hi = c->size;
+            while (lo < hi) {
+                int mid = lo + (hi - lo) / 2;
+                if (runs[mid].start <= value) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            if (lo == 0) return false;
+            const Run *run = &runs[lo - 1];
+            return value - run->start <= run->length_minus_one;
+        }
+    }
+
+    return false;
+}
+
+int64_t CompressedBitmapCount(const CompressedBitmap *b) {
+    int64_t ret = 0;
+    for (int64_t i = 0; i < b->num_chunks; ++i) {
+        const Container *c = &b->containers[i];
+        switch (GetType(c)) {
+            case kContainerArray:
+                ret += c->size;
+                break;
+
+            case kContainerBitmap: {
+                _Atomic uint64_t *words = (_Atomic uint64_t *)c->data;
+                for (int w = 0; w < kBitmapWords; ++w) {
+                    ret += __builtin_popcountll(atomic_load_explicit(
+                        &words[w], memory_order_relaxed));
+                }
+                break;
+            }
+
+            case kContainerRun: {
+                const Run *runs = (const Run *)c->data;
+                for (int32_t r = 0; r < c->size; ++r) {
+                    ret += runs[r].length_minus_one + 1;
+                }
+                break;
+            }
+        }
+    }
+
+    return ret;
+}
+
+bool CompressedBitmapOr(CompressedBitmap *dest, const CompressedBitmap *src) {
+    assert(dest->num_bits == src->num_bits);
+    ConcurrentBool success;
+    ConcurrentBoolInit(&success, true);
+    PRAGMA_OMP_PARALLEL_FOR_SCHEDULE_DYNAMIC(16)
+    for (int64_t i = 0; i < dest->num_chunks; ++i) {
+        if (!ConcurrentBoolLoad(&success)) continue;  // Fail fast.
+        if (GetType(&src->containers[i]) == kContainerEmpty) continue;
+
+        uint64_t words[kBitmapWords], other[kBitmapWords];
+        ToWords(&dest->containers[i], words);
+        ToWords(&src->containers[i], other);
+        for (int w = 0; w < kBitmapWords; ++w) {
+            words[w] |= other[w];
+        }
+        if (!FromWords(dest, &dest->containers[i], words)) {
+            ConcurrentBoolStore(&success, false);
+        }
+    }
+
+    return ConcurrentBoolLoad(&success);
+}
+
+bool CompressedBitmapOptimize(CompressedBitmap *b) {
+    ConcurrentBool success;
+    ConcurrentBoolInit(&success, true);
+    PRAGMA_OMP_PARALLEL_FOR_SCHEDULE_DYNAMIC(16)
+    for (int64_t i = 0; i < b->num_chunks; ++i) {
+        if (!ConcurrentBoolLoad(&success)) continue;  // Fail fast.
+        if (GetType(&b->containers[i]) == kContainerEmpty) continue;
+
+        uint64_t words[kBitmapWords];
+        ToWords(&b->containers[i], words);
+        if (!FromWords(b, &b->containers[i], words)) {
+            ConcurrentBoolStore(&success, false);
+        }
+    }
+
+    return ConcurrentBoolLoad(&success);
+}
+
+void CompressedBitmapToBitset(const CompressedBitmap *b,
+                              ConcurrentBitset *dest) {
+    assert(b->num_bits == ConcurrentBitsetGetNumBits(dest));
+    PRAGMA_OMP_PARALLEL_FOR_SCHEDULE_DYNAMIC(16)
+    for (int64_t i = 0; i < b->num_chunks; ++i) {
+        const Container *c = &b->containers[i];
+        int64_t base = i * kChunkBits;
+        switch (GetType(c)) {
+            case kContainerArray: {
+                const uint16_t *values = (const uint16_t *)c->data;
+                for (int32_t j = 0; j < c->size; ++j) {
+                    ConcurrentBitsetSet(dest, base + values[j],
+                                        memory_order_relaxed);
+                }
+                break;
+            }
+
+            case kContainerBitmap: {
+                _Atomic uint64_t *words = (_Atomic uint64_t *)c->data;
+                for (int w = 0; w < kBitmapWords; ++w) {
+                    uint64_t bits =
+                        atomic_load_explicit(&words[w], memory_order_relaxed);
+                    while (bits) {
+                        int64_t bit = base + w * 64 + __builtin_ctzll(bits);
+                        ConcurrentBitsetSet(dest, bit, memory_order_relaxed);
+                        bits &= bits - 1;
+                    }
+                }
+                break;
+            }
+
+            case kContainerRun: {
+                const Run *runs = (const Run *)c->data;
+                for (int32_t r = 0; r < c->size; ++r) {
+                    int64_t begin = base + runs[r].start;
+                    int64_t end = begin + runs[r].length_minus_one + 1;
+                    for (int64_t bit = begin; bit < end; ++bit) {
+                        ConcurrentBitsetSet(dest, bit, memory_order_relaxed);
+                    }
+                }
+                break;
+            }
+        }
+    }
+}
+
+size_t CompressedBitmapGetSerializedSize(const CompressedBitmap *b) {
+    size_t ret = kCompressedBitmapHeaderSize;
+    for (int64_t i = 0; i < b->num_chunks; ++i) {
+        const Container *c = &b->containers[i];
+        if (GetType(c) == kContainerEmpty) continue;
+        ret += sizeof(Descriptor) + PayloadSize(c);
+    }
+
+    return ret;
+}
+
+size_t CompressedBitmapGetSerializedSizeMax(int64_t num_bits) {
+    // No container takes more space than a bitmap.
+    if (num_bits < 0) num_bits = 0;
+    return kCompressedBitmapHeaderSize +
+           NumChunks(num_bits) * (sizeof(Descriptor) + kBitmapBytes);
+}
+
+void CompressedBitmapSerialize(const CompressedBitmap *b, void *buf) {
+    uint64_t num_containers = 0;
+    for (int64_t i = 0; i < b->num_chunks; ++i) {
+        num_containers += (GetType(&b->containers[i]) != kContainerEmpty);
+    }
+    uint64_t header[4] = {
+        kMagic,
+        CompressedBitmapGetSerializedSize(b),
+        (uint64_t)b->num_bits,
+        num_containers,
+    };
+    char *out = (char *)buf;
+    memcpy(out, header, sizeof(header));
+
+    size_t descriptor_offset = kCompressedBitmapHeaderSize;
+    size_t payload_offset =
+        descriptor_offset + num_containers * sizeof(Descriptor);
+    for (int64_t i = 0; i < b->num_chunks; ++i) {
+        const Container *c = &b->containers[i];
+        int type = GetType(c);
+        if (type == kContainerEmpty) continue;
+
+        Descriptor descriptor = {
+            .chunk = (uint32_t)i,
+            .type = (uint32_t)type,
+            .size = (uint32_t)c->size,
+            .reserved = 0,
+        };
+        memcpy(out + descriptor_offset, &descriptor, sizeof(descriptor));
+        descriptor_offset += sizeof(descriptor);
+
+        size_t payload_size = PayloadSize(c);
+        memset(out + payload_offset, 0, payload_size);
+        if (type == kContainerArray) {
+            memcpy(out + payload_offset, c->data, c->size * sizeof(uint16_t));
+        } else if (type == kContainerRun) {
+            memcpy(out + payload_offset, c->data, c->size * sizeof(Run));
+        } else {
+            _Atomic uint64_t *words = (_Atomic uint64_t *)c->data;
+            for (int w = 0; w < kBitmapWords; ++w) {
+                uint64_t word =
+                    atomic_load_explicit(&words[w], memory_order_relaxed);
+                memcpy(out + payload_offset + w * sizeof(word), &word,
+                       sizeof(word));
+            }
+        }
+        payload_offset += payload_size;
+    }
+}
+
+size_t CompressedBitmapGetSerializedSizeFromHeader(const void *header) {
+    uint64_t fields[4];
+    memcpy(fields, header, sizeof(fields));
+    if (fields[0] != kMagic) return 0;
+    if (fields[1] < kCompressedBitmapHeaderSize) return 0;
+    if (fields[1] > SIZE_MAX) return 0;
+
+    return (size_t)fields[1];
+}
+
+// Returns whether the array VALUES of SIZE values is strictly increasing with
+// all values less than LENGTH.
+static bool IsValidArray(const uint16_t *values, int32_t size,
+                         int64_t length) {
+    for (int32_t i = 0; i < size; ++i) {
+        if (values[i] >= length) return false;
+        if (i > 0 && values[i] <= values[i - 1]) return false;
+    }
+
+    return true;
+}
+
+// Returns whether the SIZE RUNS are sorted and disjoint, with all bits in them
+// less than LENGTH.
+static bool IsValidRunList(const Run *runs, int32_t size, int64_t length) {
+    int64_t prev_end = -1;
+    for (int32_t i = 0; i < size; ++i) {
+        int64_t end = (int64_t)runs[i].start + runs[i].length_minus_one;
+        if (runs[i].start <= prev_end || end >= length) return false;
+        prev_end = end;
+    }
+
+    return true;
+}
+
+// Returns whether all bits at or after LENGTH in WORDS are zero.
+static bool IsValidBitmap(const uint64_t *words, int64_t length) {
+    for (int64_t w = length / 64; w < kBitmapWords; ++w) {
+        uint64_t word = words[w];
+        if (w == length / 64) word &= ~0ULL << (length % 64);
+        if (word) return false;
+    }
+
+    return true;
+}
+
+// Loads the container of chunk D->chunk of B from PAYLOAD. Returns false if
+// the container is invalid or on memory allocation failure.
+static bool LoadContainer(CompressedBitmap *b, const Descriptor *d,
+                          const char *payload) {
+    Container *c = &b->containers[d->chunk];
+    int64_t length = ChunkLength(b, d->chunk);
+    switch (d->type) {
+        case kContainerArray: {
+            uint16_t *values =
+                (uint16_t *)Allocate(b, d->size * sizeof(uint16_t));
+            if (values == NULL) return false;
+            memcpy(values, payload, d->size * sizeof(uint16_t));
+            c->data = values;
+            c->capacity = (int32_t)d->size;
+            if (!IsValidArray(values, (int32_t)d->size, length)) return false;
+            break;
+        }
+
+        case kContainerBitmap: {
+            uint64_t words[kBitmapWords];
+            memcpy(words, payload, sizeof(words));
+            if (!IsValidBitmap(words, length)) return false;
+            _Atomic uint64_t *bitmap = AllocateBitmap(b);
+            if (bitmap == NULL) return false;
+            for (int w = 0; w < kBitmapWords; ++w) {
+                atomic_store_explicit(&bitmap[w], words[w],
+                                      memory_order_relaxed);
+            }
+            c->data = (void *)bitmap;
+            break;
+        }
+
+        case kContainerRun: {
+            Run *runs = (Run *)Allocate(b, d->size * sizeof(Run));
+            if (runs == NULL) return false;
+            memcpy(runs, payload, d->size * sizeof(Run));
+            c->data = runs;
+            if (!IsValidRunList(runs, (int32_t)d->size, length)) return false;
+            break;
+        }
+
+        default:
+            return false;
+    }
+    c->size = (d->type == kContainerBitmap) ? 0 : (int32_t)d->size;
+    atomic_store_explicit(&c->type, (int)d->type, memory_order_relaxed);
+
+    return true;
+}
+
+CompressedBitmap *CompressedBitmapDeserialize(const void *buf, size_t size,
+                                              int64_t num_bits,
+                                              GamesmanAllocator *allocator) {
+    if (size < kCompressedBitmapHeaderSize) return NULL;
+    if (CompressedBitmapGetSerializedSizeFromHeader(buf) != size) return NULL;
+    const char *in = (const char *)buf;
+    uint64_t header[4];
+    memcpy(header, in, sizeof(header));
+    if (header[2] != (uint64_t)num_bits) return NULL;
+    uint64_t num_containers = header[3];
+    if (num_containers > (uint64_t)NumChunks(num_bits)) return NULL;
+
+    size_t descriptor_offset = kCompressedBitmapHeaderSize;
+    size_t payload_offset =
+        descriptor_offset + num_containers * sizeof(Descriptor);
+    if (payload_offset > size) return NULL;
+
+    CompressedBitmap *ret = CompressedBitmapCreate(num_bits, allocator);
+    if (ret == NULL) return NULL;
+
+    int64_t prev_chunk = -1;
+    for (uint64_t i = 0; i < num_containers; ++i) {
+        Descriptor d;
+        memcpy(&d, in + descriptor_offset, sizeof(d));
+        descriptor_offset += sizeof(d);
+        if ((int64_t)d.chunk <= prev_chunk) goto _bailout;
+        if ((int64_t)d.chunk >= ret->num_chunks) goto _bailout;
+        prev_chunk = d.chunk;
+
+        size_t payload_size;
+        if (d.type == kContainerArray) {
+            if (d.size == 0 || d.size > kArrayMax) goto _bailout;
+            payload_size = Pad(d.size * sizeof(uint16_t));
+        } else if (d.type == kContainerRun) {
+            if (d.size == 0 || d.size > kRunMax) goto _bailout;
+            payload_size = Pad(d.size * sizeof(Run));
+        } else if (d.type == kContainerBitmap) {
+            payload_size = kBitmapBytes;
+        } else {
+            goto _bailout;
+        }
+        if (payload_size > size - payload_offset) goto _bailout;
+        if (!LoadContainer(ret, &d, in + payload_offset)) goto _bailout;
+        payload_offset += payload_size;
+    }
+    if (payload_offset != size) goto _bailout;
+
+    return ret;
+
+_bailout:
+    CompressedBitmapDestroy(ret);
+    return NULL;
+}
+
+// -----------------------------------------------------------------------------
+
+static int64_t NumChunks(int64_t num_bits) {
+    return (num_bits + kChunkBits - 1) / kChunkBits;
+}
+
+static int64_t ChunkLength(const CompressedBitmap *b, int64_t chunk) {
+    int64_t remaining = b->num_bits - chunk * kChunkBits;
+    return remaining < kChunkBits ? remaining : kChunkBits;
+}
+
+static int GetType(const Container *c) {
+    return atomic_load_explicit(&c->type, memory_order_relaxed);
+}
+
+static void *Allocate(CompressedBitmap *b, size_t size) {
+    return GamesmanAllocatorAllocate(b->allocator, size);
+}
+
+static void Deallocate(CompressedBitmap *b, void *ptr) {
+    GamesmanAllocatorDeallocate(b->allocator, ptr);
+}
+
+static void InitContainer(Container *c) {
+    atomic_flag_clear(&c->lock);
+    atomic_init(&c->type, kContainerEmpty);
+    c->size = 0;
+    c->capacity = 0;
+    c->data = NULL;
+}
+
+static void ClearContainer(CompressedBitmap *b, Container *c) {
+    Deallocate(b, c->data);
+    c->data = NULL;
+    c->size = 0;
+    c->capacity = 0;
+    atomic_store_explicit(&c->type, kContainerEmpty, memory_order_relaxed);
+}
+
+static void Lock(Container *c) {
+    while (atomic_flag_test_and_set_explicit(&c->lock, memory_order_acquire)) {
+        // Spin.
+    }
+}
+
+static void Unlock(Container *c) {
+    atomic_flag_clear_explicit(&c->lock, memory_order_release);
+}
+
+static _Atomic uint64_t *AllocateBitmap(CompressedBitmap *b) {
+    _Atomic uint64_t *words = (_Atomic uint64_t *)Allocate(b, kBitmapBytes);
+    if (words == NULL) return NULL;
+    for (int w = 0; w < kBitmapWords; ++w) {
+        atomic_init(&words[w], 0);
+    }
+
+    return words;
+}
+
+static void BitmapSet(Container *c, int value) {
+    _Atomic uint64_t *words = (_Atomic uint64_t *)c->data;
+    atomic_fetch_or_explicit(&words[value / 64], 1ULL << (value % 64),
+                             memory_order_relaxed);
+}
+
+// Returns the index of the first value in VALUES not less than VALUE.
+static int LowerBound(const uint16_t *values, int32_t size, uint16_t value) {
+    int lo = 0, hi = size;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (values[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+// Sets the bits in [BEGIN, END) of WORDS.
+static void SetRange(uint64_t *words, int begin, int end) {
+    while (begin < end) {
+        int offset = begin % 64;
+        int n = 64 - offset;
+        if (n > end - begin) n = end - begin;
+        uint64_t mask = (n == 64) ? ~0ULL : ((1ULL << n) - 1) << offset;
+        words[begin / 64] |= mask;
+        begin += n;
+    }
+}
+
+static void ToWords(const Container *c, uint64_t *words) {
+    memset(words, 0, kBitmapBytes);
+    switch (GetType(c)) {
+        case kContainerArray: {
+            const uint16_t *values = (const uint16_t *)c->data;
+            for (int32_t i = 0; i < c->size; ++i) {
+                words[values[i] / 64] |= 1ULL << (values[i] % 64);
+            }
+            break;
+        }
+
+        case kContainerBitmap: {
+            _Atomic uint64_t *bitmap = (_Atomic uint64_t *)c->data;
+            for (int w = 0; w < kBitmapWords; ++w) {
+                words[w] =
+                    atomic_load_explicit(&bitmap[w], memory_order_relaxed);
+            }
+            break;
+        }
+
+        case kContainerRun: {
+            const Run *runs = (const Run *)c->data;
+            for (int32_t r = 0; r < c->size; ++r) {
+                int begin = runs[r].start;
+                SetRange(words, begin, begin + runs[r].length_minus_one + 1);
+            }
+            break;
+        }
+    }
+}
+
+// Replaces the content of C with the bits in WORDS, stored in the smallest
+// kind of container. Returns false on memory allocation failure, in which case
+// C is not modified.
+static bool FromWords(CompressedBitmap *b, Container *c,
+                      const uint64_t *words) {
+    int64_t cardinality = 0, num_runs = 0;
+    for (int w = 0; w < kBitmapWords; ++w) {
+        uint64_t carry = (w > 0) ? words[w - 1] >> 63 : 0;
+        uint64_t run_starts = words[w] & ~((words[w] << 1) | carry);
+        cardinality += __builtin_popcountll(words[w]);
+        num_runs += __builtin_popcountll(run_starts);
+    }
+    if (cardinality == 0) {
+        ClearContainer(b, c);
+        return true;
+    }
+
+    int64_t array_bytes = cardinality * (int64_t)sizeof(uint16_t);
+    int64_t run_bytes = num_runs * (int64_t)sizeof(Run);
+    int type = kContainerBitmap;
+    if (run_bytes < array_bytes && run_bytes < kBitmapBytes) {
+        type = kContainerRun;
+    } else if (cardinality <= kArrayMax) {
+        type = kContainerArray;
+    }
+
+    void *data = NULL;
+    int32_t size = 0;
+    if (type == kContainerArray) {
+        uint16_t *values = (uint16_t *)Allocate(b, array_bytes);
+        if (values == NULL) return false;
+        for (int w = 0; w < kBitmapWords; ++w) {
+            for (uint64_t bits = words[w]; bits; bits &= bits - 1) {
+                values[size++] = (uint16_t)(w * 64 + __builtin_ctzll(bits));
+            }
+        }
+        data = values;
+    } else if (type == kContainerRun) {
+        Run *runs = (Run *)Allocate(b, run_bytes);
+        if (runs == NULL) return false;
+        int prev = -2;
+        for (int w = 0; w < kBitmapWords; ++w) {
+            for (uint64_t bits = words[w]; bits; bits &= bits - 1) {
+                int value = w * 64 + __builtin_ctzll(bits);
+                if (value == prev + 1) {
+                    ++runs[size - 1].length_minus_one;
+                } else {
+                    runs[size].start = (uint16_t)value;
+                    runs[size++].length_minus_one = 0;
+                }
+                prev = value;
+            }
+        }
+        data = runs;
+    } else {
+        _Atomic uint64_t *bitmap = AllocateBitmap(b);
+        if (bitmap == NULL) return false;
+        for (int w = 0; w < kBitmapWords; ++w) {
+            atomic_store_explicit(&bitmap[w], words[w], memory_order_relaxed);
+        }
+        data = (void *)bitmap;
+    }
+
+    Deallocate(b, c->data);
+    c->data = data;
+    c->size = size;
+    c->capacity = (type == kContainerArray) ? size : 0;
+    atomic_store_explicit(&c->type, type, memory_order_release);
+
+    return true;
+}
+
+// Converts the array or run container C into a bitmap container. Must be
+// called with C locked.
+static bool ConvertToBitmap(CompressedBitmap *b, Container *c) {
+    _Atomic uint64_t *bitmap = AllocateBitmap(b);
+    if (bitmap == NULL) return false;
+
+    uint64_t words[kBitmapWords];
+    ToWords(c, words);
+    for (int w = 0; w < kBitmapWords; ++w) {
+        atomic_store_explicit(&bitmap[w], words[w], memory_order_relaxed);
+    }
+    Deallocate(b, c->data);
+    c->data = (void *)bitmap;
+    c->size = 0;
+    c->capacity = 0;
+
+    // Publish the bitmap to threads adding bits without the lock.
+    atomic_store_explicit(&c->type, kContainerBitmap, memory_order_release);
+
+    return true;
+}
+
+static bool AddLocked(CompressedBitmap *b, Container *c, uint16_t value) {
+    switch (GetType(c)) {
+        case kContainerEmpty: {
+            uint16_t *values = (uint16_t *)Allocate(
+                b, kArrayInitialCapacity * sizeof(uint16_t));
+            if (values == NULL) return false;
+            values[0] = value;
+            c->data = values;
+            c->size = 1;
+            c->capacity = kArrayInitialCapacity;
+            atomic_store_explicit(&c->type, kContainerArray,
+                                  memory_order_relaxed);
+            return true;
+        }
+
+        case kContainerArray:
+            break;
+
+        case kContainerBitmap:
+            BitmapSet(c, value);
+            return true;
+
+        case kContainerRun:
+            if (!ConvertToBitmap(b, c)) return false;
+            BitmapSet(c, value);
+            return true;
+    }
+
+    uint16_t *values = (uint16_t *)c->data;
+    int i = LowerBound(values, c->size, value);
+    if (i < c->size && values[i] == value) return true;
+
+    if (c->size == c->capacity) {
+        if (c->capacity >= kArrayMax) {
+            if (!ConvertToBitmap(b, c)) return false;
+            BitmapSet(c, value);
+            return true;
+        }
+
+        int32_t capacity = c->capacity * 2;
+        if (capacity > kArrayMax) capacity = kArrayMax;
+        uint16_t *grown =
+            (uint16_t *)Allocate(b, capacity * sizeof(uint16_t));
+        if (grown == NULL) return false;
+        memcpy(grown, values, c->size * sizeof(uint16_t));
+        Deallocate(b, values);
+        values = grown;
+        c->data = grown;
+        c->capacity = capacity;
+    }
+    memmove(values + i + 1, values + i, (c->size - i) * sizeof(uint16_t));
+    values[i] = value;
+    ++c->size;
+
+    return true;
+}
+
+static size_t PayloadSize(const Container *c) {
+    switch (GetType(c)) {
+        case kContainerArray:
+            return Pad(c->size * sizeof(uint16_t));
+        case kContainerBitmap:
+            return kBitmapBytes;
+        case kContainerRun:
+            return Pad(c->size * sizeof(Run));
+    }
+
+    return 0;
+}
+
+static size_t Pad(size_t size) { return (size + 7) / 8 * 8; }
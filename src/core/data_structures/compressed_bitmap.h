@@ -0,0 +1,189 @@
+/**
+ * @file compressed_bitmap.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief A container-adaptive compressed bitmap.
+ * @details The bits are split into chunks of 2^16 bits, each stored in the
+ * smallest of three kinds of containers: a sorted array of the set bits for
+ * sparse chunks, a plain bitmap for dense chunks, or a sorted list of runs of
+ * set bits for clustered chunks. Empty chunks take no space other than their
+ * header. This is the layout of Roaring bitmaps (Chambi et al., 2016).
+ *
+ * Bits may be added by multiple threads concurrently. All other operations
+ * are not thread-safe.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_DATA_STRUCTURES_COMPRESSED_BITMAP_H_
+#define GAMESMANONE_CORE_DATA_STRUCTURES_COMPRESSED_BITMAP_H_
+
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+#include <stdint.h>   // int64_t
+
+#include "core/data_structures/concurrent_bitset.h"
+#include "core/gamesman_memory.h"
+
+typedef struct CompressedBitmap CompressedBitmap;
+
+enum {
+    /** Size in bytes of the header of a serialized CompressedBitmap. */
+    kCompressedBitmapHeaderSize = 32,
+
+    /** Transient space in bytes used to convert one container. */
+    kCompressedBitmapConversionMax = 16384,
+};
+
+/**
+ * @brief Returns the amount of memory required in bytes to create an empty
+ * CompressedBitmap of size \p num_bits bits.
+ */
+size_t CompressedBitmapMemRequired(int64_t num_bits);
+
+/**
+ * @brief Returns the largest amount of memory in bytes that a CompressedBitmap
+ * of size \p num_bits bits may use once bits are added, allowing for the
+ * per-allocation overhead of a GamesmanAllocator.
+ * @note Converting a container into another takes up to
+ * kCompressedBitmapConversionMax additional bytes until the conversion is
+ * done. Each thread adding bits converts at most one container at a time.
+ */
+size_t CompressedBitmapMemRequiredMax(int64_t num_bits);
+
+/**
+ * @brief Constructs an empty CompressedBitmap of \p num_bits bits using
+ * \p allocator as the underlying memory allocator, or the default allocation
+ * functions if \p allocator is \c NULL. A new reference of \p allocator is
+ * created for the bitmap.
+ *
+ * @return Pointer to a newly created CompressedBitmap object, or
+ * @return \c NULL on memory allocation failure.
+ */
+CompressedBitmap *CompressedBitmapCreate(int64_t num_bits,
+                                         GamesmanAllocator *allocator);
+
+/**
+ * @brief Constructs a CompressedBitmap with the same bits as \p s using
+ * \p allocator as the underlying memory allocator.
+ *
+ * @return Pointer to a newly created CompressedBitmap object, or
+ * @return \c NULL on memory allocation failure.
+ */
+CompressedBitmap *CompressedBitmapCreateFromBitset(
+    ConcurrentBitset *s, GamesmanAllocator *allocator);
+
+/**
+ * @brief Destroys the given CompressedBitmap \p b. Does nothing if \p b is
+ * \c NULL.
+ */
+void CompressedBitmapDestroy(CompressedBitmap *b);
+
+/** @brief Returns the number of bits in \p b. */
+int64_t CompressedBitmapGetNumBits(const CompressedBitmap *b);
+
+/**
+ * @brief Sets the bit at index \p bit_index of \p b to 1. Undefined if
+ * \p bit_index is out of bounds.
+ * @note This function is thread-safe with respect to other calls to itself.
+ *
+ * @return \c true on success, or
+ * @return \c false on memory allocation failure, in which case the bit is not
+ * set.
+ */
+bool CompressedBitmapAdd(CompressedBitmap *b, int64_t bit_index);
+
+/**
+ * @brief Returns whether the bit at index \p bit_index of \p b is set to 1.
+ * Undefined if \p bit_index is out of bounds.
+ */
+bool CompressedBitmapContains(const CompressedBitmap *b, int64_t bit_index);
+
+/** @brief Returns the number of bits set to 1 in \p b. */
+int64_t CompressedBitmapCount(const CompressedBitmap *b);
+
+/**
+ * @brief Sets \p dest to the bitwise OR of \p dest and \p src, which must be of
+ * the same length. Each modified container of \p dest is stored in the
+ * smallest kind of container for its new content.
+ *
+ * @return \c true on success, or
+ * @return \c false on memory allocation failure, in which case \p dest
+ * contains a subset of the bits of the OR, which is a superset of the bits
+ * of \p dest before the call.
+ */
+bool CompressedBitmapOr(CompressedBitmap *dest, const CompressedBitmap *src);
+
+/**
+ * @brief Converts every container of \p b into the smallest kind of container
+ * for its content. Bits added with CompressedBitmapAdd are never stored as
+ * runs until this function is called.
+ *
+ * @return \c true on success, or
+ * @return \c false on memory allocation failure, in which case the content of
+ * \p b is unchanged.
+ */
+bool CompressedBitmapOptimize(CompressedBitmap *b);
+
+/**
+ * @brief Sets every bit of \p dest that is set in \p b, which must be of the
+ * same length.
+ */
+void CompressedBitmapToBitset(const CompressedBitmap *b,
+                              ConcurrentBitset *dest);
+
+/**
+ * @brief Returns the size in bytes of \p b once serialized, including the
+ * header.
+ */
+size_t CompressedBitmapGetSerializedSize(const CompressedBitmap *b);
+
+/**
+ * @brief Returns the largest size in bytes that a CompressedBitmap of size
+ * \p num_bits bits may take once serialized, including the header.
+ */
+size_t CompressedBitmapGetSerializedSizeMax(int64_t num_bits);
+
+/**
+ * @brief Serializes \p b into \p buf, which must hold at least
+ * CompressedBitmapGetSerializedSize(b) bytes.
+ */
+void CompressedBitmapSerialize(const CompressedBitmap *b, void *buf);
+
+/**
+ * @brief Returns the size in bytes of the serialized CompressedBitmap whose
+ * first kCompressedBitmapHeaderSize bytes are \p header, or 0 if \p header is
+ * not a valid header.
+ */
+size_t CompressedBitmapGetSerializedSizeFromHeader(const void *header);
+
+/**
+ * @brief Constructs a CompressedBitmap of \p num_bits bits from the \p size
+ * bytes of serialized content at \p buf using \p allocator as the underlying
+ * memory allocator.
+ *
+ * @return Pointer to a newly created CompressedBitmap object, or
+ * @return \c NULL if \p buf is not a valid serialized CompressedBitmap of
+ * \p num_bits bits, or on memory allocation failure.
+ */
+CompressedBitmap *CompressedBitmapDeserialize(const void *buf, size_t size,
+                                              int64_t num_bits,
+                                              GamesmanAllocator *allocator);
+
+#endif  // GAMESMANONE_CORE_DATA_STRUCTURES_COMPRESSED_BITMAP_H_
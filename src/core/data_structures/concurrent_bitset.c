@@ -63,6 +63,10 @@
 #include "core/concurrency.h"
 #include "core/gamesman_memory.h"
 
+#ifdef __AVX2__
+#include <immintrin.h>  // __m256i, _mm256_*
+#endif                  // __AVX2__
+
 // Pick the largest lock-free type available
 #if (ATOMIC_LLONG_LOCK_FREE == 2)
 typedef unsigned long long BlockType;
@@ -73,8 +77,16 @@ typedef unsigned int BlockType;
 #endif
 typedef _Atomic BlockType AtomicBlockType;
 static const int64_t kBitsPerBlock = sizeof(BlockType) * 8;
+static const int64_t kBlocksPerChunk =
+    kConcurrentBitsetChunkBits / (sizeof(BlockType) * 8);
 static const BlockType kOne = 1;
 
+// Blocks are accessed as plain 64-bit integers by the vectorized bulk
+// operations, which are not thread-safe anyway.
+#if defined(__AVX2__) && (ATOMIC_LLONG_LOCK_FREE == 2)
+#define CONCURRENT_BITSET_USE_AVX2
+#endif
+
 struct ConcurrentBitset {
     GamesmanAllocator *allocator;
     int64_t num_bits;
@@ -207,6 +219,140 @@ bool ConcurrentBitsetTest(ConcurrentBitset *s, int64_t bit_index,
     return block & mask;
 }
 
+int64_t ConcurrentBitsetNumChunks(const ConcurrentBitset *s) {
+    return (s->num_bits + kConcurrentBitsetChunkBits - 1) /
+           kConcurrentBitsetChunkBits;
+}
+
+static int LowestBit(BlockType block) {
+    return __builtin_ctzll((unsigned long long)block);
+}
+
+// Returns the index of the first bit in [BEGIN, END) of S that differs from
+// the corresponding bit of FLIP, or END if there is none.
+static int64_t FindNext(ConcurrentBitset *s, int64_t begin, int64_t end,
+                        BlockType flip, memory_order order) {
+    int64_t limit = end < s->num_bits ? end : s->num_bits;
+    if (begin >= limit) return end;
+
+    int64_t block_index = BlockIndex(begin);
+    int64_t last_block_index = BlockIndex(limit - 1);
+    BlockType block = atomic_load_explicit(&s->data[block_index], order);
+    block = (block ^ flip) & (~(BlockType)0 << BitOffset(begin));
+    while (block == 0) {
+        if (++block_index > last_block_index) return end;
+        block = atomic_load_explicit(&s->data[block_index], order) ^ flip;
+    }
+    int64_t ret = block_index * kBitsPerBlock + LowestBit(block);
+
+    return ret < limit ? ret : end;
+}
+
+int64_t ConcurrentBitsetFindNextSet(ConcurrentBitset *s, int64_t begin,
+                                    int64_t end, memory_order order) {
+    assert(begin >= 0);
+    return FindNext(s, begin, end, 0, order);
+}
+
+int64_t ConcurrentBitsetFindNextUnset(ConcurrentBitset *s, int64_t begin,
+                                      int64_t end, memory_order order) {
+    assert(begin >= 0);
+    return FindNext(s, begin, end, ~(BlockType)0, order);
+}
+
+int64_t ConcurrentBitsetCount(ConcurrentBitset *s) {
+    int64_t num_blocks = NumBitsToNumBlocks(s->num_bits);
+    ConcurrentSizeType count;
+    ConcurrentSizeTypeInit(&count, 0);
+    PRAGMA_OMP_PARALLEL {
+        size_t local_count = 0;
+        PRAGMA_OMP_FOR_SCHEDULE_DYNAMIC(kBlocksPerChunk)
+        for (int64_t i = 0; i < num_blocks; ++i) {
+            BlockType block =
+                atomic_load_explicit(&s->data[i], memory_order_relaxed);
+            local_count += __builtin_popcountll((unsigned long long)block);
+        }
+        ConcurrentSizeTypeAdd(&count, local_count);
+    }
+
+    return (int64_t)ConcurrentSizeTypeLoad(&count);
+}
+
+typedef enum { kBulkAnd, kBulkOr, kBulkAndNot } BulkOp;
+
+static BlockType ApplyBlock(BlockType dest, BlockType src, BulkOp op) {
+    switch (op) {
+        case kBulkAnd:
+            return dest & src;
+        case kBulkOr:
+            return dest | src;
+        case kBulkAndNot:
+            return dest & ~src;
+    }
+
+    return dest;
+}
+
+#ifdef CONCURRENT_BITSET_USE_AVX2
+static __m256i ApplyVector(__m256i dest, __m256i src, BulkOp op) {
+    switch (op) {
+        case kBulkAnd:
+            return _mm256_and_si256(dest, src);
+        case kBulkOr:
+            return _mm256_or_si256(dest, src);
+        case kBulkAndNot:
+            return _mm256_andnot_si256(src, dest);
+    }
+
+    return dest;
+}
+#endif  // CONCURRENT_BITSET_USE_AVX2
+
+static void ApplyRange(ConcurrentBitset *dest, ConcurrentBitset *src,
+                       int64_t begin, int64_t end, BulkOp op) {
+    int64_t i = begin;
+#ifdef CONCURRENT_BITSET_USE_AVX2
+    BlockType *d = (BlockType *)dest->data;
+    const BlockType *s = (const BlockType *)src->data;
+    for (; i + 4 <= end; i += 4) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(d + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(s + i));
+        _mm256_storeu_si256((__m256i *)(d + i), ApplyVector(a, b, op));
+    }
+#endif  // CONCURRENT_BITSET_USE_AVX2
+    for (; i < end; ++i) {
+        memory_order relaxed = memory_order_relaxed;
+        BlockType a = atomic_load_explicit(&dest->data[i], relaxed);
+        BlockType b = atomic_load_explicit(&src->data[i], relaxed);
+        atomic_store_explicit(&dest->data[i], ApplyBlock(a, b, op), relaxed);
+    }
+}
+
+static void Apply(ConcurrentBitset *dest, ConcurrentBitset *src, BulkOp op) {
+    assert(dest->num_bits == src->num_bits);
+    int64_t num_blocks = NumBitsToNumBlocks(dest->num_bits);
+    int64_t num_chunks = (num_blocks + kBlocksPerChunk - 1) / kBlocksPerChunk;
+    PRAGMA_OMP_PARALLEL_FOR_SCHEDULE_DYNAMIC(1)
+    for (int64_t c = 0; c < num_chunks; ++c) {
+        int64_t begin = c * kBlocksPerChunk;
+        int64_t end = begin + kBlocksPerChunk;
+        if (end > num_blocks) end = num_blocks;
+        ApplyRange(dest, src, begin, end, op);
+    }
+}
+
+void ConcurrentBitsetAnd(ConcurrentBitset *dest, ConcurrentBitset *src) {
+    Apply(dest, src, kBulkAnd);
+}
+
+void ConcurrentBitsetOr(ConcurrentBitset *dest, ConcurrentBitset *src) {
+    Apply(dest, src, kBulkOr);
+}
+
+void ConcurrentBitsetAndNot(ConcurrentBitset *dest, ConcurrentBitset *src) {
+    Apply(dest, src, kBulkAndNot);
+}
+
 size_t ConcurrentBitsetGetSerializedSize(const ConcurrentBitset *s) {
     int64_t num_blocks = NumBitsToNumBlocks(s->num_bits);
 
@@ -66,6 +66,13 @@
 
 typedef struct ConcurrentBitset ConcurrentBitset;
 
+/**
+ * @brief Number of bits in each chunk of a parallel scan over a
+ * ConcurrentBitset. Chunks never share a block, so each chunk may be scanned
+ * by a different thread.
+ */
+enum { kConcurrentBitsetChunkBits = 1 << 16 };
+
 /**
  * @brief Returns the amount of memory required in bytes to create a
  * ConcurrentBitset of size \p num_bits bits.
@@ -179,6 +186,86 @@ void ConcurrentBitsetResetAll(ConcurrentBitset *s);
 bool ConcurrentBitsetTest(ConcurrentBitset *s, int64_t bit_index,
                           memory_order order);
 
+/**
+ * @brief Returns the number of chunks of kConcurrentBitsetChunkBits bits, the
+ * last of which may be shorter, that cover the given ConcurrentBitset.
+ *
+ * @param s Pointer to a ConcurrentBitset object.
+ * @return Number of chunks in \p s.
+ */
+int64_t ConcurrentBitsetNumChunks(const ConcurrentBitset *s);
+
+/**
+ * @brief Returns the index of the first bit set to 1 in the range
+ * [ \p begin, \p end ) of \p s, or \p end if there is none. The bits are
+ * scanned a block at a time, so iterating over the set bits with
+ * @code
+ * for (int64_t i = ConcurrentBitsetFindNextSet(s, begin, end, order);
+ *      i < end; i = ConcurrentBitsetFindNextSet(s, i + 1, end, order)) {
+ *     // ...
+ * }
+ * @endcode
+ * costs time proportional to the number of blocks in the range plus the
+ * number of set bits. \p end may exceed the number of bits in \p s.
+ *
+ * @param s Pointer to the source ConcurrentBitset object.
+ * @param begin Index of the first bit to scan, which must not be negative.
+ * @param end One past the index of the last bit to scan.
+ * @param order Memory order to use.
+ * @return Index of the first set bit in range, or
+ * @return \p end if all bits in range are 0.
+ */
+int64_t ConcurrentBitsetFindNextSet(ConcurrentBitset *s, int64_t begin,
+                                    int64_t end, memory_order order);
+
+/**
+ * @brief Same as ConcurrentBitsetFindNextSet, except that the index of the
+ * first bit set to 0 is returned.
+ */
+int64_t ConcurrentBitsetFindNextUnset(ConcurrentBitset *s, int64_t begin,
+                                      int64_t end, memory_order order);
+
+/**
+ * @brief Returns the number of bits set to 1 in the given ConcurrentBitset.
+ * @note This function does not provide thread-safety. The count is not a
+ * snapshot if \p s is modified by another thread while this function is in
+ * progress.
+ *
+ * @param s Pointer to the source ConcurrentBitset object.
+ * @return Number of bits set to 1 in \p s.
+ */
+int64_t ConcurrentBitsetCount(ConcurrentBitset *s);
+
+/**
+ * @brief Sets \p dest to the bitwise AND of \p dest and \p src, which must be
+ * of the same length.
+ * @note This function does not provide thread-safety.
+ *
+ * @param dest Pointer to the destination ConcurrentBitset object.
+ * @param src Pointer to the source ConcurrentBitset object.
+ */
+void ConcurrentBitsetAnd(ConcurrentBitset *dest, ConcurrentBitset *src);
+
+/**
+ * @brief Sets \p dest to the bitwise OR of \p dest and \p src, which must be
+ * of the same length.
+ * @note This function does not provide thread-safety.
+ *
+ * @param dest Pointer to the destination ConcurrentBitset object.
+ * @param src Pointer to the source ConcurrentBitset object.
+ */
+void ConcurrentBitsetOr(ConcurrentBitset *dest, ConcurrentBitset *src);
+
+/**
+ * @brief Resets all bits in \p dest that are set in \p src, which must be of
+ * the same length.
+ * @note This function does not provide thread-safety.
+ *
+ * @param dest Pointer to the destination ConcurrentBitset object.
+ * @param src Pointer to the source ConcurrentBitset object.
+ */
+void ConcurrentBitsetAndNot(ConcurrentBitset *dest, ConcurrentBitset *src);
+
 /**
  * @brief Returns the amount of memory required in bytes to store the serialized
  * ConcurrentBitset object.
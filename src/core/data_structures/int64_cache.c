@@ -3,9 +3,10 @@
  * @author Robert Shi (robertyishi@berkeley.edu)
  * @author GamesCrafters Research Group, UC Berkeley
  *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
- * @brief (UNFINISHED) 64-bit-integer-indexed cache
- * @version 0.0.0
- * @date 2024-07-09
+ * @brief Implementation of the 64-bit-integer-indexed least-recently-used
+ * cache of byte buffers.
+ * @version 1.0.0
+ * @date 2026-10-18
  *
  * @copyright This file is part of GAMESMAN, The Finite, Two-person
  * Perfect-Information Game Generator released under the GPL:
@@ -26,21 +27,17 @@
 
 #include "core/data_structures/int64_cache.h"
 
-#include <stdbool.h>  // bool
+#include <stdbool.h>  // bool, true, false
 #include <stddef.h>   // NULL, size_t
-#include <stdint.h>   // int64_t
+#include <stdint.h>   // int64_t, uint64_t
 #include <stdlib.h>   // calloc, malloc, free
 
-#include "core/misc.h"
-
 static const double kMaxLoadFactor = 0.5;
-
-static void *(*alloc_func)(size_t size);
-static void (*free_func)(void *ptr);
+enum { kNumBucketsMin = 16 };
 
 typedef struct Entry {
     int64_t key;          /**< Key to the entry. */
-    void *data;           /**< Data allocated using \p alloc_func. */
+    void *data;           /**< Data allocated using the cache's allocator. */
     size_t size;          /**< Size of \p data in bytes. */
     struct Entry *d_prev; /**< Doubly-linked list previous entry. */
     struct Entry *d_next; /**< Doubly-linked list next entry. */
@@ -49,20 +46,26 @@ typedef struct Entry {
 
 struct Int64Cache {
     Entry **hash_table;   // calloc'ed array of buckets.
-    Entry *head;          // calloc'ed head node.
-    Entry *tail;          // calloc'ed tail node.
+    Entry *head;          // calloc'ed head node, before the most recent entry.
+    Entry *tail;          // calloc'ed tail node, after the least recent entry.
     int64_t num_entries;  // Number of cache entries.
     int64_t num_buckets;  // Number of hash table buckets.
-    size_t size;          // Size of the cache in bytes.
+    size_t size;          // Capacity of the cache in bytes.
+    size_t usage;         // Total size of all entries in bytes.
+    void *(*alloc_func)(size_t size);
+    void (*free_func)(void *ptr);
 };
 
-Int64Cache *Int64CacheInit(size_t size, Int64CacheAllocator *allocator) {
+Int64Cache *Int64CacheInit(size_t size, const Int64CacheAllocator *allocator) {
     Int64Cache *cache = (Int64Cache *)calloc(1, sizeof(Int64Cache));
     if (cache == NULL) return NULL;
 
+    cache->hash_table = (Entry **)calloc(kNumBucketsMin, sizeof(Entry *));
     cache->head = (Entry *)calloc(1, sizeof(Entry));
     cache->tail = (Entry *)calloc(1, sizeof(Entry));
-    if (cache->head == NULL || cache->tail == NULL) {
+    if (cache->hash_table == NULL || cache->head == NULL ||
+        cache->tail == NULL) {
+        free(cache->hash_table);
         free(cache->head);
         free(cache->tail);
         free(cache);
@@ -71,12 +74,13 @@ Int64Cache *Int64CacheInit(size_t size, Int64CacheAllocator *allocator) {
 
     cache->head->d_next = cache->tail;
     cache->tail->d_prev = cache->head;
+    cache->num_buckets = kNumBucketsMin;
+    cache->size = size;
+    cache->alloc_func = &malloc;
+    cache->free_func = &free;
     if (allocator != NULL) {
-        alloc_func = allocator->alloc ? allocator->alloc : &malloc;
-        free_func = allocator->free ? allocator->free : &free;
-    } else {
-        alloc_func = &malloc;
-        free_func = &free;
+        if (allocator->alloc != NULL) cache->alloc_func = allocator->alloc;
+        if (allocator->free != NULL) cache->free_func = allocator->free;
     }
 
     return cache;
@@ -85,52 +89,128 @@ Int64Cache *Int64CacheInit(size_t size, Int64CacheAllocator *allocator) {
 int Int64CacheDestroy(Int64Cache *cache) {
     if (cache == NULL) return 0;
     free(cache->hash_table);  // free the buckets first.
-    Entry *walker = cache->head;
-    Entry *free_this;
-    while (walker != NULL) {
-        free_this = walker;
+    Entry *walker = cache->head->d_next;
+    while (walker != cache->tail) {
+        Entry *free_this = walker;
         walker = walker->d_next;
-        free_func(free_this->data);
+        cache->free_func(free_this->data);
         free(free_this);
     }
+    free(cache->head);
+    free(cache->tail);
     free(cache);
     return 0;
 }
 
 static int64_t Hash(int64_t key, int64_t num_buckets) {
-    return ((uint64_t)key) % num_buckets;
+    return (int64_t)(((uint64_t)key) % (uint64_t)num_buckets);
 }
 
-void *Int64CachePut(Int64Cache *cache, int64_t key, size_t size) {
-    // TODO:
-    // First verify that the cache size is enough for SIZE. If not
-    // enough, return NULL immediately without evicting entries.
-    // look for existing key, if exists, free old data and reallocate
-    // if not found, allocate a new entry and custom-alloc data of the
-    // given size if remaining space is enough. Otherwise, keep evicting
-    // entries off the tail of the doubly-linked list until enough room
-    // is made.
-    return NULL;
+static Entry *Find(const Int64Cache *cache, int64_t key) {
+    Entry *walker = cache->hash_table[Hash(key, cache->num_buckets)];
+    while (walker != NULL && walker->key != key) {
+        walker = walker->s_next;
+    }
+
+    return walker;
+}
+
+static void ListUnlink(Entry *entry) {
+    entry->d_next->d_prev = entry->d_prev;
+    entry->d_prev->d_next = entry->d_next;
 }
 
-void *Int64CacheGet(Int64Cache *cache, int64_t key, int64_t *size) {
-    int slot = Hash(key, cache->num_buckets);
-    Entry *walker = cache->hash_table[slot];
-    while (walker != NULL) {
-        if (walker->key == key) {
-            // Bring this entry to the front of the list.
-            walker->d_next->d_prev = walker->d_prev;
-            walker->d_prev->d_next = walker->d_next;
-            walker->d_prev = cache->head;
-            walker->d_next = cache->head->d_next;
-            cache->head->d_next = walker;
-            walker->d_next->d_prev = walker;
-
-            *size = walker->size;
-            return walker->data;
+static void ListPushFront(Int64Cache *cache, Entry *entry) {
+    entry->d_prev = cache->head;
+    entry->d_next = cache->head->d_next;
+    cache->head->d_next = entry;
+    entry->d_next->d_prev = entry;
+}
+
+// Removes ENTRY from both the hash table and the list, and frees it.
+static void Remove(Int64Cache *cache, Entry *entry) {
+    Entry **link = &cache->hash_table[Hash(entry->key, cache->num_buckets)];
+    while (*link != entry) {
+        link = &(*link)->s_next;
+    }
+    *link = entry->s_next;
+    ListUnlink(entry);
+
+    cache->usage -= entry->size;
+    --cache->num_entries;
+    cache->free_func(entry->data);
+    free(entry);
+}
+
+static void Rehash(Int64Cache *cache) {
+    int64_t num_buckets = cache->num_buckets * 2;
+    Entry **hash_table = (Entry **)calloc(num_buckets, sizeof(Entry *));
+
+    // The table is only overloaded, so failing to grow it is not an error.
+    if (hash_table == NULL) return;
+
+    for (int64_t i = 0; i < cache->num_buckets; ++i) {
+        Entry *walker = cache->hash_table[i];
+        while (walker != NULL) {
+            Entry *next = walker->s_next;
+            int64_t slot = Hash(walker->key, num_buckets);
+            walker->s_next = hash_table[slot];
+            hash_table[slot] = walker;
+            walker = next;
         }
-        walker = walker->s_next;
     }
+    free(cache->hash_table);
+    cache->hash_table = hash_table;
+    cache->num_buckets = num_buckets;
+}
 
-    return NULL;
+void *Int64CachePut(Int64Cache *cache, int64_t key, size_t size) {
+    Entry *existing = Find(cache, key);
+    if (existing != NULL) Remove(cache, existing);
+    if (size > cache->size) return NULL;
+
+    // Evict entries off the tail of the list until there is enough room.
+    while (cache->size - cache->usage < size) {
+        Remove(cache, cache->tail->d_prev);
+    }
+
+    Entry *entry = (Entry *)malloc(sizeof(Entry));
+    if (entry == NULL) return NULL;
+    entry->data = cache->alloc_func(size);
+    if (entry->data == NULL) {
+        free(entry);
+        return NULL;
+    }
+    entry->key = key;
+    entry->size = size;
+
+    int64_t slot = Hash(key, cache->num_buckets);
+    entry->s_next = cache->hash_table[slot];
+    cache->hash_table[slot] = entry;
+    ListPushFront(cache, entry);
+    cache->usage += size;
+    ++cache->num_entries;
+    if (cache->num_entries > cache->num_buckets * kMaxLoadFactor) {
+        Rehash(cache);
+    }
+
+    return entry->data;
 }
+
+void *Int64CacheGet(Int64Cache *cache, int64_t key, size_t *size) {
+    Entry *entry = Find(cache, key);
+    if (entry == NULL) return NULL;
+
+    // Bring this entry to the front of the list.
+    ListUnlink(entry);
+    ListPushFront(cache, entry);
+    if (size != NULL) *size = entry->size;
+
+    return entry->data;
+}
+
+bool Int64CacheContains(const Int64Cache *cache, int64_t key) {
+    return Find(cache, key) != NULL;
+}
+
+size_t Int64CacheUsage(const Int64Cache *cache) { return cache->usage; }
@@ -3,9 +3,9 @@
  * @author Robert Shi (robertyishi@berkeley.edu)
  * @author GamesCrafters Research Group, UC Berkeley
  *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
- * @brief (UNFINISHED) 64-bit-integer-indexed cache
- * @version 0.0.0
- * @date 2024-07-09
+ * @brief 64-bit-integer-indexed least-recently-used cache of byte buffers.
+ * @version 1.0.0
+ * @date 2026-10-18
  *
  * @copyright This file is part of GAMESMAN, The Finite, Two-person
  * Perfect-Information Game Generator released under the GPL:
@@ -31,16 +31,80 @@
 #include <stddef.h>   // size_t
 #include <stdint.h>   // int64_t
 
+/**
+ * @brief Cache of byte buffers indexed by 64-bit integer keys, holding at most
+ * a fixed total number of bytes. When a new buffer does not fit, the least
+ * recently used buffers are evicted until it does.
+ *
+ * @example
+ * Int64Cache *cache = Int64CacheInit(1 << 20, NULL);  // 1 MiB of data.
+ * char *data = (char *)Int64CachePut(cache, 42, 6);
+ * if (data != NULL) strcpy(data, "hello");
+ * size_t size;
+ * data = (char *)Int64CacheGet(cache, 42, &size);  // "hello", size == 6.
+ * Int64CacheDestroy(cache);
+ */
 typedef struct Int64Cache Int64Cache;
+
+/** @brief Custom allocator of the buffers stored in an Int64Cache. */
 typedef struct Int64CacheAllocator {
-    void *(*alloc)(size_t size);
-    void (*free)(void *ptr);
+    void *(*alloc)(size_t size); /**< Defaults to malloc if NULL. */
+    void (*free)(void *ptr);     /**< Defaults to free if NULL. */
 } Int64CacheAllocator;
 
-Int64Cache *Int64CacheInit(size_t size, Int64CacheAllocator *allocator);
+/**
+ * @brief Creates a new cache that holds at most \p size bytes of buffers.
+ *
+ * @param size Capacity of the cache in bytes, not including the bookkeeping
+ * overhead of about 64 bytes per entry.
+ * @param allocator Allocator of the buffers, which is copied into the cache.
+ * If \c NULL, buffers are allocated using malloc and freed using free.
+ * @return New cache on success, or
+ * @return \c NULL on allocation failure.
+ */
+Int64Cache *Int64CacheInit(size_t size, const Int64CacheAllocator *allocator);
+
+/**
+ * @brief Destroys \p cache and frees all buffers in it. Does nothing if
+ * \p cache is \c NULL.
+ *
+ * @return 0 always.
+ */
 int Int64CacheDestroy(Int64Cache *cache);
 
+/**
+ * @brief Allocates a buffer of \p size bytes for \p key in \p cache and marks
+ * it as the most recently used entry. The previous buffer of \p key, if any,
+ * is freed, and least recently used entries are evicted until the new buffer
+ * fits. The contents of the new buffer are uninitialized.
+ *
+ * @param cache Destination cache.
+ * @param key Key of the buffer.
+ * @param size Size of the buffer in bytes.
+ * @return Pointer to the new buffer, which stays valid until its entry is
+ * replaced or evicted, or
+ * @return \c NULL if \p size exceeds the capacity of \p cache or on allocation
+ * failure, in which case \p key is no longer in \p cache.
+ */
 void *Int64CachePut(Int64Cache *cache, int64_t key, size_t size);
+
+/**
+ * @brief Returns the buffer of \p key in \p cache and marks it as the most
+ * recently used entry.
+ *
+ * @param cache Cache to look up.
+ * @param key Key of the buffer.
+ * @param size (Output parameter) Set to the size of the buffer in bytes if
+ * \p key is found and \p size is not \c NULL.
+ * @return Pointer to the buffer, or
+ * @return \c NULL if \p key is not in \p cache.
+ */
 void *Int64CacheGet(Int64Cache *cache, int64_t key, size_t *size);
 
+/** @brief Returns whether \p cache contains \p key, without marking it. */
+bool Int64CacheContains(const Int64Cache *cache, int64_t key);
+
+/** @brief Returns the total size of the buffers in \p cache in bytes. */
+size_t Int64CacheUsage(const Int64Cache *cache);
+
 #endif  // GAMESMANONE_CORE_DATA_STRUCTURES_INT64_CACHE_H_
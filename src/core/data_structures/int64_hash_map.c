@@ -3,9 +3,9 @@
  * @author Robert Shi (robertyishi@berkeley.edu)
  * @author GamesCrafters Research Group, UC Berkeley
  *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
- * @brief Linear-probing (open addressing) int64_t to int64_t hash map.
- * @version 1.0.4
- * @date 2025-04-26
+ * @brief Open addressing int64_t to int64_t hash map implementation.
+ * @version 1.1.0
+ * @date 2026-10-18
  *
  * @copyright This file is part of GAMESMAN, The Finite, Two-person
  * Perfect-Information Game Generator released under the GPL:
@@ -26,38 +26,19 @@
 
 #include "core/data_structures/int64_hash_map.h"
 
-#include <assert.h>   // assert
-#include <math.h>     // INFINITY
 #include <stdbool.h>  // bool, true, false
 #include <stddef.h>   // NULL
-#include <stdint.h>   // int64_t, uint64_t
+#include <stdint.h>   // int64_t
 
-#include "core/gamesman_memory.h"
-#include "core/misc.h"  // NextPrime
-
-static int64_t Hash(int64_t key, int64_t capacity) {
-    return (int64_t)(((uint64_t)key) % capacity);
-}
-
-static int64_t NextIndex(int64_t index, int64_t capacity) {
-    return (index + 1) % capacity;
-}
+#include "core/data_structures/swiss_table.h"
 
 void Int64HashMapInit(Int64HashMap *map, double max_load_factor) {
-    map->entries = NULL;
-    map->capacity = 0;
-    map->size = 0;
     if (max_load_factor > 0.75) max_load_factor = 0.75;
     if (max_load_factor < 0.25) max_load_factor = 0.25;
-    map->max_load_factor = max_load_factor;
+    SwissTableInit(&map->table, 1, 1, max_load_factor);
 }
 
-void Int64HashMapDestroy(Int64HashMap *map) {
-    GamesmanFree(map->entries);
-    map->entries = NULL;
-    map->capacity = 0;
-    map->size = 0;
-}
+void Int64HashMapDestroy(Int64HashMap *map) { SwissTableDestroy(&map->table); }
 
 static Int64HashMapIterator NewIterator(const Int64HashMap *map,
                                         int64_t index) {
@@ -68,97 +49,55 @@ static Int64HashMapIterator NewIterator(const Int64HashMap *map,
 }
 
 Int64HashMapIterator Int64HashMapGet(const Int64HashMap *map, int64_t key) {
-    int64_t capacity = map->capacity;
-    // Edge case: return invalid iterator if map is empty.
-    if (capacity == 0) return NewIterator(map, capacity);
-    int64_t index = Hash(key, capacity);
-    while (map->entries[index].used) {
-        if (map->entries[index].key == key) {
-            return NewIterator(map, index);
-        }
-        index = NextIndex(index, capacity);
-    }
-    return NewIterator(map, capacity);
-}
+    int64_t index = SwissTableFind(&map->table, &key);
+    // Return invalid iterator if key is not found.
+    if (index < 0) return NewIterator(map, SwissTableEnd(&map->table));
 
-static bool Expand(Int64HashMap *map) {
-    int64_t new_capacity = NextPrime(map->capacity * 2);
-    Int64HashMapEntry *new_entries = (Int64HashMapEntry *)GamesmanCallocWhole(
-        new_capacity, sizeof(Int64HashMapEntry));
-    if (new_entries == NULL) return false;
-    for (int64_t i = 0; i < map->capacity; ++i) {
-        if (map->entries[i].used) {
-            int64_t new_index = Hash(map->entries[i].key, new_capacity);
-            while (new_entries[new_index].used) {
-                new_index = NextIndex(new_index, new_capacity);
-            }
-            new_entries[new_index] = map->entries[i];
-        }
-    }
-    GamesmanFree(map->entries);
-    map->entries = new_entries;
-    map->capacity = new_capacity;
-    return true;
+    return NewIterator(map, index);
 }
 
 bool Int64HashMapSet(Int64HashMap *map, int64_t key, int64_t value) {
-    // Check if resizing is needed.
-    double load_factor = (map->capacity == 0)
-                             ? INFINITY
-                             : (double)(map->size + 1) / (double)map->capacity;
-    if (map->capacity == 0 || load_factor > map->max_load_factor) {
-        if (!Expand(map)) return false;
-    }
-
-    // Set value at key.
-    int64_t capacity = map->capacity;
-    int64_t index = Hash(key, capacity);
-    while (map->entries[index].used) {
-        if (map->entries[index].key == key) {
-            map->entries[index].value = value;
-            return true;
-        }
-        index = NextIndex(index, capacity);
-    }
-    map->entries[index].key = key;
-    map->entries[index].value = value;
-    map->entries[index].used = true;
-    ++map->size;
+    int64_t index = SwissTableInsert(&map->table, &key, NULL);
+    if (index < 0) return false;
+
+    SwissTableSlot(&map->table, index)[1] = value;
     return true;
 }
 
 bool Int64HashMapContains(const Int64HashMap *map, int64_t key) {
-    Int64HashMapIterator it = Int64HashMapGet(map, key);
-    return Int64HashMapIteratorIsValid(&it);
+    return SwissTableFind(&map->table, &key) >= 0;
+}
+
+bool Int64HashMapRemove(Int64HashMap *map, int64_t key) {
+    return SwissTableRemove(&map->table, &key);
 }
 
+int64_t Int64HashMapSize(const Int64HashMap *map) { return map->table.size; }
+
 Int64HashMapIterator Int64HashMapBegin(Int64HashMap *map) {
     return (Int64HashMapIterator){.map = map, .index = -1};
 }
 
 int64_t Int64HashMapIteratorKey(const Int64HashMapIterator *it) {
-    return it->map->entries[it->index].key;
+    return SwissTableSlot(&it->map->table, it->index)[0];
 }
 
 int64_t Int64HashMapIteratorValue(const Int64HashMapIterator *it) {
-    return it->map->entries[it->index].value;
+    return SwissTableSlot(&it->map->table, it->index)[1];
 }
 
 bool Int64HashMapIteratorIsValid(const Int64HashMapIterator *it) {
-    return it->index >= 0 && it->index < it->map->capacity;
+    return it->index >= 0 && it->index < SwissTableEnd(&it->map->table);
 }
 
 bool Int64HashMapIteratorNext(Int64HashMapIterator *it, int64_t *key,
                               int64_t *value) {
-    const Int64HashMap *map = it->map;
-    for (int64_t i = it->index + 1; i < map->capacity; ++i) {
-        if (map->entries[i].used) {
-            it->index = i;
-            if (key) *key = map->entries[i].key;
-            if (value) *value = map->entries[i].value;
-            return true;
-        }
-    }
-    it->index = map->capacity;
-    return false;
+    const SwissTable *table = &it->map->table;
+    it->index = SwissTableNext(table, it->index);
+    if (it->index >= SwissTableEnd(table)) return false;
+
+    const int64_t *slot = SwissTableSlot(table, it->index);
+    if (key) *key = slot[0];
+    if (value) *value = slot[1];
+    return true;
 }
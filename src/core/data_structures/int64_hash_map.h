@@ -3,9 +3,11 @@
  * @author Robert Shi (robertyishi@berkeley.edu)
  * @author GamesCrafters Research Group, UC Berkeley
  *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
- * @brief Linear-probing (open addressing) int64_t to int64_t hash map.
- * @version 1.0.4
- * @date 2025-04-26
+ * @brief Open addressing int64_t to int64_t hash map built on the SwissTable
+ * core, which probes groups of 16 slots at a time using SIMD control-byte
+ * matching and supports tombstone-free removal.
+ * @version 1.1.0
+ * @date 2026-10-18
  *
  * @copyright This file is part of GAMESMAN, The Finite, Two-person
  * Perfect-Information Game Generator released under the GPL:
@@ -30,19 +32,10 @@
 #include <stdbool.h>  // bool
 #include <stdint.h>   // int64_t
 
-/**
- * @brief Entry object of an \c Int64HashMap. This struct is not meant to be
- * used by the user of this library. Always use accessor and mutator functions
- * instead.
- */
-typedef struct Int64HashMapEntry {
-    int64_t key;   /**< Key to the entry. */
-    int64_t value; /**< Value of the entry. */
-    bool used;     /**< True iff this bucket contains an actual record. */
-} Int64HashMapEntry;
+#include "core/data_structures/swiss_table.h"
 
 /**
- * @brief Linear-probing int64_t to int64_t hash map.
+ * @brief Open addressing int64_t to int64_t hash map.
  *
  * @example
  * Int64HashMap mymap;
@@ -61,11 +54,8 @@ typedef struct Int64HashMapEntry {
  * Int64HashMapDestroy(&mymap);
  */
 typedef struct Int64HashMap {
-    Int64HashMapEntry *entries; /**< Dynamic array of buckets. */
-    int64_t capacity;           /**< Current capacity of the hash map. */
-    int64_t size;               /**< Number of entries in the hash map. */
-    double max_load_factor;     /**< Hash map will automatically expand if
-                                (double)size/capacity is greater than this value. */
+    /** Underlying table of one key word and one value word per slot. */
+    SwissTable table;
 } Int64HashMap;
 
 /**
@@ -82,7 +72,7 @@ typedef struct Int64HashMap {
 typedef struct Int64HashMapIterator {
     const Int64HashMap
         *map;      /**< The Int64HashMap this iterator is being used on. */
-    int64_t index; /**< Internal index into the Int64HashMap.entries array. */
+    int64_t index; /**< Internal slot index into the underlying table. */
 } Int64HashMapIterator;
 
 /**
@@ -134,6 +124,20 @@ bool Int64HashMapSet(Int64HashMap *map, int64_t key, int64_t value);
  */
 bool Int64HashMapContains(const Int64HashMap *map, int64_t key);
 
+/**
+ * @brief Removes the entry with \p key from \p map. Does nothing if \p key does
+ * not exist. Iterators to other entries remain valid.
+ *
+ * @param map Target hash map.
+ * @param key Key to the entry to remove.
+ * @return \c true if an entry was removed, or
+ * @return \c false if \p key does not exist in \p map.
+ */
+bool Int64HashMapRemove(Int64HashMap *map, int64_t key);
+
+/** @brief Returns the number of entries in \p map. */
+int64_t Int64HashMapSize(const Int64HashMap *map);
+
 /**
  * @brief Returns an invalid iterator to the entry before the first entry of
  * MAP.
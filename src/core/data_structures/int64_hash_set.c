@@ -3,9 +3,9 @@
  * @author Robert Shi (robertyishi@berkeley.edu)
  * @author GamesCrafters Research Group, UC Berkeley
  *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
- * @brief Linear-probing int64_t hash set implementation.
- * @version 1.1.1
- * @date 2025-04-26
+ * @brief Open addressing int64_t hash set implementation.
+ * @version 1.2.0
+ * @date 2026-10-18
  *
  * @copyright This file is part of GAMESMAN, The Finite, Two-person
  * Perfect-Information Game Generator released under the GPL:
@@ -26,102 +26,34 @@
 
 #include "core/data_structures/int64_hash_set.h"
 
-#include <assert.h>   // assert
-#include <math.h>     // INFINITY
-#include <stdbool.h>  // bool, true, false
+#include <stdbool.h>  // bool
 #include <stddef.h>   // NULL
-#include <stdint.h>   // int64_t, uint64_t
+#include <stdint.h>   // int64_t
 
-#include "core/gamesman_memory.h"
-#include "core/misc.h"  // NextPrime
-
-static int64_t Hash(int64_t key, int64_t capacity) {
-    return (int64_t)(((uint64_t)key) % capacity);
-}
-
-static int64_t NextIndex(int64_t index, int64_t capacity) {
-    return (index + 1) % capacity;
-}
+#include "core/data_structures/swiss_table.h"
 
 void Int64HashSetInit(Int64HashSet *set, double max_load_factor) {
-    set->entries = NULL;
-    set->capacity = 0;
-    set->size = 0;
     if (max_load_factor > 0.75) max_load_factor = 0.75;
     if (max_load_factor < 0.25) max_load_factor = 0.25;
-    set->max_load_factor = max_load_factor;
-}
-
-static bool Expand(Int64HashSet *set, int64_t new_capacity) {
-    Int64HashSetEntry *new_entries = (Int64HashSetEntry *)GamesmanCallocWhole(
-        new_capacity, sizeof(Int64HashSetEntry));
-    if (new_entries == NULL) return false;
-
-    for (int64_t i = 0; i < set->capacity; ++i) {
-        if (set->entries[i].used) {
-            int64_t new_index = Hash(set->entries[i].key, new_capacity);
-            while (new_entries[new_index].used) {
-                new_index = NextIndex(new_index, new_capacity);
-            }
-            new_entries[new_index] = set->entries[i];
-        }
-    }
-    GamesmanFree(set->entries);
-    set->entries = new_entries;
-    set->capacity = new_capacity;
-
-    return true;
+    SwissTableInit(&set->table, 1, 0, max_load_factor);
 }
 
 bool Int64HashSetReserve(Int64HashSet *set, int64_t size) {
-    int64_t target_capacity =
-        NextPrime((int64_t)((double)size / set->max_load_factor));
-    if (target_capacity <= set->capacity) return true;
-
-    return Expand(set, target_capacity);
+    return SwissTableReserve(&set->table, size);
 }
 
-void Int64HashSetDestroy(Int64HashSet *set) {
-    GamesmanFree(set->entries);
-    set->entries = NULL;
-    set->capacity = 0;
-    set->size = 0;
-}
+void Int64HashSetDestroy(Int64HashSet *set) { SwissTableDestroy(&set->table); }
 
 bool Int64HashSetAdd(Int64HashSet *set, int64_t key) {
-    // Check if resizing is needed.
-    double load_factor = (set->capacity == 0)
-                             ? INFINITY
-                             : (double)(set->size + 1) / (double)set->capacity;
-    if (set->capacity == 0 || load_factor > set->max_load_factor) {
-        int64_t new_capacity = NextPrime(set->capacity * 2);
-        if (!Expand(set, new_capacity)) return false;
-    }
-
-    // Set value at key.
-    int64_t capacity = set->capacity;
-    int64_t index = Hash(key, capacity);
-    while (set->entries[index].used) {
-        if (set->entries[index].key == key) return true;
-        index = NextIndex(index, capacity);
-    }
-    set->entries[index].key = key;
-    set->entries[index].used = true;
-    ++set->size;
-
-    return true;
+    return SwissTableInsert(&set->table, &key, NULL) >= 0;
 }
 
 bool Int64HashSetContains(const Int64HashSet *set, int64_t key) {
-    int64_t capacity = set->capacity;
-    // Edge case: return false if set is empty.
-    if (capacity == 0) return false;
-
-    int64_t index = Hash(key, capacity);
-    while (set->entries[index].used) {
-        if (set->entries[index].key == key) return true;
-        index = NextIndex(index, capacity);
-    }
+    return SwissTableFind(&set->table, &key) >= 0;
+}
 
-    return false;
+bool Int64HashSetRemove(Int64HashSet *set, int64_t key) {
+    return SwissTableRemove(&set->table, &key);
 }
+
+int64_t Int64HashSetSize(const Int64HashSet *set) { return set->table.size; }
@@ -3,9 +3,9 @@
  * @author Robert Shi (robertyishi@berkeley.edu)
  * @author GamesCrafters Research Group, UC Berkeley
  *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
- * @brief Linear-probing int64_t hash set.
- * @version 1.1.1
- * @date 2025-04-26
+ * @brief Open addressing int64_t hash set built on the SwissTable core.
+ * @version 1.2.0
+ * @date 2026-10-18
  *
  * @copyright This file is part of GAMESMAN, The Finite, Two-person
  * Perfect-Information Game Generator released under the GPL:
@@ -30,18 +30,10 @@
 #include <stdbool.h>  // bool
 #include <stdint.h>   // int64_t
 
-/**
- * @brief Entry object of an \c Int64HashSet. This struct is not meant to be
- * used by the user of this library. Always use accessor and mutator functions
- * instead.
- */
-typedef struct Int64HashSetEntry {
-    int64_t key; /**< Key to the entry. */
-    bool used;   /**< True iff this bucket contains an actual record. */
-} Int64HashSetEntry;
+#include "core/data_structures/swiss_table.h"
 
 /**
- * @brief Linear-probing int64_t hash set.
+ * @brief Open addressing int64_t hash set.
  *
  * @example
  * Int64HashSet myset;
@@ -58,11 +50,8 @@ typedef struct Int64HashSetEntry {
  * Int64HashSetDestroy(&myset);
  */
 typedef struct Int64HashSet {
-    Int64HashSetEntry *entries; /**< Dynamic array of buckets. */
-    int64_t capacity;           /**< Current capacity of the hash set. */
-    int64_t size;               /**< Number of entries in the hash set. */
-    double max_load_factor;     /**< Hash set will automatically expand if
-                                (double)size/capacity is greater than this value. */
+    /** Underlying table of one key word and no value words per slot. */
+    SwissTable table;
 } Int64HashSet;
 
 /**
@@ -117,4 +106,18 @@ bool Int64HashSetAdd(Int64HashSet *set, int64_t key);
  */
 bool Int64HashSetContains(const Int64HashSet *set, int64_t key);
 
+/**
+ * @brief Removes \p key from \p set. Does nothing if \p set does not contain
+ * \p key.
+ *
+ * @param set Set to remove \p key from.
+ * @param key Key to remove.
+ * @return true if \p key was removed, or
+ * @return false if \p set does not contain \p key.
+ */
+bool Int64HashSetRemove(Int64HashSet *set, int64_t key);
+
+/** @brief Returns the number of keys in \p set. */
+int64_t Int64HashSetSize(const Int64HashSet *set);
+
 #endif  // GAMESMANONE_CORE_DATA_STRUCTURES_INT64_HASH_SET_H_
@@ -105,3 +105,30 @@ int64_t Int64QueueFront(const Int64Queue *queue) {
 
     return queue->array[queue->front];
 }
+
+int64_t Int64QueueAt(const Int64Queue *queue, int64_t index) {
+    if (index < 0 || index >= queue->size) {
+        fprintf(stderr, "Int64QueueAt: index out of bounds.\n");
+        return 0;
+    }
+
+    return queue->array[(queue->front + index) % queue->capacity];
+}
+
+int64_t Int64QueueRemoveAt(Int64Queue *queue, int64_t index) {
+    if (index < 0 || index >= queue->size) {
+        fprintf(stderr, "Int64QueueRemoveAt: index out of bounds.\n");
+        return 0;
+    }
+
+    // Shift the items in front of INDEX back by one slot.
+    int64_t element = Int64QueueAt(queue, index);
+    for (int64_t i = index; i > 0; --i) {
+        queue->array[(queue->front + i) % queue->capacity] =
+            queue->array[(queue->front + i - 1) % queue->capacity];
+    }
+    queue->front = (queue->front + 1) % queue->capacity;
+    --queue->size;
+
+    return element;
+}
@@ -80,4 +80,16 @@ int64_t Int64QueuePop(Int64Queue *queue);
 /** @brief Returns the item at the front of the QUEUE without popping it. */
 int64_t Int64QueueFront(const Int64Queue *queue);
 
+/**
+ * @brief Returns the item at position INDEX of the QUEUE without popping it,
+ * where the front of the QUEUE is at position 0.
+ */
+int64_t Int64QueueAt(const Int64Queue *queue, int64_t index);
+
+/**
+ * @brief Removes the item at position INDEX of the QUEUE and returns it. The
+ * other items keep their order.
+ */
+int64_t Int64QueueRemoveAt(Int64Queue *queue, int64_t index);
+
 #endif  // GAMESMANONE_CORE_DATA_STRUCTURES_INT64_QUEUE_H_
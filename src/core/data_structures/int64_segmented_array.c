@@ -0,0 +1,151 @@
+/**
+ * @file int64_segmented_array.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the growable int64_t array stored in fixed-size
+ * chunks.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/data_structures/int64_segmented_array.h"
+
+#include <stdbool.h>  // bool, true, false
+#include <stddef.h>   // NULL
+#include <stdint.h>   // int64_t
+#include <string.h>   // memcpy
+
+#include "core/gamesman_memory.h"
+
+enum {
+    kHeadCapacityMin = 16,
+    kChunksCapacityMin = 4,
+};
+
+void Int64SegmentedArrayInit(Int64SegmentedArray *array) {
+    Int64SegmentedArrayInitAllocator(array, NULL);
+}
+
+void Int64SegmentedArrayInitAllocator(Int64SegmentedArray *array,
+                                      GamesmanAllocator *allocator) {
+    array->chunks = NULL;
+    array->num_chunks = 0;
+    array->chunks_capacity = 0;
+    array->head_capacity = 0;
+    array->size = 0;
+    array->allocator = GamesmanAllocatorAddRef(allocator);
+}
+
+void Int64SegmentedArrayDestroy(Int64SegmentedArray *array) {
+    Int64SegmentedArrayClear(array);
+    GamesmanAllocatorRelease(array->allocator);
+    array->allocator = NULL;
+}
+
+void Int64SegmentedArrayClear(Int64SegmentedArray *array) {
+    for (int64_t c = 0; c < array->num_chunks; ++c) {
+        GamesmanAllocatorDeallocate(array->allocator, array->chunks[c]);
+    }
+    GamesmanAllocatorDeallocate(array->allocator, array->chunks);
+    array->chunks = NULL;
+    array->num_chunks = 0;
+    array->chunks_capacity = 0;
+    array->head_capacity = 0;
+    array->size = 0;
+}
+
+static bool ExpandChunkTable(Int64SegmentedArray *array) {
+    int64_t new_capacity = array->chunks_capacity == 0
+                               ? kChunksCapacityMin
+                               : array->chunks_capacity * 2;
+    int64_t **new_chunks = (int64_t **)GamesmanAllocatorAllocate(
+        array->allocator, new_capacity * sizeof(int64_t *));
+    if (new_chunks == NULL) return false;
+
+    if (array->num_chunks > 0) {
+        memcpy(new_chunks, array->chunks,
+               array->num_chunks * sizeof(int64_t *));
+    }
+    GamesmanAllocatorDeallocate(array->allocator, array->chunks);
+    array->chunks = new_chunks;
+    array->chunks_capacity = new_capacity;
+
+    return true;
+}
+
+// The first chunk is the only one that is ever copied, and it never exceeds
+// kInt64SegmentedArrayChunkSize items.
+static bool ExpandHead(Int64SegmentedArray *array) {
+    if (array->chunks_capacity == 0 && !ExpandChunkTable(array)) return false;
+
+    int64_t new_capacity = array->head_capacity == 0
+                               ? kHeadCapacityMin
+                               : array->head_capacity * 2;
+    if (new_capacity > kInt64SegmentedArrayChunkSize) {
+        new_capacity = kInt64SegmentedArrayChunkSize;
+    }
+    int64_t *new_head = (int64_t *)GamesmanAllocatorAllocate(
+        array->allocator, new_capacity * sizeof(int64_t));
+    if (new_head == NULL) return false;
+
+    if (array->num_chunks == 0) {
+        array->num_chunks = 1;
+    } else {
+        memcpy(new_head, array->chunks[0], array->size * sizeof(int64_t));
+        GamesmanAllocatorDeallocate(array->allocator, array->chunks[0]);
+    }
+    array->chunks[0] = new_head;
+    array->head_capacity = new_capacity;
+
+    return true;
+}
+
+static bool AppendChunk(Int64SegmentedArray *array) {
+    if (array->num_chunks == array->chunks_capacity &&
+        !ExpandChunkTable(array)) {
+        return false;
+    }
+
+    int64_t *chunk = (int64_t *)GamesmanAllocatorAllocate(
+        array->allocator, kInt64SegmentedArrayChunkSize * sizeof(int64_t));
+    if (chunk == NULL) return false;
+
+    array->chunks[array->num_chunks++] = chunk;
+
+    return true;
+}
+
+bool Int64SegmentedArrayPushBack(Int64SegmentedArray *array, int64_t item) {
+    int64_t c = array->size >> kInt64SegmentedArrayChunkShift;
+    int64_t offset = array->size & kInt64SegmentedArrayChunkMask;
+    if (c == 0) {
+        if (offset == array->head_capacity && !ExpandHead(array)) return false;
+    } else if (c == array->num_chunks) {
+        if (!AppendChunk(array)) return false;
+    }
+    array->chunks[c][offset] = item;
+    ++array->size;
+
+    return true;
+}
+
+void Int64SegmentedArrayReleaseChunk(Int64SegmentedArray *array, int64_t c) {
+    GamesmanAllocatorDeallocate(array->allocator, array->chunks[c]);
+    array->chunks[c] = NULL;
+}
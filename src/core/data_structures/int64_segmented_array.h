@@ -0,0 +1,208 @@
+/**
+ * @file int64_segmented_array.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Growable int64_t array stored in fixed-size chunks.
+ * @details Unlike Int64Array, which doubles its capacity by allocating a new
+ * block and copying the old contents over, a segmented array never moves its
+ * items. Once the first chunk has grown to \c kInt64SegmentedArrayChunkSize
+ * items, each further chunk is allocated at full size when the previous one
+ * fills up. Appending is therefore O(1) in the worst case apart from the
+ * occasional growth of the chunk table, which holds one pointer per chunk.
+ * This avoids the transient 1.5 to 2 times peak memory usage of a copying
+ * expansion, which matters for the very large position arrays created by the
+ * solvers and analyzers.
+ *
+ * Items are accessed by index in O(1) using a shift and a mask, or chunk by
+ * chunk using Int64SegmentedArrayChunk() and
+ * Int64SegmentedArrayChunkLength(). Consumed chunks may be released before the
+ * whole array is cleared.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_DATA_STRUCTURES_INT64_SEGMENTED_ARRAY_H_
+#define GAMESMANONE_CORE_DATA_STRUCTURES_INT64_SEGMENTED_ARRAY_H_
+
+#include <stdbool.h>  // bool
+#include <stdint.h>   // int64_t
+
+#include "core/gamesman_memory.h"
+
+enum {
+    /** Base-2 logarithm of the number of items in a full chunk. */
+    kInt64SegmentedArrayChunkShift = 13,
+
+    /** Number of items in a full chunk (64 KiB of data). */
+    kInt64SegmentedArrayChunkSize = 1 << kInt64SegmentedArrayChunkShift,
+
+    /** Mask for the index of an item within its chunk. */
+    kInt64SegmentedArrayChunkMask = kInt64SegmentedArrayChunkSize - 1,
+};
+
+/**
+ * @brief Growable int64_t array stored in fixed-size chunks.
+ *
+ * @example
+ * Int64SegmentedArray array;
+ * Int64SegmentedArrayInit(&array);
+ * for (int64_t i = 0; i < 100000; ++i) {
+ *     Int64SegmentedArrayPushBack(&array, i);
+ * }
+ * int64_t sum = 0;
+ * for (int64_t c = 0; c < Int64SegmentedArrayNumChunks(&array); ++c) {
+ *     const int64_t *chunk = Int64SegmentedArrayChunk(&array, c);
+ *     int64_t length = Int64SegmentedArrayChunkLength(&array, c);
+ *     for (int64_t i = 0; i < length; ++i) sum += chunk[i];
+ * }
+ * Int64SegmentedArrayDestroy(&array);
+ */
+typedef struct Int64SegmentedArray {
+    /** Chunk table. Only the first num_chunks entries are valid. */
+    int64_t **chunks;
+
+    /** Number of allocated chunks. */
+    int64_t num_chunks;
+
+    /** Number of entries in the chunk table. */
+    int64_t chunks_capacity;
+
+    /**
+     * Capacity of the first chunk, which grows geometrically up to
+     * kInt64SegmentedArrayChunkSize so that small arrays stay small.
+     */
+    int64_t head_capacity;
+
+    /** Number of items in the array. */
+    int64_t size;
+
+    /** Allocator used for the chunks and the chunk table. */
+    GamesmanAllocator *allocator;
+} Int64SegmentedArray;
+
+/**
+ * @brief Initializes \p array to an empty array using the default memory
+ * allocator.
+ *
+ * @param array Array to initialize.
+ */
+void Int64SegmentedArrayInit(Int64SegmentedArray *array);
+
+/**
+ * @brief Initializes \p array to an empty array using \p allocator as the
+ * underlying memory allocator. If \p allocator is \c NULL, the call is
+ * equivalent to Int64SegmentedArrayInit(array). A new reference to
+ * \p allocator is held by the array until it is destroyed.
+ *
+ * @param array Array to initialize.
+ * @param allocator Memory allocator to use.
+ */
+void Int64SegmentedArrayInitAllocator(Int64SegmentedArray *array,
+                                      GamesmanAllocator *allocator);
+
+/**
+ * @brief Deallocates \p array, releasing its reference to the allocator.
+ *
+ * @param array Array to deallocate.
+ */
+void Int64SegmentedArrayDestroy(Int64SegmentedArray *array);
+
+/**
+ * @brief Removes all items from \p array and releases all of its chunks while
+ * keeping the allocator, leaving \p array empty and ready to be reused.
+ *
+ * @param array Array to clear.
+ */
+void Int64SegmentedArrayClear(Int64SegmentedArray *array);
+
+/**
+ * @brief Appends \p item to the back of \p array. Existing items are never
+ * moved.
+ *
+ * @param array Destination array.
+ * @param item New item.
+ * @return \c true on success, or
+ * @return \c false on allocation failure, in which case \p array is
+ * unchanged.
+ */
+bool Int64SegmentedArrayPushBack(Int64SegmentedArray *array, int64_t item);
+
+/**
+ * @brief Releases chunk \p c of \p array back to its allocator. The items in
+ * the released chunk must not be accessed afterwards, but the size of the
+ * array and the indices of the items in the other chunks are unchanged. No
+ * more items may be appended to \p array until it is cleared. Releasing
+ * different chunks of the same array from different threads is safe as long as
+ * the allocator is.
+ *
+ * @param array Array to release the chunk from.
+ * @param c Index of the chunk, which is assumed to be in range.
+ */
+void Int64SegmentedArrayReleaseChunk(Int64SegmentedArray *array, int64_t c);
+
+/** @brief Returns the number of items in \p array. */
+static inline int64_t Int64SegmentedArraySize(
+    const Int64SegmentedArray *array) {
+    //
+    return array->size;
+}
+
+/**
+ * @brief Returns the item at index \p i of \p array, which is assumed to be
+ * in range.
+ */
+static inline int64_t Int64SegmentedArrayGet(const Int64SegmentedArray *array,
+                                             int64_t i) {
+    return array->chunks[i >> kInt64SegmentedArrayChunkShift]
+                        [i & kInt64SegmentedArrayChunkMask];
+}
+
+/** @brief Returns the number of chunks in \p array. */
+static inline int64_t Int64SegmentedArrayNumChunks(
+    const Int64SegmentedArray *array) {
+    //
+    return array->num_chunks;
+}
+
+/**
+ * @brief Returns a pointer to the items in chunk \p c of \p array, which is
+ * assumed to be in range.
+ */
+static inline int64_t *Int64SegmentedArrayChunk(
+    const Int64SegmentedArray *array, int64_t c) {
+    //
+    return array->chunks[c];
+}
+
+/**
+ * @brief Returns the number of items stored in chunk \p c of \p array, which is
+ * assumed to be in range. All chunks except the last one are full.
+ */
+static inline int64_t Int64SegmentedArrayChunkLength(
+    const Int64SegmentedArray *array, int64_t c) {
+    //
+    int64_t begin = c << kInt64SegmentedArrayChunkShift;
+    int64_t remaining = array->size - begin;
+
+    return remaining < kInt64SegmentedArrayChunkSize
+               ? remaining
+               : kInt64SegmentedArrayChunkSize;
+}
+
+#endif  // GAMESMANONE_CORE_DATA_STRUCTURES_INT64_SEGMENTED_ARRAY_H_
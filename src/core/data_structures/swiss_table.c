@@ -0,0 +1,307 @@
+/**
+ * @file swiss_table.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the open-addressing hash table core with SIMD
+ * control-byte group probing.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/data_structures/swiss_table.h"
+
+#include <assert.h>   // assert
+#include <stdbool.h>  // bool, true, false
+#include <stddef.h>   // NULL, size_t
+#include <stdint.h>   // int64_t, uint8_t, uint32_t, uint64_t
+#include <string.h>   // memset
+
+#ifdef __SSE2__
+#include <immintrin.h>  // __m128i, _mm_*
+#endif                  // __SSE2__
+
+#include "core/gamesman_memory.h"
+
+enum {
+    kMinCapacity = kSwissTableGroupSize,
+    kTagMask = 0x7F,
+    kOverflowSaturated = 0xFF,
+};
+
+// ============================== Group Matching ==============================
+
+#ifdef __SSE2__
+static uint32_t MatchTag(const uint8_t *group, uint8_t tag) {
+    __m128i ctrl = _mm_load_si128((const __m128i *)group);
+    __m128i match = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)tag));
+
+    return (uint32_t)_mm_movemask_epi8(match);
+}
+
+static uint32_t MatchEmpty(const uint8_t *group) {
+    // Only empty slots have the highest bit set.
+    return (uint32_t)_mm_movemask_epi8(
+        _mm_load_si128((const __m128i *)group));
+}
+#else   // __SSE2__ not defined
+static uint32_t MatchTag(const uint8_t *group, uint8_t tag) {
+    uint32_t ret = 0;
+    for (int i = 0; i < kSwissTableGroupSize; ++i) {
+        ret |= (uint32_t)(group[i] == tag) << i;
+    }
+
+    return ret;
+}
+
+static uint32_t MatchEmpty(const uint8_t *group) {
+    uint32_t ret = 0;
+    for (int i = 0; i < kSwissTableGroupSize; ++i) {
+        ret |= (uint32_t)(group[i] >> 7) << i;
+    }
+
+    return ret;
+}
+#endif  // __SSE2__
+
+static int LowestBit(uint32_t mask) { return __builtin_ctz(mask); }
+
+// ================================== Helpers ==================================
+
+static uint64_t Hash(const SwissTable *table, const int64_t *key) {
+    uint64_t h = (uint64_t)key[0];
+    if (table->key_words == 2) h += (uint64_t)key[1] * 0x9E3779B97F4A7C15ULL;
+
+    return SwissTableMix64(h);
+}
+
+static bool KeyEquals(const SwissTable *table, const int64_t *slot,
+                      const int64_t *key) {
+    if (slot[0] != key[0]) return false;
+    return table->key_words == 1 || slot[1] == key[1];
+}
+
+static int64_t NumGroups(int64_t capacity) {
+    return capacity / kSwissTableGroupSize;
+}
+
+static size_t SlotBytes(int64_t capacity, int slot_words) {
+    return (size_t)capacity * (size_t)slot_words * sizeof(int64_t);
+}
+
+static size_t AllocSize(int64_t capacity, int slot_words) {
+    return SlotBytes(capacity, slot_words) + (size_t)capacity +
+           (size_t)NumGroups(capacity);
+}
+
+/**
+ * @brief Points \p table to a newly allocated empty array of \p capacity slots.
+ * The old arrays are not freed. Returns false on malloc failure, in which case
+ * \p table is unchanged.
+ */
+static bool Allocate(SwissTable *table, int64_t capacity) {
+    // Slots come first so that the control bytes are 16-byte aligned.
+    int64_t *slots = (int64_t *)GamesmanAlignedAlloc(
+        kSwissTableGroupSize, AllocSize(capacity, table->slot_words));
+    if (slots == NULL) return false;
+
+    table->slots = slots;
+    table->ctrl = (uint8_t *)slots + SlotBytes(capacity, table->slot_words);
+    table->overflow = table->ctrl + capacity;
+    table->capacity = capacity;
+    memset(table->ctrl, kSwissTableEmpty, (size_t)capacity);
+    memset(table->overflow, 0, (size_t)NumGroups(capacity));
+
+    return true;
+}
+
+static int64_t FirstGroup(const SwissTable *table, uint64_t hash) {
+    return (int64_t)(hash >> 7) & (NumGroups(table->capacity) - 1);
+}
+
+/**
+ * @brief Claims the first empty slot on the probe sequence of \p hash,
+ * assuming the key does not exist in \p table and there is space for it.
+ * Returns the index of the new slot.
+ */
+static int64_t PlaceNew(SwissTable *table, uint64_t hash) {
+    int64_t group_mask = NumGroups(table->capacity) - 1;
+    int64_t group = FirstGroup(table, hash);
+    for (int64_t step = 1;; ++step) {
+        uint8_t *ctrl = table->ctrl + group * kSwissTableGroupSize;
+        uint32_t empty = MatchEmpty(ctrl);
+        if (empty) {
+            int64_t index = group * kSwissTableGroupSize + LowestBit(empty);
+            table->ctrl[index] = (uint8_t)(hash & kTagMask);
+            ++table->size;
+            return index;
+        }
+        if (table->overflow[group] != kOverflowSaturated) {
+            ++table->overflow[group];
+        }
+        group = (group + step) & group_mask;  // Triangular probing.
+    }
+}
+
+static bool Rehash(SwissTable *table, int64_t new_capacity) {
+    SwissTable old = *table;
+    if (!Allocate(table, new_capacity)) return false;
+
+    table->size = 0;
+    int words = table->slot_words;
+    for (int64_t i = SwissTableNext(&old, -1); i < SwissTableEnd(&old);
+         i = SwissTableNext(&old, i)) {
+        const int64_t *src = SwissTableSlot(&old, i);
+        int64_t index = PlaceNew(table, Hash(table, src));
+        int64_t *dest = SwissTableSlot(table, index);
+        for (int w = 0; w < words; ++w) dest[w] = src[w];
+    }
+    GamesmanFree(old.slots);
+
+    return true;
+}
+
+static bool Fits(const SwissTable *table, int64_t capacity, int64_t size) {
+    return (double)size <= (double)capacity * table->max_load_factor;
+}
+
+// ================================ Public API ================================
+
+void SwissTableInit(SwissTable *table, int key_words, int value_words,
+                    double max_load_factor) {
+    assert(key_words >= 1 && key_words <= kSwissTableKeyWordsMax);
+    assert(value_words >= 0);
+    table->ctrl = NULL;
+    table->overflow = NULL;
+    table->slots = NULL;
+    table->capacity = 0;
+    table->size = 0;
+    table->key_words = key_words;
+    table->slot_words = key_words + value_words;
+    if (max_load_factor > 0.875) max_load_factor = 0.875;
+    if (max_load_factor < 0.25) max_load_factor = 0.25;
+    table->max_load_factor = max_load_factor;
+}
+
+void SwissTableDestroy(SwissTable *table) {
+    GamesmanFree(table->slots);
+    table->ctrl = NULL;
+    table->overflow = NULL;
+    table->slots = NULL;
+    table->capacity = 0;
+    table->size = 0;
+}
+
+void SwissTableClear(SwissTable *table) {
+    if (table->capacity == 0) return;
+    memset(table->ctrl, kSwissTableEmpty, (size_t)table->capacity);
+    memset(table->overflow, 0, (size_t)NumGroups(table->capacity));
+    table->size = 0;
+}
+
+bool SwissTableReserve(SwissTable *table, int64_t size) {
+    int64_t capacity = kMinCapacity;
+    while (!Fits(table, capacity, size)) capacity *= 2;
+    if (capacity <= table->capacity) return true;
+
+    return Rehash(table, capacity);
+}
+
+int64_t SwissTableFind(const SwissTable *table, const int64_t *key) {
+    if (table->size == 0) return -1;
+
+    uint64_t hash = Hash(table, key);
+    uint8_t tag = (uint8_t)(hash & kTagMask);
+    int64_t num_groups = NumGroups(table->capacity);
+    int64_t group = FirstGroup(table, hash);
+    for (int64_t step = 1; step <= num_groups; ++step) {
+        const uint8_t *ctrl = table->ctrl + group * kSwissTableGroupSize;
+        uint32_t match = MatchTag(ctrl, tag);
+        while (match) {
+            int64_t index = group * kSwissTableGroupSize + LowestBit(match);
+            if (KeyEquals(table, SwissTableSlot(table, index), key)) {
+                return index;
+            }
+            match &= match - 1;
+        }
+
+        // No key that hashed to an earlier group was ever pushed past this one.
+        if (table->overflow[group] == 0) return -1;
+        group = (group + step) & (num_groups - 1);
+    }
+
+    return -1;
+}
+
+int64_t SwissTableInsert(SwissTable *table, const int64_t *key,
+                         bool *inserted) {
+    int64_t index = SwissTableFind(table, key);
+    if (index >= 0) {
+        if (inserted) *inserted = false;
+        return index;
+    }
+
+    // Expand if the new key would exceed the maximum load factor.
+    if (!Fits(table, table->capacity, table->size + 1)) {
+        int64_t new_capacity =
+            table->capacity ? table->capacity * 2 : kMinCapacity;
+        if (!Rehash(table, new_capacity)) return -1;
+    }
+
+    index = PlaceNew(table, Hash(table, key));
+    int64_t *slot = SwissTableSlot(table, index);
+    int w = 0;
+    for (; w < table->key_words; ++w) slot[w] = key[w];
+    for (; w < table->slot_words; ++w) slot[w] = 0;
+    if (inserted) *inserted = true;
+
+    return index;
+}
+
+bool SwissTableRemove(SwissTable *table, const int64_t *key) {
+    int64_t index = SwissTableFind(table, key);
+    if (index < 0) return false;
+
+    // Undo the overflow increments made by PlaceNew on the way to this slot.
+    int64_t group_mask = NumGroups(table->capacity) - 1;
+    int64_t target_group = index / kSwissTableGroupSize;
+    int64_t group = FirstGroup(table, Hash(table, key));
+    for (int64_t step = 1; group != target_group; ++step) {
+        if (table->overflow[group] != kOverflowSaturated) {
+            --table->overflow[group];
+        }
+        group = (group + step) & group_mask;
+    }
+    table->ctrl[index] = kSwissTableEmpty;
+    --table->size;
+
+    return true;
+}
+
+int64_t SwissTableNext(const SwissTable *table, int64_t index) {
+    int64_t group = (index + 1) / kSwissTableGroupSize;
+    int i = (int)((index + 1) % kSwissTableGroupSize);
+    for (; group < NumGroups(table->capacity); ++group, i = 0) {
+        const uint8_t *ctrl = table->ctrl + group * kSwissTableGroupSize;
+        uint32_t full = ~MatchEmpty(ctrl) & 0xFFFF;
+        full &= ~((1u << i) - 1);  // Skip slots up to and including index.
+        if (full) return group * kSwissTableGroupSize + LowestBit(full);
+    }
+
+    return table->capacity;
+}
@@ -0,0 +1,173 @@
+/**
+ * @file swiss_table.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Open-addressing hash table core with SIMD control-byte group probing,
+ * shared by the hash map and hash set containers.
+ * @details The table stores fixed-size slots of one or two int64_t key words
+ * followed by zero or more int64_t value words. It follows the design of
+ * Abseil's SwissTable: each slot has a one-byte control word which is either
+ * \c kSwissTableEmpty or the lower 7 bits of the key's hash. Slots are grouped
+ * into groups of \c kSwissTableGroupSize, and a lookup compares the control
+ * bytes of a whole group against the hash tag in a single SSE2 instruction,
+ * so it usually touches only the one slot that holds the key. The control
+ * bytes are kept in a separate dense array, which is small enough to stay in
+ * cache for most tables. Groups are probed quadratically over a power-of-two
+ * number of groups.
+ *
+ * Deletion is tombstone-free. Each group keeps a saturating counter of the
+ * number of keys that were inserted past it while it was full (the approach of
+ * Folly's F14). A lookup stops at the first group that does not contain the
+ * key and whose counter is zero. Removing a key simply clears its control byte
+ * and decrements the counters along its probe path, so the table never
+ * degrades with churn.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_DATA_STRUCTURES_SWISS_TABLE_H_
+#define GAMESMANONE_CORE_DATA_STRUCTURES_SWISS_TABLE_H_
+
+#include <stdbool.h>  // bool
+#include <stdint.h>   // int64_t, uint8_t, uint64_t
+
+enum {
+    /** Number of slots in each probing group. */
+    kSwissTableGroupSize = 16,
+
+    /** Control byte of an empty slot. Full slots have the highest bit unset. */
+    kSwissTableEmpty = 0x80,
+
+    /** Maximum number of int64_t words in a key. */
+    kSwissTableKeyWordsMax = 2,
+};
+
+/**
+ * @brief Open-addressing hash table core. Users should use the containers
+ * built on top of it (Int64HashMap, Int64HashSet, TierHashMap,
+ * TierPositionHashSet) instead of accessing this struct directly.
+ */
+typedef struct SwissTable {
+    uint8_t *ctrl;          /**< Control bytes, one per slot. */
+    uint8_t *overflow;      /**< Saturating overflow counters, one per group. */
+    int64_t *slots;         /**< Slot words, slot_words per slot. */
+    int64_t capacity;       /**< Number of slots, 0 or a power of 2. */
+    int64_t size;           /**< Number of keys in the table. */
+    int key_words;          /**< Number of int64_t words in each key. */
+    int slot_words;         /**< Number of int64_t words in each slot. */
+    double max_load_factor; /**< Maximum ratio of size to capacity. */
+} SwissTable;
+
+/**
+ * @brief Initializes \p table to an empty table of slots with \p key_words
+ * key words and \p value_words value words.
+ *
+ * @param table Table to initialize.
+ * @param key_words Number of int64_t words in each key, must be 1 or 2.
+ * @param value_words Number of int64_t words in each value, may be 0.
+ * @param max_load_factor Maximum load factor of the table, clamped to
+ * [0.25, 0.875].
+ */
+void SwissTableInit(SwissTable *table, int key_words, int value_words,
+                    double max_load_factor);
+
+/** @brief Deallocates \p table. */
+void SwissTableDestroy(SwissTable *table);
+
+/**
+ * @brief Removes all keys from \p table without releasing its memory.
+ */
+void SwissTableClear(SwissTable *table);
+
+/**
+ * @brief Attempts to reserve space for \p size keys in \p table. On success,
+ * \p table is guaranteed not to expand before it holds \p size keys. On
+ * failure, \p table is unchanged.
+ *
+ * @return \c true on success, or
+ * @return \c false on failure to allocate memory.
+ */
+bool SwissTableReserve(SwissTable *table, int64_t size);
+
+/**
+ * @brief Returns the index of the slot containing \p key in \p table, or -1 if
+ * \p key is not found.
+ */
+int64_t SwissTableFind(const SwissTable *table, const int64_t *key);
+
+/**
+ * @brief Returns the index of the slot containing \p key in \p table, adding
+ * \p key to \p table if it does not exist. The value words of a newly added
+ * slot are zero-initialized.
+ *
+ * @param table Destination table.
+ * @param key Key to find or insert.
+ * @param inserted (Output parameter) If not \c NULL, set to \c true if \p key
+ * was newly added, or \c false if it already existed.
+ * @return Index of the slot containing \p key, or
+ * @return -1 on failure to expand the table, in which case \p table is
+ * unchanged.
+ */
+int64_t SwissTableInsert(SwissTable *table, const int64_t *key,
+                         bool *inserted);
+
+/**
+ * @brief Removes \p key from \p table.
+ *
+ * @return \c true if \p key was found and removed, or
+ * @return \c false if \p key does not exist in \p table.
+ */
+bool SwissTableRemove(SwissTable *table, const int64_t *key);
+
+/**
+ * @brief Returns the index of the first full slot after slot \p index, or
+ * SwissTableEnd( \p table ) if there is none. Pass -1 to find the first full
+ * slot.
+ */
+int64_t SwissTableNext(const SwissTable *table, int64_t index);
+
+/**
+ * @brief Returns the past-the-end slot index of \p table, which is also its
+ * capacity.
+ */
+static inline int64_t SwissTableEnd(const SwissTable *table) {
+    return table->capacity;
+}
+
+/** @brief Returns a pointer to the words of slot \p index in \p table. */
+static inline int64_t *SwissTableSlot(const SwissTable *table, int64_t index) {
+    return table->slots + index * table->slot_words;
+}
+
+/**
+ * @brief Returns a strong 64-bit mix of \p x. This is the finalizer of
+ * MurmurHash3, which has full avalanche and makes sequential keys safe to use
+ * with power-of-two capacities.
+ */
+static inline uint64_t SwissTableMix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+
+    return x;
+}
+
+#endif  // GAMESMANONE_CORE_DATA_STRUCTURES_SWISS_TABLE_H_
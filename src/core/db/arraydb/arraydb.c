@@ -31,20 +31,31 @@
 
 #include "core/db/arraydb/arraydb.h"
 
-#include <assert.h>   // assert
-#include <stdbool.h>  // bool, true, false
-#include <stddef.h>   // NULL, size_t
-#include <stdint.h>   // intptr_t, uint64_t, int64_t
-#include <stdio.h>    // fprintf, stderr
-#include <string.h>   // strcpy
+#include <assert.h>    // assert
+#include <dirent.h>    // DIR, opendir, readdir, closedir
+#include <fcntl.h>     // O_RDONLY
+#include <stdbool.h>   // bool, true, false
+#include <stddef.h>    // NULL, size_t
+#include <stdint.h>    // intptr_t, uint64_t, int64_t
+#include <stdio.h>     // fprintf, stderr
+#include <stdlib.h>    // qsort
+#include <string.h>    // strcpy
+#include <sys/stat.h>  // stat
+#include <time.h>      // time
+#include <unistd.h>    // fdatasync
 
 #ifdef _OPENMP
 #include <omp.h>
 #endif  // _OPENMP
 
+#include "core/concurrency.h"
 #include "core/constants.h"
 #include "core/db/arraydb/record.h"
 #include "core/db/arraydb/record_array.h"
+#include "core/db/arraydb/tier_flusher.h"
+#include "core/db/arraydb/tier_manifest.h"
+#include "core/db/arraydb/tier_residency.h"
+#include "core/db/arraydb/tier_segments.h"
 #include "core/gamesman_memory.h"
 #include "core/misc.h"
 #include "core/types/gamesman_types.h"
@@ -61,6 +72,8 @@ static void ArrayDbFinalize(void);
 static int ArrayDbCreateSolvingTier(Tier tier, int64_t size);
 static int ArrayDbFlushSolvingTier(void *aux);
 static int ArrayDbFreeSolvingTier(void);
+static int ArrayDbSetAsyncFlush(intptr_t budget);
+static bool ArrayDbPopFlushedTier(bool wait, Tier *tier, int *error);
 
 static int ArrayDbSetGameSolved(void);
 static int ArrayDbSetValue(Position position, Value value);
@@ -77,6 +90,9 @@ static intptr_t ArrayDbTierMemUsage(Tier tier, int64_t size);
 static int ArrayDbLoadTier(Tier tier, int64_t size);
 static int ArrayDbUnloadTier(Tier tier);
 static bool ArrayDbIsTierLoaded(Tier tier);
+static int ArrayDbSetTierCache(intptr_t budget);
+static bool ArrayDbIsTierCached(Tier tier);
+static void ArrayDbEvictTier(Tier tier);
 static Value ArrayDbGetValueFromLoaded(Tier tier, Position position);
 static int ArrayDbGetRemotenessFromLoaded(Tier tier, Position position);
 
@@ -84,7 +100,16 @@ static int ArrayDbProbeInit(DbProbe *probe);
 static int ArrayDbProbeDestroy(DbProbe *probe);
 static Value ArrayDbProbeValue(DbProbe *probe, TierPosition tier_position);
 static int ArrayDbProbeRemoteness(DbProbe *probe, TierPosition tier_position);
+static Value ArrayDbProbeValueRemoteness(DbProbe *probe,
+                                         TierPosition tier_position,
+                                         int *remoteness);
+static int ArrayDbProbeBatch(DbProbe *probe, int64_t n,
+                             const TierPosition *tier_positions, Value *values,
+                             int *remotenesses);
 static int ArrayDbTierStatus(Tier tier);
+static int ArrayDbRebuildTierManifest(int64_t n, const Tier *tiers,
+                                      const int64_t *sizes);
+static int ArrayDbPackTiers(int64_t n, const Tier *tiers);
 static int ArrayDbGameStatus(void);
 
 const Database kArrayDb = {
@@ -98,6 +123,8 @@ const Database kArrayDb = {
     .CreateSolvingTier = ArrayDbCreateSolvingTier,
     .FlushSolvingTier = ArrayDbFlushSolvingTier,
     .FreeSolvingTier = ArrayDbFreeSolvingTier,
+    .SetAsyncFlush = ArrayDbSetAsyncFlush,
+    .PopFlushedTier = ArrayDbPopFlushedTier,
 
     .SetGameSolved = ArrayDbSetGameSolved,
     .SetValue = ArrayDbSetValue,
@@ -113,6 +140,9 @@ const Database kArrayDb = {
     .LoadTier = ArrayDbLoadTier,
     .UnloadTier = ArrayDbUnloadTier,
     .IsTierLoaded = ArrayDbIsTierLoaded,
+    .SetTierCache = ArrayDbSetTierCache,
+    .IsTierCached = ArrayDbIsTierCached,
+    .EvictTier = ArrayDbEvictTier,
     .GetValueFromLoaded = ArrayDbGetValueFromLoaded,
     .GetRemotenessFromLoaded = ArrayDbGetRemotenessFromLoaded,
     .CheckpointRemove = ArrayDbCheckpointRemove,
@@ -122,20 +152,46 @@ const Database kArrayDb = {
     .ProbeDestroy = ArrayDbProbeDestroy,
     .ProbeValue = ArrayDbProbeValue,
     .ProbeRemoteness = ArrayDbProbeRemoteness,
+    .ProbeValueRemoteness = ArrayDbProbeValueRemoteness,
+    .ProbeBatch = ArrayDbProbeBatch,
     .TierStatus = ArrayDbTierStatus,
+    .RebuildTierManifest = ArrayDbRebuildTierManifest,
+    .PackTiers = ArrayDbPackTiers,
     .GameStatus = ArrayDbGameStatus,
 };
 
 // Types
 
+// Maximum number of tier files a probe keeps open. Children of a position
+// usually span a handful of tiers, so keeping a few files open avoids reopening
+// a file and decoding its index and current block each time a session
+// alternates between tiers.
+enum { kArrayDbProbeFilesMax = 4 };
+
 typedef struct {
-    XzraFile *file;
-    bool init;
+    XzraFile *files[kArrayDbProbeFilesMax];
+    Tier tiers[kArrayDbProbeFilesMax];
+    int64_t last_used[kArrayDbProbeFilesMax];
+    int64_t clock;
+    int current;
 } AdbProbeInternal;
 
+// A tier position in a batched probe and its index in the result arrays.
+typedef struct {
+    TierPosition tier_position;
+    int64_t index;
+} AdbBatchRequest;
+
+// Location of the compressed stream of a tier: the whole tier file in the
+// per-tier layout, or a range of a segment file in the packed layout.
+typedef struct {
+    char *path;
+    int64_t offset;
+    int64_t length;  // -1 if the stream extends to the end of the file.
+} AdbTierLocation;
+
 // Constants
 
-enum { kArrayDbNumLoadedTiersMax = 256 };
 const int kArrayDbRecordSize = sizeof(Record);
 const ArrayDbOptions kArrayDbOptionsInit = {
     .block_size = 1 << 20,         // 1 MiB.
@@ -144,6 +200,10 @@ const ArrayDbOptions kArrayDbOptionsInit = {
 };
 static const int kDefaultLz4Level = 0;  //
 
+// The background flusher compresses with one in every this many threads, as
+// the solver keeps using all of them for the next tier meanwhile.
+static const int kFlusherThreadsDivisor = 4;
+
 // Global options
 
 static int block_size;  // For XZ compression.
@@ -157,8 +217,42 @@ static int current_variant;
 static GetTierNameFunc CurrentGetTierName;
 static char *sandbox_path;
 static Tier current_tier;
-static TierHashMapSC loaded_tier_to_index;
-static RecordArray loaded_records[kArrayDbNumLoadedTiersMax];
+static RecordArray solving_records;
+
+// Tiers loaded using ArrayDbLoadTier(), which are kept in memory after being
+// unloaded if the tier cache is enabled.
+static TierResidency loaded_tiers;
+
+// Solved tiers recorded in the manifest file in the sandbox. The manifest is
+// only used if USE_MANIFEST is true. Databases solved before the manifest was
+// introduced have tier files but no manifest, and fall back to checking for
+// each tier file until the manifest is rebuilt.
+static TierManifest manifest;
+static bool use_manifest;
+static bool manifest_hint_printed;
+
+// Segment files and index of the packed layout, which is used instead of one
+// file per tier if the sandbox contains a segment index. The segment index
+// also replaces the manifest in the packed layout.
+static TierSegments segments;
+static bool use_segments;
+
+// Background compression stage, used by ArrayDbFlushSolvingTier() if
+// USE_FLUSHER is true. The job of the solving tier is allocated along with the
+// solving tier so that handing the tier over cannot fail.
+static TierFlusher flusher;
+static bool use_flusher;
+static TierFlushJob *solving_job;
+
+// Writer of the segment files that the flusher compresses tiers into in the
+// packed layout. Only the background thread of the flusher uses it, and the
+// solving thread indexes the streams it writes.
+static TierSegments flush_writer;
+
+static int InitLayout(void);
+static int SetSolvingTier(Tier tier);
+static const RecordArray *GetLoadedRecords(Tier tier);
+static int SyncFile(const char *path);
 
 static int ArrayDbInit(ReadOnlyString game_name, int variant,
                        ReadOnlyString path, GetTierNameFunc GetTierName,
@@ -181,19 +275,20 @@ static int ArrayDbInit(ReadOnlyString game_name, int variant,
     current_variant = variant;
     CurrentGetTierName = GetTierName;
     current_tier = kIllegalTier;
-    TierHashMapSCInit(&loaded_tier_to_index, 0.5);
-    memset(&loaded_records, 0, sizeof(loaded_records));
+    memset(&solving_records, 0, sizeof(solving_records));
+    TierResidencyInit(&loaded_tiers);
 
-    return kNoError;
+    return InitLayout();
 }
 
 static void ArrayDbFinalize(void) {
+    ArrayDbSetAsyncFlush(0);
     GamesmanFree(sandbox_path);
     sandbox_path = NULL;
-    TierHashMapSCDestroy(&loaded_tier_to_index);
-    for (int i = 0; i < kArrayDbNumLoadedTiersMax; ++i) {
-        RecordArrayDestroy(&loaded_records[i]);
-    }
+    TierManifestDestroy(&manifest);
+    TierSegmentsDestroy(&segments);
+    RecordArrayDestroy(&solving_records);
+    TierResidencyDestroy(&loaded_tiers);
 }
 
 static int ArrayDbCreateSolvingTier(Tier tier, int64_t size) {
@@ -204,18 +299,11 @@ static int ArrayDbCreateSolvingTier(Tier tier, int64_t size) {
         return kRuntimeError;
     }
 
-    // Initialize the 0-th loaded record as the solving tier's record array.
-    int error = RecordArrayInit(&loaded_records[0], size);
+    // Initialize the solving tier's record array.
+    int error = RecordArrayInit(&solving_records, size);
     if (error != kNoError) return error;
 
-    // Add the solving tier's index to the map.
-    if (!TierHashMapSCSet(&loaded_tier_to_index, tier, 0)) {
-        RecordArrayDestroy(&loaded_records[0]);
-        return kMallocFailureError;
-    }
-
-    current_tier = tier;
-    return kNoError;
+    return SetSolvingTier(tier);
 }
 
 /**
@@ -292,6 +380,105 @@ static char *GetFullPathToFinishFlag(void) {
     return full_path;
 }
 
+static char *GetFullPathToSandboxFile(ReadOnlyString name) {
+    // Full path: "<path>/<name>", +2 for '/' and '\0'.
+    char *full_path = (char *)GamesmanCallocWhole(
+        (strlen(sandbox_path) + strlen(name) + 2), sizeof(char));
+    if (full_path == NULL) {
+        fprintf(stderr,
+                "GetFullPathToSandboxFile: failed to calloc full_path.\n");
+        return NULL;
+    }
+
+    sprintf(full_path, "%s/%s", sandbox_path, name);
+    return full_path;
+}
+
+static char *GetFullPathToManifest(void) {
+    return GetFullPathToSandboxFile(".manifest");
+}
+
+/** @brief Returns whether the sandbox contains any tier DB file. */
+static bool SandboxContainsTierFiles(void) {
+    static const char extension[] = ".adb.xz";
+    static const size_t extension_length = sizeof(extension) - 1;
+    DIR *dir = opendir(sandbox_path);
+    if (dir == NULL) return false;
+
+    bool found = false;
+    struct dirent *entry;
+    while (!found && (entry = readdir(dir)) != NULL) {
+        size_t length = strlen(entry->d_name);
+        found = length > extension_length &&
+                strcmp(entry->d_name + length - extension_length, extension) ==
+                    0;
+    }
+    closedir(dir);
+
+    return found;
+}
+
+static int InitManifest(void) {
+    char *path = GetFullPathToManifest();
+    if (path == NULL) return kMallocFailureError;
+
+    int error = TierManifestInit(&manifest, path);
+    GamesmanFree(path);
+    if (error != kNoError) return error;
+
+    manifest_hint_printed = false;
+    if (use_segments) {
+        use_manifest = false;
+        return kNoError;
+    }
+
+    error = TierManifestLoad(&manifest);
+    if (error == kMallocFailureError) return error;
+
+    // Without a readable manifest, a new database starts one whereas an
+    // existing one keeps checking for tier files.
+    use_manifest = (error == kNoError) || !SandboxContainsTierFiles();
+
+    return kNoError;
+}
+
+static int InitLayout(void) {
+    int error =
+        TierSegmentsInit(&segments, sandbox_path, kTierSegmentsIndexName);
+    if (error != kNoError) return error;
+
+    error = TierSegmentsLoad(&segments);
+    if (error == kMallocFailureError) return error;
+    use_segments = (error == kNoError);
+
+    return InitManifest();
+}
+
+static int GetTierLocation(Tier tier, AdbTierLocation *location) {
+    if (!use_segments) {
+        location->path = GetFullPathToFile(tier, CurrentGetTierName);
+        location->offset = 0;
+        location->length = -1;
+        return location->path == NULL ? kMallocFailureError : kNoError;
+    }
+
+    // Looking up a tier missing from memory reloads the index.
+    int error = kNoError;
+    PRAGMA_OMP_CRITICAL(arraydb_segments) {
+        const TierSegmentEntry *entry = TierSegmentsLookup(&segments, tier);
+        if (entry == NULL) {
+            error = kFileSystemError;
+        } else {
+            location->path = TierSegmentsGetPath(&segments, entry->segment);
+            location->offset = entry->offset;
+            location->length = entry->length;
+            if (location->path == NULL) error = kMallocFailureError;
+        }
+    }
+
+    return error;
+}
+
 static int GetNumThreads(void) {
 #ifdef _OPENMP
     return omp_get_max_threads();
@@ -300,8 +487,96 @@ static int GetNumThreads(void) {
 #endif  // _OPENMP
 }
 
+static int GetNumFlusherThreads(void) {
+    int num_threads = GetNumThreads() / kFlusherThreadsDivisor;
+    return num_threads > 1 ? num_threads : 1;
+}
+
+static int FlushSolvingTierToSegment(void) {
+    int32_t segment;
+    int64_t offset;
+    int error = TierSegmentsPrepareWrite(&segments, &segment, &offset);
+    if (error != kNoError) return error;
+
+    char *segment_path = TierSegmentsGetPath(&segments, segment);
+    if (segment_path == NULL) return kMallocFailureError;
+
+    int64_t compressed_size =
+        XzraCompressStream(segment_path, true, block_size, lzma_level,
+                           enable_extreme_compression, GetNumThreads(),
+                           RecordArrayGetData(&solving_records),
+                           RecordArrayGetRawSize(&solving_records));
+    GamesmanFree(segment_path);
+    if (compressed_size < 0) {
+        // The segment may end with a partial stream. Leave it behind.
+        TierSegmentsAbortWrite(&segments);
+        return compressed_size == -2 ? kFileSystemError : kRuntimeError;
+    }
+
+    return TierSegmentsCommitWrite(&segments, current_tier, compressed_size,
+                                   kTierManifestCodecXz);
+}
+
+/**
+ * @brief Makes SOLVING_RECORDS the records of solving tier TIER. The record
+ * array is destroyed on failure.
+ */
+static int SetSolvingTier(Tier tier) {
+    current_tier = tier;
+    if (!use_flusher) return kNoError;
+
+    char *tmp_full_path = GetFullPathToTempFile(tier, CurrentGetTierName);
+    if (tmp_full_path != NULL) {
+        solving_job = TierFlushJobCreate(tier, tmp_full_path);
+        GamesmanFree(tmp_full_path);
+    }
+    if (solving_job == NULL) {
+        ArrayDbFreeSolvingTier();
+        return kMallocFailureError;
+    }
+
+    return kNoError;
+}
+
+/**
+ * @brief Records TIER of SIZE positions, whose file of COMPRESSED_SIZE bytes
+ * is in place, in the manifest if the manifest is in use.
+ */
+static int RecordSolvedTier(Tier tier, int64_t size, int64_t compressed_size,
+                            uint64_t checksum) {
+    if (!use_manifest) return kNoError;
+
+    TierManifestEntry entry = {
+        .tier = tier,
+        .size = size,
+        .compressed_size = compressed_size,
+        .timestamp = (int64_t)time(NULL),
+        .checksum = checksum,
+        .codec = kTierManifestCodecXz,
+    };
+    int error = TierManifestAppend(&manifest, &entry);
+    if (error != kNoError) {
+        fprintf(stderr,
+                "RecordSolvedTier: failed to record tier %" PRITier
+                " in the manifest (code %d)\n",
+                tier, error);
+    }
+
+    return error;
+}
+
 static int ArrayDbFlushSolvingTier(void *aux) {
     (void)aux;  // Unused.
+    if (use_flusher) {
+        // Hand the records over to the flusher.
+        solving_job->size = solving_records.size;
+        solving_job->records = solving_records;
+        memset(&solving_records, 0, sizeof(solving_records));
+        TierFlusherSubmit(&flusher, solving_job);
+        solving_job = NULL;
+        return kNoError;
+    }
+    if (use_segments) return FlushSolvingTierToSegment();
 
     // Create db file.
     int error = kNoError;
@@ -317,8 +592,8 @@ static int ArrayDbFlushSolvingTier(void *aux) {
     int64_t compressed_size =
         XzraCompressStream(tmp_full_path, false, block_size, lzma_level,
                            enable_extreme_compression, GetNumThreads(),
-                           RecordArrayGetData(&loaded_records[0]),
-                           RecordArrayGetRawSize(&loaded_records[0]));
+                           RecordArrayGetData(&solving_records),
+                           RecordArrayGetRawSize(&solving_records));
     switch (compressed_size) {
         case -2:
             error = kFileSystemError;
@@ -328,13 +603,24 @@ static int ArrayDbFlushSolvingTier(void *aux) {
             goto _bailout;
     }
 
-    // If successful, rename the temp file into the desired tier DB name.
+    // The tier must be durable before the manifest records it as solved.
+    error = SyncFile(tmp_full_path);
+    if (error != kNoError) goto _bailout;
+
+    // If successful, rename the temp file into the desired tier DB name, and
+    // make the rename durable before the manifest depends on it.
     int rename_error = GuardedRename(tmp_full_path, full_path);
-    if (rename_error) {
+    if (rename_error || GuardedSyncDirectory(sandbox_path) != 0) {
         error = kFileSystemError;
         goto _bailout;
     }
 
+    // Record the tier only after its file is in place.
+    error = RecordSolvedTier(
+        current_tier, solving_records.size, compressed_size,
+        TierManifestChecksum(RecordArrayGetData(&solving_records),
+                             RecordArrayGetRawSize(&solving_records)));
+
 _bailout:
     GamesmanFree(full_path);
     GamesmanFree(tmp_full_path);
@@ -343,13 +629,170 @@ _bailout:
 }
 
 static int ArrayDbFreeSolvingTier(void) {
-    RecordArrayDestroy(&loaded_records[0]);
-    TierHashMapSCRemove(&loaded_tier_to_index, current_tier);
+    TierFlushJobDestroy(solving_job);
+    solving_job = NULL;
+    RecordArrayDestroy(&solving_records);
     current_tier = kIllegalTier;
 
     return kNoError;
 }
 
+/**
+ * @brief Compresses the records of JOB into its temp file and writes the file
+ * to storage. Runs on the background thread of the flusher.
+ */
+static int FlushJobToTempFile(TierFlushJob *job) {
+    void *data = RecordArrayGetData(&job->records);
+    int64_t raw_size = RecordArrayGetRawSize(&job->records);
+    job->checksum = TierManifestChecksum(data, raw_size);
+    job->compressed_size =
+        XzraCompressStream(job->path, false, block_size, lzma_level,
+                           enable_extreme_compression, GetNumFlusherThreads(),
+                           data, raw_size);
+    if (job->compressed_size < 0) {
+        job->error =
+            (job->compressed_size == -2) ? kFileSystemError : kRuntimeError;
+        return job->error;
+    }
+
+    // The tier is reported as flushed only after its file is durable.
+    job->error = SyncFile(job->path);
+
+    return job->error;
+}
+
+/**
+ * @brief Compresses the records of JOB into the next segment file of the
+ * flusher and writes the stream to storage. Runs on the background thread of
+ * the flusher.
+ */
+static int FlushJobToSegment(TierFlushJob *job) {
+    void *data = RecordArrayGetData(&job->records);
+    int64_t raw_size = RecordArrayGetRawSize(&job->records);
+    job->checksum = TierManifestChecksum(data, raw_size);
+    job->error = TierSegmentsPrepareWrite(&flush_writer, &job->segment,
+                                          &job->offset);
+    if (job->error != kNoError) return job->error;
+
+    char *segment_path = TierSegmentsGetPath(&flush_writer, job->segment);
+    if (segment_path == NULL) {
+        TierSegmentsAbortWrite(&flush_writer);
+        job->error = kMallocFailureError;
+        return job->error;
+    }
+    job->compressed_size =
+        XzraCompressStream(segment_path, true, block_size, lzma_level,
+                           enable_extreme_compression, GetNumFlusherThreads(),
+                           data, raw_size);
+    GamesmanFree(segment_path);
+    if (job->compressed_size < 0) {
+        // The segment may end with a partial stream. Leave it behind.
+        TierSegmentsAbortWrite(&flush_writer);
+        job->error =
+            (job->compressed_size == -2) ? kFileSystemError : kRuntimeError;
+        return job->error;
+    }
+
+    // The tier is reported as flushed only after its stream is durable.
+    job->error = TierSegmentsFinishWrite(&flush_writer, job->compressed_size);
+    if (job->error != kNoError) TierSegmentsAbortWrite(&flush_writer);
+
+    return job->error;
+}
+
+// Writes the content of the file at PATH to storage.
+static int SyncFile(const char *path) {
+    int fd = GuardedOpen(path, O_RDONLY);
+    if (fd < 0) return kFileSystemError;
+    if (fdatasync(fd) != 0) {
+        perror("fdatasync");
+        return BailOutClose(fd, kFileSystemError);
+    }
+    if (GuardedClose(fd) != 0) return kFileSystemError;
+
+    return kNoError;
+}
+
+/**
+ * @brief Indexes the stream of a processed JOB in the packed layout, or moves
+ * its temp file into the database otherwise, which marks its tier as solved.
+ * Runs on the thread that solves tiers, which owns the manifest and the
+ * segment index.
+ */
+static int CommitFlushJob(const TierFlushJob *job) {
+    if (job->error != kNoError) return job->error;
+
+    if (use_segments) {
+        return TierSegmentsIndexStream(&segments, job->tier, job->segment,
+                                       job->offset, job->compressed_size,
+                                       kTierManifestCodecXz);
+    }
+
+    // The rename must be durable before the manifest depends on it.
+    int error = kNoError;
+    char *full_path = GetFullPathToFile(job->tier, CurrentGetTierName);
+    if (full_path == NULL) return kMallocFailureError;
+    if (GuardedRename(job->path, full_path) != 0 ||
+        GuardedSyncDirectory(sandbox_path) != 0) {
+        error = kFileSystemError;
+    }
+    GamesmanFree(full_path);
+    if (error != kNoError) return error;
+
+    return RecordSolvedTier(job->tier, job->size, job->compressed_size,
+                            job->checksum);
+}
+
+static int ArrayDbSetAsyncFlush(intptr_t budget) {
+    if (use_flusher) {
+        // Commit the tiers flushed so far before stopping.
+        TierFlushJob *job;
+        while ((job = TierFlusherPop(&flusher, true)) != NULL) {
+            int error = CommitFlushJob(job);
+            if (error != kNoError) {
+                fprintf(stderr,
+                        "ArrayDbSetAsyncFlush: failed to flush tier %" PRITier
+                        " (code %d)\n",
+                        job->tier, error);
+            }
+            TierFlushJobDestroy(job);
+        }
+        TierFlusherDestroy(&flusher);
+        TierSegmentsDestroy(&flush_writer);
+        use_flusher = false;
+    }
+    if (budget <= 0) return kNoError;
+
+    int error = kNoError;
+    if (use_segments) {
+        error = TierSegmentsInitWriter(&flush_writer, &segments);
+        if (error != kNoError) return error;
+        error = TierFlusherInit(&flusher, budget, FlushJobToSegment);
+    } else {
+        error = TierFlusherInit(&flusher, budget, FlushJobToTempFile);
+    }
+    if (error != kNoError) {
+        TierSegmentsDestroy(&flush_writer);
+        return error;
+    }
+    use_flusher = true;
+
+    return kNoError;
+}
+
+static bool ArrayDbPopFlushedTier(bool wait, Tier *tier, int *error) {
+    if (!use_flusher) return false;
+
+    TierFlushJob *job = TierFlusherPop(&flusher, wait);
+    if (job == NULL) return false;
+
+    *tier = job->tier;
+    *error = CommitFlushJob(job);
+    TierFlushJobDestroy(job);
+
+    return true;
+}
+
 static int ArrayDbSetGameSolved(void) {
     char *flag_filename = GetFullPathToFinishFlag();
     if (flag_filename == NULL) return kMallocFailureError;
@@ -365,23 +808,23 @@ static int ArrayDbSetGameSolved(void) {
 }
 
 static int ArrayDbSetValue(Position position, Value value) {
-    RecordArraySetValue(&loaded_records[0], position, value);
+    RecordArraySetValue(&solving_records, position, value);
 
     return kNoError;
 }
 
 static int ArrayDbSetRemoteness(Position position, int remoteness) {
-    RecordArraySetRemoteness(&loaded_records[0], position, remoteness);
+    RecordArraySetRemoteness(&solving_records, position, remoteness);
 
     return kNoError;
 }
 
 static Value ArrayDbGetValue(Position position) {
-    return RecordArrayGetValue(&loaded_records[0], position);
+    return RecordArrayGetValue(&solving_records, position);
 }
 
 static int ArrayDbGetRemoteness(Position position) {
-    return RecordArrayGetRemoteness(&loaded_records[0], position);
+    return RecordArrayGetRemoteness(&solving_records, position);
 }
 
 bool ArrayDbCheckpointExists(Tier tier) {
@@ -402,9 +845,9 @@ int ArrayDbCheckpointSave(const void *status, size_t status_size) {
         goto _bailout;
     }
 
-    const void *inputs[] = {RecordArrayGetReadOnlyData(&loaded_records[0]),
+    const void *inputs[] = {RecordArrayGetReadOnlyData(&solving_records),
                             status};
-    const size_t input_sizes[] = {RecordArrayGetRawSize(&loaded_records[0]),
+    const size_t input_sizes[] = {RecordArrayGetRawSize(&solving_records),
                                   status_size};
     int64_t compressed_size = Lz4UtilsCompressStreams(
         inputs, input_sizes, 2, kDefaultLz4Level, tmp_full_path);
@@ -443,37 +886,30 @@ int ArrayDbCheckpointLoad(Tier tier, int64_t size, void *status,
         return kRuntimeError;
     }
 
-    // Initialize the 0-th loaded record as the solving tier's record array.
-    int error = RecordArrayInit(&loaded_records[0], size);
+    // Initialize the solving tier's record array.
+    int error = RecordArrayInit(&solving_records, size);
     if (error != kNoError) return error;
 
     // Get full path to the checkpoint file.
     char *full_path = GetFullPathToCheckpoint(tier, CurrentGetTierName);
     if (full_path == NULL) {
-        RecordArrayDestroy(&loaded_records[0]);
+        RecordArrayDestroy(&solving_records);
         return kMallocFailureError;
     }
 
     // Decompress the checkpoint file into the record array and status.
-    void *out_buffers[] = {RecordArrayGetData(&loaded_records[0]), status};
-    size_t out_sizes[] = {RecordArrayGetRawSize(&loaded_records[0]),
+    void *out_buffers[] = {RecordArrayGetData(&solving_records), status};
+    size_t out_sizes[] = {RecordArrayGetRawSize(&solving_records),
                           status_size};
     int64_t decomp_size =
         Lz4UtilsDecompressFileMultistream(full_path, out_buffers, out_sizes, 2);
     GamesmanFree(full_path);
     if (decomp_size < 0) {
-        RecordArrayDestroy(&loaded_records[0]);
+        RecordArrayDestroy(&solving_records);
         return kRuntimeError;
     }
 
-    // Add the solving tier's index to the map.
-    if (!TierHashMapSCSet(&loaded_tier_to_index, tier, 0)) {
-        RecordArrayDestroy(&loaded_records[0]);
-        return kMallocFailureError;
-    }
-
-    current_tier = tier;
-    return kNoError;
+    return SetSolvingTier(tier);
 }
 
 static int ArrayDbCheckpointRemove(Tier tier) {
@@ -490,99 +926,92 @@ static intptr_t ArrayDbTierMemUsage(Tier tier, int64_t size) {
     return size * 2;
 }
 
-static int GetFirstUnusedRecordArrayIndex(void) {
-    int i;  // The 0-th space is reserved for the solving tier.
-    for (i = 1; i < kArrayDbNumLoadedTiersMax; ++i) {
-        if (loaded_records[i].records == NULL) break;
-    }
-
-    return i;
-}
-
 static int ArrayDbLoadTier(Tier tier, int64_t size) {
-    // Find the first unused slot in the loaded records array.
-    int i = GetFirstUnusedRecordArrayIndex();
-    if (i == kArrayDbNumLoadedTiersMax) {
-        fprintf(stderr,
-                "ArrayDbLoadTier: cannot load more than %d tiers at the same "
-                "time\n",
-                kArrayDbNumLoadedTiersMax);
-        return kRuntimeError;
-    }
+    // Reuse the tier if it is still in memory.
+    if (TierResidencyAcquire(&loaded_tiers, tier)) return kNoError;
 
-    int error = RecordArrayInit(&loaded_records[i], size);
+    RecordArray records;
+    int error = RecordArrayInit(&records, size);
     if (error != kNoError) return kMallocFailureError;
 
-    char *full_path = GetFullPathToFile(tier, CurrentGetTierName);
-    if (full_path == NULL) {
-        RecordArrayDestroy(&loaded_records[i]);
-        return kMallocFailureError;
+    AdbTierLocation location;
+    error = GetTierLocation(tier, &location);
+    if (error != kNoError) {
+        RecordArrayDestroy(&records);
+        return error;
     }
 
     uint64_t mem = XzraDecompressionMemUsage(
         block_size, lzma_level, enable_extreme_compression, GetNumThreads());
-    int64_t decomp_size = XzraDecompressFile(
-        RecordArrayGetData(&loaded_records[i]), size * kArrayDbRecordSize,
-        GetNumThreads(), mem, full_path);
-    GamesmanFree(full_path);
+    int64_t decomp_size = XzraDecompressFileRange(
+        RecordArrayGetData(&records), size * kArrayDbRecordSize,
+        GetNumThreads(), mem, location.path, location.offset, location.length);
+    GamesmanFree(location.path);
     if (decomp_size < 0) {
-        RecordArrayDestroy(&loaded_records[i]);
+        RecordArrayDestroy(&records);
         return kRuntimeError;
     }
 
-    if (!TierHashMapSCSet(&loaded_tier_to_index, tier, i)) {
-        RecordArrayDestroy(&loaded_records[i]);
-        return kMallocFailureError;
-    }
-
-    return kNoError;
+    return TierResidencyInsert(&loaded_tiers, tier, &records);
 }
 
-static int GetLoadedTierIndex(Tier tier) {
-    int64_t index;
-    if (!TierHashMapSCGet(&loaded_tier_to_index, tier, &index)) return -1;
+static int ArrayDbUnloadTier(Tier tier) {
+    // Attempting to unload the solving tier is an error.
+    return TierResidencyRelease(&loaded_tiers, tier);
+}
 
-    assert(index >= 0 && index < kArrayDbNumLoadedTiersMax);
-    return (int)index;
+static bool ArrayDbIsTierLoaded(Tier tier) {
+    return GetLoadedRecords(tier) != NULL;
 }
 
-static int ArrayDbUnloadTier(Tier tier) {
-    int index = GetLoadedTierIndex(tier);
+static int ArrayDbSetTierCache(intptr_t budget) {
+    TierResidencySetBudget(&loaded_tiers, budget > 0 ? budget : 0);
 
-    // Either not found or attempting to unload the solving tier.
-    if (index <= 0) return kRuntimeError;
+    return kNoError;
+}
 
-    RecordArrayDestroy(&loaded_records[index]);
-    TierHashMapSCRemove(&loaded_tier_to_index, tier);
+static bool ArrayDbIsTierCached(Tier tier) {
+    return TierResidencyContains(&loaded_tiers, tier);
+}
 
-    return kNoError;
+static void ArrayDbEvictTier(Tier tier) {
+    TierResidencyEvict(&loaded_tiers, tier);
 }
 
-static bool ArrayDbIsTierLoaded(Tier tier) {
-    int index = GetLoadedTierIndex(tier);
-    if (index < 0) return false;
+/**
+ * @brief Returns the records of TIER if it is the solving tier or a loaded
+ * tier, or NULL otherwise.
+ */
+static const RecordArray *GetLoadedRecords(Tier tier) {
+    if (tier == current_tier && solving_records.records != NULL) {
+        return &solving_records;
+    }
 
-    return loaded_records[index].records != NULL;
+    return TierResidencyGet(&loaded_tiers, tier);
 }
 
 static Value ArrayDbGetValueFromLoaded(Tier tier, Position position) {
-    int index = GetLoadedTierIndex(tier);
-    if (index < 0) return kErrorValue;
+    const RecordArray *records = GetLoadedRecords(tier);
+    if (records == NULL) return kErrorValue;
 
-    return RecordArrayGetValue(&loaded_records[index], position);
+    return RecordArrayGetValue(records, position);
 }
 
 static int ArrayDbGetRemotenessFromLoaded(Tier tier, Position position) {
-    int index = GetLoadedTierIndex(tier);
-    if (index < 0) return -1;
+    const RecordArray *records = GetLoadedRecords(tier);
+    if (records == NULL) return -1;
 
-    return RecordArrayGetRemoteness(&loaded_records[index], position);
+    return RecordArrayGetRemoteness(records, position);
 }
 
 static int ArrayDbProbeInit(DbProbe *probe) {
     probe->buffer = GamesmanCallocWhole(1, sizeof(AdbProbeInternal));
     if (probe->buffer == NULL) return kMallocFailureError;
 
+    AdbProbeInternal *probe_internal = (AdbProbeInternal *)probe->buffer;
+    for (int i = 0; i < kArrayDbProbeFilesMax; ++i) {
+        probe_internal->tiers[i] = kIllegalTier;
+    }
     probe->tier = kIllegalTier;
     // probe->begin and probe->size are unused.
 
@@ -591,33 +1020,67 @@ static int ArrayDbProbeInit(DbProbe *probe) {
 
 static int ArrayDbProbeDestroy(DbProbe *probe) {
     AdbProbeInternal *probe_internal = (AdbProbeInternal *)probe->buffer;
-    XzraFileClose(probe_internal->file);
+    for (int i = 0; i < kArrayDbProbeFilesMax; ++i) {
+        if (probe_internal->files[i] != NULL) {
+            XzraFileClose(probe_internal->files[i]);
+        }
+    }
     GamesmanFree(probe->buffer);
     memset(probe, 0, sizeof(*probe));
 
     return kNoError;
 }
 
-static bool ProbeSameFile(const DbProbe *probe, TierPosition tier_position) {
-    return probe->tier == tier_position.tier;
-}
-
-static int ProbeLoadNewTier(DbProbe *probe, Tier tier) {
+// Makes the file of TIER the current file of PROBE, opening it in place of the
+// least recently used file if it is not already open.
+static int ProbeSelectTier(DbProbe *probe, Tier tier) {
     AdbProbeInternal *probe_internal = (AdbProbeInternal *)probe->buffer;
-    if (probe_internal->init) {
-        int error = XzraFileClose(probe_internal->file);
+    ++probe_internal->clock;
+    if (probe->tier == tier) {
+        probe_internal->last_used[probe_internal->current] =
+            probe_internal->clock;
+        return kNoError;
+    }
+
+    int victim = 0;
+    for (int i = 0; i < kArrayDbProbeFilesMax; ++i) {
+        if (probe_internal->tiers[i] == tier) {
+            probe_internal->current = i;
+            probe_internal->last_used[i] = probe_internal->clock;
+            probe->tier = tier;
+            return kNoError;
+        }
+        if (probe_internal->last_used[i] < probe_internal->last_used[victim]) {
+            victim = i;
+        }
+    }
+
+    // The current tier is no longer open once its file is evicted, even if
+    // the file fails to close.
+    if (probe_internal->current == victim) probe->tier = kIllegalTier;
+    if (probe_internal->files[victim] != NULL) {
+        int error = XzraFileClose(probe_internal->files[victim]);
+        probe_internal->files[victim] = NULL;
+        probe_internal->tiers[victim] = kIllegalTier;
+        probe_internal->last_used[victim] = 0;
         if (error != 0) return kRuntimeError;
     }
 
-    char *full_path = GetFullPathToFile(tier, CurrentGetTierName);
-    if (full_path == NULL) return kMallocFailureError;
+    AdbTierLocation location;
+    int error = GetTierLocation(tier, &location);
+    if (error != kNoError) return error;
 
-    probe_internal->file = XzraFileOpen(full_path);
-    GamesmanFree(full_path);
-    if (probe_internal->file == NULL) return kFileSystemError;
+    XzraFile *file =
+        XzraFileOpenRange(location.path, location.offset, location.length);
+    GamesmanFree(location.path);
+    if (file == NULL) return kFileSystemError;
 
-    probe_internal->init = true;
+    probe_internal->files[victim] = file;
+    probe_internal->tiers[victim] = tier;
+    probe_internal->last_used[victim] = probe_internal->clock;
+    probe_internal->current = victim;
     probe->tier = tier;
+
     return kNoError;
 }
 
@@ -625,8 +1088,9 @@ static Record ProbeGetRecord(const DbProbe *probe, Position position) {
     int64_t offset = position * (int64_t)sizeof(Record);
     Record rec;
     AdbProbeInternal *probe_internal = (AdbProbeInternal *)probe->buffer;
-    XzraFileSeek(probe_internal->file, offset, XZRA_SEEK_SET);
-    size_t bytes_read = XzraFileRead(&rec, sizeof(rec), probe_internal->file);
+    XzraFile *file = probe_internal->files[probe_internal->current];
+    XzraFileSeek(file, offset, XZRA_SEEK_SET);
+    size_t bytes_read = XzraFileRead(&rec, sizeof(rec), file);
     if (bytes_read != sizeof(rec)) {
         fprintf(stderr, "ProbeGetRecord: (BUG) corrupt record\n");
     }
@@ -635,14 +1099,11 @@ static Record ProbeGetRecord(const DbProbe *probe, Position position) {
 }
 
 static Value ArrayDbProbeValue(DbProbe *probe, TierPosition tier_position) {
-    if (!ProbeSameFile(probe, tier_position)) {
-        int error = ProbeLoadNewTier(probe, tier_position.tier);
-        if (error != kNoError) {
-            fprintf(stderr,
-                    "ArrayDbProbeValue: failed to load tier %" PRITier "\n",
-                    tier_position.tier);
-            return kErrorValue;
-        }
+    int error = ProbeSelectTier(probe, tier_position.tier);
+    if (error != kNoError) {
+        fprintf(stderr, "ArrayDbProbeValue: failed to load tier %" PRITier "\n",
+                tier_position.tier);
+        return kErrorValue;
     }
 
     Record rec = ProbeGetRecord(probe, tier_position.position);
@@ -650,22 +1111,114 @@ static Value ArrayDbProbeValue(DbProbe *probe, TierPosition tier_position) {
 }
 
 static int ArrayDbProbeRemoteness(DbProbe *probe, TierPosition tier_position) {
-    if (!ProbeSameFile(probe, tier_position)) {
-        int error = ProbeLoadNewTier(probe, tier_position.tier);
-        if (error != kNoError) {
-            fprintf(stderr,
-                    "ArrayDbProbeRemoteness: failed to load tier %" PRITier
-                    "\n",
-                    tier_position.tier);
-            return kErrorRemoteness;
-        }
+    int error = ProbeSelectTier(probe, tier_position.tier);
+    if (error != kNoError) {
+        fprintf(stderr,
+                "ArrayDbProbeRemoteness: failed to load tier %" PRITier "\n",
+                tier_position.tier);
+        return kErrorRemoteness;
     }
 
     Record rec = ProbeGetRecord(probe, tier_position.position);
     return RecordGetRemoteness(&rec);
 }
 
+static Value ArrayDbProbeValueRemoteness(DbProbe *probe,
+                                         TierPosition tier_position,
+                                         int *remoteness) {
+    int error = ProbeSelectTier(probe, tier_position.tier);
+    if (error != kNoError) {
+        fprintf(stderr,
+                "ArrayDbProbeValueRemoteness: failed to load tier %" PRITier
+                "\n",
+                tier_position.tier);
+        *remoteness = kErrorRemoteness;
+        return kErrorValue;
+    }
+
+    Record rec = ProbeGetRecord(probe, tier_position.position);
+    *remoteness = RecordGetRemoteness(&rec);
+    return RecordGetValue(&rec);
+}
+
+static int CompareBatchRequests(const void *a, const void *b) {
+    const TierPosition *x = &((const AdbBatchRequest *)a)->tier_position;
+    const TierPosition *y = &((const AdbBatchRequest *)b)->tier_position;
+    if (x->tier != y->tier) return x->tier < y->tier ? -1 : 1;
+    if (x->position != y->position) return x->position < y->position ? -1 : 1;
+
+    return 0;
+}
+
+// Sorting the requests by tier and position groups them by tier file and, since
+// each block of a file holds a contiguous range of positions, by block within
+// the file. Each tier file is then selected once per batch and each block is
+// decompressed once, as the file keeps its most recently decoded block until a
+// position outside of it is read.
+static int ArrayDbProbeBatch(DbProbe *probe, int64_t n,
+                             const TierPosition *tier_positions, Value *values,
+                             int *remotenesses) {
+    AdbBatchRequest *requests =
+        (AdbBatchRequest *)GamesmanMalloc(n * sizeof(AdbBatchRequest));
+    if (requests == NULL) return kMallocFailureError;
+
+    for (int64_t i = 0; i < n; ++i) {
+        requests[i].tier_position = tier_positions[i];
+        requests[i].index = i;
+    }
+    qsort(requests, n, sizeof(AdbBatchRequest), CompareBatchRequests);
+
+    Record rec = 0;
+    bool tier_ok = false;
+    for (int64_t i = 0; i < n; ++i) {
+        TierPosition tier_position = requests[i].tier_position;
+        bool new_tier =
+            i == 0 || requests[i - 1].tier_position.tier != tier_position.tier;
+        if (new_tier) {
+            tier_ok = ProbeSelectTier(probe, tier_position.tier) == kNoError;
+            if (!tier_ok) {
+                fprintf(stderr,
+                        "ArrayDbProbeBatch: failed to load tier %" PRITier "\n",
+                        tier_position.tier);
+            }
+        }
+
+        if (!tier_ok) {
+            values[requests[i].index] = kErrorValue;
+            remotenesses[requests[i].index] = kErrorRemoteness;
+            continue;
+        }
+
+        // Duplicates are adjacent after sorting and share the same record.
+        if (new_tier || CompareBatchRequests(&requests[i - 1], &requests[i])) {
+            rec = ProbeGetRecord(probe, tier_position.position);
+        }
+        values[requests[i].index] = RecordGetValue(&rec);
+        remotenesses[requests[i].index] = RecordGetRemoteness(&rec);
+    }
+    GamesmanFree(requests);
+
+    return kNoError;
+}
+
 static int ArrayDbTierStatus(Tier tier) {
+    if (use_segments) {
+        return TierSegmentsFind(&segments, tier) != NULL
+                   ? kDbTierStatusSolved
+                   : kDbTierStatusMissing;
+    }
+    if (use_manifest) {
+        return TierManifestContains(&manifest, tier) ? kDbTierStatusSolved
+                                                     : kDbTierStatusMissing;
+    }
+
+    if (!manifest_hint_printed) {
+        printf("No manifest of solved tiers found in [%s]. Checking tier "
+               "files one at a time; solve with --rebuild-manifest to create "
+               "the manifest.\n",
+               sandbox_path);
+        manifest_hint_printed = true;
+    }
     char *full_path = GetFullPathToFile(tier, CurrentGetTierName);
     if (full_path == NULL) return kDbTierStatusCheckError;
 
@@ -679,6 +1232,154 @@ static int ArrayDbTierStatus(Tier tier) {
     return kDbTierStatusSolved;
 }
 
+static int ArrayDbRebuildTierManifest(int64_t n, const Tier *tiers,
+                                      const int64_t *sizes) {
+    // The segment index already records every tier in the packed layout.
+    if (use_segments) return kNoError;
+
+    TierManifestEntry *entries =
+        (TierManifestEntry *)GamesmanCallocWhole(n, sizeof(TierManifestEntry));
+    bool *found = (bool *)GamesmanCallocWhole(n, sizeof(bool));
+    if ((n > 0 && entries == NULL) || (n > 0 && found == NULL)) {
+        GamesmanFree(entries);
+        GamesmanFree(found);
+        return kMallocFailureError;
+    }
+
+    // File metadata requests are independent and mostly wait on the file
+    // system, so they are issued from all threads.
+    PRAGMA_OMP_PARALLEL_FOR_SCHEDULE_DYNAMIC(256)
+    for (int64_t i = 0; i < n; ++i) {
+        char *full_path = GetFullPathToFile(tiers[i], CurrentGetTierName);
+        struct stat st;
+        if (full_path == NULL || stat(full_path, &st) != 0) {
+            GamesmanFree(full_path);
+            continue;
+        }
+        GamesmanFree(full_path);
+        entries[i] = (TierManifestEntry){
+            .tier = tiers[i],
+            .size = sizes[i],
+            .compressed_size = st.st_size,
+            .timestamp = (int64_t)st.st_mtime,
+            .checksum = 0,  // Unknown without decompressing the file.
+            .codec = kTierManifestCodecXz,
+        };
+        found[i] = true;
+    }
+
+    // Compact the entries of the tiers found in place.
+    int64_t num_found = 0;
+    for (int64_t i = 0; i < n; ++i) {
+        if (found[i]) entries[num_found++] = entries[i];
+    }
+    int error = TierManifestRewrite(&manifest, num_found, entries);
+    GamesmanFree(entries);
+    GamesmanFree(found);
+    if (error != kNoError) return error;
+    use_manifest = true;
+
+    return kNoError;
+}
+
+/**
+ * @brief Appends the files of the tiers in TIERS that exist in the per-tier
+ * layout but are missing from TARGET to the segment files of TARGET.
+ */
+static int PackTierFiles(TierSegments *target, int64_t n, const Tier *tiers) {
+    for (int64_t i = 0; i < n; ++i) {
+        if (TierSegmentsFind(target, tiers[i]) != NULL) continue;
+
+        char *full_path = GetFullPathToFile(tiers[i], CurrentGetTierName);
+        if (full_path == NULL) return kMallocFailureError;
+
+        int error = kNoError;
+        if (FileExists(full_path)) {
+            error = TierSegmentsAppendFile(target, tiers[i], full_path,
+                                           kTierManifestCodecXz);
+        }
+        GamesmanFree(full_path);
+        if (error != kNoError) return error;
+    }
+
+    return kNoError;
+}
+
+/**
+ * @brief Packs the tier files of a database in the per-tier layout into segment
+ * files under a partial index, and then renames the partial index into place,
+ * which switches the database to the packed layout atomically. An interrupted
+ * conversion resumes from the partial index.
+ */
+static int ConvertToPackedLayout(int64_t n, const Tier *tiers) {
+    static const char kPartialIndexName[] = "segments.idx.partial";
+    TierSegments partial;
+    int error = TierSegmentsInit(&partial, sandbox_path, kPartialIndexName);
+    if (error != kNoError) return error;
+
+    error = TierSegmentsLoad(&partial);
+    if (error == kNoError || error == kFileSystemError) {
+        error = PackTierFiles(&partial, n, tiers);
+    }
+    TierSegmentsDestroy(&partial);
+    if (error != kNoError) return error;
+
+    // The partial index does not exist if there was nothing to pack.
+    char *partial_path = GetFullPathToSandboxFile(kPartialIndexName);
+    char *index_path = GetFullPathToSandboxFile(kTierSegmentsIndexName);
+    if (partial_path == NULL || index_path == NULL) {
+        error = kMallocFailureError;
+    } else if (!FileExists(partial_path)) {
+        FILE *index_file = GuardedFopen(index_path, "ab");
+        if (index_file == NULL || GuardedFclose(index_file) != 0) {
+            error = kFileSystemError;
+        }
+    } else if (GuardedRename(partial_path, index_path) != 0 ||
+               GuardedSyncDirectory(sandbox_path) != 0) {
+        error = kFileSystemError;
+    }
+    GamesmanFree(partial_path);
+    GamesmanFree(index_path);
+    if (error != kNoError) return error;
+
+    TierSegmentsDestroy(&segments);
+    TierManifestDestroy(&manifest);
+    error = InitLayout();
+    if (error != kNoError) return error;
+
+    return use_segments ? kNoError : kFileSystemError;
+}
+
+static int ArrayDbPackTiers(int64_t n, const Tier *tiers) {
+    int error = use_segments ? PackTierFiles(&segments, n, tiers)
+                             : ConvertToPackedLayout(n, tiers);
+    if (error != kNoError) return error;
+
+    // Reclaim the streams left behind by tiers solved again since.
+    error = TierSegmentsCompact(&segments);
+    if (error != kNoError) return error;
+
+    // Remove the tier files only after their tiers have been indexed. A tier
+    // file left behind by an interruption is removed by the next call.
+    for (int64_t i = 0; i < n; ++i) {
+        if (TierSegmentsFind(&segments, tiers[i]) == NULL) continue;
+
+        char *full_path = GetFullPathToFile(tiers[i], CurrentGetTierName);
+        if (full_path == NULL) return kMallocFailureError;
+        if (FileExists(full_path)) error = GuardedRemove(full_path);
+        GamesmanFree(full_path);
+        if (error != kNoError) return kFileSystemError;
+    }
+
+    // The segment index replaces the manifest.
+    char *manifest_path = GetFullPathToManifest();
+    if (manifest_path == NULL) return kMallocFailureError;
+    if (FileExists(manifest_path)) error = GuardedRemove(manifest_path);
+    GamesmanFree(manifest_path);
+
+    return error == kNoError ? kNoError : kFileSystemError;
+}
+
 static int ArrayDbGameStatus(void) {
     char *full_path = GetFullPathToFinishFlag();
     if (full_path == NULL) return kDbGameStatusCheckError;
@@ -0,0 +1,198 @@
+/**
+ * @file tier_flusher.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the background compression stage of the Array
+ * Database.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/db/arraydb/tier_flusher.h"
+
+#include <pthread.h>  // pthread_*
+#include <stdbool.h>  // bool, true, false
+#include <stddef.h>   // NULL
+#include <stdint.h>   // int64_t, intptr_t
+#include <stdio.h>    // fprintf, stderr
+#include <string.h>   // memset, strcpy, strlen
+
+#include "core/db/arraydb/record_array.h"
+#include "core/gamesman_memory.h"
+#include "core/types/gamesman_types.h"
+
+static void *FlusherMain(void *arg);
+static void ProcessJob(TierFlusher *flusher, TierFlushJob *job);
+static void Enqueue(TierFlushJob **head, TierFlushJob **tail,
+                    TierFlushJob *job);
+static TierFlushJob *Dequeue(TierFlushJob **head, TierFlushJob **tail);
+
+// -----------------------------------------------------------------------------
+
+TierFlushJob *TierFlushJobCreate(Tier tier, ReadOnlyString path) {
+    TierFlushJob *job = (TierFlushJob *)GamesmanMalloc(sizeof(TierFlushJob));
+    if (job == NULL) return NULL;
+
+    memset(job, 0, sizeof(*job));
+    job->path = (char *)GamesmanMalloc(strlen(path) + 1);
+    if (job->path == NULL) {
+        GamesmanFree(job);
+        return NULL;
+    }
+
+    strcpy(job->path, path);
+    job->tier = tier;
+    job->compressed_size = -1;
+
+    return job;
+}
+
+void TierFlushJobDestroy(TierFlushJob *job) {
+    if (job == NULL) return;
+
+    RecordArrayDestroy(&job->records);
+    GamesmanFree(job->path);
+    GamesmanFree(job);
+}
+
+int TierFlusherInit(TierFlusher *flusher, intptr_t budget,
+                    TierFlushFunc flush) {
+    memset(flusher, 0, sizeof(*flusher));
+    flusher->Flush = flush;
+    flusher->budget = budget;
+    pthread_mutex_init(&flusher->mutex, NULL);
+    pthread_cond_init(&flusher->cond, NULL);
+    if (pthread_create(&flusher->thread, NULL, FlusherMain, flusher) != 0) {
+        fprintf(stderr,
+                "TierFlusherInit: failed to start the background thread\n");
+        pthread_cond_destroy(&flusher->cond);
+        pthread_mutex_destroy(&flusher->mutex);
+        return kRuntimeError;
+    }
+
+    return kNoError;
+}
+
+void TierFlusherDestroy(TierFlusher *flusher) {
+    pthread_mutex_lock(&flusher->mutex);
+    flusher->stop = true;
+    pthread_cond_broadcast(&flusher->cond);
+    pthread_mutex_unlock(&flusher->mutex);
+    pthread_join(flusher->thread, NULL);
+
+    TierFlushJob *job;
+    while ((job = Dequeue(&flusher->finished_head, &flusher->finished_tail))) {
+        TierFlushJobDestroy(job);
+    }
+    pthread_cond_destroy(&flusher->cond);
+    pthread_mutex_destroy(&flusher->mutex);
+    memset(flusher, 0, sizeof(*flusher));
+}
+
+void TierFlusherSubmit(TierFlusher *flusher, TierFlushJob *job) {
+    intptr_t mem = (intptr_t)RecordArrayGetRawSize(&job->records);
+    pthread_mutex_lock(&flusher->mutex);
+    ++flusher->num_outstanding;
+    if (mem > flusher->budget) {
+        // Too large to hold in the background. Its records are already
+        // accounted for by the caller, so flush it right here.
+        pthread_mutex_unlock(&flusher->mutex);
+        ProcessJob(flusher, job);
+        return;
+    }
+
+    while (flusher->mem_held + mem > flusher->budget) {
+        pthread_cond_wait(&flusher->cond, &flusher->mutex);
+    }
+    flusher->mem_held += mem;
+    Enqueue(&flusher->pending_head, &flusher->pending_tail, job);
+    pthread_cond_broadcast(&flusher->cond);
+    pthread_mutex_unlock(&flusher->mutex);
+}
+
+TierFlushJob *TierFlusherPop(TierFlusher *flusher, bool wait) {
+    pthread_mutex_lock(&flusher->mutex);
+    while (wait && flusher->finished_head == NULL &&
+           flusher->num_outstanding > 0) {
+        pthread_cond_wait(&flusher->cond, &flusher->mutex);
+    }
+    TierFlushJob *job =
+        Dequeue(&flusher->finished_head, &flusher->finished_tail);
+    if (job != NULL) --flusher->num_outstanding;
+    pthread_mutex_unlock(&flusher->mutex);
+
+    return job;
+}
+
+// -----------------------------------------------------------------------------
+
+static void *FlusherMain(void *arg) {
+    TierFlusher *flusher = (TierFlusher *)arg;
+    pthread_mutex_lock(&flusher->mutex);
+    while (true) {
+        while (flusher->pending_head == NULL && !flusher->stop) {
+            pthread_cond_wait(&flusher->cond, &flusher->mutex);
+        }
+        TierFlushJob *job =
+            Dequeue(&flusher->pending_head, &flusher->pending_tail);
+        if (job == NULL) break;  // Stopped with no pending jobs.
+
+        intptr_t mem = (intptr_t)RecordArrayGetRawSize(&job->records);
+        pthread_mutex_unlock(&flusher->mutex);
+        ProcessJob(flusher, job);
+        pthread_mutex_lock(&flusher->mutex);
+        flusher->mem_held -= mem;
+        pthread_cond_broadcast(&flusher->cond);
+    }
+    pthread_mutex_unlock(&flusher->mutex);
+
+    return NULL;
+}
+
+static void ProcessJob(TierFlusher *flusher, TierFlushJob *job) {
+    flusher->Flush(job);
+    RecordArrayDestroy(&job->records);
+
+    pthread_mutex_lock(&flusher->mutex);
+    Enqueue(&flusher->finished_head, &flusher->finished_tail, job);
+    pthread_cond_broadcast(&flusher->cond);
+    pthread_mutex_unlock(&flusher->mutex);
+}
+
+static void Enqueue(TierFlushJob **head, TierFlushJob **tail,
+                    TierFlushJob *job) {
+    job->next = NULL;
+    if (*tail == NULL) {
+        *head = job;
+    } else {
+        (*tail)->next = job;
+    }
+    *tail = job;
+}
+
+static TierFlushJob *Dequeue(TierFlushJob **head, TierFlushJob **tail) {
+    TierFlushJob *job = *head;
+    if (job == NULL) return NULL;
+
+    *head = job->next;
+    if (*head == NULL) *tail = NULL;
+    job->next = NULL;
+
+    return job;
+}
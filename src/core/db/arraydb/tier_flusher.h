@@ -0,0 +1,134 @@
+/**
+ * @file tier_flusher.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Background compression stage of the Array Database, which writes the
+ * records of solved tiers to storage while the solver moves on to the next
+ * tier.
+ * @details Flushing a tier compresses its whole record array, which takes a
+ * significant fraction of the time to solve a large tier. The flusher takes
+ * ownership of the record arrays of finished tiers and processes them in
+ * submission order on a background thread, keeping the total size of the
+ * record arrays it holds within a memory budget. Processed jobs are handed back
+ * to the submitting thread, which is responsible for committing them.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_DB_ARRAYDB_TIER_FLUSHER_H_
+#define GAMESMANONE_CORE_DB_ARRAYDB_TIER_FLUSHER_H_
+
+#include <pthread.h>  // pthread_t, pthread_mutex_t, pthread_cond_t
+#include <stdbool.h>  // bool
+#include <stdint.h>   // int32_t, int64_t, intptr_t, uint64_t
+
+#include "core/db/arraydb/record_array.h"
+#include "core/types/gamesman_types.h"
+
+/** @brief A solved tier to be written to storage. */
+typedef struct TierFlushJob {
+    Tier tier;           /**< The solved tier. */
+    int64_t size;        /**< Size of TIER in number of positions. */
+    RecordArray records; /**< Records of TIER, freed once processed. */
+    char *path;          /**< Path to the output file, owned by the job. */
+
+    int64_t compressed_size; /**< Set by the flush function. */
+    uint64_t checksum;       /**< Set by the flush function. */
+    int error;               /**< Set by the flush function. */
+
+    /** Segment file and offset of the stream, set by flush functions that
+     * write to segment files instead of PATH. */
+    int32_t segment;
+    int64_t offset;
+
+    struct TierFlushJob *next;
+} TierFlushJob;
+
+/**
+ * @brief Writes the records of JOB to storage, sets the output fields of JOB,
+ * and returns JOB->error. Called on the background thread, so it must not
+ * modify any state shared with the submitting thread.
+ */
+typedef int (*TierFlushFunc)(TierFlushJob *job);
+
+/** @brief Background compression stage with a bounded memory budget. */
+typedef struct TierFlusher {
+    // Private members.
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    TierFlushFunc Flush;
+    TierFlushJob *pending_head, *pending_tail;
+    TierFlushJob *finished_head, *finished_tail;
+    int64_t num_outstanding;
+    intptr_t budget;
+    intptr_t mem_held;
+    bool stop;
+} TierFlusher;
+
+/**
+ * @brief Allocates a new job for TIER writing to a copy of PATH with no
+ * records, or returns NULL if out of memory.
+ */
+TierFlushJob *TierFlushJobCreate(Tier tier, ReadOnlyString path);
+
+/** @brief Destroys JOB and frees its records, if any. */
+void TierFlushJobDestroy(TierFlushJob *job);
+
+/**
+ * @brief Initializes FLUSHER and starts its background thread, which processes
+ * the submitted jobs using FLUSH.
+ *
+ * @param flusher Flusher to initialize.
+ * @param budget Maximum total size in bytes of the record arrays held by
+ * FLUSHER.
+ * @param flush Function that writes a job to storage.
+ * @return kNoError on success, or
+ * @return kRuntimeError if the background thread cannot be started.
+ */
+int TierFlusherInit(TierFlusher *flusher, intptr_t budget, TierFlushFunc flush);
+
+/**
+ * @brief Waits for all submitted jobs to be processed, stops the background
+ * thread of FLUSHER, and destroys the processed jobs that have not been
+ * popped.
+ */
+void TierFlusherDestroy(TierFlusher *flusher);
+
+/**
+ * @brief Hands JOB over to FLUSHER, which takes ownership of it, blocking
+ * until FLUSHER has room for its records. A job whose records exceed the
+ * budget on their own is processed on the calling thread instead.
+ */
+void TierFlusherSubmit(TierFlusher *flusher, TierFlushJob *job);
+
+/**
+ * @brief Removes and returns the earliest processed job of FLUSHER, which the
+ * caller then owns.
+ *
+ * @param flusher Flusher to pop from.
+ * @param wait If true and no job has been processed yet, waits for the next
+ * job to finish.
+ * @return The earliest processed job, or
+ * @return NULL if no job has been processed and WAIT is false, or if there are
+ * no outstanding jobs.
+ */
+TierFlushJob *TierFlusherPop(TierFlusher *flusher, bool wait);
+
+#endif  // GAMESMANONE_CORE_DB_ARRAYDB_TIER_FLUSHER_H_
@@ -0,0 +1,270 @@
+/**
+ * @file tier_manifest.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the manifest of solved tiers.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/db/arraydb/tier_manifest.h"
+
+#include <fcntl.h>     // open, O_*
+#include <inttypes.h>  // PRId64
+#include <stdbool.h>   // bool, true, false
+#include <stddef.h>    // NULL, offsetof, size_t
+#include <stdint.h>    // int64_t, uint64_t
+#include <stdio.h>     // FILE, fread, perror, printf, remove, snprintf
+#include <string.h>    // memcpy, strcpy, strlen
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close, fdatasync, ftruncate, write
+
+#include "core/gamesman_memory.h"
+#include "core/misc.h"
+#include "core/types/gamesman_types.h"
+
+enum {
+    kTierManifestVersion = 1,
+
+    // Number of entries read from the manifest file at a time.
+    kTierManifestReadBatchSize = 4096,
+};
+
+// Seeds the entry checksum so that a region of zeros is not a valid entry.
+static const uint64_t kEntryChecksumSeed = 0x474d41444246535aULL;
+static const uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+static const uint64_t kFnvPrime = 1099511628211ULL;
+
+static uint64_t Checksum(const void *data, size_t size, uint64_t hash);
+static uint64_t EntryChecksum(const TierManifestEntry *entry);
+static bool EntryIsValid(const TierManifestEntry *entry);
+static void SealEntry(TierManifestEntry *entry);
+static int TruncateTornEntries(TierManifest *manifest, int fd);
+
+// -----------------------------------------------------------------------------
+
+int TierManifestInit(TierManifest *manifest, ReadOnlyString path) {
+    manifest->path = (char *)GamesmanMalloc(strlen(path) + 1);
+    if (manifest->path == NULL) return kMallocFailureError;
+
+    strcpy(manifest->path, path);
+    TierHashSetInit(&manifest->solved, 0.5);
+    manifest->loaded_size = 0;
+    manifest->valid_size = 0;
+
+    return kNoError;
+}
+
+void TierManifestDestroy(TierManifest *manifest) {
+    GamesmanFree(manifest->path);
+    manifest->path = NULL;
+    TierHashSetDestroy(&manifest->solved);
+}
+
+int TierManifestLoad(TierManifest *manifest) {
+    // A missing manifest is expected for new and legacy databases, so fopen()
+    // is used instead of GuardedFopen() to avoid printing an error.
+    FILE *file = fopen(manifest->path, "rb");
+    if (file == NULL) return kFileSystemError;
+
+    TierManifestEntry *entries = (TierManifestEntry *)GamesmanMalloc(
+        kTierManifestReadBatchSize * sizeof(TierManifestEntry));
+    if (entries == NULL) {
+        fclose(file);
+        return kMallocFailureError;
+    }
+
+    int error = kNoError;
+    int64_t num_valid = 0;
+    bool torn = false;
+    size_t n;
+    while (!torn && (n = fread(entries, sizeof(TierManifestEntry),
+                               kTierManifestReadBatchSize, file)) > 0) {
+        for (size_t i = 0; i < n; ++i) {
+            if (!EntryIsValid(&entries[i])) {
+                torn = true;
+                break;
+            }
+            if (!TierHashSetAdd(&manifest->solved, entries[i].tier)) {
+                error = kMallocFailureError;
+                goto _bailout;
+            }
+            ++num_valid;
+        }
+    }
+    if (ferror(file)) {
+        error = kFileSystemError;
+        goto _bailout;
+    }
+
+    struct stat st;
+    if (fstat(fileno(file), &st) != 0) {
+        error = kFileSystemError;
+        goto _bailout;
+    }
+    manifest->loaded_size = st.st_size;
+    manifest->valid_size = num_valid * (int64_t)sizeof(TierManifestEntry);
+    if (manifest->valid_size != manifest->loaded_size) {
+        printf("Ignoring %" PRId64 " bytes of incomplete entries at the end of "
+               "[%s]\n",
+               manifest->loaded_size - manifest->valid_size, manifest->path);
+    }
+
+_bailout:
+    GamesmanFree(entries);
+    fclose(file);
+
+    return error;
+}
+
+bool TierManifestContains(const TierManifest *manifest, Tier tier) {
+    return TierHashSetContains(&manifest->solved, tier);
+}
+
+int TierManifestAppend(TierManifest *manifest, TierManifestEntry *entry) {
+    SealEntry(entry);
+    int fd = open(manifest->path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        perror("open");
+        return kFileSystemError;
+    }
+
+    int error = TruncateTornEntries(manifest, fd);
+    if (error != kNoError) return BailOutClose(fd, error);
+
+    ssize_t written = write(fd, entry, sizeof(*entry));
+    if (written != (ssize_t)sizeof(*entry) || fdatasync(fd) != 0) {
+        perror("write");
+        return BailOutClose(fd, kFileSystemError);
+    }
+    if (GuardedClose(fd) != 0) return kFileSystemError;
+    if (!TierHashSetAdd(&manifest->solved, entry->tier)) {
+        return kMallocFailureError;
+    }
+
+    return kNoError;
+}
+
+int TierManifestRewrite(TierManifest *manifest, int64_t n,
+                        TierManifestEntry *entries) {
+    for (int64_t i = 0; i < n; ++i) {
+        SealEntry(&entries[i]);
+    }
+
+    size_t tmp_path_size = strlen(manifest->path) + sizeof(".tmp");
+    char *tmp_path = (char *)GamesmanMalloc(tmp_path_size);
+    if (tmp_path == NULL) return kMallocFailureError;
+    snprintf(tmp_path, tmp_path_size, "%s.tmp", manifest->path);
+
+    int error = kFileSystemError;
+    FILE *file = GuardedFopen(tmp_path, "wb");
+    if (file == NULL) goto _bailout;
+    if (n > 0) {
+        error = GuardedFwrite(entries, sizeof(TierManifestEntry), n, file);
+        if (error != 0) goto _bailout_close;
+    }
+    if (fflush(file) != 0 || fdatasync(fileno(file)) != 0) {
+        error = kFileSystemError;
+        goto _bailout_close;
+    }
+    error = GuardedFclose(file);
+    if (error != 0) goto _bailout;
+    error = GuardedRename(tmp_path, manifest->path);
+    if (error != 0) goto _bailout;
+    GamesmanFree(tmp_path);
+
+    TierHashSetDestroy(&manifest->solved);
+    TierHashSetInit(&manifest->solved, 0.5);
+    for (int64_t i = 0; i < n; ++i) {
+        if (!TierHashSetAdd(&manifest->solved, entries[i].tier)) {
+            return kMallocFailureError;
+        }
+    }
+    manifest->loaded_size = n * (int64_t)sizeof(TierManifestEntry);
+    manifest->valid_size = manifest->loaded_size;
+
+    return kNoError;
+
+_bailout_close:
+    BailOutFclose(file, error);
+_bailout:
+    remove(tmp_path);
+    GamesmanFree(tmp_path);
+
+    return kFileSystemError;
+}
+
+uint64_t TierManifestChecksum(const void *data, size_t size) {
+    return Checksum(data, size, kFnvOffsetBasis);
+}
+
+// -----------------------------------------------------------------------------
+
+// 64-bit FNV-1a over 8-byte words, followed by the remaining bytes.
+static uint64_t Checksum(const void *data, size_t size, uint64_t hash) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash ^= word;
+        hash *= kFnvPrime;
+    }
+    for (; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= kFnvPrime;
+    }
+
+    return hash;
+}
+
+static uint64_t EntryChecksum(const TierManifestEntry *entry) {
+    return Checksum(entry, offsetof(TierManifestEntry, entry_checksum),
+                    kEntryChecksumSeed);
+}
+
+static bool EntryIsValid(const TierManifestEntry *entry) {
+    return entry->version == kTierManifestVersion &&
+           entry->entry_checksum == EntryChecksum(entry);
+}
+
+static void SealEntry(TierManifestEntry *entry) {
+    entry->version = kTierManifestVersion;
+    entry->entry_checksum = EntryChecksum(entry);
+}
+
+/**
+ * @brief Truncates the manifest file open at FD to its valid entries if it
+ * ended with a torn entry when it was loaded and has not been appended to
+ * since. Appending after a torn entry would misalign all later entries.
+ */
+static int TruncateTornEntries(TierManifest *manifest, int fd) {
+    if (manifest->valid_size == manifest->loaded_size) return kNoError;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) return kFileSystemError;
+    if (st.st_size == manifest->loaded_size &&
+        ftruncate(fd, manifest->valid_size) != 0) {
+        perror("ftruncate");
+        return kFileSystemError;
+    }
+    manifest->loaded_size = manifest->valid_size;
+
+    return kNoError;
+}
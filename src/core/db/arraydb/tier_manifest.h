@@ -0,0 +1,141 @@
+/**
+ * @file tier_manifest.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Append-only manifest of the tiers solved into an Array Database.
+ * @details Checking whether a tier has been solved by opening its DB file
+ * takes one metadata request per tier, which is slow on parallel file systems
+ * when repeated for millions of tiers. Instead, the Array Database appends an
+ * entry to the manifest file in its sandbox directory each time a tier file is
+ * written, and loads all entries into memory once when initialized.
+ *
+ * The manifest file is a sequence of fixed-size entries, each carrying its own
+ * checksum. An entry is only appended after its tier file has been renamed into
+ * place, so a crash at any point either leaves the tier unrecorded, in which
+ * case it is solved again, or leaves a torn entry at the end of the file, which
+ * is discarded by the next load.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_DB_ARRAYDB_TIER_MANIFEST_H_
+#define GAMESMANONE_CORE_DB_ARRAYDB_TIER_MANIFEST_H_
+
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+#include <stdint.h>   // int64_t, int32_t, uint64_t
+
+#include "core/types/gamesman_types.h"
+
+/** @brief Compression formats of tier files recorded in the manifest. */
+enum TierManifestCodec {
+    kTierManifestCodecXz = 1, /**< XZ with random access (XZRA). */
+};
+
+/** @brief An entry of the manifest, recording one solved tier. */
+typedef struct TierManifestEntry {
+    Tier tier;               /**< The solved tier. */
+    int64_t size;            /**< Size of TIER in number of positions. */
+    int64_t compressed_size; /**< Size of the tier file in bytes. */
+    int64_t timestamp;       /**< Time the tier file was written. */
+
+    /** Checksum of the uncompressed records, or 0 if unknown. */
+    uint64_t checksum;
+
+    int32_t codec;   /**< One of the TierManifestCodec values. */
+    int32_t version; /**< Manifest format version, set by the manifest. */
+
+    /** Checksum of all the fields above, set by the manifest. */
+    uint64_t entry_checksum;
+} TierManifestEntry;
+
+/** @brief In-memory set of solved tiers backed by a manifest file. */
+typedef struct TierManifest {
+    TierHashSet solved; /**< Tiers recorded in the manifest file. */
+
+    // Private members.
+    char *path;
+    int64_t loaded_size;
+    int64_t valid_size;
+} TierManifest;
+
+/**
+ * @brief Initializes MANIFEST to an empty manifest backed by the file at PATH
+ * without reading the file.
+ *
+ * @return kNoError on success, or
+ * @return kMallocFailureError if out of memory.
+ */
+int TierManifestInit(TierManifest *manifest, ReadOnlyString path);
+
+/** @brief Destroys MANIFEST. The manifest file is not affected. */
+void TierManifestDestroy(TierManifest *manifest);
+
+/**
+ * @brief Adds the tiers of all valid entries in the manifest file of MANIFEST
+ * to MANIFEST->solved. Reading stops at the first invalid entry, which is
+ * removed together with everything after it by the next call to
+ * TierManifestAppend().
+ *
+ * @return kNoError on success, or
+ * @return kFileSystemError if the manifest file does not exist or cannot be
+ * read, or
+ * @return kMallocFailureError if out of memory.
+ */
+int TierManifestLoad(TierManifest *manifest);
+
+/** @brief Returns whether TIER is recorded in MANIFEST. */
+bool TierManifestContains(const TierManifest *manifest, Tier tier);
+
+/**
+ * @brief Fills in the version and entry checksum of ENTRY, appends it to the
+ * manifest file of MANIFEST, creating the file if it does not exist, and adds
+ * its tier to MANIFEST->solved. Returns only after the entry has been written
+ * to storage.
+ *
+ * @note A single entry is written with a single write(2) call on a file opened
+ * in append mode, so processes sharing a manifest file on a local file system
+ * do not interleave their entries.
+ *
+ * @return kNoError on success, or
+ * @return kFileSystemError on file system error, or
+ * @return kMallocFailureError if out of memory.
+ */
+int TierManifestAppend(TierManifest *manifest, TierManifestEntry *entry);
+
+/**
+ * @brief Replaces the manifest file of MANIFEST with the N entries in ENTRIES,
+ * filling in their versions and entry checksums, and replaces the contents of
+ * MANIFEST->solved with their tiers. The old file is kept if writing the new
+ * one fails.
+ *
+ * @return kNoError on success, or
+ * @return kFileSystemError on file system error, or
+ * @return kMallocFailureError if out of memory.
+ */
+int TierManifestRewrite(TierManifest *manifest, int64_t n,
+                        TierManifestEntry *entries);
+
+/**
+ * @brief Returns the checksum of the SIZE bytes of DATA to be stored in
+ * TierManifestEntry::checksum.
+ */
+uint64_t TierManifestChecksum(const void *data, size_t size);
+
+#endif  // GAMESMANONE_CORE_DB_ARRAYDB_TIER_MANIFEST_H_
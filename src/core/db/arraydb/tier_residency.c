@@ -0,0 +1,210 @@
+/**
+ * @file tier_residency.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the reference-counted set of the tiers loaded by
+ * the Array Database.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/db/arraydb/tier_residency.h"
+
+#include <stdbool.h>  // bool, true, false
+#include <stddef.h>   // NULL
+#include <stdint.h>   // intptr_t, int64_t
+#include <string.h>   // memset
+
+#include "core/db/arraydb/record_array.h"
+#include "core/gamesman_memory.h"
+#include "core/types/gamesman_types.h"
+
+static ResidentTier *Find(const TierResidency *residency, Tier tier);
+static void LruUnlink(TierResidency *residency, ResidentTier *entry);
+static void LruAppend(TierResidency *residency, ResidentTier *entry);
+static void ReferencedPush(TierResidency *residency, ResidentTier *entry);
+static void ReferencedUnlink(TierResidency *residency, ResidentTier *entry);
+static void Free(TierResidency *residency, ResidentTier *entry);
+static void EvictToBudget(TierResidency *residency);
+
+// -----------------------------------------------------------------------------
+
+void TierResidencyInit(TierResidency *residency) {
+    memset(residency, 0, sizeof(*residency));
+    TierHashMapSCInit(&residency->index, 0.5);
+}
+
+void TierResidencyDestroy(TierResidency *residency) {
+    TierResidencySetBudget(residency, 0);
+    while (residency->referenced != NULL) {
+        ResidentTier *entry = residency->referenced;
+        ReferencedUnlink(residency, entry);
+        Free(residency, entry);
+    }
+    TierHashMapSCDestroy(&residency->index);
+    memset(residency, 0, sizeof(*residency));
+}
+
+void TierResidencySetBudget(TierResidency *residency, intptr_t budget) {
+    residency->budget = budget;
+    EvictToBudget(residency);
+}
+
+bool TierResidencyAcquire(TierResidency *residency, Tier tier) {
+    ResidentTier *entry = Find(residency, tier);
+    if (entry == NULL) return false;
+
+    if (entry->ref_count++ == 0) {
+        LruUnlink(residency, entry);
+        residency->released_mem -= RecordArrayGetRawSize(&entry->records);
+        ReferencedPush(residency, entry);
+    }
+
+    return true;
+}
+
+int TierResidencyInsert(TierResidency *residency, Tier tier,
+                        RecordArray *records) {
+    ResidentTier *entry = (ResidentTier *)GamesmanMalloc(sizeof(ResidentTier));
+    if (entry == NULL) {
+        RecordArrayDestroy(records);
+        return kMallocFailureError;
+    }
+
+    memset(entry, 0, sizeof(*entry));
+    entry->tier = tier;
+    entry->records = *records;
+    entry->ref_count = 1;
+    memset(records, 0, sizeof(*records));
+    if (!TierHashMapSCSet(&residency->index, tier, (int64_t)(intptr_t)entry)) {
+        RecordArrayDestroy(&entry->records);
+        GamesmanFree(entry);
+        return kMallocFailureError;
+    }
+    ReferencedPush(residency, entry);
+
+    return kNoError;
+}
+
+int TierResidencyRelease(TierResidency *residency, Tier tier) {
+    ResidentTier *entry = Find(residency, tier);
+    if (entry == NULL || entry->ref_count <= 0) return kRuntimeError;
+    if (--entry->ref_count > 0) return kNoError;
+
+    ReferencedUnlink(residency, entry);
+    intptr_t mem = RecordArrayGetRawSize(&entry->records);
+    if (mem > residency->budget) {
+        Free(residency, entry);
+        return kNoError;
+    }
+
+    LruAppend(residency, entry);
+    residency->released_mem += mem;
+    EvictToBudget(residency);
+
+    return kNoError;
+}
+
+const RecordArray *TierResidencyGet(const TierResidency *residency,
+                                    Tier tier) {
+    const ResidentTier *entry = Find(residency, tier);
+    if (entry == NULL || entry->ref_count <= 0) return NULL;
+
+    return &entry->records;
+}
+
+bool TierResidencyContains(const TierResidency *residency, Tier tier) {
+    return Find(residency, tier) != NULL;
+}
+
+void TierResidencyEvict(TierResidency *residency, Tier tier) {
+    ResidentTier *entry = Find(residency, tier);
+    if (entry == NULL || entry->ref_count > 0) return;
+
+    LruUnlink(residency, entry);
+    residency->released_mem -= RecordArrayGetRawSize(&entry->records);
+    Free(residency, entry);
+}
+
+// -----------------------------------------------------------------------------
+
+static ResidentTier *Find(const TierResidency *residency, Tier tier) {
+    int64_t value;
+    if (!TierHashMapSCGet(&residency->index, tier, &value)) return NULL;
+
+    return (ResidentTier *)(intptr_t)value;
+}
+
+static void LruUnlink(TierResidency *residency, ResidentTier *entry) {
+    if (entry->prev == NULL) {
+        residency->lru_head = entry->next;
+    } else {
+        entry->prev->next = entry->next;
+    }
+    if (entry->next == NULL) {
+        residency->lru_tail = entry->prev;
+    } else {
+        entry->next->prev = entry->prev;
+    }
+    entry->prev = entry->next = NULL;
+}
+
+static void LruAppend(TierResidency *residency, ResidentTier *entry) {
+    entry->prev = residency->lru_tail;
+    entry->next = NULL;
+    if (residency->lru_tail == NULL) {
+        residency->lru_head = entry;
+    } else {
+        residency->lru_tail->next = entry;
+    }
+    residency->lru_tail = entry;
+}
+
+static void ReferencedPush(TierResidency *residency, ResidentTier *entry) {
+    entry->prev = NULL;
+    entry->next = residency->referenced;
+    if (residency->referenced != NULL) residency->referenced->prev = entry;
+    residency->referenced = entry;
+}
+
+static void ReferencedUnlink(TierResidency *residency, ResidentTier *entry) {
+    if (entry->prev == NULL) {
+        residency->referenced = entry->next;
+    } else {
+        entry->prev->next = entry->next;
+    }
+    if (entry->next != NULL) entry->next->prev = entry->prev;
+    entry->prev = entry->next = NULL;
+}
+
+// Frees ENTRY, which must not be in either list.
+static void Free(TierResidency *residency, ResidentTier *entry) {
+    TierHashMapSCRemove(&residency->index, entry->tier);
+    RecordArrayDestroy(&entry->records);
+    GamesmanFree(entry);
+}
+
+static void EvictToBudget(TierResidency *residency) {
+    while (residency->released_mem > residency->budget) {
+        ResidentTier *victim = residency->lru_head;
+        LruUnlink(residency, victim);
+        residency->released_mem -= RecordArrayGetRawSize(&victim->records);
+        Free(residency, victim);
+    }
+}
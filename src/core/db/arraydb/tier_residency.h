@@ -0,0 +1,116 @@
+/**
+ * @file tier_residency.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Reference-counted set of the tiers loaded by the Array Database,
+ * which keeps recently released tiers decompressed within a memory budget.
+ * @details Solvers load every child tier of the tier being solved and release
+ * them once the tier is solved. Sibling tiers usually share most of their child
+ * tiers, so a released tier is likely to be loaded again soon. Released tiers
+ * are kept in least-recently-used order and evicted once the total size of
+ * their record arrays exceeds the budget, or when the caller knows that they
+ * will not be loaded again.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_DB_ARRAYDB_TIER_RESIDENCY_H_
+#define GAMESMANONE_CORE_DB_ARRAYDB_TIER_RESIDENCY_H_
+
+#include <stdbool.h>  // bool
+#include <stdint.h>   // intptr_t
+
+#include "core/db/arraydb/record_array.h"
+#include "core/types/gamesman_types.h"
+
+/** @brief A tier whose records are in memory. */
+typedef struct ResidentTier {
+    Tier tier;
+    RecordArray records;
+    int ref_count; /**< Number of loads not yet released. */
+
+    /** Neighbors in the list of referenced tiers or of released tiers. */
+    struct ResidentTier *prev, *next;
+} ResidentTier;
+
+/** @brief Reference-counted set of loaded tiers. */
+typedef struct TierResidency {
+    // Private members.
+    TierHashMapSC index;      /**< Tier -> ResidentTier pointer. */
+    ResidentTier *referenced; /**< Tiers with at least one reference. */
+    ResidentTier *lru_head;   /**< Least recently released tier. */
+    ResidentTier *lru_tail;   /**< Most recently released tier. */
+    intptr_t budget;          /**< Maximum size in bytes of released tiers. */
+    intptr_t released_mem;    /**< Size in bytes of released tiers. */
+} TierResidency;
+
+/** @brief Initializes RESIDENCY with no tiers and a budget of 0. */
+void TierResidencyInit(TierResidency *residency);
+
+/** @brief Destroys RESIDENCY and all of its tiers. */
+void TierResidencyDestroy(TierResidency *residency);
+
+/**
+ * @brief Sets the maximum total size in bytes of the record arrays of the
+ * released tiers kept by RESIDENCY to BUDGET, evicting the least recently
+ * released tiers until it fits. A budget of 0 frees each tier as soon as it is
+ * released.
+ */
+void TierResidencySetBudget(TierResidency *residency, intptr_t budget);
+
+/**
+ * @brief Adds a reference to TIER if it is resident in RESIDENCY and returns
+ * true, or returns false if it is not.
+ */
+bool TierResidencyAcquire(TierResidency *residency, Tier tier);
+
+/**
+ * @brief Adds TIER with RECORDS to RESIDENCY with one reference. RESIDENCY
+ * takes ownership of RECORDS, which are destroyed on failure.
+ *
+ * @return kNoError on success, or
+ * @return kMallocFailureError if out of memory.
+ */
+int TierResidencyInsert(TierResidency *residency, Tier tier,
+                        RecordArray *records);
+
+/**
+ * @brief Removes a reference to TIER. The tier is kept in RESIDENCY as the
+ * most recently released tier once its last reference is removed, unless it
+ * does not fit in the budget.
+ *
+ * @return kNoError on success, or
+ * @return kRuntimeError if TIER is not referenced.
+ */
+int TierResidencyRelease(TierResidency *residency, Tier tier);
+
+/**
+ * @brief Returns the records of TIER if TIER is referenced, or NULL otherwise.
+ * Safe to call concurrently as long as no other function is called on
+ * RESIDENCY at the same time.
+ */
+const RecordArray *TierResidencyGet(const TierResidency *residency, Tier tier);
+
+/** @brief Returns whether TIER is resident in RESIDENCY. */
+bool TierResidencyContains(const TierResidency *residency, Tier tier);
+
+/** @brief Frees TIER if it has been released, or does nothing otherwise. */
+void TierResidencyEvict(TierResidency *residency, Tier tier);
+
+#endif  // GAMESMANONE_CORE_DB_ARRAYDB_TIER_RESIDENCY_H_
@@ -0,0 +1,606 @@
+/**
+ * @file tier_segments.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the packed layout of the Array Database.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/db/arraydb/tier_segments.h"
+
+#include <errno.h>      // errno, EEXIST, ENOENT
+#include <fcntl.h>      // open, O_*
+#include <stdbool.h>    // bool, true, false
+#include <stddef.h>     // NULL, offsetof, size_t
+#include <stdint.h>     // int64_t, int32_t, INT32_MAX
+#include <stdio.h>      // FILE, fopen, fread, fseeko, perror, remove
+#include <string.h>     // memset, strcpy, strlen
+#include <sys/stat.h>   // fstat
+#include <sys/types.h>  // off_t
+#include <unistd.h>     // close, fdatasync, ftruncate, pread, write
+
+#include "core/db/arraydb/tier_manifest.h"
+#include "core/gamesman_memory.h"
+#include "core/misc.h"
+#include "core/types/gamesman_types.h"
+
+const char kTierSegmentsIndexName[] = "segments.idx";
+
+enum {
+    // Number of index entries read from the index file at a time.
+    kTierSegmentsReadBatchSize = 4096,
+
+    // Size of the buffer used to copy tier files into segment files.
+    kTierSegmentsCopyBufferSize = 1 << 20,
+
+    // Maximum length of a segment file name: "segment_<int32>.xzs".
+    kTierSegmentFileNameLengthMax = 32,
+};
+
+// Name of the index written by TierSegmentsCompact() before it replaces the
+// index file.
+static const char kTierSegmentsCompactIndexName[] = "segments.idx.compact";
+
+// A new segment file is started once the current one reaches this size. A
+// single tier larger than this occupies a segment file of its own.
+static const int64_t kTierSegmentSizeMax = (int64_t)1 << 32;
+
+static uint64_t EntryChecksum(const TierSegmentEntry *entry);
+static bool EntryIsValid(const TierSegmentEntry *entry);
+static int AddEntry(TierSegments *segments, const TierSegmentEntry *entry);
+static int AppendEntry(TierSegments *segments, TierSegmentEntry *entry);
+static int SyncFile(ReadOnlyString path);
+static int WriteAll(int fd, const void *buf, size_t size);
+static int SyncAndClose(int fd, int error);
+static int CopyRange(int out_fd, ReadOnlyString path, int64_t offset,
+                     int64_t length, int64_t *copied);
+static int CopyLiveStreams(TierSegments *segments, TierSegments *compact);
+static int WriteIndex(const TierSegments *segments);
+static int RemoveUnusedSegments(const TierSegments *segments);
+
+// -----------------------------------------------------------------------------
+
+int TierSegmentsInit(TierSegments *segments, ReadOnlyString dir,
+                     ReadOnlyString index_name) {
+    memset(segments, 0, sizeof(*segments));
+    size_t dir_length = strlen(dir);
+    size_t index_path_size = dir_length + strlen(index_name) + 2;
+    segments->dir = (char *)GamesmanMalloc(dir_length + 1);
+    segments->index_path = (char *)GamesmanMalloc(index_path_size);
+    if (segments->dir == NULL || segments->index_path == NULL) {
+        GamesmanFree(segments->dir);
+        GamesmanFree(segments->index_path);
+        return kMallocFailureError;
+    }
+
+    strcpy(segments->dir, dir);
+    snprintf(segments->index_path, index_path_size, "%s/%s", dir, index_name);
+    TierHashMapInit(&segments->tier_to_entry, 0.5);
+    segments->write_segment = -1;
+
+    return kNoError;
+}
+
+int TierSegmentsInitWriter(TierSegments *writer, const TierSegments *segments) {
+    int error = TierSegmentsInit(writer, segments->dir, "");
+    if (error != kNoError) return error;
+
+    // Segment files are numbered after the ones SEGMENTS refers to.
+    writer->num_segments = segments->num_segments;
+
+    return kNoError;
+}
+
+void TierSegmentsDestroy(TierSegments *segments) {
+    GamesmanFree(segments->dir);
+    GamesmanFree(segments->index_path);
+    GamesmanFree(segments->entries);
+    TierHashMapDestroy(&segments->tier_to_entry);
+    memset(segments, 0, sizeof(*segments));
+}
+
+int TierSegmentsLoad(TierSegments *segments) {
+    // A missing index means the database uses the per-tier layout, so fopen()
+    // is used instead of GuardedFopen() to avoid printing an error.
+    FILE *file = fopen(segments->index_path, "rb");
+    if (file == NULL) return kFileSystemError;
+
+    TierSegmentEntry *batch = (TierSegmentEntry *)GamesmanMalloc(
+        kTierSegmentsReadBatchSize * sizeof(TierSegmentEntry));
+    if (batch == NULL) {
+        fclose(file);
+        return kMallocFailureError;
+    }
+
+    int error = kNoError;
+    if (fseeko(file, (off_t)segments->valid_size, SEEK_SET) != 0) {
+        error = kFileSystemError;
+        goto _bailout;
+    }
+    bool torn = false;
+    size_t n;
+    while (!torn && (n = fread(batch, sizeof(TierSegmentEntry),
+                               kTierSegmentsReadBatchSize, file)) > 0) {
+        for (size_t i = 0; i < n; ++i) {
+            if (!EntryIsValid(&batch[i])) {
+                torn = true;
+                break;
+            }
+            error = AddEntry(segments, &batch[i]);
+            if (error != kNoError) goto _bailout;
+            segments->valid_size += (int64_t)sizeof(TierSegmentEntry);
+        }
+    }
+    if (ferror(file)) {
+        error = kFileSystemError;
+        goto _bailout;
+    }
+
+    struct stat st;
+    if (fstat(fileno(file), &st) != 0) {
+        error = kFileSystemError;
+        goto _bailout;
+    }
+    segments->loaded_size = st.st_size;
+
+_bailout:
+    GamesmanFree(batch);
+    fclose(file);
+
+    return error;
+}
+
+const TierSegmentEntry *TierSegmentsFind(const TierSegments *segments,
+                                         Tier tier) {
+    TierHashMapIterator it =
+        TierHashMapGet((TierHashMap *)&segments->tier_to_entry, tier);
+    if (!TierHashMapIteratorIsValid(&it)) return NULL;
+
+    return &segments->entries[TierHashMapIteratorValue(&it)];
+}
+
+const TierSegmentEntry *TierSegmentsLookup(TierSegments *segments, Tier tier) {
+    const TierSegmentEntry *entry = TierSegmentsFind(segments, tier);
+    if (entry != NULL) return entry;
+
+    if (TierSegmentsLoad(segments) != kNoError) return NULL;
+
+    return TierSegmentsFind(segments, tier);
+}
+
+char *TierSegmentsGetPath(const TierSegments *segments, int32_t segment) {
+    size_t size = strlen(segments->dir) + kTierSegmentFileNameLengthMax + 2;
+    char *path = (char *)GamesmanMalloc(size);
+    if (path == NULL) return NULL;
+
+    snprintf(path, size, "%s/segment_%d.xzs", segments->dir, segment);
+
+    return path;
+}
+
+int TierSegmentsPrepareWrite(TierSegments *segments, int32_t *segment,
+                             int64_t *offset) {
+    if (segments->write_segment >= 0 &&
+        segments->write_offset < kTierSegmentSizeMax) {
+        *segment = segments->write_segment;
+        *offset = segments->write_offset;
+        return kNoError;
+    }
+
+    // Create a new segment file owned by this process. Numbers taken by other
+    // processes or by segment files abandoned in earlier runs are skipped.
+    for (int32_t i = segments->num_segments; i < INT32_MAX; ++i) {
+        char *path = TierSegmentsGetPath(segments, i);
+        if (path == NULL) return kMallocFailureError;
+
+        int fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+        GamesmanFree(path);
+        if (fd < 0 && errno == EEXIST) continue;
+        if (fd < 0) {
+            perror("open");
+            return kFileSystemError;
+        }
+        if (GuardedClose(fd) != 0) return kFileSystemError;
+
+        // Index entries must never refer to a segment file lost in a crash.
+        if (GuardedSyncDirectory(segments->dir) != 0) return kFileSystemError;
+        segments->num_segments = i + 1;
+        segments->write_segment = i;
+        segments->write_offset = 0;
+        *segment = i;
+        *offset = 0;
+        return kNoError;
+    }
+
+    return kFileSystemError;
+}
+
+void TierSegmentsAbortWrite(TierSegments *segments) {
+    segments->write_segment = -1;
+}
+
+int TierSegmentsFinishWrite(TierSegments *segments, int64_t length) {
+    char *path = TierSegmentsGetPath(segments, segments->write_segment);
+    if (path == NULL) return kMallocFailureError;
+    int error = SyncFile(path);
+    GamesmanFree(path);
+    if (error != kNoError) return error;
+    segments->write_offset += length;
+
+    return kNoError;
+}
+
+int TierSegmentsIndexStream(TierSegments *segments, Tier tier, int32_t segment,
+                            int64_t offset, int64_t length, int32_t codec) {
+    TierSegmentEntry entry = {
+        .tier = tier,
+        .offset = offset,
+        .length = length,
+        .segment = segment,
+        .codec = codec,
+    };
+
+    return AppendEntry(segments, &entry);
+}
+
+int TierSegmentsCommitWrite(TierSegments *segments, Tier tier, int64_t length,
+                            int32_t codec) {
+    int32_t segment = segments->write_segment;
+    int64_t offset = segments->write_offset;
+    int error = TierSegmentsFinishWrite(segments, length);
+    if (error != kNoError) return error;
+
+    return TierSegmentsIndexStream(segments, tier, segment, offset, length,
+                                   codec);
+}
+
+int TierSegmentsAppendFile(TierSegments *segments, Tier tier,
+                           ReadOnlyString path, int32_t codec) {
+    int32_t segment;
+    int64_t offset;
+    int error = TierSegmentsPrepareWrite(segments, &segment, &offset);
+    if (error != kNoError) return error;
+
+    char *segment_path = TierSegmentsGetPath(segments, segment);
+    if (segment_path == NULL) return kMallocFailureError;
+    int fd = GuardedOpen(segment_path, O_WRONLY | O_APPEND);
+    GamesmanFree(segment_path);
+    if (fd < 0) {
+        TierSegmentsAbortWrite(segments);
+        return kFileSystemError;
+    }
+
+    int64_t length = 0;
+    error = CopyRange(fd, path, 0, -1, &length);
+    if (GuardedClose(fd) != 0 && error == kNoError) error = kFileSystemError;
+    if (error != kNoError) {
+        TierSegmentsAbortWrite(segments);
+        return error;
+    }
+
+    return TierSegmentsCommitWrite(segments, tier, length, codec);
+}
+
+int TierSegmentsCompact(TierSegments *segments) {
+    int64_t num_live = 0;
+    for (int64_t i = 0; i < segments->num_entries; ++i) {
+        const TierSegmentEntry *entry = &segments->entries[i];
+        num_live += TierSegmentsFind(segments, entry->tier) == entry;
+    }
+    if (num_live == segments->num_entries) return kNoError;
+
+    TierSegments compact;
+    int error = TierSegmentsInit(&compact, segments->dir,
+                                 kTierSegmentsCompactIndexName);
+    if (error != kNoError) return error;
+
+    // The new segment files are numbered after the ones in use, so that the
+    // current index stays valid until it is replaced.
+    compact.num_segments = segments->num_segments;
+    error = CopyLiveStreams(segments, &compact);
+    if (error == kNoError) error = WriteIndex(&compact);
+    if (error == kNoError &&
+        (GuardedRename(compact.index_path, segments->index_path) != 0 ||
+         GuardedSyncDirectory(segments->dir) != 0)) {
+        error = kFileSystemError;
+    }
+    if (error != kNoError) {
+        remove(compact.index_path);
+        TierSegmentsDestroy(&compact);
+        return error;
+    }
+
+    // Take over the index path of SEGMENTS along with the compacted entries.
+    GamesmanFree(compact.index_path);
+    compact.index_path = segments->index_path;
+    segments->index_path = NULL;
+    TierSegmentsDestroy(segments);
+    *segments = compact;
+    segments->valid_size =
+        segments->num_entries * (int64_t)sizeof(TierSegmentEntry);
+    segments->loaded_size = segments->valid_size;
+
+    return RemoveUnusedSegments(segments);
+}
+
+// -----------------------------------------------------------------------------
+
+static uint64_t EntryChecksum(const TierSegmentEntry *entry) {
+    return TierManifestChecksum(entry,
+                                offsetof(TierSegmentEntry, entry_checksum));
+}
+
+static bool EntryIsValid(const TierSegmentEntry *entry) {
+    return entry->segment >= 0 && entry->offset >= 0 && entry->length >= 0 &&
+           entry->entry_checksum == EntryChecksum(entry);
+}
+
+static int AddEntry(TierSegments *segments, const TierSegmentEntry *entry) {
+    if (segments->num_entries == segments->capacity) {
+        int64_t new_capacity =
+            segments->capacity == 0 ? 16 : segments->capacity * 2;
+        TierSegmentEntry *new_entries = (TierSegmentEntry *)GamesmanRealloc(
+            segments->entries, segments->capacity * sizeof(TierSegmentEntry),
+            new_capacity * sizeof(TierSegmentEntry));
+        if (new_entries == NULL) return kMallocFailureError;
+        segments->entries = new_entries;
+        segments->capacity = new_capacity;
+    }
+
+    // The latest entry of a tier replaces earlier ones.
+    if (!TierHashMapSet(&segments->tier_to_entry, entry->tier,
+                        segments->num_entries)) {
+        return kMallocFailureError;
+    }
+    segments->entries[segments->num_entries++] = *entry;
+    if (entry->segment >= segments->num_segments) {
+        segments->num_segments = entry->segment + 1;
+    }
+
+    return kNoError;
+}
+
+/**
+ * @brief Appends ENTRY to the index file of SEGMENTS and adds it to the loaded
+ * entries. An index file that ended with a torn entry when it was loaded is
+ * first truncated to its valid entries, unless it has been appended to since.
+ */
+static int AppendEntry(TierSegments *segments, TierSegmentEntry *entry) {
+    entry->entry_checksum = EntryChecksum(entry);
+    int fd = open(segments->index_path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        perror("open");
+        return kFileSystemError;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) return BailOutClose(fd, kFileSystemError);
+    if (segments->valid_size < segments->loaded_size &&
+        st.st_size == segments->loaded_size) {
+        if (ftruncate(fd, segments->valid_size) != 0) {
+            perror("ftruncate");
+            return BailOutClose(fd, kFileSystemError);
+        }
+        st.st_size = segments->valid_size;
+    }
+    bool up_to_date = st.st_size == segments->valid_size;
+
+    ssize_t written = write(fd, entry, sizeof(*entry));
+    if (written != (ssize_t)sizeof(*entry) || fdatasync(fd) != 0) {
+        perror("write");
+        return BailOutClose(fd, kFileSystemError);
+    }
+    if (GuardedClose(fd) != 0) return kFileSystemError;
+
+    int error = AddEntry(segments, entry);
+    if (error != kNoError) return error;
+
+    // Entries appended by other processes in between are picked up by the
+    // next TierSegmentsLoad() instead.
+    if (up_to_date) {
+        segments->valid_size += (int64_t)sizeof(*entry);
+        segments->loaded_size = segments->valid_size;
+    }
+
+    return kNoError;
+}
+
+static int SyncFile(ReadOnlyString path) {
+    int fd = GuardedOpen(path, O_RDONLY);
+    if (fd < 0) return kFileSystemError;
+    if (fdatasync(fd) != 0) {
+        perror("fdatasync");
+        return BailOutClose(fd, kFileSystemError);
+    }
+    if (GuardedClose(fd) != 0) return kFileSystemError;
+
+    return kNoError;
+}
+
+static int WriteAll(int fd, const void *buf, size_t size) {
+    for (size_t done = 0; done < size;) {
+        ssize_t written = write(fd, (const char *)buf + done, size - done);
+        if (written < 0) {
+            perror("write");
+            return kFileSystemError;
+        }
+        done += (size_t)written;
+    }
+
+    return kNoError;
+}
+
+/**
+ * @brief Appends LENGTH bytes of the file at PATH starting from OFFSET, or
+ * everything from OFFSET to the end of the file if LENGTH is negative, to
+ * OUT_FD. Sets COPIED to the number of bytes appended.
+ */
+static int CopyRange(int out_fd, ReadOnlyString path, int64_t offset,
+                     int64_t length, int64_t *copied) {
+    int in_fd = GuardedOpen(path, O_RDONLY);
+    if (in_fd < 0) return kFileSystemError;
+
+    char *buffer = (char *)GamesmanMalloc(kTierSegmentsCopyBufferSize);
+    if (buffer == NULL) return BailOutClose(in_fd, kMallocFailureError);
+
+    int error = kNoError;
+    *copied = 0;
+    while (length < 0 || *copied < length) {
+        size_t size = kTierSegmentsCopyBufferSize;
+        if (length >= 0 && (int64_t)size > length - *copied) {
+            size = (size_t)(length - *copied);
+        }
+        ssize_t n = pread(in_fd, buffer, size, (off_t)(offset + *copied));
+        if (n < 0) {
+            perror("pread");
+            error = kFileSystemError;
+            break;
+        }
+        if (n == 0) {
+            // A stream cut short means that its segment file is corrupt.
+            if (length >= 0) error = kFileSystemError;
+            break;
+        }
+        error = WriteAll(out_fd, buffer, (size_t)n);
+        if (error != kNoError) break;
+        *copied += n;
+    }
+    GamesmanFree(buffer);
+    if (GuardedClose(in_fd) != 0 && error == kNoError) {
+        error = kFileSystemError;
+    }
+
+    return error;
+}
+
+// Writes FD to storage and closes it, returning ERROR if it is an error.
+static int SyncAndClose(int fd, int error) {
+    if (error == kNoError && fdatasync(fd) != 0) {
+        perror("fdatasync");
+        error = kFileSystemError;
+    }
+    if (GuardedClose(fd) != 0 && error == kNoError) error = kFileSystemError;
+
+    return error;
+}
+
+/**
+ * @brief Copies the latest stream of each tier in SEGMENTS into new segment
+ * files of COMPACT and adds their entries to COMPACT. The segment files are
+ * written to storage, but the index file of COMPACT is not written.
+ */
+static int CopyLiveStreams(TierSegments *segments, TierSegments *compact) {
+    int error = kNoError;
+    int out_fd = -1;
+    int32_t out_segment = -1;
+    for (int64_t i = 0; i < segments->num_entries; ++i) {
+        const TierSegmentEntry *entry = &segments->entries[i];
+        if (TierSegmentsFind(segments, entry->tier) != entry) continue;
+
+        int32_t segment;
+        int64_t offset;
+        error = TierSegmentsPrepareWrite(compact, &segment, &offset);
+        if (error != kNoError) break;
+        if (segment != out_segment) {
+            if (out_fd >= 0) error = SyncAndClose(out_fd, kNoError);
+            out_fd = -1;
+            if (error != kNoError) break;
+
+            char *out_path = TierSegmentsGetPath(compact, segment);
+            if (out_path == NULL) {
+                error = kMallocFailureError;
+                break;
+            }
+            out_fd = GuardedOpen(out_path, O_WRONLY | O_APPEND);
+            GamesmanFree(out_path);
+            if (out_fd < 0) {
+                error = kFileSystemError;
+                break;
+            }
+            out_segment = segment;
+        }
+
+        char *in_path = TierSegmentsGetPath(segments, entry->segment);
+        if (in_path == NULL) {
+            error = kMallocFailureError;
+            break;
+        }
+        int64_t length = 0;
+        error = CopyRange(out_fd, in_path, entry->offset, entry->length,
+                          &length);
+        GamesmanFree(in_path);
+        if (error != kNoError) break;
+
+        TierSegmentEntry moved = *entry;
+        moved.segment = segment;
+        moved.offset = offset;
+        moved.entry_checksum = EntryChecksum(&moved);
+        error = AddEntry(compact, &moved);
+        if (error != kNoError) break;
+        compact->write_offset += length;
+    }
+    if (out_fd >= 0) error = SyncAndClose(out_fd, error);
+
+    return error;
+}
+
+// Writes all loaded entries of SEGMENTS to its index file and to storage.
+static int WriteIndex(const TierSegments *segments) {
+    int fd = open(segments->index_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        perror("open");
+        return kFileSystemError;
+    }
+    int error = WriteAll(fd, segments->entries,
+                         segments->num_entries * sizeof(TierSegmentEntry));
+
+    return SyncAndClose(fd, error);
+}
+
+/**
+ * @brief Removes the segment files numbered below the number of segments of
+ * SEGMENTS that none of its entries refers to.
+ */
+static int RemoveUnusedSegments(const TierSegments *segments) {
+    bool *used = (bool *)GamesmanCallocWhole(segments->num_segments,
+                                             sizeof(bool));
+    if (segments->num_segments > 0 && used == NULL) return kMallocFailureError;
+    for (int64_t i = 0; i < segments->num_entries; ++i) {
+        used[segments->entries[i].segment] = true;
+    }
+
+    int error = kNoError;
+    for (int32_t i = 0; i < segments->num_segments; ++i) {
+        if (used[i]) continue;
+        char *path = TierSegmentsGetPath(segments, i);
+        if (path == NULL) {
+            error = kMallocFailureError;
+            break;
+        }
+        if (remove(path) != 0 && errno != ENOENT) {
+            perror("remove");
+            error = kFileSystemError;
+        }
+        GamesmanFree(path);
+    }
+    GamesmanFree(used);
+
+    return error;
+}
@@ -0,0 +1,215 @@
+/**
+ * @file tier_segments.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Packed layout of the Array Database, which stores the compressed
+ * tiers back to back in large segment files.
+ * @details Storing each tier in its own file creates millions of small files
+ * for games with millions of tiers, which overloads the metadata servers of
+ * parallel file systems and makes copying a database slow. In the packed
+ * layout, the compressed stream of each tier is appended to a segment file,
+ * and an entry mapping the tier to its segment, offset, length and codec is
+ * appended to an index file in the same directory.
+ *
+ * Each process appends only to segment files it created itself, so concurrent
+ * solver processes never write to the same segment. A tier stream is written
+ * to storage before its index entry is appended, and each index entry carries
+ * its own checksum, so a crash leaves at most an unreferenced stream at the end
+ * of a segment and a torn entry at the end of the index, which is discarded by
+ * the next load. The latest entry of a tier takes precedence.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_DB_ARRAYDB_TIER_SEGMENTS_H_
+#define GAMESMANONE_CORE_DB_ARRAYDB_TIER_SEGMENTS_H_
+
+#include <stdbool.h>  // bool
+#include <stdint.h>   // int64_t, int32_t, uint64_t
+
+#include "core/types/gamesman_types.h"
+
+/** @brief Name of the index file of the packed layout. */
+extern const char kTierSegmentsIndexName[];
+
+/** @brief Location of the compressed stream of a tier in the packed layout. */
+typedef struct TierSegmentEntry {
+    Tier tier;      /**< The tier. */
+    int64_t offset; /**< Offset of the stream in the segment file in bytes. */
+    int64_t length; /**< Length of the stream in bytes. */
+    int32_t segment; /**< Number of the segment file. */
+    int32_t codec;   /**< One of the TierManifestCodec values. */
+
+    /** Checksum of all the fields above, set by TierSegments. */
+    uint64_t entry_checksum;
+} TierSegmentEntry;
+
+/** @brief Segment files and index of a database in the packed layout. */
+typedef struct TierSegments {
+    // Private members.
+    char *dir;
+    char *index_path;
+    TierSegmentEntry *entries;
+    int64_t num_entries;
+    int64_t capacity;
+    TierHashMap tier_to_entry;
+    int64_t loaded_size;
+    int64_t valid_size;
+    int32_t num_segments;
+    int32_t write_segment;
+    int64_t write_offset;
+} TierSegments;
+
+/**
+ * @brief Initializes SEGMENTS to an empty packed database in directory DIR
+ * whose index file is named INDEX_NAME, without accessing the file system.
+ *
+ * @return kNoError on success, or
+ * @return kMallocFailureError if out of memory.
+ */
+int TierSegmentsInit(TierSegments *segments, ReadOnlyString dir,
+                     ReadOnlyString index_name);
+
+/**
+ * @brief Initializes WRITER to write tier streams to new segment files of the
+ * database of SEGMENTS, so that one thread can write streams with WRITER while
+ * another indexes them in SEGMENTS using TierSegmentsIndexStream(). WRITER
+ * never accesses the index file.
+ *
+ * @return kNoError on success, or
+ * @return kMallocFailureError if out of memory.
+ */
+int TierSegmentsInitWriter(TierSegments *writer, const TierSegments *segments);
+
+/** @brief Destroys SEGMENTS. The files are not affected. */
+void TierSegmentsDestroy(TierSegments *segments);
+
+/**
+ * @brief Loads the entries of the index file of SEGMENTS that have not been
+ * loaded yet. Loading stops at the first invalid entry.
+ *
+ * @return kNoError on success, or
+ * @return kFileSystemError if the index file does not exist or cannot be read,
+ * or
+ * @return kMallocFailureError if out of memory.
+ */
+int TierSegmentsLoad(TierSegments *segments);
+
+/**
+ * @brief Returns the latest loaded entry of TIER in SEGMENTS, or NULL if TIER
+ * has not been loaded. Does not access the file system.
+ */
+const TierSegmentEntry *TierSegmentsFind(const TierSegments *segments,
+                                         Tier tier);
+
+/**
+ * @brief Same as TierSegmentsFind(), except that the index file is reloaded
+ * if TIER is not found, which picks up tiers appended by other processes.
+ */
+const TierSegmentEntry *TierSegmentsLookup(TierSegments *segments, Tier tier);
+
+/**
+ * @brief Returns the path to segment file number SEGMENT of SEGMENTS, which
+ * must be freed by the caller, or NULL if out of memory.
+ */
+char *TierSegmentsGetPath(const TierSegments *segments, int32_t segment);
+
+/**
+ * @brief Prepares a segment file of SEGMENTS to which the next tier stream is
+ * appended, creating a new segment file if this process has none or if the
+ * current one is full.
+ *
+ * @param segment (Output parameter) Number of the segment file.
+ * @param offset (Output parameter) Offset at which the next stream begins.
+ * @return kNoError on success, or
+ * @return kFileSystemError if a new segment file cannot be created.
+ */
+int TierSegmentsPrepareWrite(TierSegments *segments, int32_t *segment,
+                             int64_t *offset);
+
+/**
+ * @brief Discards the segment file prepared by TierSegmentsPrepareWrite()
+ * after a failed write, so that the next write starts a new segment file.
+ */
+void TierSegmentsAbortWrite(TierSegments *segments);
+
+/**
+ * @brief Writes the LENGTH bytes appended to the segment file prepared by
+ * TierSegmentsPrepareWrite() to storage, and moves the write offset past them
+ * without indexing them.
+ *
+ * @return kNoError on success, or
+ * @return kFileSystemError on file system error, or
+ * @return kMallocFailureError if out of memory.
+ */
+int TierSegmentsFinishWrite(TierSegments *segments, int64_t length);
+
+/**
+ * @brief Appends the index entry of the stream of TIER compressed with CODEC,
+ * which takes LENGTH bytes at OFFSET in segment file SEGMENT, to the index of
+ * SEGMENTS. The stream must already be in storage.
+ *
+ * @return kNoError on success, or
+ * @return kFileSystemError on file system error, or
+ * @return kMallocFailureError if out of memory.
+ */
+int TierSegmentsIndexStream(TierSegments *segments, Tier tier, int32_t segment,
+                            int64_t offset, int64_t length, int32_t codec);
+
+/**
+ * @brief Commits the LENGTH bytes appended to the segment file prepared by
+ * TierSegmentsPrepareWrite() as the stream of TIER compressed with CODEC.
+ * Returns only after both the stream and its index entry have been written to
+ * storage.
+ *
+ * @return kNoError on success, or
+ * @return kFileSystemError on file system error, or
+ * @return kMallocFailureError if out of memory.
+ */
+int TierSegmentsCommitWrite(TierSegments *segments, Tier tier, int64_t length,
+                            int32_t codec);
+
+/**
+ * @brief Appends the contents of the file at PATH to a segment file of
+ * SEGMENTS and commits it as the stream of TIER compressed with CODEC.
+ *
+ * @return kNoError on success, or
+ * @return kFileSystemError on file system error, or
+ * @return kMallocFailureError if out of memory.
+ */
+int TierSegmentsAppendFile(TierSegments *segments, Tier tier,
+                           ReadOnlyString path, int32_t codec);
+
+/**
+ * @brief Reclaims the streams of SEGMENTS superseded by later streams of the
+ * same tiers, which re-solving a packed database leaves behind.
+ * @details The latest stream of each tier is copied into new segment files
+ * under a new index, which then replaces the index file of SEGMENTS. The old
+ * segment files are removed afterwards. An interrupted call leaves the
+ * database as it was, apart from new segment files that are never referenced.
+ * Does nothing if no stream has been superseded. Must not be called while
+ * other processes write to the database.
+ *
+ * @return kNoError on success, or
+ * @return kFileSystemError on file system error, or
+ * @return kMallocFailureError if out of memory.
+ */
+int TierSegmentsCompact(TierSegments *segments);
+
+#endif  // GAMESMANONE_CORE_DB_ARRAYDB_TIER_SEGMENTS_H_
@@ -113,6 +113,18 @@ int DbManagerFlushSolvingTier(void *aux) {
 
 int DbManagerFreeSolvingTier(void) { return current_db->FreeSolvingTier(); }
 
+int DbManagerSetAsyncFlush(intptr_t budget) {
+    if (current_db->SetAsyncFlush == NULL) return kNotImplementedError;
+
+    return current_db->SetAsyncFlush(budget);
+}
+
+bool DbManagerPopFlushedTier(bool wait, Tier *tier, int *error) {
+    if (current_db->PopFlushedTier == NULL) return false;
+
+    return current_db->PopFlushedTier(wait, tier, error);
+}
+
 int DbManagerSetGameSolved(void) { return current_db->SetGameSolved(); }
 
 int DbManagerSetValue(Position position, Value value) {
@@ -160,6 +172,24 @@ int DbManagerUnloadTier(Tier tier) { return current_db->UnloadTier(tier); }
 
 bool DbManagerIsTierLoaded(Tier tier) { return current_db->IsTierLoaded(tier); }
 
+int DbManagerSetTierCache(intptr_t budget) {
+    if (current_db->SetTierCache == NULL) return kNotImplementedError;
+
+    return current_db->SetTierCache(budget);
+}
+
+bool DbManagerIsTierCached(Tier tier) {
+    if (current_db->IsTierCached == NULL) return false;
+
+    return current_db->IsTierCached(tier);
+}
+
+void DbManagerEvictTier(Tier tier) {
+    if (current_db->EvictTier == NULL) return;
+
+    current_db->EvictTier(tier);
+}
+
 Value DbManagerGetValueFromLoaded(Tier tier, Position position) {
     return current_db->GetValueFromLoaded(tier, position);
 }
@@ -182,8 +212,48 @@ int DbManagerProbeRemoteness(DbProbe *probe, TierPosition tier_position) {
     return current_db->ProbeRemoteness(probe, tier_position);
 }
 
+Value DbManagerProbeValueRemoteness(DbProbe *probe, TierPosition tier_position,
+                                    int *remoteness) {
+    if (current_db->ProbeValueRemoteness != NULL) {
+        return current_db->ProbeValueRemoteness(probe, tier_position,
+                                                remoteness);
+    }
+
+    *remoteness = current_db->ProbeRemoteness(probe, tier_position);
+    return current_db->ProbeValue(probe, tier_position);
+}
+
+int DbManagerProbeBatch(DbProbe *probe, int64_t n,
+                        const TierPosition *tier_positions, Value *values,
+                        int *remotenesses) {
+    if (current_db->ProbeBatch != NULL) {
+        return current_db->ProbeBatch(probe, n, tier_positions, values,
+                                      remotenesses);
+    }
+
+    for (int64_t i = 0; i < n; ++i) {
+        values[i] = DbManagerProbeValueRemoteness(probe, tier_positions[i],
+                                                  &remotenesses[i]);
+    }
+
+    return kNoError;
+}
+
 int DbManagerTierStatus(Tier tier) { return current_db->TierStatus(tier); }
 
+int DbManagerRebuildTierManifest(int64_t n, const Tier *tiers,
+                                 const int64_t *sizes) {
+    if (current_db->RebuildTierManifest == NULL) return kNoError;
+
+    return current_db->RebuildTierManifest(n, tiers, sizes);
+}
+
+int DbManagerPackTiers(int64_t n, const Tier *tiers) {
+    if (current_db->PackTiers == NULL) return kNotImplementedError;
+
+    return current_db->PackTiers(n, tiers);
+}
+
 int DbManagerGameStatus(void) { return current_db->GameStatus(); }
 
 int DbManagerRefProbeInit(DbProbe *probe) { return ref_db->ProbeInit(probe); }
@@ -104,6 +104,32 @@ int DbManagerFlushSolvingTier(void *aux);
  */
 int DbManagerFreeSolvingTier(void);
 
+/**
+ * @brief Enables flushing solved tiers in the background using at most BUDGET
+ * bytes of memory if BUDGET is positive, or waits for all pending flushes and
+ * disables it otherwise.
+ *
+ * @return kNoError on success, or
+ * @return kNotImplementedError if the current database does not support
+ * flushing in the background, or
+ * @return non-zero error code on failure.
+ */
+int DbManagerSetAsyncFlush(intptr_t budget);
+
+/**
+ * @brief Reports the next tier flushed in the background by the current
+ * database.
+ *
+ * @param wait Whether to wait for a pending flush to finish if no flushed tier
+ * is ready to be reported.
+ * @param tier (Output parameter) The flushed tier.
+ * @param error (Output parameter) kNoError if TIER has been durably stored, or
+ * the error that occurred while flushing TIER.
+ * @return true if a flushed tier is reported, or
+ * @return false otherwise.
+ */
+bool DbManagerPopFlushedTier(bool wait, Tier *tier, int *error);
+
 /**
  * @brief Sets the current game as solved.
  *
@@ -237,6 +263,26 @@ int DbManagerUnloadTier(Tier tier);
  */
 bool DbManagerIsTierLoaded(Tier tier);
 
+/**
+ * @brief Keeps up to BUDGET bytes of unloaded tiers in memory if BUDGET is
+ * positive, or disables the tier cache otherwise.
+ *
+ * @return kNoError on success, or
+ * @return kNotImplementedError if the current database does not support
+ * caching tiers, or
+ * @return non-zero error code on failure.
+ */
+int DbManagerSetTierCache(intptr_t budget);
+
+/**
+ * @brief Returns whether TIER is loaded or cached by the current database, or
+ * false if the current database does not support caching tiers.
+ */
+bool DbManagerIsTierCached(Tier tier);
+
+/** @brief Frees TIER if it is cached but not loaded. */
+void DbManagerEvictTier(Tier tier);
+
 /**
  * @brief Returns the value of position \p position in tier \p tier if
  * \p tier has been loaded. Returns \c kErrorValue otherwise.
@@ -301,6 +347,47 @@ Value DbManagerProbeValue(DbProbe *probe, TierPosition tier_position);
  */
 int DbManagerProbeRemoteness(DbProbe *probe, TierPosition tier_position);
 
+/**
+ * @brief Reads both the value and the remoteness of TIER_POSITION in the
+ * current database from disk using the given initialized PROBE. The remoteness
+ * is stored in REMOTENESS and the value is returned.
+ *
+ * @note Results in undefined behavior if PROBE has not been initialized.
+ *
+ * @param probe Initialized database probe.
+ * @param tier_position TierPosition to read.
+ * @param remoteness (Output parameter) Remoteness of the given TIER_POSITION in
+ * database; a negative value on error.
+ * @return Value of the given TIER_POSITION in database; kErrorValue if the
+ * given TIER has not been solved, the given POSITION is out of bounds, or any
+ * other error occurred.
+ */
+Value DbManagerProbeValueRemoteness(DbProbe *probe, TierPosition tier_position,
+                                    int *remoteness);
+
+/**
+ * @brief Reads the values and remotenesses of the N tier positions in
+ * TIER_POSITIONS in the current database from disk using the given initialized
+ * PROBE, storing them in VALUES and REMOTENESSES in the same order. Databases
+ * that support batched probing reorder the reads to visit each tier file and
+ * each block once; all others are probed one tier position at a time.
+ *
+ * @note Results in undefined behavior if PROBE has not been initialized.
+ *
+ * @param probe Initialized database probe.
+ * @param n Number of tier positions to read.
+ * @param tier_positions Array of N tier positions to read.
+ * @param values (Output parameter) Array of size at least N for the values;
+ * kErrorValue for tier positions that cannot be read.
+ * @param remotenesses (Output parameter) Array of size at least N for the
+ * remotenesses; a negative value for tier positions that cannot be read.
+ * @return kNoError on success, or
+ * @return non-zero error code on failure.
+ */
+int DbManagerProbeBatch(DbProbe *probe, int64_t n,
+                        const TierPosition *tier_positions, Value *values,
+                        int *remotenesses);
+
 /**
  * @brief Returns the status of TIER.
  *
@@ -313,6 +400,32 @@ int DbManagerProbeRemoteness(DbProbe *probe, TierPosition tier_position);
  */
 int DbManagerTierStatus(Tier tier);
 
+/**
+ * @brief Rebuilds the record of solved tiers kept by the current database, if
+ * any, from the files of the N tiers in TIERS found in permanent storage.
+ *
+ * @param n Number of tiers to check.
+ * @param tiers Array of N tiers to check.
+ * @param sizes Array of the sizes of the N tiers in TIERS.
+ * @return kNoError on success, or
+ * @return non-zero error code on failure.
+ */
+int DbManagerRebuildTierManifest(int64_t n, const Tier *tiers,
+                                 const int64_t *sizes);
+
+/**
+ * @brief Moves the solved tiers among the N tiers in TIERS into the packed
+ * layout of the current database, which stores many tiers per file.
+ *
+ * @param n Number of tiers to pack.
+ * @param tiers Array of N tiers to pack.
+ * @return kNoError on success, or
+ * @return kNotImplementedError if the current database has no packed layout,
+ * or
+ * @return non-zero error code on failure.
+ */
+int DbManagerPackTiers(int64_t n, const Tier *tiers);
+
 /**
  * @brief Returns the solving status of the current game.
  *
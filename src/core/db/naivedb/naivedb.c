@@ -64,6 +64,9 @@ static int NaiveDbProbeInit(DbProbe *probe);
 static int NaiveDbProbeDestroy(DbProbe *probe);
 static Value NaiveDbProbeValue(DbProbe *probe, TierPosition tier_position);
 static int NaiveDbProbeRemoteness(DbProbe *probe, TierPosition tier_position);
+static Value NaiveDbProbeValueRemoteness(DbProbe *probe,
+                                         TierPosition tier_position,
+                                         int *remoteness);
 static int NaiveDbTierStatus(Tier tier);
 static int NaiveDbGameStatus(void);
 
@@ -97,6 +100,7 @@ const Database kNaiveDb = {
     .ProbeDestroy = &NaiveDbProbeDestroy,
     .ProbeValue = &NaiveDbProbeValue,
     .ProbeRemoteness = &NaiveDbProbeRemoteness,
+    .ProbeValueRemoteness = &NaiveDbProbeValueRemoteness,
     .TierStatus = &NaiveDbTierStatus,
     .GameStatus = &NaiveDbGameStatus,
 };
@@ -465,6 +469,18 @@ static int NaiveDbProbeRemoteness(DbProbe *probe, TierPosition tier_position) {
     return record.remoteness;
 }
 
+static Value NaiveDbProbeValueRemoteness(DbProbe *probe,
+                                         TierPosition tier_position,
+                                         int *remoteness) {
+    if (!ProbeFillBuffer(probe, tier_position)) {
+        *remoteness = kErrorRemoteness;
+        return kErrorValue;
+    }
+    NaiveDbEntry record = ProbeGetRecord(probe, tier_position.position);
+    *remoteness = record.remoteness;
+    return record.value;
+}
+
 static int NaiveDbTierStatus(Tier tier) {
     char *full_path = GetFullPathToFile(tier, CurrentGetTierName);
     if (full_path == NULL) return kDbTierStatusCheckError;
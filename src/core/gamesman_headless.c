@@ -28,7 +28,7 @@
 
 #include <stdbool.h>  // bool
 #include <stdint.h>   // intptr_t,
-#include <stdlib.h>   // atoi
+#include <stdlib.h>   // atoi, atoll
 #ifdef USE_MPI
 #include <mpi.h>
 #endif  // USE_MPI
@@ -36,23 +36,15 @@
 #include "core/headless/hanalyze.h"
 #include "core/headless/hparser.h"
 #include "core/headless/hquery.h"
+#include "core/headless/hbatch.h"
+#include "core/headless/hcache.h"
+#include "core/headless/hpool.h"
+#include "core/headless/hserve.h"
 #include "core/headless/hsolve.h"
 #include "core/headless/hutils.h"
 #include "core/misc.h"
 #include "core/types/gamesman_types.h"
 
-/**
- * @brief Convert the input memory limit string \p str, which is in GiB, into
- * an integer memory limit, which is in bytes.
- */
-static intptr_t ParseMemLimit(ReadOnlyString str) {
-    if (str == NULL || *str == '\0') return 0;
-    int gigabytes = atoi(str);
-    if (gigabytes < 0) return 0;
-
-    return (intptr_t)gigabytes << 30;
-}
-
 int GamesmanHeadlessMain(int argc, char **argv) {
 #ifdef USE_MPI
 #ifdef _OPENMP
@@ -73,7 +65,7 @@ int GamesmanHeadlessMain(int argc, char **argv) {
     HeadlessArguments arguments = HeadlessParseArguments(argc, argv);
     char *game = arguments.game;
     char *data_path = arguments.data_path;
-    intptr_t memlimit = ParseMemLimit(arguments.memlimit);
+    intptr_t memlimit = HeadlessParseMemLimit(arguments.memlimit);
     bool force = arguments.force;
     char *position = arguments.position;
     int verbose = HeadlessGetVerbosity(arguments.verbose, arguments.quiet);
@@ -85,8 +77,8 @@ int GamesmanHeadlessMain(int argc, char **argv) {
 
     switch (arguments.action) {
         case kHeadlessSolve:
-            error = HeadlessSolve(game, variant_id, data_path, force, verbose,
-                                  memlimit);
+            error = HeadlessSolve(game, variant_id, data_path,
+                                  &arguments.solve_options);
             break;
         case kHeadlessAnalyze:
             error = HeadlessAnalyze(game, variant_id, data_path, force, verbose,
@@ -95,12 +87,34 @@ int GamesmanHeadlessMain(int argc, char **argv) {
         case kHeadlessQuery:
             error = HeadlessQuery(game, variant_id, data_path, position);
             break;
+        case kHeadlessQueryBatch:
+            error = HeadlessQueryBatch(game, variant_id, data_path,
+                                       arguments.input);
+            break;
         case kHeadlessGetStart:
             error = HeadlessGetStart(game, variant_id);
             break;
         case kHeadlessGetRandom:
             error = HeadlessGetRandom(game, variant_id);
             break;
+        case kHeadlessServe:
+            if (game == NULL) {
+                error = HeadlessServePool(data_path, arguments.socket_path,
+                                          memlimit);
+            } else {
+                error = HeadlessServe(game, variant_id, data_path,
+                                      arguments.socket_path,
+                                      arguments.cache_path);
+            }
+            break;
+        case kHeadlessPrecompute:
+            error = HeadlessPrecompute(
+                game, variant_id, data_path, arguments.cache_path,
+                arguments.depth != NULL ? atoi(arguments.depth)
+                                        : kHeadlessPrecomputeDepthDefault,
+                arguments.limit != NULL ? atoll(arguments.limit)
+                                        : kHeadlessPrecomputeLimitDefault);
+            break;
         default:
             fprintf(stderr, "GamesmanHeadlessMain: unknown action\n");
             error = kNotReachedError;
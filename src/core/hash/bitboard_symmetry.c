@@ -0,0 +1,519 @@
+/**
+ * @file bitboard_symmetry.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the generic symmetry canonicalization engine for
+ * bit-board games.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/hash/bitboard_symmetry.h"
+
+#include <stdbool.h>  // bool, true, false
+#include <stddef.h>   // NULL
+#include <stdint.h>   // int8_t, int64_t, intptr_t, uint64_t
+#include <stdio.h>    // fprintf, stderr
+#include <string.h>   // memset
+#ifdef __SSE2__
+#include <immintrin.h>  // __m128i, _mm_*
+#endif                  // __SSE2__
+
+#include "core/gamesman_memory.h"
+#include "core/misc.h"
+#include "core/types/gamesman_types.h"
+
+enum {
+    kGridOpTranspose = 1 << 0, /**< Applied first. */
+    kGridOpFlip = 1 << 1,      /**< Applied second. */
+    kGridOpMirror = 1 << 2,    /**< Applied last. */
+    kGridOpAll = kGridOpTranspose | kGridOpFlip | kGridOpMirror,
+    kBatchBlockSize = 64,
+};
+
+// ----------------------------- Scalar Grid Ops -----------------------------
+
+// Transposes the 8x8 bit grid. Same as X86SimdTwoPieceHashFlipDiag.
+static inline uint64_t Transpose(uint64_t x) {
+    uint64_t t;
+    t = 0x0f0f0f0f00000000ULL & (x ^ (x << 28));
+    x ^= t ^ (t >> 28);
+    t = 0x3333000033330000ULL & (x ^ (x << 14));
+    x ^= t ^ (t >> 14);
+    t = 0x5500550055005500ULL & (x ^ (x << 7));
+    x ^= t ^ (t >> 7);
+
+    return x;
+}
+
+// Same as X86SimdTwoPieceHashFlipVertical.
+static inline uint64_t FlipVertical(uint64_t x, int rows) {
+    return __builtin_bswap64(x) >> ((8 - rows) << 3);
+}
+
+// Same as X86SimdTwoPieceHashMirrorHorizontal.
+static inline uint64_t MirrorHorizontal(uint64_t x, int cols) {
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((x & 0x0f0f0f0f0f0f0f0fULL) << 4);
+
+    return x >> (8 - cols);
+}
+
+static inline uint64_t GridApply(uint64_t x, uint8_t ops, int rows, int cols) {
+    if (ops & kGridOpTranspose) x = Transpose(x);
+    if (ops & kGridOpFlip) x = FlipVertical(x, rows);
+    if (ops & kGridOpMirror) x = MirrorHorizontal(x, cols);
+
+    return x;
+}
+
+// ------------------------------ SIMD Grid Ops ------------------------------
+
+#ifdef __SSE2__
+static inline __m128i TransposePair(__m128i board) {
+    const __m128i k1 = _mm_set1_epi64x(0x5500550055005500LL);
+    const __m128i k2 = _mm_set1_epi64x(0x3333000033330000LL);
+    const __m128i k4 = _mm_set1_epi64x(0x0f0f0f0f00000000LL);
+    __m128i t;
+    t = _mm_and_si128(k4, _mm_xor_si128(board, _mm_slli_epi64(board, 28)));
+    board = _mm_xor_si128(board, _mm_xor_si128(t, _mm_srli_epi64(t, 28)));
+    t = _mm_and_si128(k2, _mm_xor_si128(board, _mm_slli_epi64(board, 14)));
+    board = _mm_xor_si128(board, _mm_xor_si128(t, _mm_srli_epi64(t, 14)));
+    t = _mm_and_si128(k1, _mm_xor_si128(board, _mm_slli_epi64(board, 7)));
+    board = _mm_xor_si128(board, _mm_xor_si128(t, _mm_srli_epi64(t, 7)));
+
+    return board;
+}
+
+static inline __m128i FlipVerticalPair(__m128i board, int rows) {
+#ifdef __SSSE3__
+    const __m128i kReverse =
+        _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+    board = _mm_shuffle_epi8(board, kReverse);
+#else   // __SSSE3__ not defined
+    __attribute__((aligned(16))) uint64_t s[2];
+    _mm_store_si128((__m128i *)s, board);
+    s[0] = __builtin_bswap64(s[0]);
+    s[1] = __builtin_bswap64(s[1]);
+    board = _mm_load_si128((const __m128i *)s);
+#endif  // __SSSE3__
+
+    return _mm_srli_epi64(board, (8 - rows) << 3);
+}
+
+static inline __m128i MirrorHorizontalPair(__m128i board, int cols) {
+    const __m128i k1 = _mm_set1_epi64x(0x5555555555555555LL);
+    const __m128i k2 = _mm_set1_epi64x(0x3333333333333333LL);
+    const __m128i k4 = _mm_set1_epi64x(0x0f0f0f0f0f0f0f0fLL);
+    board = _mm_or_si128(_mm_and_si128(_mm_srli_epi64(board, 1), k1),
+                         _mm_slli_epi64(_mm_and_si128(board, k1), 1));
+    board = _mm_or_si128(_mm_and_si128(_mm_srli_epi64(board, 2), k2),
+                         _mm_slli_epi64(_mm_and_si128(board, k2), 2));
+    board = _mm_or_si128(_mm_and_si128(_mm_srli_epi64(board, 4), k4),
+                         _mm_slli_epi64(_mm_and_si128(board, k4), 4));
+
+    return _mm_srli_epi64(board, 8 - cols);
+}
+
+static inline void GridApplyPair(const uint64_t board[2], uint8_t ops,
+                                 int rows, int cols, uint64_t dest[2]) {
+    __m128i x = _mm_loadu_si128((const __m128i *)board);
+    if (ops & kGridOpTranspose) x = TransposePair(x);
+    if (ops & kGridOpFlip) x = FlipVerticalPair(x, rows);
+    if (ops & kGridOpMirror) x = MirrorHorizontalPair(x, cols);
+    _mm_storeu_si128((__m128i *)dest, x);
+}
+#else   // __SSE2__ not defined
+static inline void GridApplyPair(const uint64_t board[2], uint8_t ops,
+                                 int rows, int cols, uint64_t dest[2]) {
+    dest[0] = GridApply(board[0], ops, rows, cols);
+    dest[1] = GridApply(board[1], ops, rows, cols);
+}
+#endif  // __SSE2__
+
+// ------------------------------- Compilation -------------------------------
+
+void BitboardSymmetryOptionsSetDefaults(BitboardSymmetryOptions *options) {
+    options->board_size = 0;
+    options->symmetry_matrix = NULL;
+    options->num_symmetries = 1;
+    options->slot_to_bit = NULL;
+    options->num_planes = 1;
+    options->plane_stride = 0;
+}
+
+static int SlotToBit(const BitboardSymmetryOptions *options, int slot,
+                     int plane) {
+    int bit = options->slot_to_bit ? options->slot_to_bit[slot] : slot;
+
+    return bit + plane * options->plane_stride;
+}
+
+static bool ValidateLayout(const BitboardSymmetryOptions *options) {
+    if (options->board_size <= 0 || options->board_size > 64) return false;
+    if (options->num_symmetries <= 0) return false;
+    if (options->num_symmetries > kBitboardSymmetryMax) return false;
+    if (options->num_planes <= 0) return false;
+    if (options->num_planes > 1 && options->plane_stride <= 0) return false;
+
+    // Each slot of each plane must be mapped to a distinct bit.
+    uint64_t used = 0;
+    for (int p = 0; p < options->num_planes; ++p) {
+        for (int i = 0; i < options->board_size; ++i) {
+            int bit = SlotToBit(options, i, p);
+            if (bit < 0 || bit >= 64) return false;
+            if (used & (1ULL << bit)) return false;
+            used |= 1ULL << bit;
+        }
+    }
+
+    return true;
+}
+
+static bool ValidateOptions(const BitboardSymmetryOptions *options) {
+    if (!ValidateLayout(options)) return false;
+    if (options->num_symmetries > 1 && options->symmetry_matrix == NULL) {
+        return false;
+    }
+
+    // Each row of the symmetry matrix must be a permutation.
+    for (int s = 0; s < options->num_symmetries && options->symmetry_matrix;
+         ++s) {
+        uint64_t image = 0;
+        for (int i = 0; i < options->board_size; ++i) {
+            int dest = options->symmetry_matrix[s][i];
+            if (dest < 0 || dest >= options->board_size) return false;
+            image |= 1ULL << dest;
+        }
+        if (Popcount64(image) != options->board_size) return false;
+    }
+
+    return true;
+}
+
+static int CountActiveBytes(uint64_t domain) {
+    int ret = 0;
+    for (int i = 0; i < 8; ++i) {
+        ret += ((domain >> (i << 3)) & 0xFF) != 0;
+    }
+
+    return ret;
+}
+
+intptr_t BitboardSymmetryGetMemoryRequired(
+    const BitboardSymmetryOptions *options) {
+    //
+    if (!ValidateLayout(options)) return 0;
+    uint64_t domain = 0;
+    for (int p = 0; p < options->num_planes; ++p) {
+        for (int i = 0; i < options->board_size; ++i) {
+            domain |= 1ULL << SlotToBit(options, i, p);
+        }
+    }
+
+    return (intptr_t)options->num_symmetries * CountActiveBytes(domain) * 256 *
+           (intptr_t)sizeof(uint64_t);
+}
+
+// Builds the bit-level permutation PERM of symmetry S. Bits outside DOMAIN are
+// mapped to themselves.
+static void BuildBitPermutation(const BitboardSymmetryOptions *options, int s,
+                                int perm[64]) {
+    for (int i = 0; i < 64; ++i) {
+        perm[i] = i;
+    }
+    if (options->symmetry_matrix == NULL) return;
+
+    for (int p = 0; p < options->num_planes; ++p) {
+        for (int i = 0; i < options->board_size; ++i) {
+            int dest_slot = options->symmetry_matrix[s][i];
+            perm[SlotToBit(options, i, p)] = SlotToBit(options, dest_slot, p);
+        }
+    }
+}
+
+static bool IsIdentity(const int perm[64], uint64_t domain) {
+    for (int i = 0; i < 64; ++i) {
+        if (((domain >> i) & 1) && perm[i] != i) return false;
+    }
+
+    return true;
+}
+
+static bool GridMatches(const int perm[64], uint64_t domain, uint8_t ops,
+                        int rows, int cols) {
+    for (int i = 0; i < 64; ++i) {
+        if (!((domain >> i) & 1)) continue;
+        if (GridApply(1ULL << i, ops, rows, cols) != (1ULL << perm[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Returns the grid operation mask that implements PERM on the given grid
+// dimensions, or 0 if there is none.
+static uint8_t FindGridOps(const int perm[64], uint64_t domain, int rows,
+                           int cols) {
+    for (uint8_t ops = 1; ops <= kGridOpAll; ++ops) {
+        if (GridMatches(perm, domain, ops, rows, cols)) return ops;
+    }
+
+    return 0;
+}
+
+// Picks the grid dimensions under which the largest number of non-identity
+// symmetries can be evaluated using grid kernels.
+static void SelectGrid(int num_symmetries, const int (*perms)[64],
+                       const bool *identity, uint64_t domain,
+                       BitboardSymmetry *symmetry) {
+    int best_count = 0;
+    for (int rows = 1; rows <= 8; ++rows) {
+        for (int cols = 1; cols <= 8; ++cols) {
+            int count = 0;
+            for (int s = 0; s < num_symmetries; ++s) {
+                if (identity[s]) continue;
+                count += FindGridOps(perms[s], domain, rows, cols) != 0;
+            }
+            if (count > best_count) {
+                best_count = count;
+                symmetry->grid_rows = (int8_t)rows;
+                symmetry->grid_cols = (int8_t)cols;
+            }
+        }
+    }
+}
+
+static void FillTables(const int perm[64], const BitboardSymmetry *symmetry,
+                       uint64_t domain, uint64_t *tables) {
+    for (int b = 0; b < symmetry->num_bytes; ++b) {
+        int base = symmetry->bytes[b] << 3;
+        uint64_t *table = tables + b * 256;
+        for (int v = 0; v < 256; ++v) {
+            uint64_t image = 0;
+            for (int i = 0; i < 8; ++i) {
+                int bit = base + i;
+                if (!((v >> i) & 1) || !((domain >> bit) & 1)) continue;
+                image |= 1ULL << perm[bit];
+            }
+            table[v] = image;
+        }
+    }
+}
+
+int BitboardSymmetryInit(BitboardSymmetry *symmetry,
+                         const BitboardSymmetryOptions *options) {
+    memset(symmetry, 0, sizeof(*symmetry));
+    if (!ValidateOptions(options)) {
+        fprintf(stderr, "BitboardSymmetryInit: invalid options\n");
+        return kIllegalArgumentError;
+    }
+
+    uint64_t domain = 0;
+    for (int p = 0; p < options->num_planes; ++p) {
+        for (int i = 0; i < options->board_size; ++i) {
+            domain |= 1ULL << SlotToBit(options, i, p);
+        }
+    }
+    for (int i = 0; i < 8; ++i) {
+        if ((domain >> (i << 3)) & 0xFF) {
+            symmetry->bytes[symmetry->num_bytes++] = (int8_t)i;
+        }
+    }
+
+    // Build bit-level permutations and detect identities.
+    int num_symmetries = symmetry->num_symmetries = options->num_symmetries;
+    int perms[kBitboardSymmetryMax][64];
+    bool identity[kBitboardSymmetryMax];
+    for (int s = 0; s < num_symmetries; ++s) {
+        BuildBitPermutation(options, s, perms[s]);
+        identity[s] = IsIdentity(perms[s], domain);
+    }
+
+    // Assign kernels.
+    SelectGrid(num_symmetries, (const int(*)[64])perms, identity, domain,
+               symmetry);
+    int num_tables = 0;
+    for (int s = 0; s < num_symmetries; ++s) {
+        uint8_t ops = 0;
+        if (identity[s]) {
+            symmetry->kernels[s] = kBitboardSymmetryKernelIdentity;
+        } else if (symmetry->grid_rows > 0 &&
+                   (ops = FindGridOps(perms[s], domain, symmetry->grid_rows,
+                                      symmetry->grid_cols)) != 0) {
+            symmetry->kernels[s] = kBitboardSymmetryKernelGrid;
+            symmetry->params[s] = ops;
+        } else {
+            symmetry->kernels[s] = kBitboardSymmetryKernelTable;
+            symmetry->params[s] = (uint8_t)num_tables++;
+        }
+    }
+
+    // Fill byte tables for the remaining symmetries.
+    if (num_tables == 0) return kNoError;
+    intptr_t table_block_size = (intptr_t)symmetry->num_bytes * 256;
+    symmetry->tables = (uint64_t *)GamesmanMalloc(
+        num_tables * table_block_size * sizeof(uint64_t));
+    if (symmetry->tables == NULL) {
+        BitboardSymmetryDestroy(symmetry);
+        return kMallocFailureError;
+    }
+    for (int s = 0; s < num_symmetries; ++s) {
+        if (symmetry->kernels[s] != kBitboardSymmetryKernelTable) continue;
+        FillTables(perms[s], symmetry, domain,
+                   symmetry->tables + symmetry->params[s] * table_block_size);
+    }
+
+    return kNoError;
+}
+
+void BitboardSymmetryDestroy(BitboardSymmetry *symmetry) {
+    GamesmanFree(symmetry->tables);
+    memset(symmetry, 0, sizeof(*symmetry));
+}
+
+// ------------------------------- Evaluation -------------------------------
+
+static inline uint64_t TableApply(const BitboardSymmetry *symmetry,
+                                  uint64_t board, int index) {
+    const uint64_t *tables =
+        symmetry->tables +
+        (intptr_t)symmetry->params[index] * symmetry->num_bytes * 256;
+    uint64_t ret = 0;
+    for (int b = 0; b < symmetry->num_bytes; ++b) {
+        ret |= tables[(b << 8) | ((board >> (symmetry->bytes[b] << 3)) & 0xFF)];
+    }
+
+    return ret;
+}
+
+uint64_t BitboardSymmetryApply(const BitboardSymmetry *symmetry,
+                               uint64_t board, int index) {
+    switch (symmetry->kernels[index]) {
+        case kBitboardSymmetryKernelGrid:
+            return GridApply(board, symmetry->params[index],
+                             symmetry->grid_rows, symmetry->grid_cols);
+        case kBitboardSymmetryKernelTable:
+            return TableApply(symmetry, board, index);
+        default:
+            return board;
+    }
+}
+
+uint64_t BitboardSymmetryGetCanonical(const BitboardSymmetry *symmetry,
+                                      uint64_t board, int *index) {
+    uint64_t min_board = BitboardSymmetryApply(symmetry, board, 0);
+    int min_index = 0;
+    for (int s = 1; s < symmetry->num_symmetries; ++s) {
+        uint64_t image = BitboardSymmetryApply(symmetry, board, s);
+        if (image < min_board) {
+            min_board = image;
+            min_index = s;
+        }
+    }
+    if (index != NULL) *index = min_index;
+
+    return min_board;
+}
+
+void BitboardSymmetryGetCanonicalBatch(const BitboardSymmetry *symmetry,
+                                       const uint64_t *boards, int64_t n,
+                                       uint64_t *canonical, int8_t *indices) {
+    uint64_t src[kBatchBlockSize], min_board[kBatchBlockSize];
+    int8_t min_index[kBatchBlockSize];
+    for (int64_t begin = 0; begin < n; begin += kBatchBlockSize) {
+        int count = (n - begin < kBatchBlockSize) ? (int)(n - begin)
+                                                  : (int)kBatchBlockSize;
+        for (int j = 0; j < count; ++j) {
+            src[j] = boards[begin + j];
+            min_board[j] = BitboardSymmetryApply(symmetry, src[j], 0);
+            min_index[j] = 0;
+        }
+
+        // Symmetry-major order: dispatch on the kernel once per block and keep
+        // the tables of a single symmetry hot.
+        for (int s = 1; s < symmetry->num_symmetries; ++s) {
+            int8_t kernel = symmetry->kernels[s];
+            if (kernel == kBitboardSymmetryKernelIdentity) continue;
+            for (int j = 0; j < count; ++j) {
+                uint64_t image =
+                    (kernel == kBitboardSymmetryKernelGrid)
+                        ? GridApply(src[j], symmetry->params[s],
+                                    symmetry->grid_rows, symmetry->grid_cols)
+                        : TableApply(symmetry, src[j], s);
+                if (image < min_board[j]) {
+                    min_board[j] = image;
+                    min_index[j] = (int8_t)s;
+                }
+            }
+        }
+
+        for (int j = 0; j < count; ++j) {
+            canonical[begin + j] = min_board[j];
+            if (indices != NULL) indices[begin + j] = min_index[j];
+        }
+    }
+}
+
+void BitboardSymmetryApplyPair(const BitboardSymmetry *symmetry,
+                               const uint64_t board[2], int index,
+                               uint64_t dest[2]) {
+    switch (symmetry->kernels[index]) {
+        case kBitboardSymmetryKernelGrid:
+            GridApplyPair(board, symmetry->params[index], symmetry->grid_rows,
+                          symmetry->grid_cols, dest);
+            break;
+        case kBitboardSymmetryKernelTable: {
+            uint64_t lo = TableApply(symmetry, board[0], index);
+            uint64_t hi = TableApply(symmetry, board[1], index);
+            dest[0] = lo;
+            dest[1] = hi;
+            break;
+        }
+        default:
+            dest[0] = board[0];
+            dest[1] = board[1];
+    }
+}
+
+static inline bool PairLessThan(const uint64_t a[2], const uint64_t b[2]) {
+    return a[1] < b[1] || (a[1] == b[1] && a[0] < b[0]);
+}
+
+int BitboardSymmetryGetCanonicalPair(const BitboardSymmetry *symmetry,
+                                     const uint64_t board[2],
+                                     uint64_t canonical[2]) {
+    uint64_t src[2] = {board[0], board[1]}, min_board[2], image[2];
+    BitboardSymmetryApplyPair(symmetry, src, 0, min_board);
+    int min_index = 0;
+    for (int s = 1; s < symmetry->num_symmetries; ++s) {
+        BitboardSymmetryApplyPair(symmetry, src, s, image);
+        if (PairLessThan(image, min_board)) {
+            min_board[0] = image[0];
+            min_board[1] = image[1];
+            min_index = s;
+        }
+    }
+    canonical[0] = min_board[0];
+    canonical[1] = min_board[1];
+
+    return min_index;
+}
@@ -0,0 +1,234 @@
+/**
+ * @file bitboard_symmetry.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Generic symmetry canonicalization engine for bit-board games.
+ * @details The engine takes a symmetry group described as permutation matrices
+ * over board slots, together with a description of how the slots are laid out
+ * in a 64-bit word, and compiles each symmetry into the fastest kernel that
+ * implements it:
+ *
+ *   1. identity: the symmetry does not move any bit and is skipped.
+ *   2. grid: the symmetry coincides with a composition of a transpose, a
+ *      vertical flip, and a horizontal mirror of a rows x cols board mapped to
+ *      the bottom right corner of an 8x8 bit grid (the layout used by
+ *      x86_simd_two_piece.h). These are evaluated with byte swaps and delta
+ *      swaps, two boards at a time with SSE2 if available.
+ *   3. table: all other permutations are evaluated with a byte-indexed table
+ *      network, which costs one lookup per non-empty source byte.
+ *
+ * Kernel selection is automatic. The canonical board is defined as the image
+ * with the smallest unsigned 64-bit integer representation, which matches the
+ * definition used by TwoPieceHashGetCanonicalBoard.
+ *
+ * @example Using the engine with the board format of two_piece.h, where the
+ * lower 32 bits hold the O pattern and the upper 32 bits hold the X pattern:
+ *
+ *     BitboardSymmetryOptions options;
+ *     BitboardSymmetryOptionsSetDefaults(&options);
+ *     options.board_size = 9;
+ *     options.symmetry_matrix = symmetry_matrix;  // const int *const *
+ *     options.num_symmetries = 8;
+ *     options.num_planes = 2;
+ *     options.plane_stride = 32;
+ *     BitboardSymmetry symmetry;
+ *     int error = BitboardSymmetryInit(&symmetry, &options);
+ *     ...
+ *     int index;
+ *     uint64_t canonical =
+ *         BitboardSymmetryGetCanonical(&symmetry, board, &index);
+ *     ...
+ *     BitboardSymmetryDestroy(&symmetry);
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_HASH_BITBOARD_SYMMETRY_H_
+#define GAMESMANONE_CORE_HASH_BITBOARD_SYMMETRY_H_
+
+#include <stdint.h>  // int8_t, int64_t, intptr_t, uint64_t
+
+/** @brief Maximum number of symmetries supported by the engine. */
+enum { kBitboardSymmetryMax = 64 };
+
+/** @brief Kernel used to evaluate a single symmetry. */
+typedef enum BitboardSymmetryKernel {
+    kBitboardSymmetryKernelIdentity, /**< Leaves the board unchanged. */
+    kBitboardSymmetryKernelGrid,     /**< Transpose/flip/mirror on 8x8 grid. */
+    kBitboardSymmetryKernelTable,    /**< Byte-table permutation network. */
+} BitboardSymmetryKernel;
+
+/** @brief Options for BitboardSymmetryInit. */
+typedef struct BitboardSymmetryOptions {
+    /** Number of slots on the board. */
+    int board_size;
+
+    /**
+     * A 2D array of size \c num_symmetries by \c board_size. Slot \c j of the
+     * original board is moved to slot \c symmetry_matrix[i][j] under the i-th
+     * symmetry. This is the same convention as TwoPieceHashInit.
+     */
+    const int *const *symmetry_matrix;
+
+    /** Number of symmetries in the group, including the identity. */
+    int num_symmetries;
+
+    /**
+     * Optional array of size \c board_size mapping each slot to its bit index
+     * within a plane. Set to \c NULL to map slot \c i to bit \c i.
+     */
+    const int *slot_to_bit;
+
+    /** Number of piece planes packed in each 64-bit word. */
+    int num_planes;
+
+    /** Bit offset between two adjacent planes in the same 64-bit word. */
+    int plane_stride;
+} BitboardSymmetryOptions;
+
+/**
+ * @brief Compiled symmetry group. All fields are read-only after
+ * initialization and the object may be shared by multiple threads.
+ */
+typedef struct BitboardSymmetry {
+    /** Number of symmetries in the group. */
+    int num_symmetries;
+
+    /** Kernel type of each symmetry. */
+    int8_t kernels[kBitboardSymmetryMax];
+
+    /**
+     * Kernel parameter of each symmetry. For grid kernels, this is the bit mask
+     * of grid operations to apply. For table kernels, this is the index of the
+     * symmetry's block of byte tables.
+     */
+    uint8_t params[kBitboardSymmetryMax];
+
+    /** Effective number of rows of the grid, if any grid kernel is used. */
+    int8_t grid_rows;
+
+    /** Effective number of columns of the grid, if any grid kernel is used. */
+    int8_t grid_cols;
+
+    /** Number of source bytes that may contain set bits. */
+    int8_t num_bytes;
+
+    /** Indices of the source bytes that may contain set bits. */
+    int8_t bytes[8];
+
+    /** Byte tables of size [num_table_kernels][num_bytes][256]. */
+    uint64_t *tables;
+} BitboardSymmetry;
+
+/**
+ * @brief Sets \p options to its default values: one plane of zero slots
+ * laid out in bit order and no symmetries.
+ */
+void BitboardSymmetryOptionsSetDefaults(BitboardSymmetryOptions *options);
+
+/**
+ * @brief Returns the maximum amount of memory in bytes that a compiled
+ * symmetry group described by \p options may use.
+ */
+intptr_t BitboardSymmetryGetMemoryRequired(
+    const BitboardSymmetryOptions *options);
+
+/**
+ * @brief Compiles the symmetry group described by \p options into \p symmetry.
+ *
+ * @param symmetry Symmetry group to initialize.
+ * @param options Description of the symmetry group and the board layout.
+ * @return \c kNoError on success,
+ * @return \c kIllegalArgumentError if \p options describes an invalid layout or
+ * more than \c kBitboardSymmetryMax symmetries, or
+ * @return \c kMallocFailureError on failure to allocate memory.
+ */
+int BitboardSymmetryInit(BitboardSymmetry *symmetry,
+                         const BitboardSymmetryOptions *options);
+
+/**
+ * @brief Deallocates \p symmetry.
+ */
+void BitboardSymmetryDestroy(BitboardSymmetry *symmetry);
+
+/**
+ * @brief Returns the image of \p board under the symmetry of index \p index.
+ */
+uint64_t BitboardSymmetryApply(const BitboardSymmetry *symmetry,
+                               uint64_t board, int index);
+
+/**
+ * @brief Returns the canonical image of \p board, which is the image with the
+ * smallest unsigned integer value among all symmetries in the group.
+ *
+ * @param symmetry Compiled symmetry group.
+ * @param board Source board.
+ * @param index (Output parameter) If not \c NULL, the index of the first
+ * symmetry that maps \p board to the returned canonical board is stored here.
+ * @return The canonical board.
+ */
+uint64_t BitboardSymmetryGetCanonical(const BitboardSymmetry *symmetry,
+                                      uint64_t board, int *index);
+
+/**
+ * @brief Same as calling BitboardSymmetryGetCanonical on each of the \p n
+ * \p boards, storing the results in \p canonical and \p indices. The boards are
+ * processed symmetry-major in small blocks so that the tables of each symmetry
+ * stay in cache.
+ *
+ * @param symmetry Compiled symmetry group.
+ * @param boards Array of \p n source boards.
+ * @param n Number of boards.
+ * @param canonical (Output parameter) Array of size at least \p n. May alias
+ * \p boards.
+ * @param indices (Output parameter) If not \c NULL, array of size at least
+ * \p n to store the symmetry index of each canonical board.
+ */
+void BitboardSymmetryGetCanonicalBatch(const BitboardSymmetry *symmetry,
+                                       const uint64_t *boards, int64_t n,
+                                       uint64_t *canonical, int8_t *indices);
+
+/**
+ * @brief Applies the symmetry of index \p index to both words of \p board and
+ * stores the result in \p dest, which may alias \p board. Designed for boards
+ * stored as two 64-bit planes, such as the format used by x86_simd_two_piece.h,
+ * in which case \p symmetry should be compiled with one plane per word.
+ */
+void BitboardSymmetryApplyPair(const BitboardSymmetry *symmetry,
+                               const uint64_t board[2], int index,
+                               uint64_t dest[2]);
+
+/**
+ * @brief Stores the canonical image of the two-word \p board in \p canonical.
+ * Two-word boards are compared as unsigned 128-bit integers with \c board[1]
+ * being the more significant word, which matches the ordering of __m128i
+ * boards in x86_simd_two_piece.h.
+ *
+ * @param symmetry Compiled symmetry group.
+ * @param board Source board.
+ * @param canonical (Output parameter) Canonical board. May alias \p board.
+ * @return Index of the first symmetry that maps \p board to the canonical
+ * board.
+ */
+int BitboardSymmetryGetCanonicalPair(const BitboardSymmetry *symmetry,
+                                     const uint64_t board[2],
+                                     uint64_t canonical[2]);
+
+#endif  // GAMESMANONE_CORE_HASH_BITBOARD_SYMMETRY_H_
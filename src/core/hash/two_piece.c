@@ -58,6 +58,7 @@
 #include <stdio.h>      // fprintf, stderr
 
 #include "core/gamesman_memory.h"
+#include "core/hash/bitboard_symmetry.h"
 #include "core/misc.h"
 #include "core/types/gamesman_types.h"
 
@@ -67,8 +68,20 @@ static int curr_board_size;
 static int32_t *pattern_to_order;
 static uint32_t **pop_order_to_pattern;
 
-static int curr_num_symmetries;
-static uint32_t **pattern_symmetries;  // [symm][pattern]
+static BitboardSymmetry symmetry;
+
+// The X and O patterns are two planes of the same 64-bit word, 32 bits apart.
+static void SetSymmetryOptions(BitboardSymmetryOptions *options,
+                               int board_size,
+                               const int *const *symmetry_matrix,
+                               int num_symmetries) {
+    BitboardSymmetryOptionsSetDefaults(options);
+    options->board_size = board_size;
+    options->symmetry_matrix = symmetry_matrix;
+    options->num_symmetries = num_symmetries;
+    options->num_planes = 2;
+    options->plane_stride = 32;
+}
 
 intptr_t TwoPieceHashGetMemoryRequired(int board_size, int num_symmetries) {
     intptr_t ret = (1 << board_size) * sizeof(int32_t);
@@ -76,7 +89,9 @@ intptr_t TwoPieceHashGetMemoryRequired(int board_size, int num_symmetries) {
     ret += (1 << board_size) * sizeof(int32_t);  // Binomial theorem
 
     if (num_symmetries > 1) {
-        ret += num_symmetries * (1 << board_size) * sizeof(uint32_t);
+        BitboardSymmetryOptions options;
+        SetSymmetryOptions(&options, board_size, NULL, num_symmetries);
+        ret += BitboardSymmetryGetMemoryRequired(&options);
     }
 
     return ret;
@@ -108,28 +123,13 @@ static int InitTables(void) {
     return kNoError;
 }
 
-static int InitSymmetries(const int *const *symmetry_matrix) {
-    // Allocate space
-    pattern_symmetries = (uint32_t **)GamesmanCallocWhole(curr_num_symmetries,
-                                                          sizeof(uint32_t *));
-    if (!pattern_symmetries) return kMallocFailureError;
-    for (int i = 0; i < curr_num_symmetries; ++i) {
-        pattern_symmetries[i] = (uint32_t *)GamesmanMalloc(
-            (1 << curr_board_size) * sizeof(uint32_t));
-        if (!pattern_symmetries[i]) return kMallocFailureError;
-    }
-
-    for (uint32_t pattern = 0; pattern < (1U << curr_board_size); ++pattern) {
-        for (int i = 0; i < curr_num_symmetries; ++i) {
-            uint32_t sym = 0;
-            for (int j = 0; j < curr_board_size; ++j) {
-                sym |= ((pattern >> j) & 1U) << symmetry_matrix[i][j];
-            }
-            pattern_symmetries[i][pattern] = sym;
-        }
-    }
+static int InitSymmetries(const int *const *symmetry_matrix,
+                          int num_symmetries) {
+    BitboardSymmetryOptions options;
+    SetSymmetryOptions(&options, curr_board_size, symmetry_matrix,
+                       num_symmetries);
 
-    return kNoError;
+    return BitboardSymmetryInit(&symmetry, &options);
 }
 
 int TwoPieceHashInit(int board_size, const int *const *symmetry_matrix,
@@ -153,17 +153,16 @@ int TwoPieceHashInit(int board_size, const int *const *symmetry_matrix,
 
     // Initialize the symmetry lookup table if requested
     if (symmetry_matrix && num_symmetries > 1) {
-        if (num_symmetries > INT8_MAX) {
+        if (num_symmetries > kBitboardSymmetryMax) {
             fprintf(stderr,
                     "TwoPieceHashInit: too many symmetries (%d) provided. At "
                     "most %d are supported\n",
-                    num_symmetries, INT8_MAX);
+                    num_symmetries, kBitboardSymmetryMax);
             TwoPieceHashFinalize();
             return kIllegalArgumentError;
         }
 
-        curr_num_symmetries = num_symmetries;
-        int error = InitSymmetries(symmetry_matrix);
+        int error = InitSymmetries(symmetry_matrix, num_symmetries);
         if (error != kNoError) {
             TwoPieceHashFinalize();
             return error;
@@ -187,20 +186,11 @@ void TwoPieceHashFinalize(void) {
         pop_order_to_pattern = NULL;
     }
 
-    // pattern_symmetries
-    if (pattern_symmetries != NULL) {
-        for (int i = 0; i < curr_num_symmetries; ++i) {
-            GamesmanFree(pattern_symmetries[i]);
-        }
-        GamesmanFree(pattern_symmetries);
-        pattern_symmetries = NULL;
-    }
+    // Compiled symmetry group, also resets the number of symmetries.
+    BitboardSymmetryDestroy(&symmetry);
 
     // Reset the board size
     curr_board_size = 0;
-
-    // Reset number of symmetries.
-    curr_num_symmetries = 0;
 }
 
 int64_t TwoPieceHashGetNumPositions(int num_x, int num_o) {
@@ -259,15 +249,7 @@ uint64_t TwoPieceHashUnhash(Position hash, int num_x, int num_o) {
 int TwoPieceHashGetTurn(Position hash) { return hash & 1; }
 
 uint64_t TwoPieceHashGetCanonicalBoard(uint64_t board) {
-    uint64_t min_board = board;
-    for (int i = 1; i < curr_num_symmetries; ++i) {
-        uint32_t s_x = (uint32_t)(board >> 32);
-        uint32_t s_o = (uint32_t)board;
-        uint32_t c_x = pattern_symmetries[i][s_x];
-        uint32_t c_o = pattern_symmetries[i][s_o];
-        uint64_t new_board = (((uint64_t)c_x) << 32) | (uint64_t)c_o;
-        if (new_board < min_board) min_board = new_board;
-    }
+    if (symmetry.num_symmetries <= 1) return board;
 
-    return min_board;
+    return BitboardSymmetryGetCanonical(&symmetry, board, NULL);
 }
@@ -0,0 +1,244 @@
+/**
+ * @file hbatch.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the batch position query of headless mode.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/headless/hbatch.h"
+
+#include <stdbool.h>  // bool, true, false
+#include <stddef.h>   // NULL, size_t
+#include <stdint.h>   // int64_t
+#include <stdio.h>    // FILE, fopen, fclose, getline, printf
+#include <stdlib.h>   // free
+#include <string.h>   // memcpy, strcspn
+
+#include "core/concurrency.h"
+#include "core/gamesman_memory.h"
+#include "core/headless/hjson.h"
+#include "core/headless/hquery.h"
+#include "core/headless/hutils.h"
+#include "core/misc.h"
+#include "core/solvers/solver_manager.h"
+#include "core/types/gamesman_types.h"
+
+enum {
+    /** Number of positions read and answered at a time. */
+    kBatchSize = 4096,
+};
+
+/** @brief Positions of a chunk of input and their responses. */
+typedef struct BatchChunk {
+    char *lines[kBatchSize];
+    size_t capacities[kBatchSize];
+    int size;
+
+    TierPositionArray probes[kBatchSize];
+    int64_t offsets[kBatchSize + 1];
+    int errors[kBatchSize];
+    HeadlessJsonWriter responses[kBatchSize];
+
+    Value *values;
+    int *remotenesses;
+} BatchChunk;
+
+static BatchChunk *BatchChunkCreate(void);
+static void BatchChunkDestroy(BatchChunk *chunk);
+static int ReadChunk(BatchChunk *chunk, FILE *in);
+static int AnswerChunk(SolverProbe *probe, BatchChunk *chunk);
+static int ProbeChunk(SolverProbe *probe, BatchChunk *chunk);
+static int PrintChunk(BatchChunk *chunk);
+
+// -----------------------------------------------------------------------------
+
+int HeadlessQueryBatch(ReadOnlyString game_name, int variant_id,
+                       ReadOnlyString data_path, ReadOnlyString input_path) {
+    int error = HeadlessInitSolver(game_name, variant_id, data_path);
+    if (error != 0) {
+        fprintf(stderr, "HeadlessQueryBatch: game initialization failed\n");
+        return error;
+    }
+
+    FILE *in = input_path == NULL ? stdin : GuardedFopen(input_path, "r");
+    if (in == NULL) return kFileSystemError;
+
+    SolverProbe probe;
+    BatchChunk *chunk = BatchChunkCreate();
+    if (chunk == NULL) {
+        error = kMallocFailureError;
+        goto _bailout;
+    }
+    error = SolverManagerProbeInit(&probe);
+    if (error != 0) {
+        fprintf(stderr, "HeadlessQueryBatch: failed to initialize probe\n");
+        goto _bailout;
+    }
+
+    while ((error = ReadChunk(chunk, in)) == kNoError && chunk->size > 0) {
+        error = AnswerChunk(&probe, chunk);
+        if (error != kNoError) break;
+        error = PrintChunk(chunk);
+        if (error != kNoError) break;
+    }
+    SolverManagerProbeDestroy(&probe);
+
+_bailout:
+    BatchChunkDestroy(chunk);
+    if (in != stdin) fclose(in);
+
+    return error;
+}
+
+// -----------------------------------------------------------------------------
+
+static BatchChunk *BatchChunkCreate(void) {
+    BatchChunk *chunk =
+        (BatchChunk *)GamesmanCallocWhole(1, sizeof(BatchChunk));
+    if (chunk == NULL) return NULL;
+
+    for (int i = 0; i < kBatchSize; ++i) {
+        TierPositionArrayInit(&chunk->probes[i]);
+        HeadlessJsonWriterInit(&chunk->responses[i]);
+    }
+
+    return chunk;
+}
+
+static void BatchChunkDestroy(BatchChunk *chunk) {
+    if (chunk == NULL) return;
+
+    for (int i = 0; i < kBatchSize; ++i) {
+        free(chunk->lines[i]);
+        TierPositionArrayDestroy(&chunk->probes[i]);
+        HeadlessJsonWriterDestroy(&chunk->responses[i]);
+    }
+    GamesmanFree(chunk->values);
+    GamesmanFree(chunk->remotenesses);
+    GamesmanFree(chunk);
+}
+
+// Reads up to kBatchSize lines from IN into CHUNK. Blank lines are kept so
+// that each input line gets a response. Line buffers are reused across chunks.
+static int ReadChunk(BatchChunk *chunk, FILE *in) {
+    chunk->size = 0;
+    while (chunk->size < kBatchSize) {
+        int i = chunk->size;
+        if (getline(&chunk->lines[i], &chunk->capacities[i], in) < 0) {
+            return ferror(in) ? kFileSystemError : kNoError;
+        }
+        chunk->lines[i][strcspn(chunk->lines[i], "\r\n")] = '\0';
+        ++chunk->size;
+    }
+
+    return kNoError;
+}
+
+static int AnswerChunk(SolverProbe *probe, BatchChunk *chunk) {
+    // Collect the tier positions needed by each response.
+    PRAGMA_OMP_PARALLEL_FOR_SCHEDULE_DYNAMIC(16)
+    for (int i = 0; i < chunk->size; ++i) {
+        chunk->probes[i].size = 0;
+        if (chunk->lines[i][0] == '\0') {
+            chunk->errors[i] = kIllegalArgumentError;  // Blank line.
+        } else {
+            chunk->errors[i] =
+                HeadlessQueryCollectProbes(chunk->lines[i], &chunk->probes[i]);
+        }
+    }
+
+    int error = ProbeChunk(probe, chunk);
+    if (error != kNoError) return error;
+
+    // Write the responses. Each line has its own writer, whose buffer is
+    // reused across chunks.
+    PRAGMA_OMP_PARALLEL_FOR_SCHEDULE_DYNAMIC(16)
+    for (int i = 0; i < chunk->size; ++i) {
+        HeadlessJsonWriter *response = &chunk->responses[i];
+        HeadlessJsonWriterClear(response);
+        if (chunk->errors[i] == kNoError) {
+            int64_t offset = chunk->offsets[i];
+            chunk->errors[i] = HeadlessQueryWritePositionResponseFromResults(
+                chunk->lines[i], chunk->values + offset,
+                chunk->remotenesses + offset, response);
+        }
+        if (chunk->errors[i] != kNoError) {
+            HeadlessJsonWriterClear(response);
+            ReadOnlyString message = HeadlessExplainError(chunk->errors[i]);
+            if (HeadlessJsonWriteError(response, message) != kNoError) {
+                chunk->errors[i] = kMallocFailureError;
+                HeadlessJsonWriterClear(response);
+            }
+        }
+    }
+
+    return kNoError;
+}
+
+// Probes all tier positions collected for CHUNK in one batch, letting the
+// database visit each tier file and each block once.
+static int ProbeChunk(SolverProbe *probe, BatchChunk *chunk) {
+    chunk->offsets[0] = 0;
+    for (int i = 0; i < chunk->size; ++i) {
+        int64_t size = chunk->errors[i] == kNoError ? chunk->probes[i].size : 0;
+        chunk->offsets[i + 1] = chunk->offsets[i] + size;
+    }
+    int64_t total = chunk->offsets[chunk->size];
+
+    GamesmanFree(chunk->values);
+    GamesmanFree(chunk->remotenesses);
+    chunk->values = (Value *)GamesmanMalloc((total + 1) * sizeof(Value));
+    chunk->remotenesses = (int *)GamesmanMalloc((total + 1) * sizeof(int));
+    TierPosition *tier_positions =
+        (TierPosition *)GamesmanMalloc((total + 1) * sizeof(TierPosition));
+    if (chunk->values == NULL || chunk->remotenesses == NULL ||
+        tier_positions == NULL) {
+        GamesmanFree(tier_positions);
+        return kMallocFailureError;
+    }
+
+    for (int i = 0; i < chunk->size; ++i) {
+        int64_t size = chunk->offsets[i + 1] - chunk->offsets[i];
+        memcpy(tier_positions + chunk->offsets[i], chunk->probes[i].array,
+               size * sizeof(TierPosition));
+    }
+    int error = SolverManagerProbeBatch(probe, total, tier_positions,
+                                        chunk->values, chunk->remotenesses);
+    GamesmanFree(tier_positions);
+
+    return error;
+}
+
+// Prints the responses of CHUNK in input order. A line whose error response
+// could not be written is left out and reported as a memory failure.
+static int PrintChunk(BatchChunk *chunk) {
+    int ret = kNoError;
+    for (int i = 0; i < chunk->size && ret == kNoError; ++i) {
+        const HeadlessJsonWriter *response = &chunk->responses[i];
+        if (response->length == 0) {
+            ret = kMallocFailureError;
+        } else if (printf("%s\n", HeadlessJsonWriterGetString(response)) < 0) {
+            ret = kFileSystemError;
+        }
+    }
+
+    return ret;
+}
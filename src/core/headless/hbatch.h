@@ -0,0 +1,56 @@
+/**
+ * @file hbatch.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Batch position query of headless mode.
+ * @details Formal positions are read one per line and answered in chunks. For
+ * each chunk, the positions whose values are needed by the responses are first
+ * collected in parallel, then probed in a single batch so that the database
+ * can visit each tier file and each block once, and finally the responses are
+ * built and serialized in parallel using the probed results.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_HEADLESS_HBATCH_H_
+#define GAMESMANONE_CORE_HEADLESS_HBATCH_H_
+
+#include "core/types/gamesman_types.h"
+
+/**
+ * @brief Prints out a detailed position response for each formal position read
+ * from INPUT_PATH, one line per position, for game GAME_NAME, variant index
+ * VARIANT_ID. Each response is identical to the one printed by
+ * HeadlessQuery(). Positions that cannot be queried are answered with
+ * { "error": "<message>" }, including blank lines, so that the N-th line of
+ * output always answers the N-th line of input.
+ *
+ * @param game_name Name of the game used internally by GAMESMAN.
+ * @param variant_id Index of the variant to load. If negative, the default
+ * variant will be loaded.
+ * @param data_path Path to the "data" directory. The default path will be used
+ * if set to NULL.
+ * @param input_path Path to the file of formal positions, or NULL to read from
+ * stdin.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessQueryBatch(ReadOnlyString game_name, int variant_id,
+                       ReadOnlyString data_path, ReadOnlyString input_path);
+
+#endif  // GAMESMANONE_CORE_HEADLESS_HBATCH_H_
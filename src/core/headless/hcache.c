@@ -0,0 +1,446 @@
+/**
+ * @file hcache.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the position response cache of the headless query
+ * server.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/headless/hcache.h"
+
+#include <fcntl.h>                // O_RDONLY
+#include <inttypes.h>             // PRId64
+#include <json-c/json_object.h>   // json_object and related functions
+#include <json-c/json_tokener.h>  // json_tokener_parse
+#include <stdbool.h>              // bool, true, false
+#include <stddef.h>               // NULL, size_t
+#include <stdint.h>               // int64_t, uint64_t, uint32_t
+#include <stdio.h>                // FILE, fprintf, printf, perror
+#include <stdlib.h>               // qsort
+#include <string.h>               // memcmp, memcpy, strcmp, strlen, ...
+#include <sys/mman.h>             // mmap, munmap
+#include <sys/stat.h>             // fstat
+
+#include "core/data_structures/int64_cache.h"
+#include "core/data_structures/int64_hash_set.h"
+#include "core/game_manager.h"
+#include "core/gamesman_memory.h"
+#include "core/headless/hjson.h"
+#include "core/headless/hquery.h"
+#include "core/headless/hutils.h"
+#include "core/misc.h"
+#include "core/solvers/solver_manager.h"
+#include "core/types/gamesman_types.h"
+
+static const char kCacheFileMagic[8] = {'G', 'M', 'R', 'E', 'S', 'P', '0', '1'};
+
+typedef struct CacheFileHeader {
+    char magic[8];
+    char game[kGameNameLengthMax + 1];
+    int32_t variant_id;
+    int32_t reserved;
+    int64_t num_entries;
+} CacheFileHeader;
+
+struct HeadlessCacheFileEntry {
+    uint64_t hash;          /**< Hash of the formal position. */
+    uint64_t offset;        /**< Offset of the formal position in the file. */
+    uint32_t key_length;    /**< Length of the formal position. */
+    uint32_t value_length;  /**< Length of the response, which follows. */
+};
+
+/** @brief Precomputed response waiting to be written to the cache file. */
+typedef struct PendingEntry {
+    uint64_t hash;
+    char *key;
+    char *value;
+} PendingEntry;
+
+static uint64_t HashFormalPosition(ReadOnlyString formal_position);
+static char *CopyString(ReadOnlyString str);
+static int GetCurrentVariantId(void);
+static int MapCacheFile(HeadlessCache *cache, ReadOnlyString path);
+static ReadOnlyString FileGet(const HeadlessCache *cache,
+                              ReadOnlyString formal_position, uint64_t hash);
+static int ComparePendingEntries(const void *a, const void *b);
+static int WriteCacheFile(ReadOnlyString path, PendingEntry *entries,
+                          int64_t num_entries);
+static ReadOnlyString GetPositionField(json_object *response);
+
+// -----------------------------------------------------------------------------
+
+int HeadlessCacheInit(HeadlessCache *cache, ReadOnlyString path,
+                      size_t lru_size) {
+    cache->file = NULL;
+    cache->file_size = 0;
+    cache->entries = NULL;
+    cache->num_entries = 0;
+    cache->lru = Int64CacheInit(lru_size, NULL);
+    if (cache->lru == NULL) return kMallocFailureError;
+    if (path == NULL) return kNoError;
+
+    int error = MapCacheFile(cache, path);
+    if (error != kNoError) {
+        Int64CacheDestroy(cache->lru);
+        cache->lru = NULL;
+    }
+
+    return error;
+}
+
+void HeadlessCacheDestroy(HeadlessCache *cache) {
+    Int64CacheDestroy(cache->lru);
+    cache->lru = NULL;
+    if (cache->file != NULL) munmap((void *)cache->file, cache->file_size);
+    cache->file = NULL;
+    cache->entries = NULL;
+}
+
+ReadOnlyString HeadlessCacheGet(HeadlessCache *cache,
+                                ReadOnlyString formal_position) {
+    uint64_t hash = HashFormalPosition(formal_position);
+
+    // Runtime entries hold the formal position followed by the response.
+    const char *data = (const char *)Int64CacheGet(cache->lru, (int64_t)hash,
+                                                   NULL);
+    if (data != NULL && strcmp(data, formal_position) == 0) {
+        return data + strlen(data) + 1;
+    }
+
+    return FileGet(cache, formal_position, hash);
+}
+
+void HeadlessCachePut(HeadlessCache *cache, ReadOnlyString formal_position,
+                      ReadOnlyString response) {
+    uint64_t hash = HashFormalPosition(formal_position);
+    size_t key_size = strlen(formal_position) + 1;
+    size_t value_size = strlen(response) + 1;
+    char *data =
+        (char *)Int64CachePut(cache->lru, (int64_t)hash, key_size + value_size);
+    if (data == NULL) return;
+
+    memcpy(data, formal_position, key_size);
+    memcpy(data + key_size, response, value_size);
+}
+
+int HeadlessPrecompute(ReadOnlyString game_name, int variant_id,
+                       ReadOnlyString data_path, ReadOnlyString cache_path,
+                       int depth, int64_t limit) {
+    int error = HeadlessInitSolver(game_name, variant_id, data_path);
+    if (error != 0) {
+        fprintf(stderr, "HeadlessPrecompute: game initialization failed\n");
+        return error;
+    }
+
+    SolverProbe probe;
+    error = SolverManagerProbeInit(&probe);
+    if (error != 0) {
+        fprintf(stderr, "HeadlessPrecompute: failed to initialize probe\n");
+        return error;
+    }
+
+    // The queue holds the formal positions to visit in breadth-first order.
+    // Visited positions become the keys of the pending entries.
+    Int64HashSet discovered;
+    Int64HashSetInit(&discovered, 0.5);
+    int64_t capacity = limit < 1024 ? limit + 1 : 1024;
+    int64_t queue_head = 0, queue_size = 0, num_entries = 0;
+    char **queue = (char **)GamesmanMalloc(capacity * sizeof(char *));
+    PendingEntry *entries =
+        (PendingEntry *)GamesmanMalloc(capacity * sizeof(PendingEntry));
+    HeadlessJsonWriter writer;
+    HeadlessJsonWriterInit(&writer);
+    json_object *start = NULL;
+    if (queue == NULL || entries == NULL) {
+        error = kMallocFailureError;
+        goto _bailout;
+    }
+
+    // Responses are parsed back to find the formal positions of the children.
+    error = HeadlessQueryWriteStartResponse(&writer);
+    if (error != kNoError) goto _bailout;
+    start = json_tokener_parse(HeadlessJsonWriterGetString(&writer));
+    ReadOnlyString start_position = GetPositionField(start);
+    if (start_position == NULL) {
+        error = kRuntimeError;
+        goto _bailout;
+    }
+    queue[queue_size++] = CopyString(start_position);
+    Int64HashSetAdd(&discovered, (int64_t)HashFormalPosition(start_position));
+    if (queue[0] == NULL) {
+        error = kMallocFailureError;
+        goto _bailout;
+    }
+
+    // Positions in the queue at indices [0, level_end) are at most LEVEL moves
+    // away from the start position.
+    int level = 0;
+    int64_t level_end = 1;
+    while (queue_head < queue_size && num_entries < limit) {
+        if (queue_head == level_end) {
+            ++level;
+            level_end = queue_size;
+        }
+        char *formal_position = queue[queue_head++];
+        HeadlessJsonWriterClear(&writer);
+        error = HeadlessQueryWritePositionResponse(&probe, formal_position,
+                                                   &writer);
+        if (error != kNoError) {
+            GamesmanFree(formal_position);
+            goto _bailout;
+        }
+
+        PendingEntry *entry = &entries[num_entries++];
+        entry->hash = HashFormalPosition(formal_position);
+        entry->key = formal_position;
+        entry->value = CopyString(HeadlessJsonWriterGetString(&writer));
+        if (entry->value == NULL) error = kMallocFailureError;
+        json_object *response = json_tokener_parse(entry->value);
+
+        // Enqueue the children of positions above the maximum depth.
+        json_object *moves = NULL;
+        if (level < depth && error == kNoError &&
+            json_object_object_get_ex(response, "moves", &moves)) {
+            size_t num_moves = json_object_array_length(moves);
+            for (size_t i = 0; i < num_moves && error == kNoError; ++i) {
+                ReadOnlyString child =
+                    GetPositionField(json_object_array_get_idx(moves, i));
+                if (child == NULL) continue;
+                int64_t key = (int64_t)HashFormalPosition(child);
+                if (Int64HashSetContains(&discovered, key)) continue;
+                if (!Int64HashSetAdd(&discovered, key)) {
+                    error = kMallocFailureError;
+                    break;
+                }
+                if (queue_size == capacity) {
+                    int64_t new_capacity = capacity * 2;
+                    char **new_queue = (char **)GamesmanRealloc(
+                        queue, capacity * sizeof(char *),
+                        new_capacity * sizeof(char *));
+                    PendingEntry *new_entries = NULL;
+                    if (new_queue != NULL) queue = new_queue;
+                    new_entries = (PendingEntry *)GamesmanRealloc(
+                        entries, capacity * sizeof(PendingEntry),
+                        new_capacity * sizeof(PendingEntry));
+                    if (new_entries != NULL) entries = new_entries;
+                    if (new_queue == NULL || new_entries == NULL) {
+                        error = kMallocFailureError;
+                        break;
+                    }
+                    capacity = new_capacity;
+                }
+                queue[queue_size] = CopyString(child);
+                if (queue[queue_size] == NULL) {
+                    error = kMallocFailureError;
+                    break;
+                }
+                ++queue_size;
+            }
+        }
+        json_object_put(response);
+        if (error != kNoError) goto _bailout;
+    }
+
+    error = WriteCacheFile(cache_path, entries, num_entries);
+    if (error == kNoError) {
+        printf("precomputed %" PRId64
+               " responses within %d moves from the start position\n",
+               num_entries, level);
+    }
+
+_bailout:
+    for (int64_t i = queue_head; i < queue_size; ++i) {
+        GamesmanFree(queue[i]);
+    }
+    for (int64_t i = 0; i < num_entries; ++i) {
+        GamesmanFree(entries[i].key);
+        GamesmanFree(entries[i].value);
+    }
+    GamesmanFree(queue);
+    GamesmanFree(entries);
+    json_object_put(start);
+    HeadlessJsonWriterDestroy(&writer);
+    Int64HashSetDestroy(&discovered);
+    SolverManagerProbeDestroy(&probe);
+
+    return error;
+}
+
+// -----------------------------------------------------------------------------
+
+// 64-bit FNV-1a.
+static uint64_t HashFormalPosition(ReadOnlyString formal_position) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char *p = (const unsigned char *)formal_position;
+         *p != '\0'; ++p) {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+static char *CopyString(ReadOnlyString str) {
+    size_t size = strlen(str) + 1;
+    char *ret = (char *)GamesmanMalloc(size);
+    if (ret != NULL) memcpy(ret, str, size);
+
+    return ret;
+}
+
+static int GetCurrentVariantId(void) {
+    const Game *game = GameManagerGetCurrentGame();
+    const GameVariant *variant = NULL;
+    if (game->GetCurrentVariant != NULL) variant = game->GetCurrentVariant();
+
+    return GameVariantToIndex(variant);
+}
+
+static int MapCacheFile(HeadlessCache *cache, ReadOnlyString path) {
+    int fd = GuardedOpen(path, O_RDONLY);
+    if (fd < 0) return kFileSystemError;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(CacheFileHeader)) {
+        fprintf(stderr, "MapCacheFile: [%s] is not a cache file\n", path);
+        return BailOutClose(fd, kFileSystemError);
+    }
+    void *file = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    GuardedClose(fd);
+    if (file == MAP_FAILED) {
+        perror("mmap");
+        return kFileSystemError;
+    }
+
+    const CacheFileHeader *header = (const CacheFileHeader *)file;
+    const Game *game = GameManagerGetCurrentGame();
+    size_t table_size =
+        (size_t)header->num_entries * sizeof(HeadlessCacheFileEntry);
+    if (memcmp(header->magic, kCacheFileMagic, sizeof(kCacheFileMagic)) != 0 ||
+        header->num_entries < 0 ||
+        table_size > (size_t)st.st_size - sizeof(CacheFileHeader)) {
+        fprintf(stderr, "MapCacheFile: [%s] is not a cache file\n", path);
+        munmap(file, st.st_size);
+        return kFileSystemError;
+    }
+    if (strncmp(header->game, game->name, sizeof(header->game)) != 0 ||
+        header->variant_id != GetCurrentVariantId()) {
+        fprintf(stderr,
+                "MapCacheFile: [%s] was created for variant %d of game "
+                "[%.*s]\n",
+                path, header->variant_id, (int)sizeof(header->game),
+                header->game);
+        munmap(file, st.st_size);
+        return kIllegalArgumentError;
+    }
+
+    cache->file = (const char *)file;
+    cache->file_size = st.st_size;
+    cache->entries =
+        (const HeadlessCacheFileEntry *)(cache->file + sizeof(CacheFileHeader));
+    cache->num_entries = header->num_entries;
+
+    return kNoError;
+}
+
+static ReadOnlyString FileGet(const HeadlessCache *cache,
+                              ReadOnlyString formal_position, uint64_t hash) {
+    // Find the first entry whose hash is not less than HASH.
+    int64_t lo = 0, hi = cache->num_entries;
+    while (lo < hi) {
+        int64_t mid = lo + (hi - lo) / 2;
+        if (cache->entries[mid].hash < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    size_t length = strlen(formal_position);
+    for (; lo < cache->num_entries && cache->entries[lo].hash == hash; ++lo) {
+        const HeadlessCacheFileEntry *entry = &cache->entries[lo];
+        uint64_t end = entry->offset + entry->key_length + entry->value_length;
+        if (end >= cache->file_size) return NULL;  // Corrupted entry.
+        if (entry->key_length != length) continue;
+
+        const char *key = cache->file + entry->offset;
+        if (memcmp(key, formal_position, length) == 0) return key + length;
+    }
+
+    return NULL;
+}
+
+static int ComparePendingEntries(const void *a, const void *b) {
+    uint64_t x = ((const PendingEntry *)a)->hash;
+    uint64_t y = ((const PendingEntry *)b)->hash;
+
+    return (x > y) - (x < y);
+}
+
+static int WriteCacheFile(ReadOnlyString path, PendingEntry *entries,
+                          int64_t num_entries) {
+    qsort(entries, num_entries, sizeof(PendingEntry), ComparePendingEntries);
+
+    CacheFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kCacheFileMagic, sizeof(kCacheFileMagic));
+    SafeStrncpy(header.game, GameManagerGetCurrentGame()->name,
+                sizeof(header.game));
+    header.variant_id = GetCurrentVariantId();
+    header.num_entries = num_entries;
+
+    FILE *file = GuardedFopen(path, "wb");
+    if (file == NULL) return kFileSystemError;
+    int error = GuardedFwrite(&header, sizeof(header), 1, file);
+    if (error != kNoError) return BailOutFclose(file, error);
+
+    uint64_t offset =
+        sizeof(header) + num_entries * sizeof(HeadlessCacheFileEntry);
+    for (int64_t i = 0; i < num_entries; ++i) {
+        HeadlessCacheFileEntry entry = {
+            .hash = entries[i].hash,
+            .offset = offset,
+            .key_length = (uint32_t)strlen(entries[i].key),
+            .value_length = (uint32_t)strlen(entries[i].value),
+        };
+        error = GuardedFwrite(&entry, sizeof(entry), 1, file);
+        if (error != kNoError) return BailOutFclose(file, error);
+        offset += entry.key_length + entry.value_length + 1;
+    }
+    for (int64_t i = 0; i < num_entries; ++i) {
+        error = GuardedFwrite(entries[i].key, 1, strlen(entries[i].key), file);
+        if (error != kNoError) return BailOutFclose(file, error);
+        error = GuardedFwrite(entries[i].value, 1, strlen(entries[i].value) + 1,
+                              file);
+        if (error != kNoError) return BailOutFclose(file, error);
+    }
+
+    return GuardedFclose(file);
+}
+
+static ReadOnlyString GetPositionField(json_object *response) {
+    json_object *position = NULL;
+    if (!json_object_object_get_ex(response, "position", &position)) {
+        return NULL;
+    }
+
+    return json_object_get_string(position);
+}
@@ -0,0 +1,136 @@
+/**
+ * @file hcache.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Position response cache of the headless query server.
+ * @details Most queries are about positions a few moves away from the start
+ * position. The responses to those positions can be precomputed into a cache
+ * file by a breadth-first search from the start position. A server maps the
+ * cache file into memory and answers the positions in it without generating
+ * moves, probing the database, or building JSON. Responses computed at
+ * runtime are kept in a least-recently-used cache in front of the file.
+ *
+ * The cache file begins with a header identifying the game variant, followed
+ * by a table of entries sorted by the 64-bit FNV-1a hash of their formal
+ * positions, followed by the formal positions and responses. Each response is
+ * stored with a terminating null character so that it can be written out
+ * directly from the mapped file.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_HEADLESS_HCACHE_H_
+#define GAMESMANONE_CORE_HEADLESS_HCACHE_H_
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // int64_t
+
+#include "core/data_structures/int64_cache.h"
+#include "core/types/gamesman_types.h"
+
+enum {
+    /** Default capacity of the runtime cache in bytes. */
+    kHeadlessCacheLruSizeDefault = 16 << 20,
+
+    /** Default depth of the precomputation search. */
+    kHeadlessPrecomputeDepthDefault = 12,
+
+    /** Default maximum number of precomputed responses. */
+    kHeadlessPrecomputeLimitDefault = 100000,
+};
+
+/** @brief File entry of a precomputed response. */
+typedef struct HeadlessCacheFileEntry HeadlessCacheFileEntry;
+
+/** @brief Position response cache. */
+typedef struct HeadlessCache {
+    /** Responses computed at runtime, keyed by position hash. */
+    Int64Cache *lru;
+
+    /** Mapped cache file, or NULL if there is none. */
+    const char *file;
+
+    /** Size of the mapped cache file in bytes. */
+    size_t file_size;
+
+    /** Entries of the cache file, sorted by position hash. */
+    const HeadlessCacheFileEntry *entries;
+
+    /** Number of entries in the cache file. */
+    int64_t num_entries;
+} HeadlessCache;
+
+/**
+ * @brief Initializes CACHE for the game variant currently loaded in the Game
+ * Manager.
+ *
+ * @param cache Cache to initialize.
+ * @param path Path to the precomputed cache file of the current game variant,
+ * or NULL to use only the runtime cache.
+ * @param lru_size Capacity of the runtime cache in bytes.
+ * @return 0 on success, or
+ * @return non-zero error code if the cache file cannot be mapped or was
+ * created for a different game variant.
+ */
+int HeadlessCacheInit(HeadlessCache *cache, ReadOnlyString path,
+                      size_t lru_size);
+
+/** @brief Destroys CACHE, unmapping its cache file. */
+void HeadlessCacheDestroy(HeadlessCache *cache);
+
+/**
+ * @brief Returns the cached response to FORMAL_POSITION, looking up the
+ * runtime cache first and then the cache file.
+ *
+ * @return The response, which is valid until the next call to
+ * HeadlessCachePut() or HeadlessCacheDestroy(), or
+ * @return NULL if FORMAL_POSITION is not cached.
+ */
+ReadOnlyString HeadlessCacheGet(HeadlessCache *cache,
+                                ReadOnlyString formal_position);
+
+/**
+ * @brief Stores RESPONSE to FORMAL_POSITION in the runtime cache of CACHE,
+ * evicting the least recently used responses if necessary. Failure to store
+ * the response is not an error.
+ */
+void HeadlessCachePut(HeadlessCache *cache, ReadOnlyString formal_position,
+                      ReadOnlyString response);
+
+/**
+ * @brief Precomputes the responses to the positions of game GAME_NAME, variant
+ * index VARIANT_ID within DEPTH moves from the start position, in
+ * breadth-first order, and writes them to a cache file at CACHE_PATH.
+ *
+ * @param game_name Name of the game used internally by GAMESMAN.
+ * @param variant_id Index of the variant to load. If negative, the default
+ * variant will be loaded.
+ * @param data_path Path to the "data" directory. The default path will be used
+ * if set to NULL.
+ * @param cache_path Path to the cache file to create, replacing any existing
+ * file.
+ * @param depth Maximum number of moves from the start position.
+ * @param limit Maximum number of responses to precompute.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessPrecompute(ReadOnlyString game_name, int variant_id,
+                       ReadOnlyString data_path, ReadOnlyString cache_path,
+                       int depth, int64_t limit);
+
+#endif  // GAMESMANONE_CORE_HEADLESS_HCACHE_H_
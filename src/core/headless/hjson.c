@@ -3,9 +3,10 @@
  * @author Robert Shi (robertyishi@berkeley.edu)
  * @author GamesCrafters Research Group, UC Berkeley
  *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
- * @brief Json parser helper method collection for headless mode.
- * @version 1.1.0
- * @date 2024-10-21
+ * @brief Implementation of the streaming JSON writer and response field helpers
+ * for headless mode.
+ * @version 1.2.0
+ * @date 2026-10-18
  *
  * @copyright This file is part of GAMESMAN, The Finite, Two-person
  * Perfect-Information Game Generator released under the GPL:
@@ -26,66 +27,274 @@
 
 #include "core/headless/hjson.h"
 
-#include <json-c/json_object.h>
+#include <inttypes.h>  // PRId64
+#include <stdbool.h>   // bool, true, false
+#include <stddef.h>    // NULL, size_t
+#include <stdint.h>    // int64_t, uint64_t
+#include <stdio.h>     // snprintf
+#include <string.h>    // memcpy, strlen
 
 #include "core/constants.h"
+#include "core/gamesman_memory.h"
 #include "core/types/gamesman_types.h"
 
-static int AddStringHelper(json_object *dest, ReadOnlyString key,
-                           ReadOnlyString value) {
-    json_object *position_obj = json_object_new_string(value);
-    if (position_obj == NULL) return kMallocFailureError;
+static int Reserve(HeadlessJsonWriter *writer, int64_t size);
+static int Append(HeadlessJsonWriter *writer, const char *str, int64_t size);
+static int AppendEscaped(HeadlessJsonWriter *writer, ReadOnlyString str);
+static int BeginMember(HeadlessJsonWriter *writer, ReadOnlyString key);
+static int BeginContainer(HeadlessJsonWriter *writer, ReadOnlyString key,
+                          char open);
+static int EndContainer(HeadlessJsonWriter *writer, char close);
 
-    return json_object_object_add(dest, key, position_obj);
+// -----------------------------------------------------------------------------
+
+void HeadlessJsonWriterInit(HeadlessJsonWriter *writer) {
+    writer->buffer = NULL;
+    writer->length = 0;
+    writer->capacity = 0;
+    writer->has_members = 0;
+    writer->depth = 0;
+}
+
+void HeadlessJsonWriterDestroy(HeadlessJsonWriter *writer) {
+    GamesmanFree(writer->buffer);
+    HeadlessJsonWriterInit(writer);
+}
+
+void HeadlessJsonWriterClear(HeadlessJsonWriter *writer) {
+    writer->length = 0;
+    writer->has_members = 0;
+    writer->depth = 0;
+    if (writer->buffer != NULL) writer->buffer[0] = '\0';
+}
+
+ReadOnlyString HeadlessJsonWriterGetString(const HeadlessJsonWriter *writer) {
+    return writer->buffer == NULL ? "" : writer->buffer;
 }
 
-int HeadlessJsonAddPosition(json_object *dest, ReadOnlyString formal_position) {
-    return AddStringHelper(dest, "position", formal_position);
+int HeadlessJsonWriterBeginObject(HeadlessJsonWriter *writer,
+                                  ReadOnlyString key) {
+    return BeginContainer(writer, key, '{');
 }
 
-int HeadlessJsonAddAutoGuiPosition(json_object *dest,
+int HeadlessJsonWriterEndObject(HeadlessJsonWriter *writer) {
+    return EndContainer(writer, '}');
+}
+
+int HeadlessJsonWriterBeginArray(HeadlessJsonWriter *writer,
+                                 ReadOnlyString key) {
+    return BeginContainer(writer, key, '[');
+}
+
+int HeadlessJsonWriterEndArray(HeadlessJsonWriter *writer) {
+    return EndContainer(writer, ']');
+}
+
+int HeadlessJsonWriterAddString(HeadlessJsonWriter *writer, ReadOnlyString key,
+                                ReadOnlyString value) {
+    int error = BeginMember(writer, key);
+    if (error != kNoError) return error;
+
+    return AppendEscaped(writer, value);
+}
+
+int HeadlessJsonWriterAddInt(HeadlessJsonWriter *writer, ReadOnlyString key,
+                             int64_t value) {
+    int error = BeginMember(writer, key);
+    if (error != kNoError) return error;
+
+    char buf[24];
+    int length = snprintf(buf, sizeof(buf), "%" PRId64, value);
+
+    return Append(writer, buf, length);
+}
+
+int HeadlessJsonAddPosition(HeadlessJsonWriter *dest,
+                            ReadOnlyString formal_position) {
+    return HeadlessJsonWriterAddString(dest, "position", formal_position);
+}
+
+int HeadlessJsonAddAutoGuiPosition(HeadlessJsonWriter *dest,
                                    ReadOnlyString autogui_position) {
-    return AddStringHelper(dest, "autoguiPosition", autogui_position);
+    return HeadlessJsonWriterAddString(dest, "autoguiPosition",
+                                       autogui_position);
 }
 
-int HeadlessJsonAddMove(json_object *dest, ReadOnlyString formal_move) {
-    return AddStringHelper(dest, "move", formal_move);
+int HeadlessJsonAddMove(HeadlessJsonWriter *dest, ReadOnlyString formal_move) {
+    return HeadlessJsonWriterAddString(dest, "move", formal_move);
 }
 
-int HeadlessJsonAddAutoGuiMove(json_object *dest, ReadOnlyString autogui_move) {
-    return AddStringHelper(dest, "autoguiMove", autogui_move);
+int HeadlessJsonAddAutoGuiMove(HeadlessJsonWriter *dest,
+                               ReadOnlyString autogui_move) {
+    return HeadlessJsonWriterAddString(dest, "autoguiMove", autogui_move);
 }
 
-int HeadlessJsonAddFrom(json_object *dest, ReadOnlyString from) {
-    return AddStringHelper(dest, "from", from);
+int HeadlessJsonAddFrom(HeadlessJsonWriter *dest, ReadOnlyString from) {
+    return HeadlessJsonWriterAddString(dest, "from", from);
 }
 
-int HeadlessJsonAddTo(json_object *dest, ReadOnlyString to) {
-    return AddStringHelper(dest, "to", to);
+int HeadlessJsonAddTo(HeadlessJsonWriter *dest, ReadOnlyString to) {
+    return HeadlessJsonWriterAddString(dest, "to", to);
 }
 
-int HeadlessJsonAddFull(json_object *dest, ReadOnlyString full) {
-    return AddStringHelper(dest, "full", full);
+int HeadlessJsonAddFull(HeadlessJsonWriter *dest, ReadOnlyString full) {
+    return HeadlessJsonWriterAddString(dest, "full", full);
 }
 
-int HeadlessJsonAddValue(json_object *dest, Value value) {
+int HeadlessJsonAddValue(HeadlessJsonWriter *dest, Value value) {
     ReadOnlyString value_string = value < 0 ? "unsolved" : kValueStrings[value];
 
-    return AddStringHelper(dest, "positionValue", value_string);
+    return HeadlessJsonWriterAddString(dest, "positionValue", value_string);
+}
+
+int HeadlessJsonAddRemoteness(HeadlessJsonWriter *dest, int remoteness) {
+    return HeadlessJsonWriterAddInt(dest, "remoteness", remoteness);
+}
+
+int HeadlessJsonBeginMovesArray(HeadlessJsonWriter *dest) {
+    return HeadlessJsonWriterBeginArray(dest, "moves");
+}
+
+int HeadlessJsonBeginPartmovesArray(HeadlessJsonWriter *dest) {
+    return HeadlessJsonWriterBeginArray(dest, "partMoves");
+}
+
+int HeadlessJsonWriteError(HeadlessJsonWriter *dest, ReadOnlyString message) {
+    int error = HeadlessJsonWriterBeginObject(dest, NULL);
+    error |= HeadlessJsonWriterAddString(dest, "error", message);
+    error |= HeadlessJsonWriterEndObject(dest);
+
+    return error ? kMallocFailureError : kNoError;
+}
+
+// -----------------------------------------------------------------------------
+
+// Makes room for SIZE more bytes and a null terminator.
+static int Reserve(HeadlessJsonWriter *writer, int64_t size) {
+    int64_t required = writer->length + size + 1;
+    if (required <= writer->capacity) return kNoError;
+
+    int64_t new_capacity = writer->capacity == 0 ? 256 : writer->capacity;
+    while (new_capacity < required) new_capacity *= 2;
+    char *new_buffer = (char *)GamesmanRealloc(writer->buffer, writer->capacity,
+                                               new_capacity);
+    if (new_buffer == NULL) return kMallocFailureError;
+
+    writer->buffer = new_buffer;
+    writer->capacity = new_capacity;
+
+    return kNoError;
 }
 
-int HeadlessJsonAddRemoteness(json_object *dest, int remoteness) {
-    json_object *remoteness_obj = json_object_new_int(remoteness);
-    if (remoteness_obj == NULL) return kMallocFailureError;
+static int Append(HeadlessJsonWriter *writer, const char *str, int64_t size) {
+    int error = Reserve(writer, size);
+    if (error != kNoError) return error;
+
+    memcpy(writer->buffer + writer->length, str, size);
+    writer->length += size;
+    writer->buffer[writer->length] = '\0';
 
-    return json_object_object_add(dest, "remoteness", remoteness_obj);
+    return kNoError;
 }
 
-int HeadlessJsonAddMovesArray(json_object *dest, json_object *moves_array_obj) {
-    return json_object_object_add(dest, "moves", moves_array_obj);
+// Appends STR as a quoted JSON string, escaping characters the same way as
+// json-c does by default.
+static int AppendEscaped(HeadlessJsonWriter *writer, ReadOnlyString str) {
+    static const char kHexDigits[] = "0123456789abcdef";
+    size_t length = strlen(str);
+
+    // Each character expands to at most 6 bytes, plus the 2 quotes.
+    int error = Reserve(writer, (int64_t)length * 6 + 2);
+    if (error != kNoError) return error;
+
+    char *out = writer->buffer + writer->length;
+    *out++ = '"';
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = (unsigned char)str[i];
+        switch (c) {
+            case '\b':
+                *out++ = '\\';
+                *out++ = 'b';
+                break;
+            case '\n':
+                *out++ = '\\';
+                *out++ = 'n';
+                break;
+            case '\r':
+                *out++ = '\\';
+                *out++ = 'r';
+                break;
+            case '\t':
+                *out++ = '\\';
+                *out++ = 't';
+                break;
+            case '\f':
+                *out++ = '\\';
+                *out++ = 'f';
+                break;
+            case '"':
+            case '\\':
+            case '/':
+                *out++ = '\\';
+                *out++ = (char)c;
+                break;
+            default:
+                if (c < ' ') {
+                    memcpy(out, "\\u00", 4);
+                    out[4] = kHexDigits[c >> 4];
+                    out[5] = kHexDigits[c & 0xF];
+                    out += 6;
+                } else {
+                    *out++ = (char)c;
+                }
+        }
+    }
+    *out++ = '"';
+    *out = '\0';
+    writer->length = out - writer->buffer;
+
+    return kNoError;
 }
 
-int HeadlessJsonAddPartmovesArray(json_object *dest,
-                                  json_object *partmoves_array_obj) {
-    return json_object_object_add(dest, "partMoves", partmoves_array_obj);
+// Writes the separator and the key, if any, before a new member of the current
+// container.
+static int BeginMember(HeadlessJsonWriter *writer, ReadOnlyString key) {
+    if (writer->depth == 0) return kNoError;  // Top-level value.
+
+    uint64_t bit = UINT64_C(1) << (writer->depth - 1);
+    bool first = (writer->has_members & bit) == 0;
+    writer->has_members |= bit;
+    int error = first ? Append(writer, " ", 1) : Append(writer, ", ", 2);
+    if (error != kNoError || key == NULL) return error;
+
+    error = AppendEscaped(writer, key);
+    if (error != kNoError) return error;
+
+    return Append(writer, ": ", 2);
+}
+
+static int BeginContainer(HeadlessJsonWriter *writer, ReadOnlyString key,
+                          char open) {
+    if (writer->depth >= kHeadlessJsonWriterDepthMax) return kRuntimeError;
+
+    int error = BeginMember(writer, key);
+    if (error != kNoError) return error;
+
+    error = Append(writer, &open, 1);
+    if (error != kNoError) return error;
+
+    ++writer->depth;
+    writer->has_members &= ~(UINT64_C(1) << (writer->depth - 1));
+
+    return kNoError;
+}
+
+// Empty containers are written as "{ }" and "[ ]", like json-c does.
+static int EndContainer(HeadlessJsonWriter *writer, char close) {
+    if (writer->depth == 0) return kRuntimeError;
+
+    --writer->depth;
+    char closing[2] = {' ', close};
+
+    return Append(writer, closing, 2);
 }
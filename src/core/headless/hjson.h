@@ -3,9 +3,15 @@
  * @author Robert Shi (robertyishi@berkeley.edu)
  * @author GamesCrafters Research Group, UC Berkeley
  *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
- * @brief Json parser helper method collection for headless mode.
- * @version 1.1.0
- * @date 2024-10-21
+ * @brief Streaming JSON writer and response field helpers for headless mode.
+ * @details Responses are written field by field into a reusable buffer instead
+ * of being built as json-c object trees, which saves an allocation per field
+ * and per nested container on every response. The output is byte-identical to
+ * json_object_to_json_string() with the default json-c formatting: a space
+ * after each opening bracket, after each comma and before each closing
+ * bracket, a space after each colon, and forward slashes escaped.
+ * @version 1.2.0
+ * @date 2026-10-18
  *
  * @copyright This file is part of GAMESMAN, The Finite, Two-person
  * Perfect-Information Game Generator released under the GPL:
@@ -27,84 +33,171 @@
 #ifndef GAMESMANONE_CORE_HEADLESS_HJSON_H_
 #define GAMESMANONE_CORE_HEADLESS_HJSON_H_
 
-#include <json-c/json_object.h>  // json_object
+#include <stdint.h>  // int64_t, uint64_t
 
 #include "core/types/gamesman_types.h"
 
+/** @brief Maximum nesting depth of containers in a HeadlessJsonWriter. */
+enum { kHeadlessJsonWriterDepthMax = 63 };
+
+/**
+ * @brief Streaming JSON writer. Containers and members are appended to a
+ * null-terminated buffer, which is kept across calls to
+ * HeadlessJsonWriterClear() so that a writer reused for many responses stops
+ * allocating once its buffer is large enough.
+ */
+typedef struct HeadlessJsonWriter {
+    /** Null-terminated output, or NULL if nothing has been written. */
+    char *buffer;
+
+    /** Length of the output in bytes, not including the null terminator. */
+    int64_t length;
+
+    /** Size of BUFFER in bytes. */
+    int64_t capacity;
+
+    /** Bit i is set if the container at depth i + 1 has a member. */
+    uint64_t has_members;
+
+    /** Number of open containers. */
+    int depth;
+} HeadlessJsonWriter;
+
+/** @brief Initializes WRITER to an empty writer. */
+void HeadlessJsonWriterInit(HeadlessJsonWriter *writer);
+
+/** @brief Destroys WRITER, freeing its buffer. */
+void HeadlessJsonWriterDestroy(HeadlessJsonWriter *writer);
+
+/** @brief Discards the output of WRITER, keeping its buffer for reuse. */
+void HeadlessJsonWriterClear(HeadlessJsonWriter *writer);
+
+/**
+ * @brief Returns the null-terminated output of WRITER, which is valid until the
+ * next write to or destruction of WRITER.
+ */
+ReadOnlyString HeadlessJsonWriterGetString(const HeadlessJsonWriter *writer);
+
+/**
+ * @brief Opens an object as the member KEY of the current object, or as the
+ * next element of the current array or the top-level value if KEY is NULL.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessJsonWriterBeginObject(HeadlessJsonWriter *writer,
+                                  ReadOnlyString key);
+
+/**
+ * @brief Closes the current object.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessJsonWriterEndObject(HeadlessJsonWriter *writer);
+
 /**
- * @brief Adds {"position: <FORMAL_POSITION>"} to the DEST json object.
+ * @brief Opens an array as the member KEY of the current object, or as the
+ * next element of the current array or the top-level value if KEY is NULL.
  * @return 0 on success, non-zero error code otherwise.
  */
-int HeadlessJsonAddPosition(json_object *dest, ReadOnlyString formal_position);
+int HeadlessJsonWriterBeginArray(HeadlessJsonWriter *writer,
+                                 ReadOnlyString key);
 
 /**
- * @brief Adds {"autoguiPosition: <AUTOGUI_POSITION>"} to the DEST json object.
+ * @brief Closes the current array.
  * @return 0 on success, non-zero error code otherwise.
  */
-int HeadlessJsonAddAutoGuiPosition(json_object *dest,
+int HeadlessJsonWriterEndArray(HeadlessJsonWriter *writer);
+
+/**
+ * @brief Writes VALUE as a JSON string, as the member KEY of the current object
+ * or as the next element of the current array if KEY is NULL.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessJsonWriterAddString(HeadlessJsonWriter *writer, ReadOnlyString key,
+                                ReadOnlyString value);
+
+/**
+ * @brief Writes VALUE as a JSON number, as the member KEY of the current object
+ * or as the next element of the current array if KEY is NULL.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessJsonWriterAddInt(HeadlessJsonWriter *writer, ReadOnlyString key,
+                             int64_t value);
+
+/**
+ * @brief Adds "position": <FORMAL_POSITION> to the current object of DEST.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessJsonAddPosition(HeadlessJsonWriter *dest,
+                            ReadOnlyString formal_position);
+
+/**
+ * @brief Adds "autoguiPosition": <AUTOGUI_POSITION> to the current object of
+ * DEST.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessJsonAddAutoGuiPosition(HeadlessJsonWriter *dest,
                                    ReadOnlyString autogui_position);
 
 /**
- * @brief Adds {"move: <FORMAL_MOVE>"} to the DEST json object.
+ * @brief Adds "move": <FORMAL_MOVE> to the current object of DEST.
  * @return 0 on success, non-zero error code otherwise.
  */
-int HeadlessJsonAddMove(json_object *dest, ReadOnlyString formal_move);
+int HeadlessJsonAddMove(HeadlessJsonWriter *dest, ReadOnlyString formal_move);
 
 /**
- * @brief Adds {"autoguiMove: <AUTOGUI_MOVE>"} to the DEST json object.
+ * @brief Adds "autoguiMove": <AUTOGUI_MOVE> to the current object of DEST.
  * @return 0 on success, non-zero error code otherwise.
  */
-int HeadlessJsonAddAutoGuiMove(json_object *dest, ReadOnlyString autogui_move);
+int HeadlessJsonAddAutoGuiMove(HeadlessJsonWriter *dest,
+                               ReadOnlyString autogui_move);
 
 /**
- * @brief Adds {"from: <FROM>"} to the DEST json object.
+ * @brief Adds "from": <FROM> to the current object of DEST.
  * @return 0 on success, non-zero error code otherwise.
  */
-int HeadlessJsonAddFrom(json_object *dest, ReadOnlyString from);
+int HeadlessJsonAddFrom(HeadlessJsonWriter *dest, ReadOnlyString from);
 
 /**
- * @brief Adds {"to: <TO>"} to the DEST json object.
+ * @brief Adds "to": <TO> to the current object of DEST.
  * @return 0 on success, non-zero error code otherwise.
  */
-int HeadlessJsonAddTo(json_object *dest, ReadOnlyString to);
+int HeadlessJsonAddTo(HeadlessJsonWriter *dest, ReadOnlyString to);
 
 /**
- * @brief Adds {"full: <FULL>"} to the DEST json object.
+ * @brief Adds "full": <FULL> to the current object of DEST.
  * @return 0 on success, non-zero error code otherwise.
  */
-int HeadlessJsonAddFull(json_object *dest, ReadOnlyString full);
+int HeadlessJsonAddFull(HeadlessJsonWriter *dest, ReadOnlyString full);
 
 /**
- * @brief Adds {"value: <VALUE>"} to the DEST json object.
+ * @brief Adds "positionValue": <VALUE> to the current object of DEST.
  * @return 0 on success, non-zero error code otherwise.
  */
-int HeadlessJsonAddValue(json_object *dest, Value value);
+int HeadlessJsonAddValue(HeadlessJsonWriter *dest, Value value);
 
 /**
- * @brief Adds {"remoteness: <REMOTENESS>"} to the DEST json object.
+ * @brief Adds "remoteness": <REMOTENESS> to the current object of DEST.
  * @return 0 on success, non-zero error code otherwise.
  */
-int HeadlessJsonAddRemoteness(json_object *dest, int remoteness);
+int HeadlessJsonAddRemoteness(HeadlessJsonWriter *dest, int remoteness);
 
 /**
- * @brief Adds {"moves: MOVES_ARRAY_OBJ"} to the DEST json object.
- *
- * @param dest Destination object.
- * @param move_array_obj A json object that contains an array of moves and
- * outcomes. Must be of type json_type_array.
+ * @brief Opens the "moves" array of moves and outcomes in the current object of
+ * DEST. Close it with HeadlessJsonWriterEndArray().
  * @return 0 on success, non-zero error code otherwise.
  */
-int HeadlessJsonAddMovesArray(json_object *dest, json_object *moves_array_obj);
+int HeadlessJsonBeginMovesArray(HeadlessJsonWriter *dest);
 
 /**
- * @brief Adds {"partMoves: PARTMOVES_ARRAY_OBJ"} to the DEST json object.
- *
- * @param dest Destination object.
- * @param move_array_obj A json object that contains an array of part-moves.
- * Must be of type json_type_array.
+ * @brief Opens the "partMoves" array of part-moves in the current object of
+ * DEST. Close it with HeadlessJsonWriterEndArray().
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessJsonBeginPartmovesArray(HeadlessJsonWriter *dest);
+
+/**
+ * @brief Writes the top-level error response { "error": <MESSAGE> } to DEST.
  * @return 0 on success, non-zero error code otherwise.
  */
-int HeadlessJsonAddPartmovesArray(json_object *dest,
-                                  json_object *partmoves_array_obj);
+int HeadlessJsonWriteError(HeadlessJsonWriter *dest, ReadOnlyString message);
 
 #endif  // GAMESMANONE_CORE_HEADLESS_HJSON_H_
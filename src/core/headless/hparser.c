@@ -26,29 +26,57 @@
 
 #include "core/headless/hparser.h"
 
-#include <getopt.h>  // struct option, getopt_long
-#include <stdarg.h>  // va_list, va_start, va_end
-#include <stddef.h>  // NULL
-#include <stdio.h>   // vprintf, fprintf, stderr, FILE, stdout
-#include <stdlib.h>  // exit
-#include <string.h>  // strcmp
+#include <getopt.h>   // struct option, getopt_long
+#include <stdarg.h>   // va_list, va_start, va_end
+#include <stdbool.h>  // true
+#include <stddef.h>   // NULL
+#include <stdio.h>    // vprintf, fprintf, stderr, FILE, stdout
+#include <stdlib.h>   // exit
+#include <string.h>   // strcmp
 
 #include "config.h"
 #include "core/gamesman_headless.h"
+#include "core/headless/hsolve.h"
+#include "core/headless/hutils.h"
 #include "core/types/gamesman_types.h"
 
 static HeadlessArguments arguments;
 static ConstantReadOnlyString HeadlessCommands[] = {
-    "solve", "analyze", "query", "getstart", "getrandom",
+    "solve",    "analyze",   "query", "query-batch",
+    "getstart", "getrandom", "serve", "precompute",
 };
 
 static const struct option kLongOptions[] = {
+    {
+        .name = "async-flush",
+        .has_arg = no_argument,
+        .flag = NULL,
+        .val = 'A',
+    },
+    {
+        .name = "cache",
+        .has_arg = required_argument,
+        .flag = NULL,
+        .val = 'c',
+    },
+    {
+        .name = "cache-tiers",
+        .has_arg = no_argument,
+        .flag = NULL,
+        .val = 'C',
+    },
     {
         .name = "data-path",
         .has_arg = required_argument,
         .flag = NULL,
         .val = 'd',
     },
+    {
+        .name = "depth",
+        .has_arg = required_argument,
+        .flag = NULL,
+        .val = 'D',
+    },
     {
         .name = "memory",
         .has_arg = required_argument,
@@ -61,12 +89,36 @@ static const struct option kLongOptions[] = {
         .flag = NULL,
         .val = 'f',
     },
+    {
+        .name = "from",
+        .has_arg = required_argument,
+        .flag = NULL,
+        .val = 'F',
+    },
     {
         .name = "help",
         .has_arg = no_argument,
         .flag = NULL,
         .val = '?',
     },
+    {
+        .name = "histograms",
+        .has_arg = no_argument,
+        .flag = NULL,
+        .val = 'H',
+    },
+    {
+        .name = "input",
+        .has_arg = required_argument,
+        .flag = NULL,
+        .val = 'i',
+    },
+    {
+        .name = "limit",
+        .has_arg = required_argument,
+        .flag = NULL,
+        .val = 'L',
+    },
     {
         .name = "output",
         .has_arg = required_argument,
@@ -79,6 +131,30 @@ static const struct option kLongOptions[] = {
         .flag = NULL,
         .val = 'q',
     },
+    {
+        .name = "pack",
+        .has_arg = no_argument,
+        .flag = NULL,
+        .val = 'P',
+    },
+    {
+        .name = "reachable-only",
+        .has_arg = no_argument,
+        .flag = NULL,
+        .val = 'r',
+    },
+    {
+        .name = "rebuild-manifest",
+        .has_arg = no_argument,
+        .flag = NULL,
+        .val = 'R',
+    },
+    {
+        .name = "socket",
+        .has_arg = required_argument,
+        .flag = NULL,
+        .val = 's',
+    },
     {
         .name = "usage",
         .has_arg = no_argument,
@@ -110,16 +186,32 @@ static void ParseOption(int key, int option_index);
 static void ParseArgument(char *arg, int arg_num);
 static void ParseCommand(char *arg);
 static void ValidateArguments(int arg_num);
+static void BuildSolveOptions(void);
 static void PrintUsage(void);
 static void ParserError(const char *format, ...);
 
 static const char kDoc[] =
     "\nList of options:\n\n"
+    "\t-A, --async-flush\tFlush solved tiers in the background while solving\n"
+    "\t-c, --cache=PATH\tSpecify precomputed response cache file\n"
+    "\t-C, --cache-tiers\tKeep loaded child tiers in memory while solving\n"
     "\t-d, --data-path=PATH\tSpecify data path (default=\"data\")\n"
+    "\t-D, --depth=N\t\tPrecompute up to N moves from the start (default=12)\n"
     "\t-M, --memory=LIMIT\tSpecify heap memory limit in GiB (default=90%)"
+    "\t-i, --input=PATH\tSpecify input file (default=stdin)\n"
+    "\t-L, --limit=N\t\tPrecompute at most N responses (default=100000)\n"
     "\t-o, --output=PATH\tSpecify output file (default=stdout)\n"
     "\t-f, --force\t\tForce re-solve/re-analyze\n"
+    "\t-F, --from=POSITION\tSolve only the subgame from formal POSITION\n"
+    "\t-H, --histograms\tRecord tier histograms while solving to speed up "
+    "analysis\n"
     "\t-q, --quiet\t\tProduce no output\n"
+    "\t-P, --pack\t\tPack the database into segment files before solving\n"
+    "\t-r, --reachable-only\tSolve only the positions reachable from the "
+    "initial\n\t\t\tposition\n"
+    "\t-R, --rebuild-manifest\tRebuild the database manifest of solved tiers "
+    "from\n\t\t\tthe tier files before solving\n"
+    "\t-s, --socket=PATH\tServe on a Unix domain socket (default=stdin)\n"
     "\t-v, --verbose\t\tProduce verbose output\n"
     "\t-?, --help\t\tGive this help list\n"
     "\t--usage\t\t\tGive a short usage message\n"
@@ -132,8 +224,18 @@ static const char kDoc[] =
     "\n"
     "query game information\n"
     "    query\tgamesman query <game> <variant> <position>\n"
+    "    query-batch\tgamesman query-batch <game> [<variant>]\n"
+    "\t\t(one position per line of input, one response per line)\n"
     "    getstart\tgamesman getstart <game> [<variant>]\n"
-    "    getrandom\tgamesman getrandom <game> [<variant>]\n";
+    "    getrandom\tgamesman getrandom <game> [<variant>]\n"
+    "\n"
+    "answer newline-delimited JSON queries until the end of input\n"
+    "    serve\tgamesman serve [<game> [<variant>]]\n"
+    "\t\t(without a game, each request names its own \"game\" and\n"
+    "\t\t\"variant\" and is answered by a resident worker process)\n"
+    "\n"
+    "precompute the responses to positions near the start for serve --cache\n"
+    "    precompute\tgamesman precompute <game> [<variant>] --cache=PATH\n";
 
 // -----------------------------------------------------------------------------
 
@@ -144,8 +246,8 @@ HeadlessArguments HeadlessParseArguments(int argc, char **argv) {
         /* getopt_long stores the option index here. */
         int option_index = 0;
         // NOLINTBEGIN(concurrency-mt-unsafe)
-        key =
-            getopt_long(argc, argv, "dM:f?o:qvV", kLongOptions, &option_index);
+        key = getopt_long(argc, argv, "Ac:CdD:M:fF:?Hi:L:o:qPrRs:vV",
+                          kLongOptions, &option_index);
         // NOLINTEND(concurrency-mt-unsafe)
         /* Detect the end of the options. */
         if (key == -1) break;
@@ -158,6 +260,7 @@ HeadlessArguments HeadlessParseArguments(int argc, char **argv) {
         ParseArgument(argv[optind++], arg_num++);
     }
     ValidateArguments(arg_num);
+    BuildSolveOptions();
 
     return arguments;
 }
@@ -178,10 +281,26 @@ static void ParseOption(int key, int option_index) {
             printf("\n");
             break;
 
+        case 'A':
+            arguments.solve_options.async_flush = true;
+            break;
+
+        case 'c':
+            arguments.cache_path = optarg;
+            break;
+
+        case 'C':
+            arguments.solve_options.cache_tiers = true;
+            break;
+
         case 'd':
             arguments.data_path = optarg;
             break;
 
+        case 'D':
+            arguments.depth = optarg;
+            break;
+
         case 'M':
             arguments.memlimit = optarg;
             break;
@@ -190,10 +309,26 @@ static void ParseOption(int key, int option_index) {
             arguments.force = 1;
             break;
 
+        case 'F':
+            arguments.solve_options.from = optarg;
+            break;
+
         case 'h':
             PrintUsage();
             exit(0);  // NOLINT(concurrency-mt-unsafe)
 
+        case 'H':
+            arguments.solve_options.histograms = true;
+            break;
+
+        case 'i':
+            arguments.input = optarg;
+            break;
+
+        case 'L':
+            arguments.limit = optarg;
+            break;
+
         case 'o':
             arguments.output = optarg;
             break;
@@ -202,6 +337,22 @@ static void ParseOption(int key, int option_index) {
             arguments.quiet = 1;
             break;
 
+        case 'P':
+            arguments.solve_options.pack = true;
+            break;
+
+        case 'r':
+            arguments.solve_options.reachable_only = true;
+            break;
+
+        case 'R':
+            arguments.solve_options.rebuild_manifest = true;
+            break;
+
+        case 's':
+            arguments.socket_path = optarg;
+            break;
+
         case 'v':
             arguments.verbose = 1;
             break;
@@ -258,10 +409,17 @@ static void ValidateArguments(int arg_num) {
         case kHeadlessAnalyze:
         case kHeadlessGetStart:
         case kHeadlessGetRandom:
+        case kHeadlessQueryBatch:
+        case kHeadlessPrecompute:
             min_args = 2;
             max_args = 3;
             break;
 
+        case kHeadlessServe:
+            min_args = 1;
+            max_args = 3;
+            break;
+
         case kHeadlessQuery:
             min_args = max_args = 4;
             break;
@@ -270,6 +428,11 @@ static void ValidateArguments(int arg_num) {
             ParserError("invalid command %s", command);
     }
 
+    if (arguments.action == kHeadlessPrecompute &&
+        arguments.cache_path == NULL) {
+        ParserError("command %s requires --cache", command);
+    }
+
     if (arg_num < min_args) {
         ParserError(
             "too few arguments for command %s (requires %d, provided %d)",
@@ -281,6 +444,15 @@ static void ValidateArguments(int arg_num) {
     }
 }
 
+// Fills in the solve options shared with the other commands.
+static void BuildSolveOptions(void) {
+    arguments.solve_options.force = arguments.force;
+    arguments.solve_options.verbose =
+        HeadlessGetVerbosity(arguments.verbose, arguments.quiet);
+    arguments.solve_options.memlimit =
+        HeadlessParseMemLimit(arguments.memlimit);
+}
+
 static void PrintUsage(void) {
     printf("Usage: %s\n%s\n", "gamesman [OPTION...] <command> [<args>]", kDoc);
 }
@@ -27,21 +27,39 @@
 #ifndef GAMESMANONE_CORE_HEADLESS_HPARSER_H_
 #define GAMESMANONE_CORE_HEADLESS_HPARSER_H_
 
+#include "core/headless/hsolve.h"
+
 /*
  * Headless Commands:
  * solve <game> [<variant_id>]    // solve and analyze game.
  * analyze <game> [<variant_id>]  // analyze only, assuming solved.
  *
  * query <game> <variant_id> <position>  // get detailed position response.
+ * query-batch <game> [<variant_id>]     // query each line of input.
  * getstart <game> [<variant_id>]        // get starting position.
  * getrandom <game> [<variant_id>]       // get a random position.
  *
+ * serve [<game> [<variant_id>]]  // answer NDJSON queries until end of input,
+ *                                // for any game if <game> is omitted.
+ * precompute <game> [<variant_id>]  // precompute responses for serve --cache.
+ *
  * Options:
+ * -A, --async-flush   // only effective when solving
+ * -c, --cache=<path>  // only effective when serving/precomputing
+ * -C, --cache-tiers   // only effective when solving
  * --data-path=<path>
- * --memory=<limit>  // in GiB
+ * -D, --depth=<n>     // only effective when precomputing
+ * --memory=<limit>  // in GiB, also caps the workers of a multi-game server
+ * -i, --input=<path>  // only effective when batch querying
+ * -L, --limit=<n>     // only effective when precomputing
  * -o, --output=<path>
  * -f, --force    // only effective when solving/analyzing
+ * -F, --from=<formal position>  // only effective when solving
  * -q, --quiet    // only effective when solving/analyzing
+ * -P, --pack  // only effective when solving
+ * -r, --reachable-only  // only effective when solving
+ * -R, --rebuild-manifest  // only effective when solving
+ * -s, --socket=<path>  // only effective when serving
  * -v, --verbose  // only effective when solving/analyzing
  * -V, --version  // automatic
  *     --usage    // automatic
@@ -54,24 +72,36 @@ enum HeadlessAction {
     kHeadlessSolve,              /**< Solve. */
     kHeadlessAnalyze,            /**< Analyze. */
     kHeadlessQuery,              /**< Query position. */
+    kHeadlessQueryBatch,         /**< Query positions in batch. */
     kHeadlessGetStart,           /**< Get start position. */
     kHeadlessGetRandom,          /**< Get random position. */
+    kHeadlessServe,              /**< Serve queries. */
+    kHeadlessPrecompute,         /**< Precompute query responses. */
     kNumHeadlessActions,         /**< Number of all valid actions. */
 };
 
 /** @brief Collection of all arguments used for command line parsing. */
 typedef struct HeadlessArguments {
-    char *command;    /**< User command. See Headless Commands for details. */
-    char *game;       /**< Game name. */
-    char *variant_id; /**< Variant index. */
-    char *position;   /**< Position to query. */
-    char *data_path;  /**< Path to the "data" directory, NULL for default. */
-    char *memlimit;   /**< Heap memory limit, NULL for default (90%). */
-    char *output;     /**< Path to output file, defaults to stdout if NULL. */
-    int action;       /**< Action to take. */
-    int force;        /**< Whether to force solve/analyze. */
-    int verbose;      /**< Whether to print additional output. */
-    int quiet;        /**< Whether to give no output. */
+    char *command;     /**< User command. See Headless Commands for details. */
+    char *game;        /**< Game name. */
+    char *variant_id;  /**< Variant index. */
+    char *position;    /**< Position to query. */
+    char *data_path;   /**< Path to the "data" directory, NULL for default. */
+    char *memlimit;    /**< Heap memory limit, NULL for default (90%). */
+    char *input;       /**< Path to input file, defaults to stdin if NULL. */
+    char *output;      /**< Path to output file, defaults to stdout if NULL. */
+    char *socket_path; /**< Unix domain socket to serve on, NULL for stdin. */
+    char *cache_path;  /**< Precomputed response cache file, NULL if none. */
+    char *depth;       /**< Precomputation depth, NULL for default. */
+    char *limit;       /**< Precomputation limit, NULL for default. */
+    int action;        /**< Action to take. */
+    int force;         /**< Whether to force solve/analyze. */
+    int verbose;       /**< Whether to print additional output. */
+    int quiet;         /**< Whether to give no output. */
+
+    /** Options of the solve command, which also reflect FORCE, VERBOSE,
+     * QUIET, and MEMLIMIT. */
+    HeadlessSolveOptions solve_options;
 } HeadlessArguments;
 
 HeadlessArguments HeadlessParseArguments(int argc, char **argv);
@@ -0,0 +1,676 @@
+/**
+ * @file hpool.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the multi-game query server of headless mode.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/headless/hpool.h"
+
+#include <errno.h>                // errno, EINTR, EAGAIN, EWOULDBLOCK
+#include <fcntl.h>                // fcntl, F_GETFL, F_SETFL, O_NONBLOCK
+#include <json-c/json_object.h>   // json_object and related functions
+#include <json-c/json_tokener.h>  // json_tokener_parse
+#include <poll.h>                 // poll, pollfd, POLLIN, POLLOUT
+#include <signal.h>               // signal, kill, SIGPIPE, SIGTERM
+#include <stdbool.h>              // bool, true, false
+#include <stddef.h>               // NULL, size_t
+#include <stdint.h>               // intptr_t, int64_t
+#include <stdio.h>                // FILE, fprintf, fflush, fopen, fscanf
+#include <stdlib.h>               // malloc, realloc, free
+#include <string.h>               // memchr, memmove, strcmp, strcspn, strlen
+#include <sys/socket.h>           // accept
+#include <sys/types.h>            // pid_t, ssize_t
+#include <sys/wait.h>             // waitpid
+#include <unistd.h>               // close, dup, dup2, fork, pipe, read, write
+
+#include "core/headless/hjson.h"
+#include "core/headless/hserve.h"
+#include "core/misc.h"
+#include "core/types/gamesman_types.h"
+
+enum {
+    kLineReaderCapacityMin = 4096,
+
+    /** Number of requests dispatched between two memory usage checks. */
+    kMemoryCheckInterval = 1024,
+};
+
+/** @brief Buffered reader of lines from a file descriptor. */
+typedef struct LineReader {
+    int fd;
+    char *buf;
+    size_t begin;
+    size_t end;
+    size_t capacity;
+    bool eof;
+} LineReader;
+
+/** @brief Resident process serving a single game variant. */
+typedef struct PoolWorker {
+    char game[kGameNameLengthMax + 1];
+    int variant_id;
+    pid_t pid;
+    int request_fd;        /**< Non-blocking write end of the worker's stdin. */
+    LineReader responses;  /**< Read end of the worker's stdout. */
+    int64_t pending;       /**< Number of requests yet to be answered. */
+    int64_t last_used;
+    bool failed;
+} PoolWorker;
+
+/**
+ * @brief Entry of the queue of requests waiting to be answered, which is
+ * either answered by WORKER or, if WORKER is NULL, by the error message ERROR.
+ */
+typedef struct PendingResponse {
+    PoolWorker *worker;
+    ReadOnlyString error;
+} PendingResponse;
+
+typedef struct WorkerPool {
+    ReadOnlyString data_path;
+    intptr_t memlimit;
+    PoolWorker *workers[kHeadlessPoolWorkersMax];
+    int num_workers;
+    int64_t clock;
+    int64_t dispatched_since_check;
+
+    PendingResponse queue[kHeadlessPoolInFlightMax];
+    int queue_head;
+    int queue_size;
+
+    /** File descriptors of the pool that workers must not inherit. */
+    int private_fds[3];
+} WorkerPool;
+
+static bool ReaderInit(LineReader *reader, int fd);
+static void ReaderDestroy(LineReader *reader);
+static char *ReaderNextLine(LineReader *reader);
+static bool ReaderFill(LineReader *reader);
+
+static void PoolInit(WorkerPool *pool, ReadOnlyString data_path,
+                     intptr_t memlimit);
+static void PoolDestroy(WorkerPool *pool);
+static int PoolServeSocket(WorkerPool *pool, ReadOnlyString socket_path);
+static int PoolServeStream(WorkerPool *pool, int in_fd, FILE *out);
+static void PoolDispatch(WorkerPool *pool, char *line);
+static PoolWorker *PoolGetWorker(WorkerPool *pool, ReadOnlyString game,
+                                 int variant_id);
+static PoolWorker *PoolSpawnWorker(WorkerPool *pool, ReadOnlyString game,
+                                   int variant_id);
+static void RunWorker(WorkerPool *pool, ReadOnlyString game, int variant_id,
+                      const int request_pipe[2], const int response_pipe[2]);
+static void PoolEvictWorker(WorkerPool *pool, int index);
+static bool PoolEvictLeastRecentlyUsed(WorkerPool *pool);
+static void PoolEnforceMemoryLimit(WorkerPool *pool);
+static void PoolReapFailedWorkers(WorkerPool *pool);
+static void PoolDropPending(WorkerPool *pool);
+static void PoolPush(WorkerPool *pool, PoolWorker *worker,
+                     ReadOnlyString error);
+static int PoolAnswerReady(WorkerPool *pool, FILE *out);
+static int PoolWait(WorkerPool *pool, LineReader *input);
+static bool PoolWriteRequest(WorkerPool *pool, PoolWorker *worker,
+                             const char *buf, size_t size);
+static bool PoolWaitWritable(WorkerPool *pool, PoolWorker *worker);
+static intptr_t ResidentMemory(pid_t pid);
+static int WriteError(FILE *out, ReadOnlyString message);
+
+// -----------------------------------------------------------------------------
+
+int HeadlessServePool(ReadOnlyString data_path, ReadOnlyString socket_path,
+                      intptr_t memlimit) {
+    // Writing to a worker that has exited or to a client that has disconnected
+    // should not terminate the server.
+    signal(SIGPIPE, SIG_IGN);
+
+    WorkerPool pool;
+    PoolInit(&pool, data_path, memlimit);
+    int error;
+    if (socket_path == NULL) {
+        error = PoolServeStream(&pool, STDIN_FILENO, stdout);
+    } else {
+        error = PoolServeSocket(&pool, socket_path);
+    }
+    PoolDestroy(&pool);
+
+    return error;
+}
+
+// -----------------------------------------------------------------------------
+
+static bool ReaderInit(LineReader *reader, int fd) {
+    reader->fd = fd;
+    reader->buf = (char *)malloc(kLineReaderCapacityMin);
+    reader->begin = reader->end = 0;
+    reader->capacity = kLineReaderCapacityMin;
+    reader->eof = false;
+
+    return reader->buf != NULL;
+}
+
+static void ReaderDestroy(LineReader *reader) {
+    free(reader->buf);
+    reader->buf = NULL;
+}
+
+// Returns the next complete line with its line terminator removed, or NULL if
+// no complete line has been read yet. The returned line is valid until the
+// next call to ReaderFill().
+static char *ReaderNextLine(LineReader *reader) {
+    char *begin = reader->buf + reader->begin;
+    size_t size = reader->end - reader->begin;
+    char *newline = (char *)memchr(begin, '\n', size);
+    if (newline != NULL) {
+        *newline = '\0';
+        reader->begin += newline - begin + 1;
+        return begin;
+    }
+
+    // Return the last line even if it is not terminated.
+    if (reader->eof && size > 0) {
+        reader->buf[reader->end] = '\0';
+        reader->begin = reader->end;
+        return begin;
+    }
+
+    return NULL;
+}
+
+// Reads once from the file descriptor, marking the reader as having reached
+// the end of input if nothing can be read. Returns false on allocation
+// failure.
+static bool ReaderFill(LineReader *reader) {
+    if (reader->begin > 0) {
+        memmove(reader->buf, reader->buf + reader->begin,
+                reader->end - reader->begin);
+        reader->end -= reader->begin;
+        reader->begin = 0;
+    }
+
+    // One byte is always reserved for the terminator of an unterminated line.
+    if (reader->end + 1 >= reader->capacity) {
+        size_t new_capacity = reader->capacity * 2;
+        char *new_buf = (char *)realloc(reader->buf, new_capacity);
+        if (new_buf == NULL) return false;
+        reader->buf = new_buf;
+        reader->capacity = new_capacity;
+    }
+
+    ssize_t n;
+    do {
+        n = read(reader->fd, reader->buf + reader->end,
+                 reader->capacity - reader->end - 1);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) {
+        reader->eof = true;
+    } else {
+        reader->end += n;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+static void PoolInit(WorkerPool *pool, ReadOnlyString data_path,
+                     intptr_t memlimit) {
+    pool->data_path = data_path;
+    pool->memlimit = memlimit;
+    pool->num_workers = 0;
+    pool->clock = 0;
+    pool->dispatched_since_check = 0;
+    pool->queue_head = pool->queue_size = 0;
+    for (int i = 0; i < 3; ++i) {
+        pool->private_fds[i] = -1;
+    }
+}
+
+static void PoolDestroy(WorkerPool *pool) {
+    PoolDropPending(pool);
+    while (pool->num_workers > 0) {
+        PoolEvictWorker(pool, pool->num_workers - 1);
+    }
+}
+
+static int PoolServeSocket(WorkerPool *pool, ReadOnlyString socket_path) {
+    int listener = HeadlessServeListen(socket_path);
+    if (listener < 0) return kFileSystemError;
+
+    pool->private_fds[0] = listener;
+    int ret = kNoError;
+    while (true) {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) {
+            perror("accept");
+            ret = kFileSystemError;
+            break;
+        }
+        int out_fd = dup(fd);
+        FILE *out = out_fd < 0 ? NULL : fdopen(out_fd, "w");
+        if (out == NULL) {
+            if (out_fd >= 0) close(out_fd);
+            close(fd);
+            continue;
+        }
+        pool->private_fds[1] = fd;
+        pool->private_fds[2] = out_fd;
+        PoolServeStream(pool, fd, out);
+        fclose(out);
+        close(fd);
+        pool->private_fds[1] = pool->private_fds[2] = -1;
+    }
+    close(listener);
+    unlink(socket_path);
+    pool->private_fds[0] = -1;
+
+    return ret;
+}
+
+static int PoolServeStream(WorkerPool *pool, int in_fd, FILE *out) {
+    LineReader input;
+    if (!ReaderInit(&input, in_fd)) return kMallocFailureError;
+
+    int ret = kNoError;
+    while (true) {
+        ret = PoolAnswerReady(pool, out);
+        if (ret != kNoError) break;
+        PoolReapFailedWorkers(pool);
+
+        bool dispatched = false;
+        char *line;
+        while (pool->queue_size < kHeadlessPoolInFlightMax &&
+               (line = ReaderNextLine(&input)) != NULL) {
+            line[strcspn(line, "\r")] = '\0';
+            if (line[0] == '\0') continue;  // Skip blank lines.
+            PoolDispatch(pool, line);
+            dispatched = true;
+        }
+        if (dispatched) continue;
+        if (input.eof && pool->queue_size == 0) break;
+
+        // Nothing can be done until more input or responses arrive.
+        if (fflush(out) != 0) {
+            ret = kFileSystemError;
+            break;
+        }
+        ret = PoolWait(pool, &input);
+        if (ret != kNoError) break;
+    }
+    if (ret == kNoError && fflush(out) != 0) ret = kFileSystemError;
+
+    // Responses that will never be read would be sent to the next client
+    // otherwise.
+    if (ret != kNoError) PoolDropPending(pool);
+    ReaderDestroy(&input);
+
+    return ret;
+}
+
+static void PoolDispatch(WorkerPool *pool, char *line) {
+    json_object *request = json_tokener_parse(line);
+    json_object *game_obj = NULL, *variant_obj = NULL;
+    ReadOnlyString game = NULL;
+    int variant_id = -1;
+    if (json_object_object_get_ex(request, "game", &game_obj) &&
+        json_object_get_type(game_obj) == json_type_string) {
+        game = json_object_get_string(game_obj);
+    }
+    if (json_object_object_get_ex(request, "variant", &variant_obj)) {
+        variant_id = json_object_get_int(variant_obj);
+    }
+
+    PoolWorker *worker = NULL;
+    if (game == NULL || strlen(game) > kGameNameLengthMax) {
+        PoolPush(pool, NULL, "invalid request");
+    } else if ((worker = PoolGetWorker(pool, game, variant_id)) == NULL) {
+        PoolPush(pool, NULL, "too many games in use");
+    } else if (!PoolWriteRequest(pool, worker, line, strlen(line)) ||
+               !PoolWriteRequest(pool, worker, "\n", 1)) {
+        worker->failed = true;
+        PoolPush(pool, NULL, "failed to load game");
+    } else {
+        PoolPush(pool, worker, NULL);
+    }
+    json_object_put(request);
+
+    if (++pool->dispatched_since_check >= kMemoryCheckInterval) {
+        PoolEnforceMemoryLimit(pool);
+    }
+}
+
+static PoolWorker *PoolGetWorker(WorkerPool *pool, ReadOnlyString game,
+                                 int variant_id) {
+    for (int i = 0; i < pool->num_workers; ++i) {
+        PoolWorker *worker = pool->workers[i];
+        if (!worker->failed && worker->variant_id == variant_id &&
+            strcmp(worker->game, game) == 0) {
+            return worker;
+        }
+    }
+
+    return PoolSpawnWorker(pool, game, variant_id);
+}
+
+static PoolWorker *PoolSpawnWorker(WorkerPool *pool, ReadOnlyString game,
+                                   int variant_id) {
+    PoolEnforceMemoryLimit(pool);
+    if (pool->num_workers == kHeadlessPoolWorkersMax &&
+        !PoolEvictLeastRecentlyUsed(pool)) {
+        return NULL;
+    }
+
+    PoolWorker *worker = (PoolWorker *)malloc(sizeof(PoolWorker));
+    if (worker == NULL) return NULL;
+    int request_pipe[2], response_pipe[2];
+    if (pipe(request_pipe) != 0) {
+        free(worker);
+        return NULL;
+    }
+    if (pipe(response_pipe) != 0) {
+        close(request_pipe[0]);
+        close(request_pipe[1]);
+        free(worker);
+        return NULL;
+    }
+
+    fflush(NULL);  // Buffered output would be written twice otherwise.
+    pid_t pid = fork();
+    if (pid == 0) {
+        RunWorker(pool, game, variant_id, request_pipe, response_pipe);
+    }
+    close(request_pipe[0]);
+    close(response_pipe[1]);
+    int flags = fcntl(request_pipe[1], F_GETFL);
+    if (pid < 0 || flags < 0 ||
+        fcntl(request_pipe[1], F_SETFL, flags | O_NONBLOCK) != 0 ||
+        !ReaderInit(&worker->responses, response_pipe[0])) {
+        perror("PoolSpawnWorker");
+        close(request_pipe[1]);
+        close(response_pipe[0]);
+        if (pid > 0) waitpid(pid, NULL, 0);
+        free(worker);
+        return NULL;
+    }
+
+    SafeStrncpy(worker->game, game, kGameNameLengthMax + 1);
+    worker->variant_id = variant_id;
+    worker->pid = pid;
+    worker->request_fd = request_pipe[1];
+    worker->pending = 0;
+    worker->last_used = pool->clock;
+    worker->failed = false;
+    pool->workers[pool->num_workers++] = worker;
+
+    return worker;
+}
+
+// Runs in the child process and never returns.
+static void RunWorker(WorkerPool *pool, ReadOnlyString game, int variant_id,
+                      const int request_pipe[2], const int response_pipe[2]) {
+    dup2(request_pipe[0], STDIN_FILENO);
+    dup2(response_pipe[1], STDOUT_FILENO);
+    close(request_pipe[0]);
+    close(request_pipe[1]);
+    close(response_pipe[0]);
+    close(response_pipe[1]);
+
+    // Other workers must see the end of their input when the pool closes
+    // their request pipes, and clients must see the end of their connections.
+    for (int i = 0; i < pool->num_workers; ++i) {
+        close(pool->workers[i]->request_fd);
+        close(pool->workers[i]->responses.fd);
+    }
+    for (int i = 0; i < 3; ++i) {
+        if (pool->private_fds[i] >= 0) close(pool->private_fds[i]);
+    }
+    signal(SIGPIPE, SIG_DFL);
+
+    int error = HeadlessServe(game, variant_id, pool->data_path, NULL,
+                              NULL);
+    fflush(stdout);
+    _exit(error == kNoError ? 0 : 1);
+}
+
+static void PoolEvictWorker(WorkerPool *pool, int index) {
+    PoolWorker *worker = pool->workers[index];
+
+    // Idle workers exit on their own once their input is closed.
+    close(worker->request_fd);
+    if (worker->pending > 0) kill(worker->pid, SIGTERM);
+    close(worker->responses.fd);
+    ReaderDestroy(&worker->responses);
+    waitpid(worker->pid, NULL, 0);
+    free(worker);
+    pool->workers[index] = pool->workers[--pool->num_workers];
+}
+
+static int LeastRecentlyUsedIdleWorker(const WorkerPool *pool) {
+    int ret = -1;
+    for (int i = 0; i < pool->num_workers; ++i) {
+        const PoolWorker *worker = pool->workers[i];
+        if (worker->pending > 0) continue;
+        if (ret < 0 || worker->last_used < pool->workers[ret]->last_used) {
+            ret = i;
+        }
+    }
+
+    return ret;
+}
+
+static bool PoolEvictLeastRecentlyUsed(WorkerPool *pool) {
+    int index = LeastRecentlyUsedIdleWorker(pool);
+    if (index < 0) return false;
+    PoolEvictWorker(pool, index);
+
+    return true;
+}
+
+static void PoolEnforceMemoryLimit(WorkerPool *pool) {
+    pool->dispatched_since_check = 0;
+    if (pool->memlimit <= 0) return;
+
+    intptr_t usage[kHeadlessPoolWorkersMax];
+    intptr_t total = 0;
+    for (int i = 0; i < pool->num_workers; ++i) {
+        usage[i] = ResidentMemory(pool->workers[i]->pid);
+        total += usage[i];
+    }
+    while (total > pool->memlimit) {
+        int index = LeastRecentlyUsedIdleWorker(pool);
+        if (index < 0) break;
+        total -= usage[index];
+        usage[index] = usage[pool->num_workers - 1];
+        PoolEvictWorker(pool, index);
+    }
+}
+
+static void PoolReapFailedWorkers(WorkerPool *pool) {
+    for (int i = pool->num_workers - 1; i >= 0; --i) {
+        PoolWorker *worker = pool->workers[i];
+        if (worker->pending == 0 &&
+            (worker->failed || worker->responses.eof)) {
+            PoolEvictWorker(pool, i);
+        }
+    }
+}
+
+static void PoolDropPending(WorkerPool *pool) {
+    pool->queue_head = pool->queue_size = 0;
+    for (int i = pool->num_workers - 1; i >= 0; --i) {
+        if (pool->workers[i]->pending > 0) PoolEvictWorker(pool, i);
+    }
+}
+
+static void PoolPush(WorkerPool *pool, PoolWorker *worker,
+                     ReadOnlyString error) {
+    int tail = (pool->queue_head + pool->queue_size) % kHeadlessPoolInFlightMax;
+    pool->queue[tail].worker = worker;
+    pool->queue[tail].error = error;
+    ++pool->queue_size;
+    if (worker != NULL) {
+        ++worker->pending;
+        worker->last_used = ++pool->clock;
+    }
+}
+
+// Writes the responses at the front of the queue that are ready, in order.
+static int PoolAnswerReady(WorkerPool *pool, FILE *out) {
+    while (pool->queue_size > 0) {
+        PendingResponse *head = &pool->queue[pool->queue_head];
+        PoolWorker *worker = head->worker;
+        int error = kNoError;
+        if (worker == NULL) {
+            error = WriteError(out, head->error);
+        } else {
+            char *line = ReaderNextLine(&worker->responses);
+            if (line != NULL) {
+                if (fprintf(out, "%s\n", line) < 0) error = kFileSystemError;
+            } else if (worker->responses.eof) {
+                // The worker exited, most likely because the game variant
+                // could not be initialized.
+                worker->failed = true;
+                error = WriteError(out, "failed to load game");
+            } else {
+                break;  // The response has not arrived yet.
+            }
+            --worker->pending;
+        }
+        pool->queue_head = (pool->queue_head + 1) % kHeadlessPoolInFlightMax;
+        --pool->queue_size;
+        if (error != kNoError) return error;
+    }
+
+    return kNoError;
+}
+
+// Blocks until more input is available or the worker that owes the response at
+// the front of the queue has written something.
+static int PoolWait(WorkerPool *pool, LineReader *input) {
+    struct pollfd fds[2];
+    int n = 0, input_index = -1, worker_index = -1;
+    if (!input->eof && pool->queue_size < kHeadlessPoolInFlightMax) {
+        fds[n].fd = input->fd;
+        fds[n].events = POLLIN;
+        input_index = n++;
+    }
+    PoolWorker *worker = NULL;
+    if (pool->queue_size > 0) {
+        worker = pool->queue[pool->queue_head].worker;
+        fds[n].fd = worker->responses.fd;
+        fds[n].events = POLLIN;
+        worker_index = n++;
+    }
+    if (n == 0) return kNoError;
+
+    if (poll(fds, n, -1) < 0) {
+        if (errno == EINTR) return kNoError;
+        perror("poll");
+        return kRuntimeError;
+    }
+    if (input_index >= 0 && fds[input_index].revents != 0 &&
+        !ReaderFill(input)) {
+        return kMallocFailureError;
+    }
+    if (worker_index >= 0 && fds[worker_index].revents != 0 &&
+        !ReaderFill(&worker->responses)) {
+        return kMallocFailureError;
+    }
+
+    return kNoError;
+}
+
+// Writes SIZE bytes of BUF to the requests of WORKER. A worker stops reading
+// requests while its stdout is full, and the stdout of a worker is otherwise
+// only read once its response reaches the front of the queue. The responses of
+// all workers are therefore buffered whenever WORKER's requests are full.
+// Returns false if WORKER can no longer be written to or on allocation failure.
+static bool PoolWriteRequest(WorkerPool *pool, PoolWorker *worker,
+                             const char *buf, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(worker->request_fd, buf, size);
+        if (n >= 0) {
+            buf += n;
+            size -= n;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            if (!PoolWaitWritable(pool, worker)) return false;
+        } else if (errno != EINTR) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Blocks until the requests of WORKER can be written to, reading the responses
+// of all workers in the meantime. Returns false on failure.
+static bool PoolWaitWritable(WorkerPool *pool, PoolWorker *worker) {
+    struct pollfd fds[kHeadlessPoolWorkersMax + 1];
+    PoolWorker *readers[kHeadlessPoolWorkersMax];
+    int n = 0;
+    for (int i = 0; i < pool->num_workers; ++i) {
+        if (pool->workers[i]->responses.eof) continue;
+        readers[n] = pool->workers[i];
+        fds[n].fd = readers[n]->responses.fd;
+        fds[n++].events = POLLIN;
+    }
+    fds[n].fd = worker->request_fd;
+    fds[n].events = POLLOUT;
+
+    if (poll(fds, n + 1, -1) < 0) {
+        if (errno == EINTR) return true;
+        perror("poll");
+        return false;
+    }
+    for (int i = 0; i < n; ++i) {
+        if (fds[i].revents != 0 && !ReaderFill(&readers[i]->responses)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Returns the resident set size of process PID in bytes, or 0 if unknown.
+static intptr_t ResidentMemory(pid_t pid) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/statm", (int)pid);
+    FILE *statm = fopen(path, "r");
+    if (statm == NULL) return 0;
+
+    long size, resident;
+    if (fscanf(statm, "%ld %ld", &size, &resident) != 2) resident = 0;
+    fclose(statm);
+
+    return (intptr_t)resident * sysconf(_SC_PAGESIZE);
+}
+
+static int WriteError(FILE *out, ReadOnlyString message) {
+    HeadlessJsonWriter writer;
+    HeadlessJsonWriterInit(&writer);
+    int ret = HeadlessJsonWriteError(&writer, message);
+    if (ret == kNoError &&
+        fprintf(out, "%s\n", HeadlessJsonWriterGetString(&writer)) < 0) {
+        ret = kFileSystemError;
+    }
+    HeadlessJsonWriterDestroy(&writer);
+
+    return ret;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file hpool.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Multi-game query server of headless mode.
+ * @details The Game Manager, the Solver Manager, and the Database Manager keep
+ * their state in globals, which allows only one game variant to be loaded in a
+ * process. The pool therefore keeps one resident worker process for each game
+ * variant it has been asked about. Each worker is forked from the pool before
+ * any game is loaded, initializes its game variant and solver once, and then
+ * runs the same loop as HeadlessServeStream() with its own database files and
+ * probing session.
+ *
+ * Requests use the same newline-delimited JSON protocol as HeadlessServe(),
+ * with two additional fields that select the game variant:
+ *
+ *     { "game": "<name>", "variant": <id>, "action": "query", ... }
+ *
+ * "variant" may be omitted to select the default variant. The pool forwards
+ * each request to its worker without waiting for earlier requests to be
+ * answered, so requests for different game variants are answered in parallel
+ * by different workers. Responses are still written in the same order as the
+ * requests.
+ *
+ * Workers with no outstanding requests are shut down in least-recently-used
+ * order whenever the total resident memory of all workers exceeds the memory
+ * limit, or when the number of workers reaches \c kHeadlessPoolWorkersMax.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_HEADLESS_HPOOL_H_
+#define GAMESMANONE_CORE_HEADLESS_HPOOL_H_
+
+#include <stdint.h>  // intptr_t
+
+#include "core/types/gamesman_types.h"
+
+enum {
+    /** Maximum number of resident worker processes. */
+    kHeadlessPoolWorkersMax = 64,
+
+    /** Maximum number of requests waiting to be answered. */
+    kHeadlessPoolInFlightMax = 256,
+};
+
+/**
+ * @brief Serves position queries for any game variant, keeping a resident
+ * worker process for each recently used game variant.
+ *
+ * @param data_path Path to the "data" directory. The default path will be used
+ * if set to NULL.
+ * @param socket_path If NULL, requests are read from stdin and responses are
+ * written to stdout until the end of stdin is reached. Otherwise, the server
+ * listens on a Unix domain socket bound to this path, replacing any existing
+ * file, and serves connections one after another until it is terminated.
+ * @param memlimit Limit on the total resident memory of all workers in bytes,
+ * or 0 to limit only the number of workers. Workers that are answering
+ * requests are never shut down, so the limit may be exceeded temporarily.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessServePool(ReadOnlyString data_path, ReadOnlyString socket_path,
+                      intptr_t memlimit);
+
+#endif  // GAMESMANONE_CORE_HEADLESS_HPOOL_H_
@@ -27,12 +27,10 @@
 
 #include "core/headless/hquery.h"
 
-#include <assert.h>              // assert
-#include <json-c/json_object.h>  // json_object and related functions
-#include <stdbool.h>             // bool, true, false
-#include <stdbool.h>             // bool
-#include <stdint.h>              // int64_t
-#include <stdio.h>               // printf
+#include <assert.h>   // assert
+#include <stdbool.h>  // bool, true, false
+#include <stdint.h>   // int64_t
+#include <stdio.h>    // printf
 
 #include "core/constants.h"
 #include "core/game_manager.h"
@@ -41,97 +39,211 @@
 #include "core/solvers/solver_manager.h"
 #include "core/types/gamesman_types.h"
 
+/**
+ * @brief Source of the values and remotenesses of the positions in a response.
+ * Positions are looked up with the probe if it is not NULL. Otherwise, the
+ * results are read from the VALUES and REMOTENESSES arrays at the index of the
+ * position in the order collected by HeadlessQueryCollectProbes().
+ */
+typedef struct QueryLookup {
+    SolverProbe *probe;
+    const Value *values;
+    const int *remotenesses;
+} QueryLookup;
+
+static Value LookupValueRemoteness(const QueryLookup *lookup, int64_t index,
+                                   TierPosition tier_position,
+                                   int *remoteness);
+
 static int InitAndCheckGame(ReadOnlyString game_name, int variant_id,
-                            ReadOnlyString data_path, bool *is_tier_game);
+                            ReadOnlyString data_path);
+static int CheckGame(const Game *game, bool *is_tier_game);
 static bool ImplementsRegularUwapi(const Game *game);
 static bool ImplementsTierUwapi(const Game *game);
-
-static int QueryRegular(const Game *game, ReadOnlyString formal_position);
-static int QueryTier(const Game *game, ReadOnlyString formal_position);
-
-static int GetStartRegular(const Game *game);
-static int GetStartTier(const Game *game);
-
-static int GetRandomRegular(const Game *game);
-static int GetRandomTier(const Game *game);
-
-static int JsonPrintPositionResponse(const Game *game, Position position);
-static json_object *JsonCreateBasicPositionObject(const Game *game,
-                                                  Position position);
-static json_object *JsonCreateChildPositionObject(const Game *game,
-                                                  Position parent, Move move);
-static json_object *JsonCreateParentPositionObject(
-    const Game *game, Position position, json_object *moves_array_obj,
-    json_object *partmoves_array_obj);
-
-static int JsonPrintTierPositionResponse(const Game *game,
-                                         TierPosition tier_position);
+static int PrintResponse(int error, HeadlessJsonWriter *writer);
+
+static int WritePositionResponse(const QueryLookup *lookup,
+                                 ReadOnlyString formal_position,
+                                 HeadlessJsonWriter *writer);
+static int QueryRegular(const QueryLookup *lookup, const Game *game,
+                        ReadOnlyString formal_position,
+                        HeadlessJsonWriter *writer);
+static int QueryTier(const QueryLookup *lookup, const Game *game,
+                     ReadOnlyString formal_position,
+                     HeadlessJsonWriter *writer);
+static int CollectRegular(const Game *game, ReadOnlyString formal_position,
+                          TierPositionArray *probes);
+static int CollectTier(const Game *game, ReadOnlyString formal_position,
+                       TierPositionArray *probes);
+
+static int GetStartRegular(const Game *game, HeadlessJsonWriter *writer);
+static int GetStartTier(const Game *game, HeadlessJsonWriter *writer);
+
+static int GetRandomRegular(const Game *game, HeadlessJsonWriter *writer);
+static int GetRandomTier(const Game *game, HeadlessJsonWriter *writer);
+
+static MoveArray GetMovesFromPosition(const Game *game, Position position);
+static PartmoveArray GetPartmovesFromPosition(const Game *game,
+                                              Position position);
+static int JsonWritePositionResponse(const QueryLookup *lookup,
+                                     const Game *game, Position position,
+                                     HeadlessJsonWriter *writer);
+static int JsonWriteBasicPositionFields(const QueryLookup *lookup,
+                                        int64_t index, const Game *game,
+                                        Position position,
+                                        HeadlessJsonWriter *writer);
+static int JsonWriteChildPositionObject(const QueryLookup *lookup,
+                                        int64_t index, const Game *game,
+                                        Position parent, Move move,
+                                        HeadlessJsonWriter *writer);
+
+static int JsonWriteTierPositionResponse(const QueryLookup *lookup,
+                                         const Game *game,
+                                         TierPosition tier_position,
+                                         HeadlessJsonWriter *writer);
 static MoveArray GetMovesFromTierPosition(const Game *game,
                                           TierPosition tier_position);
 static PartmoveArray GetPartmovesFromTierPosition(const Game *game,
                                                   TierPosition tier_position);
-static json_object *JsonCreateBasicTierPositionObject(
-    const Game *game, TierPosition tier_position);
-static json_object *JsonCreateChildTierPositionObject(const Game *game,
-                                                      TierPosition parent,
-                                                      Move move);
-static json_object *JsonCreateParentTierPositionObject(
-    const Game *game, TierPosition tier_position, json_object *moves_array_obj,
-    json_object *partmoves_array_obj);
-static json_object *JsonCreatePartmoveEdgeObject(const Partmove *pm);
-
-static void JsonPrintStartResponse(ReadOnlyString start,
-                                   ReadOnlyString autogui_start);
-static void JsonPrintRandomResponse(ReadOnlyString random,
-                                    ReadOnlyString autogui_random);
-static void JsonPrintSinglePosition(ReadOnlyString position,
-                                    ReadOnlyString autogui_position);
+static int JsonWriteBasicTierPositionFields(const QueryLookup *lookup,
+                                            int64_t index, const Game *game,
+                                            TierPosition tier_position,
+                                            HeadlessJsonWriter *writer);
+static int JsonWriteChildTierPositionObject(const QueryLookup *lookup,
+                                            int64_t index, const Game *game,
+                                            TierPosition parent, Move move,
+                                            HeadlessJsonWriter *writer);
+
+static int JsonWriteMoveFields(CString *formal_move, CString *autogui_move,
+                               HeadlessJsonWriter *writer);
+static int JsonWritePartmovesArray(const PartmoveArray *partmoves,
+                                   HeadlessJsonWriter *writer);
+static int WriteSinglePositionResponse(CString *formal_position,
+                                       CString *autogui_position,
+                                       HeadlessJsonWriter *writer);
 
 // -----------------------------------------------------------------------------
 
 int HeadlessQuery(ReadOnlyString game_name, int variant_id,
                   ReadOnlyString data_path, ReadOnlyString formal_position) {
-    bool is_tier_game;
-    int error =
-        InitAndCheckGame(game_name, variant_id, data_path, &is_tier_game);
+    int error = InitAndCheckGame(game_name, variant_id, data_path);
     if (error != 0) return error;
 
-    const Game *game = GameManagerGetCurrentGame();
-    if (is_tier_game) return QueryTier(game, formal_position);
-    return QueryRegular(game, formal_position);
+    SolverProbe probe;
+    error = SolverManagerProbeInit(&probe);
+    if (error != 0) {
+        fprintf(stderr, "failed to initialize solver probe");
+        return error;
+    }
+
+    HeadlessJsonWriter writer;
+    HeadlessJsonWriterInit(&writer);
+    error =
+        HeadlessQueryWritePositionResponse(&probe, formal_position, &writer);
+    SolverManagerProbeDestroy(&probe);
+
+    return PrintResponse(error, &writer);
 }
 
 int HeadlessGetStart(ReadOnlyString game_name, int variant_id) {
-    bool is_tier_game;
-    int error = InitAndCheckGame(game_name, variant_id, NULL, &is_tier_game);
+    int error = InitAndCheckGame(game_name, variant_id, NULL);
     if (error != 0) return error;
 
-    const Game *game = GameManagerGetCurrentGame();
-    if (is_tier_game) return GetStartTier(game);
-    return GetStartRegular(game);
+    HeadlessJsonWriter writer;
+    HeadlessJsonWriterInit(&writer);
+    error = HeadlessQueryWriteStartResponse(&writer);
+
+    return PrintResponse(error, &writer);
 }
 
 int HeadlessGetRandom(ReadOnlyString game_name, int variant_id) {
+    int error = InitAndCheckGame(game_name, variant_id, NULL);
+    if (error != 0) return error;
+
+    HeadlessJsonWriter writer;
+    HeadlessJsonWriterInit(&writer);
+    error = HeadlessQueryWriteRandomResponse(&writer);
+
+    return PrintResponse(error, &writer);
+}
+
+int HeadlessQueryWritePositionResponse(SolverProbe *probe,
+                                       ReadOnlyString formal_position,
+                                       HeadlessJsonWriter *writer) {
+    QueryLookup lookup = {.probe = probe};
+    return WritePositionResponse(&lookup, formal_position, writer);
+}
+
+int HeadlessQueryCollectProbes(ReadOnlyString formal_position,
+                               TierPositionArray *probes) {
+    const Game *game = GameManagerGetCurrentGame();
     bool is_tier_game;
-    int error = InitAndCheckGame(game_name, variant_id, NULL, &is_tier_game);
+    int error = CheckGame(game, &is_tier_game);
     if (error != 0) return error;
 
+    if (is_tier_game) return CollectTier(game, formal_position, probes);
+    return CollectRegular(game, formal_position, probes);
+}
+
+int HeadlessQueryWritePositionResponseFromResults(
+    ReadOnlyString formal_position, const Value *values,
+    const int *remotenesses, HeadlessJsonWriter *writer) {
+    //
+    QueryLookup lookup = {
+        .probe = NULL,
+        .values = values,
+        .remotenesses = remotenesses,
+    };
+    return WritePositionResponse(&lookup, formal_position, writer);
+}
+
+int HeadlessQueryWriteStartResponse(HeadlessJsonWriter *writer) {
+    const Game *game = GameManagerGetCurrentGame();
+    bool is_tier_game;
+    int error = CheckGame(game, &is_tier_game);
+    if (error != 0) return error;
+
+    if (is_tier_game) return GetStartTier(game, writer);
+    return GetStartRegular(game, writer);
+}
+
+int HeadlessQueryWriteRandomResponse(HeadlessJsonWriter *writer) {
     const Game *game = GameManagerGetCurrentGame();
-    if (is_tier_game) return GetRandomTier(game);
-    return GetRandomRegular(game);
+    bool is_tier_game;
+    int error = CheckGame(game, &is_tier_game);
+    if (error != 0) return error;
+
+    if (is_tier_game) return GetRandomTier(game, writer);
+    return GetRandomRegular(game, writer);
 }
 
 // -----------------------------------------------------------------------------
 
+static Value LookupValueRemoteness(const QueryLookup *lookup, int64_t index,
+                                   TierPosition tier_position,
+                                   int *remoteness) {
+    if (lookup->probe != NULL) {
+        return SolverManagerProbeValueRemoteness(lookup->probe, tier_position,
+                                                 remoteness);
+    }
+
+    *remoteness = lookup->remotenesses[index];
+    return lookup->values[index];
+}
+
 static int InitAndCheckGame(ReadOnlyString game_name, int variant_id,
-                            ReadOnlyString data_path, bool *is_tier_game) {
+                            ReadOnlyString data_path) {
     int error = HeadlessInitSolver(game_name, variant_id, data_path);
     if (error != 0) {
         fprintf(stderr, "game initialization failed");
         return error;
     }
 
-    const Game *game = GameManagerGetCurrentGame();
+    bool is_tier_game;
+    return CheckGame(GameManagerGetCurrentGame(), &is_tier_game);
+}
+
+static int CheckGame(const Game *game, bool *is_tier_game) {
     assert(game != NULL);
     bool implements_regular = ImplementsRegularUwapi(game);
     bool implements_tier = ImplementsTierUwapi(game);
@@ -183,7 +295,33 @@ static bool ImplementsTierUwapi(const Game *game) {
     return true;
 }
 
-static int QueryRegular(const Game *game, ReadOnlyString formal_position) {
+static int PrintResponse(int error, HeadlessJsonWriter *writer) {
+    if (error == kNoError) {
+        printf("%s\n", HeadlessJsonWriterGetString(writer));
+    }
+    HeadlessJsonWriterDestroy(writer);
+
+    return error;
+}
+
+static int WritePositionResponse(const QueryLookup *lookup,
+                                 ReadOnlyString formal_position,
+                                 HeadlessJsonWriter *writer) {
+    const Game *game = GameManagerGetCurrentGame();
+    bool is_tier_game;
+    int error = CheckGame(game, &is_tier_game);
+    if (error != 0) return error;
+
+    if (is_tier_game) {
+        return QueryTier(lookup, game, formal_position, writer);
+    }
+
+    return QueryRegular(lookup, game, formal_position, writer);
+}
+
+static int QueryRegular(const QueryLookup *lookup, const Game *game,
+                        ReadOnlyString formal_position,
+                        HeadlessJsonWriter *writer) {
     bool legal = game->uwapi->regular->IsLegalFormalPosition(formal_position);
     if (!legal) {
         fprintf(stderr, "illegal position");
@@ -193,10 +331,12 @@ static int QueryRegular(const Game *game, ReadOnlyString formal_position) {
     Position position =
         game->uwapi->regular->FormalPositionToPosition(formal_position);
     assert(position >= 0);
-    return JsonPrintPositionResponse(game, position);
+    return JsonWritePositionResponse(lookup, game, position, writer);
 }
 
-static int QueryTier(const Game *game, ReadOnlyString formal_position) {
+static int QueryTier(const QueryLookup *lookup, const Game *game,
+                     ReadOnlyString formal_position,
+                     HeadlessJsonWriter *writer) {
     bool legal = game->uwapi->tier->IsLegalFormalPosition(formal_position);
     if (!legal) {
         fprintf(stderr, "illegal position");
@@ -206,10 +346,77 @@ static int QueryTier(const Game *game, ReadOnlyString formal_position) {
     TierPosition tier_position =
         game->uwapi->tier->FormalPositionToTierPosition(formal_position);
     assert(tier_position.tier >= 0 && tier_position.position >= 0);
-    return JsonPrintTierPositionResponse(game, tier_position);
+    return JsonWriteTierPositionResponse(lookup, game, tier_position, writer);
+}
+
+// Collects the child positions in move order, followed by the parent position.
+static int CollectRegular(const Game *game, ReadOnlyString formal_position,
+                          TierPositionArray *probes) {
+    bool legal = game->uwapi->regular->IsLegalFormalPosition(formal_position);
+    if (!legal) {
+        fprintf(stderr, "illegal position");
+        return kIllegalGamePositionError;
+    }
+
+    Position position =
+        game->uwapi->regular->FormalPositionToPosition(formal_position);
+    assert(position >= 0);
+    MoveArray moves = GetMovesFromPosition(game, position);
+    if (moves.size < 0) return kMallocFailureError;
+
+    int ret = kNoError;
+    for (int64_t i = 0; i < moves.size; ++i) {
+        TierPosition child = {
+            .tier = kDefaultTier,
+            .position = game->uwapi->regular->DoMove(position, moves.array[i]),
+        };
+        if (!TierPositionArrayAppend(probes, child)) {
+            ret = kMallocFailureError;
+            break;
+        }
+    }
+    TierPosition parent = {.tier = kDefaultTier, .position = position};
+    if (ret == kNoError && !TierPositionArrayAppend(probes, parent)) {
+        ret = kMallocFailureError;
+    }
+    MoveArrayDestroy(&moves);
+
+    return ret;
+}
+
+// Collects the child tier positions in move order, followed by the parent.
+static int CollectTier(const Game *game, ReadOnlyString formal_position,
+                       TierPositionArray *probes) {
+    bool legal = game->uwapi->tier->IsLegalFormalPosition(formal_position);
+    if (!legal) {
+        fprintf(stderr, "illegal position");
+        return kIllegalGamePositionError;
+    }
+
+    TierPosition tier_position =
+        game->uwapi->tier->FormalPositionToTierPosition(formal_position);
+    assert(tier_position.tier >= 0 && tier_position.position >= 0);
+    MoveArray moves = GetMovesFromTierPosition(game, tier_position);
+    if (moves.size < 0) return kMallocFailureError;
+
+    int ret = kNoError;
+    for (int64_t i = 0; i < moves.size; ++i) {
+        TierPosition child =
+            game->uwapi->tier->DoMove(tier_position, moves.array[i]);
+        if (!TierPositionArrayAppend(probes, child)) {
+            ret = kMallocFailureError;
+            break;
+        }
+    }
+    if (ret == kNoError && !TierPositionArrayAppend(probes, tier_position)) {
+        ret = kMallocFailureError;
+    }
+    MoveArrayDestroy(&moves);
+
+    return ret;
 }
 
-static int GetStartRegular(const Game *game) {
+static int GetStartRegular(const Game *game, HeadlessJsonWriter *writer) {
     Position start = game->uwapi->regular->GetInitialPosition();
     if (start < 0) {
         fprintf(
@@ -218,24 +425,15 @@ static int GetStartRegular(const Game *game) {
         return kIllegalGamePositionError;
     }
 
-    int ret = 0;
     CString formal_start =
         game->uwapi->regular->PositionToFormalPosition(start);
     CString autogui_start =
         game->uwapi->regular->PositionToAutoGuiPosition(start);
-    if (CStringError(&formal_start) || CStringError(&autogui_start)) {
-        fprintf(stderr, "out of memory");
-        ret = kMallocFailureError;
-    } else {
-        JsonPrintStartResponse(formal_start.str, autogui_start.str);
-    }
-    CStringDestroy(&formal_start);
-    CStringDestroy(&autogui_start);
 
-    return ret;
+    return WriteSinglePositionResponse(&formal_start, &autogui_start, writer);
 }
 
-static int GetStartTier(const Game *game) {
+static int GetStartTier(const Game *game, HeadlessJsonWriter *writer) {
     TierPosition start = {
         .tier = game->uwapi->tier->GetInitialTier(),
         .position = game->uwapi->tier->GetInitialPosition(),
@@ -247,24 +445,15 @@ static int GetStartTier(const Game *game) {
         return kIllegalGamePositionError;
     }
 
-    int ret = 0;
     CString formal_start =
         game->uwapi->tier->TierPositionToFormalPosition(start);
     CString autogui_start =
         game->uwapi->tier->TierPositionToAutoGuiPosition(start);
-    if (CStringError(&formal_start) || CStringError(&autogui_start)) {
-        fprintf(stderr, "out of memory");
-        ret = kMallocFailureError;
-    } else {
-        JsonPrintStartResponse(formal_start.str, autogui_start.str);
-    }
-    CStringDestroy(&formal_start);
-    CStringDestroy(&autogui_start);
 
-    return ret;
+    return WriteSinglePositionResponse(&formal_start, &autogui_start, writer);
 }
 
-static int GetRandomRegular(const Game *game) {
+static int GetRandomRegular(const Game *game, HeadlessJsonWriter *writer) {
     if (game->uwapi->regular->GetRandomLegalPosition == NULL) {
         fprintf(stderr, "position randomization not supported");
         return kNotImplementedError;
@@ -277,24 +466,15 @@ static int GetRandomRegular(const Game *game) {
         return kIllegalGamePositionError;
     }
 
-    int ret = 0;
     CString formal_random =
         game->uwapi->regular->PositionToFormalPosition(random);
     CString autogui_random =
         game->uwapi->regular->PositionToAutoGuiPosition(random);
-    if (CStringError(&formal_random) || CStringError(&autogui_random)) {
-        fprintf(stderr, "out of memory");
-        ret = kMallocFailureError;
-    } else {
-        JsonPrintRandomResponse(formal_random.str, autogui_random.str);
-    }
-    CStringDestroy(&formal_random);
-    CStringDestroy(&autogui_random);
 
-    return ret;
+    return WriteSinglePositionResponse(&formal_random, &autogui_random, writer);
 }
 
-static int GetRandomTier(const Game *game) {
+static int GetRandomTier(const Game *game, HeadlessJsonWriter *writer) {
     if (game->uwapi->tier->GetRandomLegalTierPosition == NULL) {
         fprintf(stderr, "position randomization not supported");
         return kNotImplementedError;
@@ -307,21 +487,12 @@ static int GetRandomTier(const Game *game) {
         return kIllegalGamePositionError;
     }
 
-    int ret = 0;
     CString formal_random =
         game->uwapi->tier->TierPositionToFormalPosition(random);
     CString autogui_random =
         game->uwapi->tier->TierPositionToAutoGuiPosition(random);
-    if (CStringError(&formal_random) || CStringError(&autogui_random)) {
-        fprintf(stderr, "out of memory");
-        ret = kMallocFailureError;
-    } else {
-        JsonPrintRandomResponse(formal_random.str, autogui_random.str);
-    }
-    CStringDestroy(&formal_random);
-    CStringDestroy(&autogui_random);
 
-    return ret;
+    return WriteSinglePositionResponse(&formal_random, &autogui_random, writer);
 }
 
 static MoveArray GetMovesFromPosition(const Game *game, Position position) {
@@ -356,215 +527,126 @@ static PartmoveArray GetPartmovesFromPosition(const Game *game,
     return partmoves;
 }
 
-static int JsonPrintPositionResponse(const Game *game, Position position) {
-    int ret = 0;
+// The parent is looked up at index MOVES.size, after its children.
+static int JsonWritePositionResponse(const QueryLookup *lookup,
+                                     const Game *game, Position position,
+                                     HeadlessJsonWriter *writer) {
+    int ret = kNoError;
     MoveArray moves = GetMovesFromPosition(game, position);
     PartmoveArray partmoves = GetPartmovesFromPosition(game, position);
-    json_object *moves_array_obj = NULL, *child_obj = NULL, *parent_obj = NULL;
-    json_object *partmoves_array_obj = NULL, *partmove_edge_obj = NULL;
     if (moves.size < 0 || partmoves.size < 0) {
         fprintf(stderr, "out of memory");
         ret = kMallocFailureError;
         goto _bailout;
     }
 
-    moves_array_obj = json_object_new_array_ext((int)moves.size);
-    partmoves_array_obj = json_object_new_array_ext((int)partmoves.size);
-    if (moves_array_obj == NULL || partmoves_array_obj == NULL) {
-        fprintf(stderr, "out of memory");
-        ret = kMallocFailureError;
-        goto _bailout;
-    }
+    int error = HeadlessJsonWriterBeginObject(writer, NULL);
+    error |= JsonWriteBasicPositionFields(lookup, moves.size, game, position,
+                                          writer);
 
     // Add moves and corresponding child positions.
-    for (int64_t i = 0; i < moves.size; ++i) {
-        Move move = moves.array[i];
-        child_obj = JsonCreateChildPositionObject(game, position, move);
-        if (child_obj == NULL) {
-            fprintf(stderr, "out of memory");
-            ret = kMallocFailureError;
-            goto _bailout;
-        }
-        json_object_array_add(moves_array_obj, child_obj);
-        child_obj = NULL;
+    error |= HeadlessJsonBeginMovesArray(writer);
+    for (int64_t i = 0; i < moves.size && !error; ++i) {
+        error |= JsonWriteChildPositionObject(lookup, i, game, position,
+                                              moves.array[i], writer);
     }
+    error |= HeadlessJsonWriterEndArray(writer);
 
-    // Add part-moves.
-    for (int64_t i = 0; i < partmoves.size; ++i) {
-        partmove_edge_obj = JsonCreatePartmoveEdgeObject(&partmoves.array[i]);
-        if (partmove_edge_obj == NULL) {
-            fprintf(stderr, "out of memory");
-            ret = kMallocFailureError;
-            goto _bailout;
-        }
-        json_object_array_add(partmoves_array_obj, partmove_edge_obj);
-        partmove_edge_obj = NULL;
-    }
-
-    parent_obj = JsonCreateParentPositionObject(game, position, moves_array_obj,
-                                                partmoves_array_obj);
-    if (parent_obj == NULL) {
+    error |= JsonWritePartmovesArray(&partmoves, writer);
+    error |= HeadlessJsonWriterEndObject(writer);
+    if (error) {
         fprintf(stderr, "out of memory");
         ret = kMallocFailureError;
-        goto _bailout;
     }
-    moves_array_obj = NULL;
-    printf("%s\n", json_object_to_json_string(parent_obj));
 
 _bailout:
     MoveArrayDestroy(&moves);
     PartmoveArrayDestroy(&partmoves);
-    json_object_put(moves_array_obj);
-    json_object_put(child_obj);
-    json_object_put(parent_obj);
-    json_object_put(partmoves_array_obj);
-    json_object_put(partmove_edge_obj);
     return ret;
 }
 
-static json_object *JsonCreateBasicPositionObject(const Game *game,
-                                                  Position position) {
-    json_object *ret = json_object_new_object();
-    if (ret == NULL) goto _bailout;
-
+static int JsonWriteBasicPositionFields(const QueryLookup *lookup,
+                                        int64_t index, const Game *game,
+                                        Position position,
+                                        HeadlessJsonWriter *writer) {
     CString formal_position =
         game->uwapi->regular->PositionToFormalPosition(position);
     CString autogui_position =
         game->uwapi->regular->PositionToAutoGuiPosition(position);
+    int error = kMallocFailureError;
     if (CStringError(&formal_position) || CStringError(&autogui_position)) {
-        json_object_put(ret);
-        ret = NULL;
         goto _bailout;
     }
-    int error = HeadlessJsonAddPosition(ret, formal_position.str);
-    error |= HeadlessJsonAddAutoGuiPosition(ret, autogui_position.str);
+    error = HeadlessJsonAddPosition(writer, formal_position.str);
+    error |= HeadlessJsonAddAutoGuiPosition(writer, autogui_position.str);
 
     TierPosition tier_position = {.tier = kDefaultTier, .position = position};
-    Value value = SolverManagerGetValue(tier_position);
-    int remoteness = SolverManagerGetRemoteness(tier_position);
-    error |= HeadlessJsonAddValue(ret, value);
-    error |= HeadlessJsonAddRemoteness(ret, remoteness);
-    if (error) {
-        json_object_put(ret);
-        ret = NULL;
-    }
+    int remoteness;
+    Value value =
+        LookupValueRemoteness(lookup, index, tier_position, &remoteness);
+    error |= HeadlessJsonAddValue(writer, value);
+    error |= HeadlessJsonAddRemoteness(writer, remoteness);
 
 _bailout:
     CStringDestroy(&formal_position);
     CStringDestroy(&autogui_position);
-    return ret;
+    return error;
 }
 
-static json_object *JsonCreateChildPositionObject(const Game *game,
-                                                  Position parent, Move move) {
+static int JsonWriteChildPositionObject(const QueryLookup *lookup,
+                                        int64_t index, const Game *game,
+                                        Position parent, Move move,
+                                        HeadlessJsonWriter *writer) {
     Position child = game->uwapi->regular->DoMove(parent, move);
-    json_object *ret = JsonCreateBasicPositionObject(game, child);
-    if (ret == NULL) return NULL;
+    int error = HeadlessJsonWriterBeginObject(writer, NULL);
+    error |= JsonWriteBasicPositionFields(lookup, index, game, child, writer);
+    if (error) return error;
 
     CString formal_move = game->uwapi->regular->MoveToFormalMove(parent, move);
     CString autogui_move =
         game->uwapi->regular->MoveToAutoGuiMove(parent, move);
-    if (CStringError(&formal_move) || CStringError(&autogui_move)) {
-        json_object_put(ret);
-        return NULL;
-    }
-
-    int error = HeadlessJsonAddMove(ret, formal_move.str);
-    if (!CStringIsNull(&autogui_move)) {  // Only add full-moves.
-        error |= HeadlessJsonAddAutoGuiMove(ret, autogui_move.str);
-    }
-    CStringDestroy(&formal_move);
-    CStringDestroy(&autogui_move);
-    if (error) {
-        json_object_put(ret);
-        return NULL;
-    }
+    error = JsonWriteMoveFields(&formal_move, &autogui_move, writer);
 
-    return ret;
+    return error | HeadlessJsonWriterEndObject(writer);
 }
 
-static json_object *JsonCreateParentPositionObject(
-    const Game *game, Position position, json_object *moves_array_obj,
-    json_object *partmoves_array_obj) {
-    //
-    json_object *ret = JsonCreateBasicPositionObject(game, position);
-    if (ret == NULL) return NULL;
-
-    int error = HeadlessJsonAddMovesArray(ret, moves_array_obj);
-    error |= HeadlessJsonAddPartmovesArray(ret, partmoves_array_obj);
-    if (error) {
-        json_object_put(ret);
-        return NULL;
-    }
-
-    return ret;
-}
-
-static int JsonPrintTierPositionResponse(const Game *game,
-                                         TierPosition tier_position) {
-    int ret = 0;
+// The parent is looked up at index MOVES.size, after its children.
+static int JsonWriteTierPositionResponse(const QueryLookup *lookup,
+                                         const Game *game,
+                                         TierPosition tier_position,
+                                         HeadlessJsonWriter *writer) {
+    int ret = kNoError;
     MoveArray moves = GetMovesFromTierPosition(game, tier_position);
     PartmoveArray partmoves = GetPartmovesFromTierPosition(game, tier_position);
-    json_object *moves_array_obj = NULL, *child_obj = NULL, *parent_obj = NULL;
-    json_object *partmoves_array_obj = NULL, *partmove_edge_obj = NULL;
     if (moves.size < 0 || partmoves.size < 0) {
         fprintf(stderr, "out of memory");
         ret = kMallocFailureError;
         goto _bailout;
     }
 
-    moves_array_obj = json_object_new_array_ext((int)moves.size);
-    partmoves_array_obj = json_object_new_array_ext((int)partmoves.size);
-    if (moves_array_obj == NULL || partmoves_array_obj == NULL) {
-        fprintf(stderr, "out of memory");
-        ret = kMallocFailureError;
-        goto _bailout;
-    }
+    int error = HeadlessJsonWriterBeginObject(writer, NULL);
+    error |= JsonWriteBasicTierPositionFields(lookup, moves.size, game,
+                                              tier_position, writer);
 
     // Add moves and corresponding child tier positions.
-    for (int64_t i = 0; i < moves.size; ++i) {
-        Move move = moves.array[i];
-        child_obj =
-            JsonCreateChildTierPositionObject(game, tier_position, move);
-        if (child_obj == NULL) {
-            fprintf(stderr, "out of memory");
-            ret = kMallocFailureError;
-            goto _bailout;
-        }
-        json_object_array_add(moves_array_obj, child_obj);
-        child_obj = NULL;
-    }
-
-    // Add part-moves.
-    for (int64_t i = 0; i < partmoves.size; ++i) {
-        partmove_edge_obj = JsonCreatePartmoveEdgeObject(&partmoves.array[i]);
-        if (partmove_edge_obj == NULL) {
-            fprintf(stderr, "out of memory");
-            ret = kMallocFailureError;
-            goto _bailout;
-        }
-        json_object_array_add(partmoves_array_obj, partmove_edge_obj);
-        partmove_edge_obj = NULL;
+    error |= HeadlessJsonBeginMovesArray(writer);
+    for (int64_t i = 0; i < moves.size && !error; ++i) {
+        error |= JsonWriteChildTierPositionObject(lookup, i, game,
+                                                  tier_position,
+                                                  moves.array[i], writer);
     }
+    error |= HeadlessJsonWriterEndArray(writer);
 
-    parent_obj = JsonCreateParentTierPositionObject(
-        game, tier_position, moves_array_obj, partmoves_array_obj);
-    if (parent_obj == NULL) {
+    error |= JsonWritePartmovesArray(&partmoves, writer);
+    error |= HeadlessJsonWriterEndObject(writer);
+    if (error) {
         fprintf(stderr, "out of memory");
         ret = kMallocFailureError;
-        goto _bailout;
     }
-    moves_array_obj = NULL;
-    printf("%s\n", json_object_to_json_string(parent_obj));
 
 _bailout:
     MoveArrayDestroy(&moves);
     PartmoveArrayDestroy(&partmoves);
-    json_object_put(moves_array_obj);
-    json_object_put(child_obj);
-    json_object_put(parent_obj);
-    json_object_put(partmoves_array_obj);
-    json_object_put(partmove_edge_obj);
     return ret;
 }
 
@@ -601,122 +683,111 @@ static PartmoveArray GetPartmovesFromTierPosition(const Game *game,
     return partmoves;
 }
 
-static json_object *JsonCreateBasicTierPositionObject(
-    const Game *game, TierPosition tier_position) {
-    //
-    json_object *ret = json_object_new_object();
-    if (ret == NULL) goto _bailout;
-
+static int JsonWriteBasicTierPositionFields(const QueryLookup *lookup,
+                                            int64_t index, const Game *game,
+                                            TierPosition tier_position,
+                                            HeadlessJsonWriter *writer) {
     CString formal_position =
         game->uwapi->tier->TierPositionToFormalPosition(tier_position);
     CString autogui_position =
         game->uwapi->tier->TierPositionToAutoGuiPosition(tier_position);
+    int error = kMallocFailureError;
     if (CStringError(&formal_position) || CStringError(&autogui_position)) {
-        json_object_put(ret);
-        ret = NULL;
         goto _bailout;
     }
-    int error = HeadlessJsonAddPosition(ret, formal_position.str);
-    error |= HeadlessJsonAddAutoGuiPosition(ret, autogui_position.str);
+    error = HeadlessJsonAddPosition(writer, formal_position.str);
+    error |= HeadlessJsonAddAutoGuiPosition(writer, autogui_position.str);
 
-    Value value = SolverManagerGetValue(tier_position);
-    int remoteness = SolverManagerGetRemoteness(tier_position);
-    error |= HeadlessJsonAddValue(ret, value);
-    error |= HeadlessJsonAddRemoteness(ret, remoteness);
-    if (error) {
-        json_object_put(ret);
-        ret = NULL;
-    }
+    int remoteness;
+    Value value =
+        LookupValueRemoteness(lookup, index, tier_position, &remoteness);
+    error |= HeadlessJsonAddValue(writer, value);
+    error |= HeadlessJsonAddRemoteness(writer, remoteness);
 
 _bailout:
     CStringDestroy(&formal_position);
     CStringDestroy(&autogui_position);
-    return ret;
+    return error;
 }
 
-static json_object *JsonCreateChildTierPositionObject(const Game *game,
-                                                      TierPosition parent,
-                                                      Move move) {
+static int JsonWriteChildTierPositionObject(const QueryLookup *lookup,
+                                            int64_t index, const Game *game,
+                                            TierPosition parent, Move move,
+                                            HeadlessJsonWriter *writer) {
     TierPosition child = game->uwapi->tier->DoMove(parent, move);
-    json_object *ret = JsonCreateBasicTierPositionObject(game, child);
-    if (ret == NULL) return NULL;
+    int error = HeadlessJsonWriterBeginObject(writer, NULL);
+    error |=
+        JsonWriteBasicTierPositionFields(lookup, index, game, child, writer);
+    if (error) return error;
 
     CString formal_move = game->uwapi->tier->MoveToFormalMove(parent, move);
     CString autogui_move = game->uwapi->tier->MoveToAutoGuiMove(parent, move);
-    if (CStringError(&formal_move) || CStringError(&autogui_move)) {
-        json_object_put(ret);
-        return NULL;
-    }
+    error = JsonWriteMoveFields(&formal_move, &autogui_move, writer);
 
-    int error = HeadlessJsonAddMove(ret, formal_move.str);
-    if (!CStringIsNull(&autogui_move)) {  // Only add full-moves.
-        error |= HeadlessJsonAddAutoGuiMove(ret, autogui_move.str);
-    }
-    CStringDestroy(&formal_move);
-    CStringDestroy(&autogui_move);
-    if (error) {
-        json_object_put(ret);
-        return NULL;
+    return error | HeadlessJsonWriterEndObject(writer);
+}
+
+// Writes the move fields of a child position object and destroys FORMAL_MOVE
+// and AUTOGUI_MOVE.
+static int JsonWriteMoveFields(CString *formal_move, CString *autogui_move,
+                               HeadlessJsonWriter *writer) {
+    int error = kMallocFailureError;
+    if (!CStringError(formal_move) && !CStringError(autogui_move)) {
+        error = HeadlessJsonAddMove(writer, formal_move->str);
+        if (!CStringIsNull(autogui_move)) {  // Only add full-moves.
+            error |= HeadlessJsonAddAutoGuiMove(writer, autogui_move->str);
+        }
     }
+    CStringDestroy(formal_move);
+    CStringDestroy(autogui_move);
 
-    return ret;
+    return error;
 }
 
-static json_object *JsonCreateParentTierPositionObject(
-    const Game *game, TierPosition tier_position, json_object *moves_array_obj,
-    json_object *partmoves_array_obj) {
-    //
-    json_object *ret = JsonCreateBasicTierPositionObject(game, tier_position);
-    if (ret == NULL) return NULL;
-
-    int error = HeadlessJsonAddMovesArray(ret, moves_array_obj);
-    error |= HeadlessJsonAddPartmovesArray(ret, partmoves_array_obj);
-    if (error) {
-        json_object_put(ret);
-        return NULL;
+static int JsonWritePartmovesArray(const PartmoveArray *partmoves,
+                                   HeadlessJsonWriter *writer) {
+    int error = HeadlessJsonBeginPartmovesArray(writer);
+    for (int64_t i = 0; i < partmoves->size && !error; ++i) {
+        const Partmove *pm = &partmoves->array[i];
+        error |= HeadlessJsonWriterBeginObject(writer, NULL);
+        error |= HeadlessJsonAddAutoGuiMove(writer, pm->autogui_move.str);
+        error |= HeadlessJsonAddMove(writer, pm->formal_move.str);
+        if (!CStringIsNull(&pm->from)) {
+            error |= HeadlessJsonAddFrom(writer, pm->from.str);
+        }
+        if (!CStringIsNull(&pm->to)) {
+            error |= HeadlessJsonAddTo(writer, pm->to.str);
+        }
+        if (!CStringIsNull(&pm->full)) {
+            error |= HeadlessJsonAddFull(writer, pm->full.str);
+        }
+        error |= HeadlessJsonWriterEndObject(writer);
     }
 
-    return ret;
+    return error | HeadlessJsonWriterEndArray(writer);
 }
 
-static json_object *JsonCreatePartmoveEdgeObject(const Partmove *pm) {
-    json_object *ret = json_object_new_object();
-    if (ret == NULL) return ret;
-
-    int error = HeadlessJsonAddAutoGuiMove(ret, pm->autogui_move.str);
-    error |= HeadlessJsonAddMove(ret, pm->formal_move.str);
-    if (!CStringIsNull(&pm->from)) {
-        error |= HeadlessJsonAddFrom(ret, pm->from.str);
-    }
-    if (!CStringIsNull(&pm->to)) {
-        error |= HeadlessJsonAddTo(ret, pm->to.str);
-    }
-    if (!CStringIsNull(&pm->full)) {
-        error |= HeadlessJsonAddFull(ret, pm->full.str);
+static int WriteSinglePositionResponse(CString *formal_position,
+                                       CString *autogui_position,
+                                       HeadlessJsonWriter *writer) {
+    int ret = kNoError;
+    if (CStringError(formal_position) || CStringError(autogui_position)) {
+        fprintf(stderr, "out of memory");
+        ret = kMallocFailureError;
+        goto _bailout;
     }
+
+    int error = HeadlessJsonWriterBeginObject(writer, NULL);
+    error |= HeadlessJsonAddPosition(writer, formal_position->str);
+    error |= HeadlessJsonAddAutoGuiPosition(writer, autogui_position->str);
+    error |= HeadlessJsonWriterEndObject(writer);
     if (error) {
-        json_object_put(ret);
-        ret = NULL;
+        fprintf(stderr, "out of memory");
+        ret = kMallocFailureError;
     }
 
+_bailout:
+    CStringDestroy(formal_position);
+    CStringDestroy(autogui_position);
     return ret;
 }
-
-static void JsonPrintStartResponse(ReadOnlyString formal_start,
-                                   ReadOnlyString autogui_start) {
-    JsonPrintSinglePosition(formal_start, autogui_start);
-}
-
-static void JsonPrintRandomResponse(ReadOnlyString formal_random,
-                                    ReadOnlyString autogui_random) {
-    JsonPrintSinglePosition(formal_random, autogui_random);
-}
-
-static void JsonPrintSinglePosition(ReadOnlyString position,
-                                    ReadOnlyString autogui_position) {
-    json_object *response = json_object_new_object();
-    HeadlessJsonAddPosition(response, position);
-    HeadlessJsonAddAutoGuiPosition(response, autogui_position);
-    printf("%s\n", json_object_to_json_string(response));
-    json_object_put(response);
-}
@@ -27,6 +27,8 @@
 #ifndef GAMESMANONE_CORE_HEADLESS_HQUERY_H_
 #define GAMESMANONE_CORE_HEADLESS_HQUERY_H_
 
+#include "core/headless/hjson.h"
+#include "core/solvers/solver_manager.h"
 #include "core/types/gamesman_types.h"
 
 /**
@@ -68,4 +70,69 @@ int HeadlessGetStart(ReadOnlyString game_name, int variant_id);
  */
 int HeadlessGetRandom(ReadOnlyString game_name, int variant_id);
 
+/**
+ * @brief Writes a detailed position response for the given FORMAL_POSITION of
+ * the game currently loaded in the Game Manager and the Solver Manager to
+ * WRITER, probing the database with PROBE. This is the response printed by
+ * HeadlessQuery().
+ *
+ * @param probe Probe initialized with SolverManagerProbeInit().
+ * @param formal_position Formal position string to query.
+ * @param writer Writer to which the response is appended as a top-level value.
+ * Its output is incomplete if an error occurs.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessQueryWritePositionResponse(SolverProbe *probe,
+                                       ReadOnlyString formal_position,
+                                       HeadlessJsonWriter *writer);
+
+/**
+ * @brief Writes a start position response for the game currently loaded in the
+ * Game Manager to WRITER. This is the response printed by HeadlessGetStart().
+ *
+ * @param writer Writer to which the response is appended as a top-level value.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessQueryWriteStartResponse(HeadlessJsonWriter *writer);
+
+/**
+ * @brief Appends to PROBES the tier positions that are looked up when writing
+ * the detailed position response for FORMAL_POSITION: the child positions in
+ * move order followed by FORMAL_POSITION itself. Thread-safe as long as the
+ * game functions used are.
+ *
+ * @param formal_position Formal position string to query.
+ * @param probes Destination array.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessQueryCollectProbes(ReadOnlyString formal_position,
+                               TierPositionArray *probes);
+
+/**
+ * @brief Writes the same response as HeadlessQueryWritePositionResponse()
+ * without probing the database, using the values and remotenesses of the tier
+ * positions collected by HeadlessQueryCollectProbes() instead. Thread-safe as
+ * long as the game functions used are.
+ *
+ * @param formal_position Formal position string to query.
+ * @param values Values of the collected tier positions, in the same order.
+ * @param remotenesses Remotenesses of the collected tier positions, in the
+ * same order.
+ * @param writer Writer to which the response is appended as a top-level value.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessQueryWritePositionResponseFromResults(
+    ReadOnlyString formal_position, const Value *values,
+    const int *remotenesses, HeadlessJsonWriter *writer);
+
+/**
+ * @brief Writes a random position response for the game currently loaded in
+ * the Game Manager to WRITER. This is the response printed by
+ * HeadlessGetRandom().
+ *
+ * @param writer Writer to which the response is appended as a top-level value.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessQueryWriteRandomResponse(HeadlessJsonWriter *writer);
+
 #endif  // GAMESMANONE_CORE_HEADLESS_HQUERY_H_
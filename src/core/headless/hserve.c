@@ -0,0 +1,278 @@
+/**
+ * @file hserve.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the long-lived query server of headless mode.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/headless/hserve.h"
+
+#include <json-c/json_object.h>   // json_object and related functions
+#include <json-c/json_tokener.h>  // json_tokener_parse
+#include <signal.h>               // signal, SIGPIPE, SIG_IGN
+#include <stdbool.h>              // true
+#include <stddef.h>               // NULL, size_t
+#include <stdio.h>                // FILE, fprintf, getline, perror
+#include <stdlib.h>               // free
+#include <string.h>               // strcmp, strcpy, strlen, strcspn, memset
+#include <sys/socket.h>           // socket, bind, listen, accept
+#include <sys/types.h>            // ssize_t
+#include <sys/un.h>               // sockaddr_un
+#include <unistd.h>               // close, dup, unlink
+
+#include "core/headless/hcache.h"
+#include "core/headless/hjson.h"
+#include "core/headless/hquery.h"
+#include "core/headless/hutils.h"
+#include "core/solvers/solver_manager.h"
+#include "core/types/gamesman_types.h"
+
+static int ServeSocket(SolverProbe *probe, HeadlessCache *cache,
+                       ReadOnlyString socket_path);
+static int ServeConnection(SolverProbe *probe, HeadlessCache *cache, int fd);
+static int HandleRequest(SolverProbe *probe, HeadlessCache *cache,
+                         ReadOnlyString line, HeadlessJsonWriter *writer,
+                         ReadOnlyString *response);
+static int QueryPosition(SolverProbe *probe, HeadlessCache *cache,
+                         ReadOnlyString position, HeadlessJsonWriter *writer,
+                         ReadOnlyString *response);
+static int WriteResponse(FILE *out, ReadOnlyString response);
+static int WriteError(FILE *out, HeadlessJsonWriter *writer,
+                      ReadOnlyString message);
+
+// -----------------------------------------------------------------------------
+
+int HeadlessServe(ReadOnlyString game_name, int variant_id,
+                  ReadOnlyString data_path, ReadOnlyString socket_path,
+                  ReadOnlyString cache_path) {
+    int error = HeadlessInitSolver(game_name, variant_id, data_path);
+    if (error != 0) {
+        fprintf(stderr, "HeadlessServe: game initialization failed\n");
+        return error;
+    }
+
+    SolverProbe probe;
+    error = SolverManagerProbeInit(&probe);
+    if (error != 0) {
+        fprintf(stderr, "HeadlessServe: failed to initialize solver probe\n");
+        return error;
+    }
+
+    HeadlessCache cache;
+    error = HeadlessCacheInit(&cache, cache_path, kHeadlessCacheLruSizeDefault);
+    if (error != kNoError) {
+        fprintf(stderr, "HeadlessServe: failed to load cache file\n");
+        SolverManagerProbeDestroy(&probe);
+        return error;
+    }
+
+    if (socket_path == NULL) {
+        error = HeadlessServeStream(&probe, &cache, stdin, stdout);
+    } else {
+        error = ServeSocket(&probe, &cache, socket_path);
+    }
+    HeadlessCacheDestroy(&cache);
+    SolverManagerProbeDestroy(&probe);
+
+    return error;
+}
+
+int HeadlessServeStream(SolverProbe *probe, HeadlessCache *cache, FILE *in,
+                        FILE *out) {
+    char *line = NULL;
+    size_t capacity = 0;
+    int ret = kNoError;
+
+    // Responses are written into the same buffer, which stops growing once it
+    // fits the largest response.
+    HeadlessJsonWriter writer;
+    HeadlessJsonWriterInit(&writer);
+    while (getline(&line, &capacity, in) >= 0) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0') continue;  // Skip blank lines.
+
+        ReadOnlyString response = NULL;
+        int error = HandleRequest(probe, cache, line, &writer, &response);
+        if (error == kNoError) {
+            error = WriteResponse(out, response);
+        } else {
+            error = WriteError(out, &writer, HeadlessExplainError(error));
+        }
+        if (error != kNoError) {
+            ret = error;
+            break;
+        }
+    }
+    HeadlessJsonWriterDestroy(&writer);
+    free(line);
+
+    return ret;
+}
+
+// -----------------------------------------------------------------------------
+
+int HeadlessServeListen(ReadOnlyString socket_path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "HeadlessServeListen: socket path [%s] is too long\n",
+                socket_path);
+        return -1;
+    }
+    strcpy(addr.sun_path, socket_path);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        perror("socket");
+        return -1;
+    }
+    unlink(socket_path);
+    if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(listener, SOMAXCONN) != 0) {
+        perror("HeadlessServeListen");
+        close(listener);
+        return -1;
+    }
+
+    return listener;
+}
+
+// -----------------------------------------------------------------------------
+
+static int ServeSocket(SolverProbe *probe, HeadlessCache *cache,
+                       ReadOnlyString socket_path) {
+    int listener = HeadlessServeListen(socket_path);
+    if (listener < 0) return kFileSystemError;
+
+    // A client that disconnects before reading its responses should not
+    // terminate the server.
+    signal(SIGPIPE, SIG_IGN);
+    int ret = kNoError;
+    while (true) {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) {
+            perror("accept");
+            ret = kFileSystemError;
+            break;
+        }
+        ServeConnection(probe, cache, fd);
+    }
+    close(listener);
+    unlink(socket_path);
+
+    return ret;
+}
+
+static int ServeConnection(SolverProbe *probe, HeadlessCache *cache, int fd) {
+    int out_fd = dup(fd);
+    FILE *in = fdopen(fd, "r");
+    FILE *out = out_fd < 0 ? NULL : fdopen(out_fd, "w");
+    if (in == NULL || out == NULL) {
+        if (in != NULL) {
+            fclose(in);
+        } else {
+            close(fd);
+        }
+        if (out != NULL) {
+            fclose(out);
+        } else if (out_fd >= 0) {
+            close(out_fd);
+        }
+        return kFileSystemError;
+    }
+
+    int error = HeadlessServeStream(probe, cache, in, out);
+    fclose(in);
+    fclose(out);
+
+    return error;
+}
+
+// Handles the request in LINE. On success, RESPONSE is set to either a cached
+// response or the output of WRITER.
+static int HandleRequest(SolverProbe *probe, HeadlessCache *cache,
+                         ReadOnlyString line, HeadlessJsonWriter *writer,
+                         ReadOnlyString *response) {
+    json_object *request = json_tokener_parse(line);
+    json_object *action_obj = NULL, *position_obj = NULL;
+    if (!json_object_object_get_ex(request, "action", &action_obj)) {
+        json_object_put(request);
+        return kIllegalArgumentError;
+    }
+
+    HeadlessJsonWriterClear(writer);
+    *response = HeadlessJsonWriterGetString(writer);
+    int ret = kIllegalArgumentError;
+    ReadOnlyString action = json_object_get_string(action_obj);
+    if (action == NULL) {
+        // Invalid action type.
+    } else if (strcmp(action, "query") == 0) {
+        if (json_object_object_get_ex(request, "position", &position_obj)) {
+            ReadOnlyString position = json_object_get_string(position_obj);
+            ret = QueryPosition(probe, cache, position, writer, response);
+        }
+    } else if (strcmp(action, "getstart") == 0) {
+        ret = HeadlessQueryWriteStartResponse(writer);
+        *response = HeadlessJsonWriterGetString(writer);
+    } else if (strcmp(action, "getrandom") == 0) {
+        ret = HeadlessQueryWriteRandomResponse(writer);
+        *response = HeadlessJsonWriterGetString(writer);
+    }
+    json_object_put(request);
+
+    return ret;
+}
+
+static int QueryPosition(SolverProbe *probe, HeadlessCache *cache,
+                         ReadOnlyString position, HeadlessJsonWriter *writer,
+                         ReadOnlyString *response) {
+    if (cache != NULL) {
+        *response = HeadlessCacheGet(cache, position);
+        if (*response != NULL) return kNoError;
+    }
+
+    int error = HeadlessQueryWritePositionResponse(probe, position, writer);
+    *response = HeadlessJsonWriterGetString(writer);
+    if (error == kNoError && cache != NULL) {
+        HeadlessCachePut(cache, position, *response);
+    }
+
+    return error;
+}
+
+static int WriteResponse(FILE *out, ReadOnlyString response) {
+    if (fprintf(out, "%s\n", response) < 0) {
+        return kFileSystemError;
+    }
+    if (fflush(out) != 0) return kFileSystemError;
+
+    return kNoError;
+}
+
+static int WriteError(FILE *out, HeadlessJsonWriter *writer,
+                      ReadOnlyString message) {
+    HeadlessJsonWriterClear(writer);
+    int error = HeadlessJsonWriteError(writer, message);
+    if (error != kNoError) return error;
+
+    return WriteResponse(out, HeadlessJsonWriterGetString(writer));
+}
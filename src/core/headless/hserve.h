@@ -0,0 +1,98 @@
+/**
+ * @file hserve.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Long-lived query server of headless mode.
+ * @details The server initializes a game variant and its solver once, and then
+ * answers newline-delimited JSON requests until the input is exhausted. Each
+ * request is a JSON object on its own line:
+ *
+ *     { "action": "query", "position": "<formal position>" }
+ *     { "action": "getstart" }
+ *     { "action": "getrandom" }
+ *
+ * Each request is answered with exactly one line in the same order as the
+ * requests. A successful response is the same JSON that the corresponding
+ * headless command (query, getstart, or getrandom) prints. A failed request is
+ * answered with { "error": "<message>" }. Database files and decompressed
+ * blocks stay open in a probing session between requests, so a query costs a
+ * few probes instead of a full game and solver initialization.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_HEADLESS_HSERVE_H_
+#define GAMESMANONE_CORE_HEADLESS_HSERVE_H_
+
+#include <stdio.h>  // FILE
+
+#include "core/headless/hcache.h"
+#include "core/solvers/solver_manager.h"
+#include "core/types/gamesman_types.h"
+
+/**
+ * @brief Serves position queries for the game of name GAME_NAME and variant
+ * index VARIANT_ID.
+ *
+ * @param game_name Name of the game used internally by GAMESMAN.
+ * @param variant_id Index of the variant to serve. If negative, the default
+ * variant will be served.
+ * @param data_path Path to the "data" directory. The default path will be used
+ * if set to NULL.
+ * @param socket_path If NULL, requests are read from stdin and responses are
+ * written to stdout until the end of stdin is reached. Otherwise, the server
+ * listens on a Unix domain socket bound to this path, replacing any existing
+ * file, and serves connections one after another until it is terminated.
+ * @param cache_path Path to a cache file created by HeadlessPrecompute() for
+ * the same game variant, or NULL if there is none. Position queries are first
+ * looked up in the cache file and in a runtime cache of recent responses.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int HeadlessServe(ReadOnlyString game_name, int variant_id,
+                  ReadOnlyString data_path, ReadOnlyString socket_path,
+                  ReadOnlyString cache_path);
+
+/**
+ * @brief Answers the requests read from IN, one line at a time, by writing the
+ * responses to OUT until the end of IN is reached. Assumes that the game to
+ * serve is loaded in the Game Manager and the Solver Manager.
+ *
+ * @param probe Probe initialized with SolverManagerProbeInit(), which is
+ * reused for all requests.
+ * @param cache Response cache to use for position queries, or NULL to answer
+ * all queries by probing the database.
+ * @param in Request stream.
+ * @param out Response stream, which is flushed after each response.
+ * @return 0 on success, or
+ * @return non-zero error code if an I/O error occurred.
+ */
+int HeadlessServeStream(SolverProbe *probe, HeadlessCache *cache, FILE *in,
+                        FILE *out);
+
+/**
+ * @brief Creates a Unix domain socket bound to SOCKET_PATH, replacing any
+ * existing file, and starts listening on it.
+ *
+ * @param socket_path Path to bind the socket to.
+ * @return File descriptor of the listening socket on success, or
+ * @return -1 on failure.
+ */
+int HeadlessServeListen(ReadOnlyString socket_path);
+
+#endif  // GAMESMANONE_CORE_HEADLESS_HSERVE_H_
@@ -27,9 +27,7 @@
 #include "core/headless/hsolve.h"
 
 #include <assert.h>   // assert
-#include <stdbool.h>  // bool
 #include <stddef.h>   // NULL
-#include <stdint.h>   // intptr_t
 #include <stdio.h>    // printf, fprintf, stderr
 
 #include "core/game_manager.h"
@@ -41,23 +39,40 @@
 #include "core/solvers/tier_solver/tier_solver.h"
 #include "core/types/gamesman_types.h"
 
-static void *GenerateSolveOptions(bool force, int verbose, intptr_t memlimit) {
+static int ParseStart(ReadOnlyString formal_position, TierPosition *start);
+
+static void *GenerateSolveOptions(const HeadlessSolveOptions *headless,
+                                  const TierPosition *start) {
     const Game *game = GameManagerGetCurrentGame();
     assert(game != NULL);
 
     if (game->solver == &kRegularSolver) {
+        if (headless->reachable_only) {
+            fprintf(stderr,
+                    "HeadlessSolve: solving only the reachable positions is "
+                    "not supported by the regular solver. Solving all legal "
+                    "positions instead.\n");
+        }
         RegularSolverSolveOptions *options =
             (RegularSolverSolveOptions *)SafeMalloc(
                 sizeof(RegularSolverSolveOptions));
-        options->force = force;
-        options->verbose = verbose;
+        options->force = headless->force;
+        options->verbose = headless->verbose;
         return (void *)options;
     } else if (game->solver == &kTierSolver) {
         TierSolverSolveOptions *options = (TierSolverSolveOptions *)SafeMalloc(
             sizeof(TierSolverSolveOptions));
-        options->force = force;
-        options->verbose = verbose;
-        options->memlimit = memlimit;
+        options->force = headless->force;
+        options->verbose = headless->verbose;
+        options->memlimit = headless->memlimit;
+        options->rebuild_manifest = headless->rebuild_manifest;
+        options->pack = headless->pack;
+        options->async_flush = headless->async_flush;
+        options->cache_tiers = headless->cache_tiers;
+        options->histograms = headless->histograms;
+        options->reachable_only = headless->reachable_only;
+        options->subgame = (start != NULL);
+        if (start != NULL) options->start = *start;
         return (void *)options;
     }  // Append new solvers to the end.
 
@@ -66,14 +81,24 @@ static void *GenerateSolveOptions(bool force, int verbose, intptr_t memlimit) {
 }
 
 int HeadlessSolve(ReadOnlyString game_name, int variant_id,
-                  ReadOnlyString data_path, bool force, int verbose,
-                  intptr_t memlimit) {
+                  ReadOnlyString data_path,
+                  const HeadlessSolveOptions *options) {
     int error = HeadlessInitSolver(game_name, variant_id, data_path);
     if (error != 0) return error;
 
-    void *options = GenerateSolveOptions(force, verbose, memlimit);
-    error = SolverManagerSolve(options);
-    GamesmanFree(options);
+    TierPosition start;
+    if (options->from != NULL) {
+        error = ParseStart(options->from, &start);
+        if (error != kNoError) {
+            GameManagerFinalize();
+            return error;
+        }
+    }
+
+    void *solver_options =
+        GenerateSolveOptions(options, options->from ? &start : NULL);
+    error = SolverManagerSolve(solver_options);
+    GamesmanFree(solver_options);
     GameManagerFinalize();
     if (error != 0) {
         fprintf(stderr, "HeadlessSolve: solve failed with code %d\n", error);
@@ -81,3 +106,28 @@ int HeadlessSolve(ReadOnlyString game_name, int variant_id,
 
     return error;
 }
+
+// -----------------------------------------------------------------------------
+
+static int ParseStart(ReadOnlyString formal_position, TierPosition *start) {
+    const Game *game = GameManagerGetCurrentGame();
+    assert(game != NULL);
+    if (game->solver != &kTierSolver || game->uwapi == NULL ||
+        game->uwapi->tier == NULL ||
+        game->uwapi->tier->IsLegalFormalPosition == NULL ||
+        game->uwapi->tier->FormalPositionToTierPosition == NULL) {
+        fprintf(stderr,
+                "HeadlessSolve: solving from a position is not supported by "
+                "the current game\n");
+        return kNotImplementedError;
+    }
+
+    if (!game->uwapi->tier->IsLegalFormalPosition(formal_position)) {
+        fprintf(stderr, "HeadlessSolve: illegal position %s\n",
+                formal_position);
+        return kIllegalGamePositionError;
+    }
+    *start = game->uwapi->tier->FormalPositionToTierPosition(formal_position);
+
+    return kNoError;
+}
@@ -32,26 +32,71 @@
 
 #include "core/types/gamesman_types.h"
 
+/** @brief Options of HeadlessSolve(), built from the command line arguments. */
+typedef struct HeadlessSolveOptions {
+    /** Whether to solve the game variant regardless of the current database
+     * status. Otherwise, the solving process is skipped if the game variant
+     * has already been correctly solved. */
+    bool force;
+
+    /** May take values 0, 1, or 2. If set to 0, no output will be produced
+     * unless an error occurrs. If set to 1, the solver will print out the
+     * default messages. If set to 2, additional information will be
+     * printed. */
+    int verbose;
+
+    intptr_t memlimit; /**< Approximate heap memory limit in bytes. */
+
+    /** Whether to rebuild the database's manifest of solved tiers from the
+     * tier files in the data path before solving. Ignored by solvers that do
+     * not keep such a manifest. */
+    bool rebuild_manifest;
+
+    /** Whether to pack the database files into segment files before solving,
+     * which also stores newly solved tiers in the segment files. Ignored by
+     * solvers without a packed layout. */
+    bool pack;
+
+    /** Whether to flush solved tiers in the background while the next tiers
+     * are solved. Ignored by solvers that flush in the foreground only. */
+    bool async_flush;
+
+    /** Whether to keep the child tiers loaded while solving in memory for the
+     * sibling tiers that share them. Ignored by solvers that do not load child
+     * tiers. */
+    bool cache_tiers;
+
+    /** Whether to record the value and remoteness histogram of each solved
+     * tier so that analyzing the game afterwards does not have to load the
+     * tiers from the database again. Ignored by solvers without a separate
+     * analyzer. */
+    bool histograms;
+
+    /** Whether to discover the positions reachable from the initial position
+     * first and solve only those. Only supported by the tier solver. Other
+     * solvers print a notice and solve all legal positions. */
+    bool reachable_only;
+
+    /** Formal position to solve the subgame from, reusing the tiers already
+     * solved in the data path, or NULL to solve the whole game. Only supported
+     * by the tier solver. */
+    ReadOnlyString from;
+} HeadlessSolveOptions;
+
 /**
- * @brief Solves the game of name GAME_NAME and variant index VARIANT_ID and
- * stores the database at the given DATA_PATH.
+ * @brief Solves the game of name GAME_NAME and variant index VARIANT_ID with
+ * OPTIONS and stores the database at the given DATA_PATH.
  *
  * @param game_name Name of the game used internally by GAMESMAN.
  * @param variant_id Index of the variant to solve for. If negative, the default
  * variant will be solved.
  * @param data_path Path to the "data" directory. The default path will be used
  * if set to NULL.
- * @param force If set to true, the given game variant will be solved regardless
- * of the current database status. Otherwise, the solving process is skipped if
- * the game variant has already been correctly solved.
- * @param verbose May take values 0, 1, or 2. If set to 0, no output will be
- * produced unless an error occurrs. If set to 1, the solver will print out the
- * default messages. If set to 2, additional information will be printed.
- * @param memlimit Approximate heap memory limit in bytes.
+ * @param options Solve options.
  * @return 0 on success, non-zero error code otherwise.
  */
 int HeadlessSolve(ReadOnlyString game_name, int variant_id,
-                  ReadOnlyString data_path, bool force, int verbose,
-                  intptr_t memlimit);
+                  ReadOnlyString data_path,
+                  const HeadlessSolveOptions *options);
 
 #endif  // GAMESMANONE_CORE_HEADLESS_HSOLVE_H_
@@ -28,8 +28,9 @@
 
 #include <stdbool.h>  // bool
 #include <stddef.h>   // NULL
+#include <stdint.h>   // intptr_t
 #include <stdio.h>    // printf, fprintf, stdout, stderr
-#include <stdlib.h>   // free
+#include <stdlib.h>   // atoi, free
 #include <string.h>   // strcmp, strcpy
 
 #include "core/data_structures/int64_array.h"
@@ -48,6 +49,14 @@ int HeadlessGetVerbosity(bool verbose, bool quiet) {
     return !quiet;
 }
 
+intptr_t HeadlessParseMemLimit(ReadOnlyString str) {
+    if (str == NULL || *str == '\0') return 0;
+    int gigabytes = atoi(str);
+    if (gigabytes < 0) return 0;
+
+    return (intptr_t)gigabytes << 30;
+}
+
 int HeadlessRedirectOutput(ReadOnlyString output) {
     if (output == NULL) return kNoError;
 
@@ -84,6 +93,23 @@ int HeadlessInitSolver(ReadOnlyString game_name, int variant_id,
     return SolverManagerInit(data_path);
 }
 
+ReadOnlyString HeadlessExplainError(int error) {
+    switch (error) {
+        case kMallocFailureError:
+            return "out of memory";
+        case kNotImplementedError:
+            return "not supported by the game";
+        case kIllegalArgumentError:
+            return "invalid request";
+        case kIllegalGamePositionError:
+            return "illegal position";
+        default:
+            break;
+    }
+
+    return "internal error";
+}
+
 // -----------------------------------------------------------------------------
 
 static int MakeDirectory(ReadOnlyString output) {
@@ -28,6 +28,7 @@
 #define GAMESMANONE_CORE_HEADLESS_HUTILS_H_
 
 #include <stdbool.h>  // bool
+#include <stdint.h>   // intptr_t
 
 #include "core/types/gamesman_types.h"
 
@@ -41,6 +42,16 @@
  */
 int HeadlessGetVerbosity(bool verbose, bool quiet);
 
+/**
+ * @brief Converts the memory limit string STR, which is in GiB, into a memory
+ * limit in bytes.
+ *
+ * @return 0, which stands for the default limit, if STR is NULL, empty, or
+ * negative, or
+ * @return the memory limit in bytes otherwise.
+ */
+intptr_t HeadlessParseMemLimit(ReadOnlyString str);
+
 /**
  * @brief Redirects stdout to the given OUTPUT file path using freopen, or does
  * nothing if OUTPUT is NULL.
@@ -64,4 +75,10 @@ int HeadlessRedirectOutput(ReadOnlyString output);
 int HeadlessInitSolver(ReadOnlyString game_name, int variant_id,
                        ReadOnlyString data_path);
 
+/**
+ * @brief Returns a short description of ERROR to be sent to clients in an
+ * error response.
+ */
+ReadOnlyString HeadlessExplainError(int error);
+
 #endif  // GAMESMANONE_CORE_HEADLESS_HUTILS_H_
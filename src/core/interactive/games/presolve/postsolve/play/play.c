@@ -20,6 +20,13 @@ static int lose_children_remoteness_min;
 static int tie_children_remoteness_min;
 static int win_children_remoteness_max;
 static Int64HashMap move_values, move_remotenesses;
+static SolverProbe probe;
+
+static Value ProbeValueRemoteness(TierPosition tier_position,
+                                  int *remoteness) {
+    return SolverManagerProbeValueRemoteness(&probe, tier_position,
+                                             remoteness);
+}
 
 static void PrintPrediction(void) {
     int turn = InteractiveMatchGetTurn();
@@ -28,7 +35,8 @@ static void PrintPrediction(void) {
     ReadOnlyString prediction = is_computer ? "will" : "should";
 
     TierPosition current = InteractiveMatchGetCurrentPosition();
-    Value value = SolverManagerGetValue(current);
+    int remoteness;
+    Value value = ProbeValueRemoteness(current, &remoteness);
     char value_string[32];
     switch (value) {
         case kUndecided:
@@ -58,7 +66,6 @@ static void PrintPrediction(void) {
             return;
     }
 
-    int remoteness = SolverManagerGetRemoteness(current);
     printf("Player %d (%s) %s %s in %d.", turn + 1, controller, prediction,
            value_string, remoteness);
 }
@@ -140,13 +147,13 @@ static void PrintMovesOfValue(const Game *game, MoveArray *moves,
                               Value childValue) {
     for (int64_t i = 0; i < moves->size; i++) {
         TierPosition child = InteractiveMatchDoMove(current, moves->array[i]);
-        if (childValue == SolverManagerGetValue(child)) {
+        int remoteness;
+        if (childValue == ProbeValueRemoteness(child, &remoteness)) {
             game->gameplay_api->common->MoveToString(moves->array[i],
                                                      move_string);
             if (childValue == kDraw) {
                 printf("\t\t\t%-16s\tDraw\n", move_string);
             } else {
-                int remoteness = SolverManagerGetRemoteness(child);
                 printf("\t\t\t%-16s\t%d\n", move_string, remoteness);
             }
         }
@@ -166,8 +173,8 @@ void SetExtremeChildRemotenesses(TierPosition current, MoveArray *moves) {
 
     for (int64_t i = 0; i < moves->size; i++) {
         TierPosition child = InteractiveMatchDoMove(current, moves->array[i]);
-        int remoteness = SolverManagerGetRemoteness(child);
-        switch (SolverManagerGetValue(child)) {
+        int remoteness;
+        switch (ProbeValueRemoteness(child, &remoteness)) {
             case kWin:
                 if (remoteness > win_children_remoteness_max) {
                     win_children_remoteness_max = remoteness;
@@ -190,9 +197,9 @@ void SetExtremeChildRemotenesses(TierPosition current, MoveArray *moves) {
 }
 
 static void MoveValueCacheCleanup(void) {
-    if (move_values.size) Int64HashMapDestroy(&move_values);
+    if (Int64HashMapSize(&move_values)) Int64HashMapDestroy(&move_values);
     memset(&move_values, 0, sizeof(move_values));
-    if (move_remotenesses.size) Int64HashMapDestroy(&move_remotenesses);
+    if (Int64HashMapSize(&move_remotenesses)) Int64HashMapDestroy(&move_remotenesses);
     memset(&move_remotenesses, 0, sizeof(move_remotenesses));
 }
 
@@ -203,14 +210,14 @@ static bool LoadMoveValues(const MoveArray *moves) {
     for (int64_t i = 0; i < moves->size; ++i) {
         TierPosition current = InteractiveMatchGetCurrentPosition();
         TierPosition child = InteractiveMatchDoMove(current, moves->array[i]);
-        Value value = SolverManagerGetValue(child);
+        int remoteness;
+        Value value = ProbeValueRemoteness(child, &remoteness);
         if (!Int64HashMapSet(&move_values, moves->array[i], value)) {
             fprintf(stderr,
                     "LoadMoveValues: failed to create new map entry for move "
                     "value\n");
             return false;
         }
-        int remoteness = SolverManagerGetRemoteness(child);
         if (!Int64HashMapSet(&move_remotenesses, moves->array[i], remoteness)) {
             fprintf(stderr,
                     "LoadMoveValues: failed to create new map entry for move "
@@ -288,13 +295,13 @@ static bool IsBestChild(Value parent_value, int parent_remoteness,
 static Move MakeComputerMove(void) {
     TierPosition current = InteractiveMatchGetCurrentPosition();
     MoveArray moves = InteractiveMatchGenerateMoves();
-    Value current_value = SolverManagerGetValue(current);
-    int current_remoteness = SolverManagerGetRemoteness(current);
+    int current_remoteness;
+    Value current_value = ProbeValueRemoteness(current, &current_remoteness);
 
     for (int64_t i = 0; i < moves.size; ++i) {
         TierPosition child = InteractiveMatchDoMove(current, moves.array[i]);
-        Value value = SolverManagerGetValue(child);
-        int remoteness = SolverManagerGetRemoteness(child);
+        int remoteness;
+        Value value = ProbeValueRemoteness(child, &remoteness);
         if (IsBestChild(current_value, current_remoteness, value, remoteness)) {
             InteractiveMatchCommitMove(moves.array[i]);
             return moves.array[i];
@@ -421,6 +428,12 @@ int InteractivePlay(ReadOnlyString key) {
 
     const Game *game = InteractiveMatchGetCurrentGame();
     solved = InteractiveMatchSolved();
+    if (solved && SolverManagerProbeInit(&probe) != 0) {
+        fprintf(stderr,
+                "InteractivePlay: failed to initialize solver probe. "
+                "Aborting...\n");
+        exit(EXIT_FAILURE);  // NOLINT(concurrency-mt-unsafe)
+    }
     PrintCurrentPosition(game);
     Value primitive_value = InteractiveMatchPrimitive();
     bool game_over = (primitive_value != kUndecided);
@@ -447,5 +460,6 @@ int InteractivePlay(ReadOnlyString key) {
     PrintGameResult(game->formal_name);
 
     MoveValueCacheCleanup();
+    if (solved) SolverManagerProbeDestroy(&probe);
     return 0;
 }
@@ -28,7 +28,7 @@
 
 #include <assert.h>     // assert
 #include <errno.h>      // errno
-#include <fcntl.h>      // open
+#include <fcntl.h>      // open, O_RDONLY, O_DIRECTORY
 #include <inttypes.h>   // PRId64, PRIu64
 #include <stdarg.h>     // va_list, va_start, va_end
 #include <stdbool.h>    // bool, true, false
@@ -40,7 +40,7 @@
 #include <sys/stat.h>   // mkdir, struct stat
 #include <sys/types.h>  // mode_t
 #include <time.h>       // clock_t, CLOCKS_PER_SEC
-#include <unistd.h>     // close, _exit
+#include <unistd.h>     // close, fsync, _exit
 #include <zlib.h>  // gzFile, gzopen, gzdopen, gzread, gzwrite, Z_NULL, Z_OK
 #ifdef USE_MPI
 #include <mpi.h>
@@ -243,6 +243,21 @@ int GuardedRemove(const char *pathname) {
     return error;
 }
 
+int GuardedSyncDirectory(const char *path) {
+    int fd = open(path, O_RDONLY | O_DIRECTORY);
+    if (fd == -1) {
+        perror("open");
+        return -1;
+    }
+    if (fsync(fd) == -1) {
+        perror("fsync");
+        close(fd);
+        return -1;
+    }
+
+    return GuardedClose(fd);
+}
+
 int BailOutClose(int fd, int error) {
     int new_error = close(fd);
     if (new_error == -1) perror("close");
@@ -196,6 +196,14 @@ int GuardedRename(const char *oldpath, const char *newpath);
  */
 int GuardedRemove(const char *pathname);
 
+/**
+ * @brief Calls fsync on the directory at PATH, which writes the entries
+ * created, renamed, or removed in it to storage. Returns 0 on success; calls
+ * perror and returns -1 otherwise.
+ * Reference: https://man7.org/linux/man-pages/man2/fsync.2.html
+ */
+int GuardedSyncDirectory(const char *path);
+
 /**
  * @brief Calls close on FD and returns error.
  * @details This function is typically called when an error occurred in the
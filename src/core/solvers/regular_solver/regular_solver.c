@@ -29,7 +29,7 @@
 
 #include "core/solvers/regular_solver/regular_solver.h"
 
-#include <assert.h>   // assert
+#include <assert.h>   // assert, static_assert
 #include <stdbool.h>  // bool, true, false
 #include <stddef.h>   // NULL
 #include <stdint.h>   // int64_t
@@ -48,6 +48,12 @@
 #include "core/solvers/tier_solver/tier_solver.h"
 #include "core/solvers/tier_solver/tier_worker.h"
 #include "core/types/gamesman_types.h"
+#include "core/types/tier_position_dedup.h"
+
+// The default canonical child generators rely on the allocation-free path.
+static_assert((int)kRegularSolverNumMovesMax <=
+                  (int)kTierPositionDedupTableMax,
+              "default child deduplication may allocate");
 
 // Solver API functions.
 
@@ -65,6 +71,14 @@ static const SolverConfig *RegularSolverGetCurrentConfig(void);
 static int RegularSolverSetOption(int option, int selection);
 static Value RegularSolverGetValue(TierPosition tier_position);
 static int RegularSolverGetRemoteness(TierPosition tier_position);
+static int RegularSolverProbeInit(DbProbe *probe);
+static int RegularSolverProbeDestroy(DbProbe *probe);
+static Value RegularSolverProbeValueRemoteness(DbProbe *probe,
+                                               TierPosition tier_position,
+                                               int *remoteness);
+static int RegularSolverProbeBatch(DbProbe *probe, int64_t n,
+                                   const TierPosition *tier_positions,
+                                   Value *values, int *remotenesses);
 
 /** @brief Regular Solver definition. */
 const Solver kRegularSolver = {
@@ -86,6 +100,11 @@ const Solver kRegularSolver = {
 
     .GetValue = &RegularSolverGetValue,
     .GetRemoteness = &RegularSolverGetRemoteness,
+
+    .ProbeInit = &RegularSolverProbeInit,
+    .ProbeDestroy = &RegularSolverProbeDestroy,
+    .ProbeValueRemoteness = &RegularSolverProbeValueRemoteness,
+    .ProbeBatch = &RegularSolverProbeBatch,
 };
 
 static ConstantReadOnlyString kChoices[] = {"On", "Off"};
@@ -421,6 +440,43 @@ static int RegularSolverGetRemoteness(TierPosition tier_position) {
     return ret;
 }
 
+static int RegularSolverProbeInit(DbProbe *probe) {
+    return DbManagerProbeInit(probe);
+}
+
+static int RegularSolverProbeDestroy(DbProbe *probe) {
+    return DbManagerProbeDestroy(probe);
+}
+
+static Value RegularSolverProbeValueRemoteness(DbProbe *probe,
+                                               TierPosition tier_position,
+                                               int *remoteness) {
+    TierPosition canonical = {
+        .tier = kDefaultTier,
+        .position = current_api.GetCanonicalPosition(tier_position),
+    };
+
+    return DbManagerProbeValueRemoteness(probe, canonical, remoteness);
+}
+
+static int RegularSolverProbeBatch(DbProbe *probe, int64_t n,
+                                   const TierPosition *tier_positions,
+                                   Value *values, int *remotenesses) {
+    TierPosition *canonicals =
+        (TierPosition *)GamesmanMalloc(n * sizeof(TierPosition));
+    if (canonicals == NULL) return kMallocFailureError;
+
+    for (int64_t i = 0; i < n; ++i) {
+        canonicals[i].tier = kDefaultTier;
+        canonicals[i].position =
+            current_api.GetCanonicalPosition(tier_positions[i]);
+    }
+    int ret = DbManagerProbeBatch(probe, n, canonicals, values, remotenesses);
+    GamesmanFree(canonicals);
+
+    return ret;
+}
+
 // -----------------------------------------------------------------------------
 
 static bool RequiredApiFunctionsImplemented(const RegularSolverApi *api) {
@@ -606,44 +662,23 @@ static Position DefaultGetCanonicalPosition(TierPosition tier_position) {
 static int DefaultGetNumberOfCanonicalChildPositions(
     TierPosition tier_position) {
     //
-    TierPositionHashSet children;
-    TierPositionHashSetInit(&children, 0.5);
-
-    Move moves[kRegularSolverNumMovesMax];
-    int num_moves = current_api.GenerateMoves(tier_position, moves);
-    for (int i = 0; i < num_moves; ++i) {
-        TierPosition child = current_api.DoMove(tier_position, moves[i]);
-        child.position = current_api.GetCanonicalPosition(child);
-        if (!TierPositionHashSetContains(&children, child)) {
-            TierPositionHashSetAdd(&children, child);
-        }
-    }
-    int num_children = (int)children.size;
-    TierPositionHashSetDestroy(&children);
-
-    return num_children;
+    TierPosition children[kRegularSolverNumChildPositionsMax];
+    return DefaultGetCanonicalChildPositions(tier_position, children);
 }
 
 static int DefaultGetCanonicalChildPositions(
     TierPosition tier_position,
     TierPosition children[static kRegularSolverNumChildPositionsMax]) {
     //
-    TierPositionHashSet deduplication_set;
-    TierPositionHashSetInit(&deduplication_set, 0.5);
     Move moves[kRegularSolverNumMovesMax];
     int num_moves = current_api.GenerateMoves(tier_position, moves);
-    int ret = 0;
     for (int i = 0; i < num_moves; ++i) {
-        TierPosition child = current_api.DoMove(tier_position, moves[i]);
-        child.position = current_api.GetCanonicalPosition(child);
-        if (!TierPositionHashSetContains(&deduplication_set, child)) {
-            TierPositionHashSetAdd(&deduplication_set, child);
-            children[ret++] = child;
-        }
+        children[i] = current_api.DoMove(tier_position, moves[i]);
+        children[i].position = current_api.GetCanonicalPosition(children[i]);
     }
-    TierPositionHashSetDestroy(&deduplication_set);
 
-    return ret;
+    // Cannot fail since the number of moves never exceeds the table size.
+    return TierPositionDedup(children, num_moves);
 }
 
 static TierType DefaultGetTierType(Tier tier) {
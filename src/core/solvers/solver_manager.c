@@ -37,6 +37,7 @@
 #include <assert.h>  // assert
 #include <stddef.h>  // NULL
 #include <stdio.h>   // printf
+#include <string.h>  // memset
 
 #include "core/game_manager.h"
 #include "core/types/gamesman_types.h"
@@ -97,3 +98,48 @@ Value SolverManagerGetValue(TierPosition tier_position) {
 int SolverManagerGetRemoteness(TierPosition tier_position) {
     return current_solver->GetRemoteness(tier_position);
 }
+
+int SolverManagerProbeInit(SolverProbe *probe) {
+    memset(probe, 0, sizeof(*probe));
+    if (current_solver->ProbeInit == NULL) return kNoError;
+
+    return current_solver->ProbeInit(&probe->db_probe);
+}
+
+int SolverManagerProbeDestroy(SolverProbe *probe) {
+    int ret = kNoError;
+    if (current_solver->ProbeDestroy != NULL) {
+        ret = current_solver->ProbeDestroy(&probe->db_probe);
+    }
+    memset(probe, 0, sizeof(*probe));
+
+    return ret;
+}
+
+Value SolverManagerProbeValueRemoteness(SolverProbe *probe,
+                                        TierPosition tier_position,
+                                        int *remoteness) {
+    if (current_solver->ProbeValueRemoteness == NULL) {
+        *remoteness = current_solver->GetRemoteness(tier_position);
+        return current_solver->GetValue(tier_position);
+    }
+
+    return current_solver->ProbeValueRemoteness(&probe->db_probe,
+                                                tier_position, remoteness);
+}
+
+int SolverManagerProbeBatch(SolverProbe *probe, int64_t n,
+                            const TierPosition *tier_positions, Value *values,
+                            int *remotenesses) {
+    if (current_solver->ProbeBatch != NULL) {
+        return current_solver->ProbeBatch(&probe->db_probe, n, tier_positions,
+                                          values, remotenesses);
+    }
+
+    for (int64_t i = 0; i < n; ++i) {
+        values[i] = SolverManagerProbeValueRemoteness(probe, tier_positions[i],
+                                                      &remotenesses[i]);
+    }
+
+    return kNoError;
+}
@@ -37,6 +37,33 @@
 
 #include "core/types/gamesman_types.h"
 
+/**
+ * @brief Probing session of the current solver.
+ *
+ * @details A session keeps the database files and read-ahead buffers opened
+ * by its probes alive between queries. Callers that probe many positions at a
+ * time, such as the children of a position, should open one session, query
+ * each position with SolverManagerProbeValueRemoteness(), and close the session
+ * when done instead of calling SolverManagerGetValue() and
+ * SolverManagerGetRemoteness() for each position, which set up and tear down a
+ * new probe on every call.
+ *
+ * @example
+ * SolverProbe probe;
+ * if (SolverManagerProbeInit(&probe) != 0) return error;
+ * for (int64_t i = 0; i < children.size; ++i) {
+ *     int remoteness;
+ *     Value value = SolverManagerProbeValueRemoteness(
+ *         &probe, children.array[i], &remoteness);
+ *     ...
+ * }
+ * SolverManagerProbeDestroy(&probe);
+ */
+typedef struct SolverProbe {
+    /** Database probe, unused if the solver does not support sessions. */
+    DbProbe db_probe;
+} SolverProbe;
+
 /**
  * @brief Initializes the Solver specified by the current game loaded in the
  * Game Manager Module, and finalizes the previous solver.
@@ -121,4 +148,56 @@ Value SolverManagerGetValue(TierPosition tier_position);
  */
 int SolverManagerGetRemoteness(TierPosition tier_position);
 
+/**
+ * @brief Opens a new probing session PROBE for the current solver.
+ *
+ * @note Assumes the solver manager is initialized with the SolverManagerInit
+ * function. Results in undefined behavior if called before the solver manager
+ * module is initialized. The session must be closed before the current solver
+ * is finalized or replaced.
+ *
+ * @param probe Probe to initialize.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int SolverManagerProbeInit(SolverProbe *probe);
+
+/**
+ * @brief Closes the probing session PROBE, freeing all allocated memory.
+ *
+ * @param probe Probe initialized with SolverManagerProbeInit().
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int SolverManagerProbeDestroy(SolverProbe *probe);
+
+/**
+ * @brief Probes both the value and the remoteness of the given TIER_POSITION
+ * using the probing session PROBE.
+ *
+ * @param probe Probe initialized with SolverManagerProbeInit().
+ * @param tier_position Tier position to probe.
+ * @param remoteness (Output parameter) Remoteness of the given TIER_POSITION.
+ * @return Value of the given TIER_POSITION.
+ */
+Value SolverManagerProbeValueRemoteness(SolverProbe *probe,
+                                        TierPosition tier_position,
+                                        int *remoteness);
+
+/**
+ * @brief Probes the values and the remotenesses of the N tier positions in
+ * TIER_POSITIONS using the probing session PROBE, storing them in VALUES and
+ * REMOTENESSES in the same order. Solvers that support batched probing let the
+ * database reorder the reads so that each tier and each block is visited once.
+ *
+ * @param probe Probe initialized with SolverManagerProbeInit().
+ * @param n Number of tier positions to probe.
+ * @param tier_positions Array of N tier positions to probe.
+ * @param values (Output parameter) Array of size at least N for the values.
+ * @param remotenesses (Output parameter) Array of size at least N for the
+ * remotenesses.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int SolverManagerProbeBatch(SolverProbe *probe, int64_t n,
+                            const TierPosition *tier_positions, Value *values,
+                            int *remotenesses);
+
 #endif  // GAMESMANONE_CORE_SOLVERS_SOLVER_MANAGER_H_
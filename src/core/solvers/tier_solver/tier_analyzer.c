@@ -34,7 +34,9 @@
 #include "core/analysis/analysis.h"
 #include "core/analysis/stat_manager.h"
 #include "core/concurrency.h"
+#include "core/data_structures/compressed_bitmap.h"
 #include "core/data_structures/concurrent_bitset.h"
+#include "core/data_structures/int64_segmented_array.h"
 #include "core/db/db_manager.h"
 #include "core/gamesman_memory.h"
 #include "core/misc.h"
@@ -65,20 +67,55 @@ static int num_child_tiers;  // Size of child_tiers.
 static TierHashMap child_tier_to_index;
 
 static ConcurrentBitset *this_tier_map;
-static ConcurrentBitset **child_tier_maps;
+
+// Positions discovered in each child tier by this tier. Child maps are only
+// written during discovery and merged into the maps on disk afterwards, so
+// they are kept compressed in a pool of child_map_reserve bytes set aside from
+// the analyzer's memory. Array fringes never grow into that pool, nor into
+// the child_map_merge_size bytes needed to merge a child map into its map on
+// disk.
+static CompressedBitmap **child_tier_maps;
+static GamesmanAllocator *child_map_allocator;
+static size_t child_map_reserve;
+static size_t child_map_merge_size;
+static ConcurrentBool child_maps_ok;  // Cleared if a child map runs out.
 
 static int num_threads;  // Number of threads available.
 
 typedef struct {
-    PositionArray a;
-    char padding[GM_CACHE_LINE_PAD(sizeof(PositionArray))];
-} PaddedPositionArray;
-static PaddedPositionArray *fringe;  // Discovered but unprocessed positions.
-static PaddedPositionArray *discovered;  // Newly discovered positions.
+    Int64SegmentedArray a;
+    char padding[GM_CACHE_LINE_PAD(sizeof(Int64SegmentedArray))];
+} PaddedFringeArray;
+static PaddedFringeArray *fringe;      // Discovered but unprocessed positions.
+static PaddedFringeArray *discovered;  // Newly discovered positions.
 
 static ConcurrentBitset *expanded;
 static ConcurrentBitset *bs_fringe, *bs_discovered;
 
+// Direction-optimizing discovery (Beamer et al., 2012). Once the fringe grows
+// past 1/kTopDownBeta of the tier and the undiscovered positions number fewer
+// than kBottomUpAlpha times the fringe, in-tier children are discovered
+// bottom-up by searching each undiscovered position for a parent in the
+// fringe. Discovery goes back to top-down as soon as the fringe shrinks below
+// 1/kTopDownBeta of the tier again.
+enum { kBottomUpAlpha = 14, kTopDownBeta = 24 };
+
+// Whether the canonical parents returned by the API are all the parents of
+// each position, which is only the case for games without position symmetry.
+static bool exact_parents;
+
+static bool bottom_up_allowed;  // For the tier being analyzed.
+
+// Fringes discovered bottom-up are not expanded during discovery. Their
+// positions are expanded afterwards, only if move statistics are needed or
+// the tier has child tiers.
+static bool went_bottom_up;
+static bool moves_needed;
+
+// Number of discovered positions in this tier, maintained only if bottom-up
+// discovery is not ruled out for the tier being analyzed.
+static int64_t num_discovered;
+
 // ============================= TierAnalyzerInit =============================
 
 bool TierAnalyzerInit(const TierSolverApi *api, intptr_t memlimit) {
@@ -92,6 +129,10 @@ bool TierAnalyzerInit(const TierSolverApi *api, intptr_t memlimit) {
     return allocator != NULL;
 }
 
+// ======================== TierAnalyzerSetExactParents ========================
+
+void TierAnalyzerSetExactParents(bool exact) { exact_parents = exact; }
+
 // ============================ TierAnalyzerAnalyze ============================
 
 // Step0Initialize
@@ -120,42 +161,55 @@ static int GetCanonicalChildTiers(
 
 static bool Step0_0CheckMem(int num_threads) {
     size_t fringe_container_size =
-        2 * num_threads * sizeof(PaddedPositionArray);
+        2 * num_threads * sizeof(PaddedFringeArray);
     size_t bitset_fringe_size = 2 * ConcurrentBitsetMemRequired(this_tier_size);
     size_t this_tier_map_size = 2 * ConcurrentBitsetMemRequired(this_tier_size);
-    size_t child_tier_maps_size = num_child_tiers * sizeof(ConcurrentBitset *);
-    size_t serialize_overhead = 0;
+    size_t child_tier_maps_size = num_child_tiers * sizeof(CompressedBitmap *);
+    size_t child_tier_maps_max = num_threads * kCompressedBitmapConversionMax;
+    child_map_merge_size = 0;
     for (int i = 0; i < num_child_tiers; ++i) {
         int64_t tier_size = api_internal->GetTierSize(child_tiers[i]);
-        child_tier_maps_size += ConcurrentBitsetMemRequired(tier_size);
-        if (child_tier_maps_size > serialize_overhead) {
-            serialize_overhead = child_tier_maps_size;
+        child_tier_maps_size += CompressedBitmapMemRequired(tier_size);
+        child_tier_maps_max += CompressedBitmapMemRequiredMax(tier_size);
+
+        // Child maps are merged one at a time.
+        size_t merge_size = StatManagerAddToDiscoveryMapMemRequired(tier_size);
+        if (merge_size > child_map_merge_size) {
+            child_map_merge_size = merge_size;
         }
     }
     size_t partial_analysis_size = num_threads * sizeof(CacheAlignedAnalysis);
     size_t fringe_offsets_size = (num_threads + 1) * sizeof(int64_t);
     size_t total = fringe_container_size + bitset_fringe_size +
-                   child_tier_maps_size + serialize_overhead +
+                   child_tier_maps_size + child_map_merge_size +
                    this_tier_map_size + partial_analysis_size +
                    fringe_offsets_size;
+    size_t remaining = GamesmanAllocatorGetRemainingPoolSize(allocator);
+    if (total > remaining) return false;
 
-    return total <= GamesmanAllocatorGetRemainingPoolSize(allocator);
+    // Set aside as much as the child maps may need, up to what is left.
+    child_map_reserve = remaining - total;
+    if (child_map_reserve > child_tier_maps_max) {
+        child_map_reserve = child_tier_maps_max;
+    }
+
+    return true;
 }
 
-static void InitFringeArray(PaddedPositionArray *target) {
+static void InitFringeArray(PaddedFringeArray *target) {
     for (int i = 0; i < num_threads; ++i) {
-        PositionArrayInitAllocator(&target[i].a, allocator);
+        Int64SegmentedArrayInitAllocator(&target[i].a, allocator);
     }
 }
 
 static void Step0_1InitFringesAndExpanded(void) {
     // Array fringes.
-    fringe = (PaddedPositionArray *)GamesmanAllocatorAllocate(
-        allocator, num_threads * sizeof(PaddedPositionArray));
-    discovered = (PaddedPositionArray *)GamesmanAllocatorAllocate(
-        allocator, num_threads * sizeof(PaddedPositionArray));
-    memset(fringe, 0, num_threads * sizeof(PaddedPositionArray));
-    memset(discovered, 0, num_threads * sizeof(PaddedPositionArray));
+    fringe = (PaddedFringeArray *)GamesmanAllocatorAllocate(
+        allocator, num_threads * sizeof(PaddedFringeArray));
+    discovered = (PaddedFringeArray *)GamesmanAllocatorAllocate(
+        allocator, num_threads * sizeof(PaddedFringeArray));
+    memset(fringe, 0, num_threads * sizeof(PaddedFringeArray));
+    memset(discovered, 0, num_threads * sizeof(PaddedFringeArray));
     InitFringeArray(fringe);
     InitFringeArray(discovered);
 
@@ -180,14 +234,27 @@ static void Step0_3InitAnalysis(Analysis *dest) {
     AnalysisSetHashSize(dest, this_tier_size);
 }
 
+// Bottom-up discovery asks for the parents of positions in this tier that are
+// also in this tier. Parents are only available with retrograde analysis, and
+// the solver never asks for them in tiers without in-tier moves.
+static void Step0_4InitBottomUpStatus(void) {
+    bottom_up_allowed =
+        exact_parents && api_internal->GetCanonicalParentPositions != NULL &&
+        api_internal->GetTierType(this_tier) != kTierTypeImmediateTransition;
+    went_bottom_up = false;
+    num_discovered = 0;
+}
+
 static bool Step0Initialize(Analysis *dest) {
     num_threads = ConcurrencyGetOmpNumThreads();
     this_tier_size = api_internal->GetTierSize(this_tier);
     num_child_tiers = GetCanonicalChildTiers(this_tier, child_tiers);
+    ConcurrentBoolInit(&child_maps_ok, true);  // Also for tiers without any.
     if (!Step0_0CheckMem(num_threads)) return false;
     Step0_1InitFringesAndExpanded();
     Step0_2InitChildTiersReverseLookupMap();
     Step0_3InitAnalysis(dest);
+    Step0_4InitBottomUpStatus();
 
     return true;
 }
@@ -202,67 +269,104 @@ static ConcurrentBitset *LoadDiscoveryMap(Tier tier) {
     int64_t tier_size = api_internal->GetTierSize(tier);
     ConcurrentBitset *ret = NULL;
     int error = StatManagerLoadDiscoveryMap(tier, tier_size, allocator, &ret);
-    if (error != kFileSystemError) return ret;
-
-    // Create a discovery map for the tier.
-    ret = ConcurrentBitsetCreate(tier_size);
-    if (ret == NULL) {
-        fprintf(
-            stderr,
-            "LoadDiscoveryMap: failed to initialize bitset for tier %" PRITier
-            "\n",
-            tier);
-        return ret;
+    if (error == kFileSystemError) {
+        // Create a discovery map for the tier.
+        ret = ConcurrentBitsetCreate(tier_size);
+        if (ret == NULL) {
+            fprintf(stderr,
+                    "LoadDiscoveryMap: failed to initialize bitset for tier "
+                    "%" PRITier "\n",
+                    tier);
+        }
     }
-
-    if (tier == api_internal->GetInitialTier()) {
-        ConcurrentBitsetSet(ret, api_internal->GetInitialPosition(),
-                            memory_order_relaxed);
+    if (ret == NULL) return NULL;
+
+    // The initial position is discovered in the canonical initial tier.
+    TierPosition initial = {.tier = api_internal->GetInitialTier(),
+                            .position = api_internal->GetInitialPosition()};
+    if (tier == initial.tier) {
+        ConcurrentBitsetSet(ret, initial.position, memory_order_relaxed);
+    } else if (tier == api_internal->GetCanonicalTier(initial.tier)) {
+        Position position =
+            api_internal->GetPositionInSymmetricTier(initial, tier);
+        ConcurrentBitsetSet(ret, position, memory_order_relaxed);
     }
 
     return ret;
 }
 
+// Creates empty child maps. What is discovered in them is added to their
+// discovery maps on disk in Step3SaveChildMaps.
+static bool Step1_0CreateChildMaps(void) {
+    GamesmanAllocatorOptions options;
+    GamesmanAllocatorOptionsSetDefaults(&options);
+    options.pool_size = child_map_reserve;
+    child_map_allocator = GamesmanAllocatorCreate(&options);
+    if (child_map_allocator == NULL) return false;
+
+    child_tier_maps = (CompressedBitmap **)GamesmanAllocatorAllocate(
+        allocator, num_child_tiers * sizeof(CompressedBitmap *));
+    if (child_tier_maps == NULL) return false;
+    memset(child_tier_maps, 0, num_child_tiers * sizeof(CompressedBitmap *));
+
+    for (int i = 0; i < num_child_tiers; ++i) {
+        int64_t tier_size = api_internal->GetTierSize(child_tiers[i]);
+        child_tier_maps[i] =
+            CompressedBitmapCreate(tier_size, child_map_allocator);
+        if (child_tier_maps[i] == NULL) return false;
+    }
+
+    return true;
+}
+
 static bool Step1LoadDiscoveryMaps(void) {
     this_tier_map = LoadDiscoveryMap(this_tier);
     if (this_tier_map == NULL) return false;
     bs_fringe = ConcurrentBitsetCreateCopy(this_tier_map);
 
-    if (num_child_tiers > 0) {
-        child_tier_maps = (ConcurrentBitset **)GamesmanAllocatorAllocate(
-            allocator, num_child_tiers * sizeof(ConcurrentBitset *));
-        if (child_tier_maps == NULL) return false;
-        memset(child_tier_maps, 0,
-               num_child_tiers * sizeof(ConcurrentBitset *));
-
-        for (int i = 0; i < num_child_tiers; ++i) {
-            child_tier_maps[i] = LoadDiscoveryMap(child_tiers[i]);
-            if (child_tier_maps[i] == NULL) return false;
-        }
-    }
+    if (num_child_tiers > 0) return Step1_0CreateChildMaps();
 
     return true;
 }
 
 // Step2Discover
 
+// Bitsets of this tier are scanned in parallel one chunk at a time, visiting
+// only the set (or unset) bits in each chunk.
+static int64_t ChunkBegin(int64_t chunk) {
+    return chunk * kConcurrentBitsetChunkBits;
+}
+
+static int64_t ChunkEnd(int64_t chunk) {
+    return (chunk + 1) * kConcurrentBitsetChunkBits;
+}
+
+static int64_t NextSet(ConcurrentBitset *s, int64_t begin, int64_t end) {
+    return ConcurrentBitsetFindNextSet(s, begin, end, memory_order_relaxed);
+}
+
+static int64_t NextUnset(ConcurrentBitset *s, int64_t begin, int64_t end) {
+    return ConcurrentBitsetFindNextUnset(s, begin, end, memory_order_relaxed);
+}
+
 static int64_t GetFringeSize(void) {
     int64_t size = 0;
     for (int i = 0; i < num_threads; ++i) {
-        size += fringe[i].a.size;
+        size += Int64SegmentedArraySize(&fringe[i].a);
     }
 
     return size;
 }
 
-static int64_t *MakeFringeOffsets(PaddedPositionArray *src) {
+static int64_t *MakeFringeOffsets(PaddedFringeArray *src) {
     int64_t *fringe_offsets = (int64_t *)GamesmanAllocatorAllocate(
         allocator, (num_threads + 1) * sizeof(int64_t));
     if (fringe_offsets == NULL) return NULL;
 
     fringe_offsets[0] = 0;
     for (int i = 1; i <= num_threads; ++i) {
-        fringe_offsets[i] = fringe_offsets[i - 1] + src[i - 1].a.size;
+        fringe_offsets[i] =
+            fringe_offsets[i - 1] + Int64SegmentedArraySize(&src[i - 1].a);
     }
 
     return fringe_offsets;
@@ -334,13 +438,16 @@ static int GetChildPositions(
 
     // If the parent position is not a canonical position, then the number of
     // canonical moves is 0. Using multiplication to avoid branching.
-    int num_canonical_moves = (int)dedup.size * IsCanonicalPosition(parent);
+    int num_canonical_moves =
+        (int)TierPositionHashSetSize(&dedup) * IsCanonicalPosition(parent);
     TierPositionHashSetDestroy(&dedup);
     AnalysisDiscoverMoves(dest, parent, num_moves, num_canonical_moves);
 
     return ret;
 }
 
+// Returns false if the array fringe ran out of memory, in which case CHILD is
+// added to the bitset fringe instead.
 static bool DiscoverProcessThisTierArray(Position child, int tid) {
     bool child_is_discovered =
         ConcurrentBitsetSet(this_tier_map, child, memory_order_relaxed);
@@ -348,7 +455,15 @@ static bool DiscoverProcessThisTierArray(Position child, int tid) {
     // Only add each unique position to the fringe once.
     if (child_is_discovered) return true;
 
-    return PositionArrayAppend(&discovered[tid].a, child);
+    // Leave the memory set aside for child maps to them.
+    if (GamesmanAllocatorGetRemainingPoolSize(allocator) >
+            child_map_reserve + child_map_merge_size &&
+        Int64SegmentedArrayPushBack(&discovered[tid].a, child)) {
+        return true;
+    }
+    ConcurrentBitsetSet(bs_discovered, child, memory_order_relaxed);
+
+    return false;
 }
 
 static void DiscoverProcessThisTierBitset(Position child) {
@@ -377,19 +492,27 @@ static void DiscoverProcessChildTier(TierPosition child) {
     }
 
     int64_t child_tier_index = TierHashMapIteratorValue(&it);
-    ConcurrentBitset *target_map = child_tier_maps[child_tier_index];
-    ConcurrentBitsetSet(target_map, child.position, memory_order_relaxed);
+    CompressedBitmap *target_map = child_tier_maps[child_tier_index];
+    if (!CompressedBitmapAdd(target_map, child.position)) {
+        ConcurrentBoolStore(&child_maps_ok, false);
+    }
 }
 
-static void DestroyFringeArray(PaddedPositionArray *target) {
+static void DestroyFringeArray(PaddedFringeArray *target) {
     if (target == NULL) return;
     for (int i = 0; i < num_threads; ++i) {
-        PositionArrayDestroy(&target[i].a);
+        Int64SegmentedArrayDestroy(&target[i].a);
+    }
+}
+
+static void ClearFringeArray(PaddedFringeArray *target) {
+    for (int i = 0; i < num_threads; ++i) {
+        Int64SegmentedArrayClear(&target[i].a);
     }
 }
 
 static void SwapFringeArrays(void) {
-    PaddedPositionArray *tmp = fringe;
+    PaddedFringeArray *tmp = fringe;
     fringe = discovered;
     discovered = tmp;
 }
@@ -436,8 +559,7 @@ static bool Expand(TierPosition parent, Analysis *dest, int tid,
             DiscoverProcessChildTier(children[j]);
         } else if (use_array) {
             use_array = DiscoverProcessThisTierArray(children[j].position, tid);
-            j -= (!use_array);  // Reprocess the j-th child if failed.
-        } else {                // Already OOM, expand to bitset fringe
+        } else {  // Already OOM, expand to bitset fringe
             DiscoverProcessThisTierBitset(children[j].position);
         }
     }
@@ -464,18 +586,20 @@ static void DiscoverFromBitsetToBitset(Analysis *dest) {
         NotReached("Terminating...\n");
     }
 
+    int64_t num_chunks = ConcurrentBitsetNumChunks(bs_fringe);
     PRAGMA_OMP_PARALLEL {
         int tid = ConcurrencyGetOmpThreadId();
-        PRAGMA_OMP_FOR_SCHEDULE_DYNAMIC(1024)
-        for (int64_t i = 0; i < this_tier_size; ++i) {
-            if (!ConcurrentBitsetTest(bs_fringe, i, memory_order_relaxed)) {
-                continue;
+        PRAGMA_OMP_FOR_SCHEDULE_DYNAMIC(1)
+        for (int64_t c = 0; c < num_chunks; ++c) {
+            int64_t end = ChunkEnd(c);
+            for (int64_t i = NextSet(bs_fringe, ChunkBegin(c), end); i < end;
+                 i = NextSet(bs_fringe, i + 1, end)) {
+                TierPosition parent = {
+                    .tier = this_tier,
+                    .position = i,
+                };
+                Expand(parent, &parts[tid].data, tid, false);
             }
-            TierPosition parent = {
-                .tier = this_tier,
-                .position = i,
-            };
-            Expand(parent, &parts[tid].data, tid, false);
         }
     }
     MergePartialAnalysisMoves(dest, parts);
@@ -509,22 +633,23 @@ static bool DiscoverFromBitsetToArray(Analysis *dest) {
         goto _bailout;
     }
 
+    int64_t num_chunks = ConcurrentBitsetNumChunks(bs_fringe);
     PRAGMA_OMP_PARALLEL {
         int tid = ConcurrencyGetOmpThreadId();
-        PRAGMA_OMP_FOR_SCHEDULE_DYNAMIC(1024)
-        for (int64_t i = 0; i < this_tier_size; ++i) {
-            if (!ConcurrentBoolLoad(&success)) {  // Fail fast.
-                continue;
-            } else if (!ConcurrentBitsetTest(bs_fringe, i,
-                                             memory_order_relaxed)) {
-                continue;
+        PRAGMA_OMP_FOR_SCHEDULE_DYNAMIC(1)
+        for (int64_t c = 0; c < num_chunks; ++c) {
+            int64_t end = ChunkEnd(c);
+            for (int64_t i = NextSet(bs_fringe, ChunkBegin(c), end); i < end;
+                 i = NextSet(bs_fringe, i + 1, end)) {
+                if (!ConcurrentBoolLoad(&success)) break;  // Fail fast.
+                TierPosition parent = {
+                    .tier = this_tier,
+                    .position = i,
+                };
+                bool step_success =
+                    Expand(parent, &parts[tid].data, tid, true);
+                if (!step_success) ConcurrentBoolStore(&success, false);
             }
-            TierPosition parent = {
-                .tier = this_tier,
-                .position = i,
-            };
-            bool step_success = Expand(parent, &parts[tid].data, tid, true);
-            if (!step_success) ConcurrentBoolStore(&success, false);
         }
     }
     MergePartialAnalysisMoves(dest, parts);
@@ -575,7 +700,8 @@ static bool DiscoverFromArrayToArray(Analysis *dest) {
             int64_t index_in_fringe = i - fringe_offsets[fringe_id];
             TierPosition parent = {
                 .tier = this_tier,
-                .position = fringe[fringe_id].a.array[index_in_fringe],
+                .position = Int64SegmentedArrayGet(&fringe[fringe_id].a,
+                                                   index_in_fringe),
             };
             bool step_success = Expand(parent, &parts[tid].data, tid, true);
             if (!step_success) ConcurrentBoolStore(&success, false);
@@ -592,29 +718,23 @@ _bailout:
 }
 
 // Adds all positions in the given array fringe to bitset fringe and
-// reinitialize.
-static void TransferFringeHelper(PaddedPositionArray *src) {
-    // Allocate space
-    int64_t *fringe_offsets = MakeFringeOffsets(src);
-    if (fringe_offsets == NULL) {
-        fprintf(stderr, "TransferFringeHelper: (BUG) unexpected OOM\n");
-        NotReached("Terminating...\n");
-    }
-
-    PRAGMA_OMP_PARALLEL {
-        int fringe_id = 0;
-        PRAGMA_OMP_FOR_SCHEDULE_MONOTONIC_DYNAMIC(1024)
-        for (int64_t i = 0; i < fringe_offsets[num_threads]; ++i) {
-            UpdateFringeId(&fringe_id, i, fringe_offsets);
-            int64_t index_in_fringe = i - fringe_offsets[fringe_id];
-            Position pos = src[fringe_id].a.array[index_in_fringe];
-            if (!ConcurrentBitsetTest(expanded, pos, memory_order_relaxed)) {
-                ConcurrentBitsetSet(bs_fringe, pos, memory_order_relaxed);
+// reinitialize. Each chunk of the array fringe is released as soon as it has
+// been transferred, which frees up memory when it is needed the most.
+static void TransferFringeHelper(PaddedFringeArray *src) {
+    for (int i = 0; i < num_threads; ++i) {
+        Int64SegmentedArray *array = &src[i].a;
+        int64_t num_chunks = Int64SegmentedArrayNumChunks(array);
+        PRAGMA_OMP_PARALLEL_FOR_SCHEDULE_DYNAMIC(1)
+        for (int64_t c = 0; c < num_chunks; ++c) {
+            const Position *chunk = Int64SegmentedArrayChunk(array, c);
+            int64_t length = Int64SegmentedArrayChunkLength(array, c);
+            for (int64_t j = 0; j < length; ++j) {
+                ConcurrentBitsetSet(bs_fringe, chunk[j], memory_order_relaxed);
             }
+            Int64SegmentedArrayReleaseChunk(array, c);
         }
     }
-    GamesmanAllocatorDeallocate(allocator, fringe_offsets);
-    fringe_offsets = NULL;
+    ClearFringeArray(src);
 }
 
 // Preconditions:
@@ -642,21 +762,152 @@ static void TransferFringe(int prev_state) {
 
     // The array discovered fringe is always used when an OOM occurs.
     TransferFringeHelper(discovered);
+
+    // Positions expanded before the OOM must not be expanded again.
+    ConcurrentBitsetAndNot(bs_fringe, expanded);
+}
+
+static bool ShouldGoBottomUp(int64_t fringe_size) {
+    if (!bottom_up_allowed) return false;
+    if (fringe_size * kTopDownBeta < this_tier_size) return false;
+
+    return fringe_size * kBottomUpAlpha > this_tier_size - num_discovered;
+}
+
+// Expands PARENT as Expand does, except that children in this tier, which
+// were discovered bottom-up already, are ignored.
+static void ExpandChildTiers(TierPosition parent, Analysis *dest) {
+    if (IsPrimitive(parent)) return;
+
+    TierPosition children[kTierSolverNumChildPositionsMax];
+    int num_children = GetChildPositions(parent, children, dest);
+    for (int j = 0; j < num_children; ++j) {
+        if (children[j].tier != this_tier) {
+            DiscoverProcessChildTier(children[j]);
+        }
+    }
+}
+
+// Discovers the undiscovered POSITION into the bitset discovered fringe if it
+// has a non-primitive parent in the bitset fringe. Returns whether POSITION
+// was discovered.
+static bool DiscoverFromFringeParent(Position position) {
+    TierPosition tier_position = {.tier = this_tier, .position = position};
+    if (!api_internal->IsLegalPosition(tier_position)) return false;
+
+    Position parents[kTierSolverNumParentPositionsMax];
+    int num_parents = api_internal->GetCanonicalParentPositions(
+        tier_position, this_tier, parents);
+    for (int i = 0; i < num_parents; ++i) {
+        TierPosition parent = {.tier = this_tier, .position = parents[i]};
+        if (ConcurrentBitsetTest(bs_fringe, parents[i], memory_order_relaxed) &&
+            !IsPrimitive(parent)) {
+            ConcurrentBitsetSet(bs_discovered, position, memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Preconditions:
+//   - array fringe is empty initialized
+//   - array discovered is empty initialized
+//   - bitset fringe contains at least one position to expand
+//   - bitset discovered is zero initialized
+//
+// Output:
+//   - array fringe remains empty initialized
+//   - array discovered remains empty initialized
+//   - bitset fringe remains unmodified
+//   - bitset discovered contains all discoverable positions from bitset fringe
+//
+// Returns the number of positions discovered. The positions in bitset fringe
+// are left unexpanded for ExpandBottomUpFringes.
+static int64_t DiscoverBottomUp(void) {
+    went_bottom_up = true;
+    int64_t num_chunks = ConcurrentBitsetNumChunks(bs_fringe);
+    ConcurrentSizeType count;
+    ConcurrentSizeTypeInit(&count, 0);
+    PRAGMA_OMP_PARALLEL {
+        size_t local_count = 0;
+        PRAGMA_OMP_FOR_SCHEDULE_DYNAMIC(1)
+        for (int64_t c = 0; c < num_chunks; ++c) {
+            int64_t end = ChunkEnd(c);
+            for (int64_t i = NextUnset(this_tier_map, ChunkBegin(c), end);
+                 i < end; i = NextUnset(this_tier_map, i + 1, end)) {
+                local_count += DiscoverFromFringeParent(i);
+            }
+        }
+        ConcurrentSizeTypeAdd(&count, local_count);
+    }
+    ConcurrentBitsetOr(this_tier_map, bs_discovered);
+
+    return (int64_t)ConcurrentSizeTypeLoad(&count);
+}
+
+// Expands the positions in the fringes discovered bottom-up, which are the
+// discovered positions not expanded top-down, for their move statistics and
+// their children in child tiers.
+static void ExpandBottomUpFringes(Analysis *dest) {
+    CacheAlignedAnalysis *parts = MakePartialAnalyses();
+    if (parts == NULL) {
+        fprintf(stderr, "ExpandBottomUpFringes: (BUG) unexpected OOM\n");
+        NotReached("Terminating...\n");
+    }
+
+    int64_t num_chunks = ConcurrentBitsetNumChunks(this_tier_map);
+    PRAGMA_OMP_PARALLEL {
+        int tid = ConcurrencyGetOmpThreadId();
+        PRAGMA_OMP_FOR_SCHEDULE_DYNAMIC(1)
+        for (int64_t c = 0; c < num_chunks; ++c) {
+            int64_t end = ChunkEnd(c);
+            for (int64_t i = NextSet(this_tier_map, ChunkBegin(c), end);
+                 i < end; i = NextSet(this_tier_map, i + 1, end)) {
+                if (ConcurrentBitsetTest(expanded, i, memory_order_relaxed)) {
+                    continue;
+                }
+                TierPosition parent = {.tier = this_tier, .position = i};
+                ExpandChildTiers(parent, &parts[tid].data);
+            }
+        }
+    }
+    MergePartialAnalysisMoves(dest, parts);
+    GamesmanAllocatorDeallocate(allocator, parts);
+}
+
+// Moves the array fringe into the bitset fringe and goes bottom-up if the
+// fringe just discovered top-down is dense enough.
+static bool TryGoBottomUp(void) {
+    if (!bottom_up_allowed) return false;
+
+    int64_t fringe_size = GetFringeSize();
+    num_discovered += fringe_size;
+    if (!ShouldGoBottomUp(fringe_size)) return false;
+
+    TransferFringeHelper(fringe);
+    return true;
 }
 
 static void Step2Discover(Analysis *dest) {
-    enum State { ArrayToArray, BitsetToArray, BitsetToBitset };
+    enum State { ArrayToArray, BitsetToArray, BitsetToBitset, BottomUp };
     enum State state = BitsetToArray;
+    if (bottom_up_allowed) {
+        num_discovered = ConcurrentBitsetCount(this_tier_map);
+        if (ShouldGoBottomUp(num_discovered)) state = BottomUp;
+    }
+
     // printf("Beginning discover step\n");
     while (state != ArrayToArray || GetFringeSize() > 0) {
         bool success = true;
+        int64_t count;
         switch (state) {
             case ArrayToArray:
                 success = DiscoverFromArrayToArray(dest);
                 if (success) {
-                    DestroyFringeArray(fringe);
-                    InitFringeArray(fringe);
+                    ClearFringeArray(fringe);
                     SwapFringeArrays();
+                    if (TryGoBottomUp()) state = BottomUp;
                     // printf("Array to Array finished\n");
                 } else {  // OOM
                     // printf("Array to Array OOM\n");
@@ -671,7 +922,7 @@ static void Step2Discover(Analysis *dest) {
                 if (success) {
                     SwapFringeArrays();
                     ConcurrentBitsetResetAll(bs_fringe);
-                    state = ArrayToArray;
+                    state = TryGoBottomUp() ? BottomUp : ArrayToArray;
                     // printf("Bitset to Array finished\n");
                 } else {  // OOM
                     // printf("Bitset to Array OOM\n");
@@ -685,20 +936,51 @@ static void Step2Discover(Analysis *dest) {
                 ConcurrentBitsetResetAll(bs_fringe);
                 SwapFringeBitsets();
                 state = BitsetToArray;
+                if (bottom_up_allowed) {
+                    // Positions moved out of the array fringes on OOM were
+                    // never counted.
+                    num_discovered = ConcurrentBitsetCount(this_tier_map);
+                    count = ConcurrentBitsetCount(bs_fringe);
+                    if (ShouldGoBottomUp(count)) state = BottomUp;
+                }
                 // printf("Bitset to Bitset finished\n");
                 break;
+
+            case BottomUp:
+                count = DiscoverBottomUp();
+                ConcurrentBitsetResetAll(bs_fringe);
+                SwapFringeBitsets();
+                num_discovered += count;
+                if (count == 0) {
+                    state = ArrayToArray;  // Both array fringes are empty.
+                } else if (count * kTopDownBeta < this_tier_size) {
+                    state = BitsetToArray;
+                }
+                break;
         }
     }
+
+    if (went_bottom_up && (moves_needed || num_child_tiers > 0)) {
+        ExpandBottomUpFringes(dest);
+    }
 }
 
 // Step3SaveChildMaps
 
 static bool Step3SaveChildMaps(void) {
+    if (!ConcurrentBoolLoad(&child_maps_ok)) {
+        fprintf(stderr,
+                "Step3SaveChildMaps: ran out of memory for the child maps of "
+                "tier %" PRITier "\n",
+                this_tier);
+        return false;
+    }
+
     for (int64_t i = 0; i < num_child_tiers; ++i) {
-        int error =
-            StatManagerSaveDiscoveryMap(child_tier_maps[i], child_tiers[i]);
+        int error = StatManagerAddToDiscoveryMap(child_tier_maps[i],
+                                                 child_tiers[i], allocator);
         if (error != 0) return false;
-        ConcurrentBitsetDestroy(child_tier_maps[i]);
+        CompressedBitmapDestroy(child_tier_maps[i]);
         child_tier_maps[i] = NULL;
     }
     GamesmanAllocatorDeallocate(allocator, child_tier_maps);
@@ -709,7 +991,34 @@ static bool Step3SaveChildMaps(void) {
 
 // Step4Analyze
 
+// Merges the histogram recorded by the solver into DEST if it covers exactly
+// the reachable positions of this tier, which is the case if all legal
+// positions are reachable. Returns whether the histogram was merged.
+static bool Step4_0MergeHistogram(Analysis *dest) {
+    CacheAlignedAnalysis *histogram =
+        (CacheAlignedAnalysis *)GamesmanAllocatorAllocate(
+            allocator, sizeof(CacheAlignedAnalysis));
+    if (histogram == NULL) return false;
+
+    bool merged = false;
+    if (StatManagerLoadHistogram(&histogram->data, this_tier) == kNoError &&
+        AnalysisGetNumReachablePositions(&histogram->data) ==
+            ConcurrentBitsetCount(this_tier_map)) {
+        AnalysisMergeCounts(dest, histogram);
+        merged = true;
+    }
+    GamesmanAllocatorDeallocate(allocator, histogram);
+
+    return merged;
+}
+
 static bool Step4Analyze(Analysis *dest) {
+    if (Step4_0MergeHistogram(dest)) {
+        ConcurrentBitsetDestroy(this_tier_map);
+        this_tier_map = NULL;
+        return true;
+    }
+
     int error = DbManagerLoadTier(this_tier, this_tier_size);
     if (error != kNoError) return false;
 
@@ -721,29 +1030,34 @@ static bool Step4Analyze(Analysis *dest) {
 
     ConcurrentBool success;
     ConcurrentBoolInit(&success, true);
+    int64_t num_chunks = ConcurrentBitsetNumChunks(this_tier_map);
     PRAGMA_OMP_PARALLEL {
         int tid = ConcurrencyGetOmpThreadId();
-        PRAGMA_OMP_FOR_SCHEDULE_DYNAMIC(1024)
-        for (int64_t i = 0; i < this_tier_size; ++i) {
-            if (!ConcurrentBoolLoad(&success)) continue;  // fail fast.
-
-            // Skip if the current position is not reachable.
-            if (!ConcurrentBitsetTest(this_tier_map, i, memory_order_relaxed)) {
-                continue;
+        PRAGMA_OMP_FOR_SCHEDULE_DYNAMIC(1)
+        for (int64_t c = 0; c < num_chunks; ++c) {
+            // Only reachable positions are visited.
+            int64_t end = ChunkEnd(c);
+            for (int64_t i = NextSet(this_tier_map, ChunkBegin(c), end);
+                 i < end; i = NextSet(this_tier_map, i + 1, end)) {
+                if (!ConcurrentBoolLoad(&success)) break;  // fail fast.
+
+                TierPosition tier_position = {.tier = this_tier,
+                                              .position = i};
+                Position canonical =
+                    api_internal->GetCanonicalPosition(tier_position);
+
+                // Must probe canonical positions. Original might not be
+                // solved.
+                Value value =
+                    DbManagerGetValueFromLoaded(this_tier, canonical);
+                int remoteness =
+                    DbManagerGetRemotenessFromLoaded(this_tier, canonical);
+                bool is_canonical = (tier_position.position == canonical);
+                int error =
+                    AnalysisCount(&parts[tid].data, tier_position, value,
+                                  remoteness, is_canonical);
+                if (error != 0) ConcurrentBoolStore(&success, false);
             }
-
-            TierPosition tier_position = {.tier = this_tier, .position = i};
-            Position canonical =
-                api_internal->GetCanonicalPosition(tier_position);
-
-            // Must probe canonical positions. Original might not be solved.
-            Value value = DbManagerGetValueFromLoaded(this_tier, canonical);
-            int remoteness =
-                DbManagerGetRemotenessFromLoaded(this_tier, canonical);
-            bool is_canonical = (tier_position.position == canonical);
-            int error = AnalysisCount(&parts[tid].data, tier_position, value,
-                                      remoteness, is_canonical);
-            if (error != 0) ConcurrentBoolStore(&success, false);
         }
     }
     MergePartialAnalysisCounts(dest, parts);
@@ -763,6 +1077,39 @@ static bool Step5SaveAnalysis(const Analysis *dest) {
     bool success = (StatManagerSaveAnalysis(this_tier, dest) == 0);
     if (!success) return false;
 
+    if (this_tier != api_internal->GetInitialTier()) {
+        StatManagerRemoveDiscoveryMap(this_tier);
+    }
+    StatManagerRemoveHistogram(this_tier);
+    return true;
+}
+
+// Step5SaveReachableMap
+
+// Saves the reachable map of this tier, which marks the canonical position of
+// each reachable position, in place of its discovery map.
+static bool Step5SaveReachableMap(void) {
+    ConcurrentBitset *reachable =
+        ConcurrentBitsetCreateAllocator(this_tier_size, allocator);
+    if (reachable == NULL) return false;
+
+    int64_t num_chunks = ConcurrentBitsetNumChunks(this_tier_map);
+    PRAGMA_OMP_PARALLEL_FOR_SCHEDULE_DYNAMIC(1)
+    for (int64_t c = 0; c < num_chunks; ++c) {
+        int64_t end = ChunkEnd(c);
+        for (int64_t i = NextSet(this_tier_map, ChunkBegin(c), end); i < end;
+             i = NextSet(this_tier_map, i + 1, end)) {
+            TierPosition tier_position = {.tier = this_tier, .position = i};
+            Position canonical =
+                api_internal->GetCanonicalPosition(tier_position);
+            ConcurrentBitsetSet(reachable, canonical, memory_order_relaxed);
+        }
+    }
+    bool success =
+        (StatManagerSaveReachableMap(reachable, this_tier) == kNoError);
+    ConcurrentBitsetDestroy(reachable);
+    if (!success) return false;
+
     if (this_tier != api_internal->GetInitialTier()) {
         StatManagerRemoveDiscoveryMap(this_tier);
     }
@@ -772,15 +1119,21 @@ static bool Step5SaveAnalysis(const Analysis *dest) {
 // Step6CleanUp
 
 static void Step6CleanUp(void) {
-    num_child_tiers = 0;
     TierHashMapDestroy(&child_tier_to_index);
     ConcurrentBitsetDestroy(this_tier_map);
     this_tier_map = NULL;
-    for (int i = 0; i < num_child_tiers; ++i) {
-        ConcurrentBitsetDestroy(child_tier_maps[i]);
+    if (child_tier_maps != NULL) {
+        for (int i = 0; i < num_child_tiers; ++i) {
+            CompressedBitmapDestroy(child_tier_maps[i]);
+        }
     }
+    num_child_tiers = 0;
     GamesmanAllocatorDeallocate(allocator, child_tier_maps);
     child_tier_maps = NULL;
+    GamesmanAllocatorRelease(child_map_allocator);
+    child_map_allocator = NULL;
+    child_map_reserve = 0;
+    child_map_merge_size = 0;
     ConcurrentBitsetDestroy(expanded);
     expanded = NULL;
 
@@ -815,6 +1168,7 @@ int TierAnalyzerAnalyze(Analysis *dest, Tier tier, bool force) {
         }
     }
 
+    moves_needed = true;
     if (!Step0Initialize(dest)) goto _bailout;
     if (!Step1LoadDiscoveryMaps()) goto _bailout;
     Step2Discover(dest);
@@ -830,6 +1184,29 @@ _bailout:
     return ret;
 }
 
+// =========================== TierAnalyzerDiscover ===========================
+
+int TierAnalyzerDiscover(Tier tier) {
+    int ret = -1;
+
+    this_tier = tier;
+    Analysis *moves = (Analysis *)GamesmanMalloc(sizeof(Analysis));
+    if (api_internal == NULL || moves == NULL) goto _bailout;
+
+    moves_needed = false;  // The move statistics are discarded.
+    if (!Step0Initialize(moves)) goto _bailout;
+    if (!Step1LoadDiscoveryMaps()) goto _bailout;
+    Step2Discover(moves);
+    if (!Step3SaveChildMaps()) goto _bailout;
+    if (!Step5SaveReachableMap()) goto _bailout;
+    ret = 0;
+
+_bailout:
+    GamesmanFree(moves);
+    Step6CleanUp();
+    return ret;
+}
+
 // =========================== TierAnalyzerFinalize ===========================
 
 void TierAnalyzerFinalize(void) {
@@ -45,6 +45,17 @@
  */
 bool TierAnalyzerInit(const TierSolverApi *api, intptr_t memlimit);
 
+/**
+ * @brief Sets whether the canonical parent positions returned by the API are
+ * all the parent positions of each position, which is the case for games
+ * without position symmetry. Dense fringes are only discovered bottom-up,
+ * by searching each undiscovered position for a parent in the fringe, if so.
+ * Not set by default.
+ *
+ * @param exact Whether canonical parent positions are exact.
+ */
+void TierAnalyzerSetExactParents(bool exact);
+
 /**
  * @brief Analyzes the given TIER.
  *
@@ -57,6 +68,17 @@ bool TierAnalyzerInit(const TierSolverApi *api, intptr_t memlimit);
  */
 int TierAnalyzerAnalyze(Analysis *dest, Tier tier, bool force);
 
+/**
+ * @brief Discovers the positions reachable in TIER from the positions already
+ * discovered in it, and saves its reachable map and the discovery maps of its
+ * child tiers without analyzing it. TIER must be canonical, and all of its
+ * canonical parent tiers must have been discovered first.
+ *
+ * @param tier Tier to discover.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int TierAnalyzerDiscover(Tier tier);
+
 /**
  * @brief Finalizes the Tier Analyzer Module.
  */
@@ -0,0 +1,261 @@
+/**
+ * @file tier_graph_snapshot.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the persisted tier graph snapshot.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/solvers/tier_solver/tier_graph_snapshot.h"
+
+#include <fcntl.h>     // open, O_RDONLY
+#include <stdbool.h>   // bool
+#include <stddef.h>    // NULL, size_t
+#include <stdint.h>    // int64_t, int32_t, uint64_t
+#include <stdio.h>     // FILE, fprintf, snprintf, stderr
+#include <string.h>    // memcmp, memcpy, memset, strlen, strncmp
+#include <sys/mman.h>  // mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close
+
+#include "core/gamesman_memory.h"
+#include "core/misc.h"
+#include "core/solvers/tier_solver/tier_solver.h"
+#include "core/types/gamesman_types.h"
+
+static const char kSnapshotFileMagic[8] = {'G', 'M', 'T', 'G',
+                                           'R', 'F', '0', '1'};
+
+typedef struct SnapshotFileHeader {
+    char magic[8];
+    char game[kGameNameLengthMax + 1];
+    int32_t variant;
+    int32_t reserved;
+    int64_t num_nodes;
+    int64_t num_children;
+    TierGraphSnapshotStats stats;
+    uint64_t checksum;  // Checksum of the node and child tier arrays.
+} SnapshotFileHeader;
+
+static int Expand(void **buffer, int64_t *capacity, int64_t min_capacity,
+                  size_t item_size);
+static uint64_t Checksum(const void *data, size_t size, uint64_t hash);
+static uint64_t SnapshotChecksum(const TierGraphSnapshot *snapshot);
+static bool SnapshotIsConsistent(const TierGraphSnapshot *snapshot);
+
+// -----------------------------------------------------------------------------
+
+void TierGraphSnapshotInit(TierGraphSnapshot *snapshot) {
+    memset(snapshot, 0, sizeof(*snapshot));
+}
+
+void TierGraphSnapshotDestroy(TierGraphSnapshot *snapshot) {
+    GamesmanFree(snapshot->node_buffer);
+    GamesmanFree(snapshot->child_buffer);
+    if (snapshot->map != NULL) munmap(snapshot->map, snapshot->map_size);
+    memset(snapshot, 0, sizeof(*snapshot));
+}
+
+int TierGraphSnapshotAppend(TierGraphSnapshot *snapshot,
+                            const TierGraphSnapshotNode *node,
+                            const Tier *children) {
+    if (snapshot->map != NULL) return kIllegalArgumentError;
+
+    int error = Expand((void **)&snapshot->node_buffer,
+                       &snapshot->node_capacity, snapshot->num_nodes + 1,
+                       sizeof(TierGraphSnapshotNode));
+    if (error != kNoError) return error;
+    error = Expand((void **)&snapshot->child_buffer, &snapshot->child_capacity,
+                   snapshot->num_children + node->num_children, sizeof(Tier));
+    if (error != kNoError) return error;
+
+    TierGraphSnapshotNode *dest = &snapshot->node_buffer[snapshot->num_nodes++];
+    *dest = *node;
+    dest->children_offset = snapshot->num_children;
+    dest->reserved = 0;
+    memcpy(&snapshot->child_buffer[snapshot->num_children], children,
+           node->num_children * sizeof(Tier));
+    snapshot->num_children += node->num_children;
+    snapshot->nodes = snapshot->node_buffer;
+    snapshot->children = snapshot->child_buffer;
+
+    return kNoError;
+}
+
+int TierGraphSnapshotSave(const TierGraphSnapshot *snapshot,
+                          ReadOnlyString path, ReadOnlyString game_name,
+                          int variant) {
+    if (strlen(game_name) > kGameNameLengthMax) return kIllegalArgumentError;
+
+    SnapshotFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kSnapshotFileMagic, sizeof(kSnapshotFileMagic));
+    strcpy(header.game, game_name);
+    header.variant = variant;
+    header.num_nodes = snapshot->num_nodes;
+    header.num_children = snapshot->num_children;
+    header.stats = snapshot->stats;
+    header.checksum = SnapshotChecksum(snapshot);
+
+    // Write to a temporary file first so that an interrupted save never leaves
+    // a truncated snapshot behind.
+    size_t tmp_path_size = strlen(path) + sizeof(".tmp");
+    char *tmp_path = (char *)GamesmanMalloc(tmp_path_size);
+    if (tmp_path == NULL) return kMallocFailureError;
+    snprintf(tmp_path, tmp_path_size, "%s.tmp", path);
+
+    int error = kFileSystemError;
+    FILE *file = GuardedFopen(tmp_path, "wb");
+    if (file == NULL) goto _bailout;
+    error = GuardedFwrite(&header, sizeof(header), 1, file);
+    if (error != 0) goto _bailout_close;
+    if (snapshot->num_nodes > 0) {
+        error = GuardedFwrite(snapshot->nodes, sizeof(TierGraphSnapshotNode),
+                              snapshot->num_nodes, file);
+        if (error != 0) goto _bailout_close;
+    }
+    if (snapshot->num_children > 0) {
+        error = GuardedFwrite(snapshot->children, sizeof(Tier),
+                              snapshot->num_children, file);
+        if (error != 0) goto _bailout_close;
+    }
+    error = GuardedFclose(file);
+    if (error != 0) goto _bailout;
+    error = GuardedRename(tmp_path, path);
+    goto _bailout;
+
+_bailout_close:
+    BailOutFclose(file, error);
+_bailout:
+    if (error != kNoError) {
+        remove(tmp_path);
+        error = kFileSystemError;
+    }
+    GamesmanFree(tmp_path);
+
+    return error;
+}
+
+int TierGraphSnapshotLoad(TierGraphSnapshot *snapshot, ReadOnlyString path,
+                          ReadOnlyString game_name, int variant) {
+    // A missing snapshot is expected on the first run, so open() is used
+    // instead of GuardedOpen() to avoid printing an error.
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return kFileSystemError;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        (size_t)st.st_size < sizeof(SnapshotFileHeader)) {
+        close(fd);
+        return kRuntimeError;
+    }
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return kFileSystemError;
+
+    const SnapshotFileHeader *header = (const SnapshotFileHeader *)map;
+    size_t nodes_size =
+        (size_t)header->num_nodes * sizeof(TierGraphSnapshotNode);
+    size_t children_size = (size_t)header->num_children * sizeof(Tier);
+    if (memcmp(header->magic, kSnapshotFileMagic, sizeof(kSnapshotFileMagic)) ||
+        strncmp(header->game, game_name, sizeof(header->game)) != 0 ||
+        header->variant != variant || header->num_nodes < 0 ||
+        header->num_children < 0 ||
+        (size_t)st.st_size !=
+            sizeof(SnapshotFileHeader) + nodes_size + children_size) {
+        munmap(map, st.st_size);
+        return kRuntimeError;
+    }
+
+    TierGraphSnapshotInit(snapshot);
+    snapshot->map = map;
+    snapshot->map_size = st.st_size;
+    snapshot->stats = header->stats;
+    snapshot->nodes =
+        (const TierGraphSnapshotNode *)((const char *)map + sizeof(*header));
+    snapshot->children =
+        (const Tier *)((const char *)snapshot->nodes + nodes_size);
+    snapshot->num_nodes = header->num_nodes;
+    snapshot->num_children = header->num_children;
+    if (SnapshotChecksum(snapshot) != header->checksum ||
+        !SnapshotIsConsistent(snapshot)) {
+        TierGraphSnapshotDestroy(snapshot);
+        return kRuntimeError;
+    }
+
+    return kNoError;
+}
+
+// -----------------------------------------------------------------------------
+
+static int Expand(void **buffer, int64_t *capacity, int64_t min_capacity,
+                  size_t item_size) {
+    if (min_capacity <= *capacity) return kNoError;
+
+    int64_t new_capacity = *capacity == 0 ? 16 : *capacity;
+    while (new_capacity < min_capacity) new_capacity *= 2;
+    void *new_buffer = GamesmanRealloc(*buffer, *capacity * item_size,
+                                       new_capacity * item_size);
+    if (new_buffer == NULL) return kMallocFailureError;
+    *buffer = new_buffer;
+    *capacity = new_capacity;
+
+    return kNoError;
+}
+
+// 64-bit FNV-1a over 8-byte words. Sizes are always multiples of 8 bytes.
+static uint64_t Checksum(const void *data, size_t size, uint64_t hash) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash ^= word;
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+static uint64_t SnapshotChecksum(const TierGraphSnapshot *snapshot) {
+    uint64_t hash = 14695981039346656037ULL;
+    hash = Checksum(snapshot->nodes,
+                    snapshot->num_nodes * sizeof(TierGraphSnapshotNode), hash);
+
+    return Checksum(snapshot->children, snapshot->num_children * sizeof(Tier),
+                    hash);
+}
+
+// Checks that the child tier ranges of all nodes lie within the child array,
+// so that a snapshot that passed the checksum can be read without bounds
+// checks.
+static bool SnapshotIsConsistent(const TierGraphSnapshot *snapshot) {
+    for (int64_t i = 0; i < snapshot->num_nodes; ++i) {
+        const TierGraphSnapshotNode *node = &snapshot->nodes[i];
+        if (node->num_children < 0 ||
+            node->num_children > kTierSolverNumChildTiersMax ||
+            node->children_offset < 0 ||
+            node->children_offset + node->num_children >
+                snapshot->num_children) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file tier_graph_snapshot.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Persisted snapshot of the tier graph of a game variant.
+ * @details Building the tier graph calls TierSolverApi::GetChildTiers and
+ * TierSolverApi::GetCanonicalTier on every tier, which takes minutes for games
+ * with millions of tiers. The Tier Manager records the tiers in the order it
+ * visits them, together with their canonical tiers, sizes, types and child
+ * tiers, and saves the record to a snapshot file in the data directory of the
+ * game variant. Later runs map the snapshot file into memory and rebuild the
+ * tier graph from it instead.
+ *
+ * The snapshot file begins with a header identifying the game variant and
+ * checksumming the rest of the file, followed by the array of tiers and the
+ * concatenated array of their child tiers.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_SOLVERS_TIER_SOLVER_TIER_GRAPH_SNAPSHOT_H_
+#define GAMESMANONE_CORE_SOLVERS_TIER_SOLVER_TIER_GRAPH_SNAPSHOT_H_
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // int64_t, int32_t
+
+#include "core/types/gamesman_types.h"
+
+/** @brief A tier in a TierGraphSnapshot. */
+typedef struct TierGraphSnapshotNode {
+    Tier tier;      /**< The tier. */
+    Tier canonical; /**< Canonical tier symmetric to TIER. */
+    int64_t size;   /**< Size of TIER in number of positions. */
+
+    /** Index of the first child tier of TIER in TierGraphSnapshot::children. */
+    int64_t children_offset;
+
+    int32_t num_children;           /**< Number of child tiers. */
+    int32_t num_canonical_children; /**< Number of unique canonical children. */
+    int32_t type;                   /**< TierType of TIER. */
+    int32_t reserved;               /**< Padding, always 0. */
+} TierGraphSnapshotNode;
+
+/** @brief Statistics of the tier graph collected while building it. */
+typedef struct TierGraphSnapshotStats {
+    int64_t total_size;             /**< Total size of canonical tiers. */
+    int64_t total_tiers;            /**< Number of tiers. */
+    int64_t total_canonical_tiers;  /**< Number of canonical tiers. */
+    int64_t max_tier_size;          /**< Size of the largest tier. */
+    Tier largest_tier;              /**< The largest tier. */
+    int64_t max_tier_group_size;    /**< Size of the largest tier group. */
+    Tier largest_tier_group_parent; /**< Parent of the largest tier group. */
+} TierGraphSnapshotStats;
+
+/**
+ * @brief Tiers of a tier graph in the order they were visited while building
+ * it. A snapshot is either being recorded into its own buffers or loaded from a
+ * mapped snapshot file, in which case it is read-only.
+ */
+typedef struct TierGraphSnapshot {
+    /** Statistics of the tier graph. */
+    TierGraphSnapshotStats stats;
+
+    /** Tiers in the order they were visited. */
+    const TierGraphSnapshotNode *nodes;
+
+    /** Child tiers of all tiers, concatenated in the order of NODES. */
+    const Tier *children;
+
+    int64_t num_nodes;    /**< Number of tiers. */
+    int64_t num_children; /**< Length of the CHILDREN array. */
+
+    // Private members.
+    TierGraphSnapshotNode *node_buffer;
+    int64_t node_capacity;
+    Tier *child_buffer;
+    int64_t child_capacity;
+    void *map;
+    size_t map_size;
+} TierGraphSnapshot;
+
+/** @brief Initializes SNAPSHOT to an empty snapshot for recording. */
+void TierGraphSnapshotInit(TierGraphSnapshot *snapshot);
+
+/** @brief Destroys SNAPSHOT, unmapping its snapshot file if it was loaded. */
+void TierGraphSnapshotDestroy(TierGraphSnapshot *snapshot);
+
+/**
+ * @brief Appends NODE with the NODE->num_children child tiers in CHILDREN to
+ * SNAPSHOT. The TierGraphSnapshotNode::children_offset field of NODE is
+ * ignored.
+ *
+ * @return kNoError on success, or
+ * @return kMallocFailureError if out of memory.
+ */
+int TierGraphSnapshotAppend(TierGraphSnapshot *snapshot,
+                            const TierGraphSnapshotNode *node,
+                            const Tier *children);
+
+/**
+ * @brief Writes SNAPSHOT of the tier graph of game GAME_NAME, variant VARIANT
+ * to a snapshot file at PATH, replacing any existing file.
+ *
+ * @return kNoError on success, or
+ * @return non-zero error code otherwise.
+ */
+int TierGraphSnapshotSave(const TierGraphSnapshot *snapshot,
+                          ReadOnlyString path, ReadOnlyString game_name,
+                          int variant);
+
+/**
+ * @brief Maps the snapshot file at PATH into memory and initializes SNAPSHOT
+ * from it.
+ *
+ * @return kNoError on success, or
+ * @return kFileSystemError if the file does not exist or cannot be mapped, or
+ * @return kRuntimeError if the file is corrupt or was created for a different
+ * game variant.
+ */
+int TierGraphSnapshotLoad(TierGraphSnapshot *snapshot, ReadOnlyString path,
+                          ReadOnlyString game_name, int variant);
+
+#endif  // GAMESMANONE_CORE_SOLVERS_TIER_SOLVER_TIER_GRAPH_SNAPSHOT_H_
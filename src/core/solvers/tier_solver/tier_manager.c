@@ -40,15 +40,19 @@
 #include <stdbool.h>   // bool, false
 #include <stddef.h>    // NULL
 #include <stdint.h>    // int64_t
-#include <stdio.h>     // printf, fprintf, stderr
+#include <stdio.h>     // printf, fprintf, stderr, snprintf
+#include <string.h>    // strlen
 #include <time.h>      // time_t, time, difftime
 
 #include "core/analysis/analysis.h"
+#include "core/analysis/stat_manager.h"
+#include "core/concurrency.h"
 #include "core/db/db_manager.h"
 #include "core/gamesman_memory.h"
 #include "core/misc.h"
 #include "core/solvers/tier_solver/reverse_tier_graph.h"
 #include "core/solvers/tier_solver/tier_analyzer.h"
+#include "core/solvers/tier_solver/tier_graph_snapshot.h"
 #include "core/solvers/tier_solver/tier_solver.h"
 #include "core/solvers/tier_solver/tier_worker.h"
 #include "core/types/gamesman_types.h"
@@ -77,6 +81,28 @@ enum TierGraphErrorTypes {
     kTierGraphLoopDetected,
 };
 
+enum {
+    /** Number of tiers expanded in parallel at a time. */
+    kExpandChunkSize = 4096,
+
+    /** Number of ready tiers considered when picking the next tier to solve
+     * with the tier cache enabled. */
+    kReadyTierScanMax = 16,
+};
+
+// Results of the tier API calls on all tiers of the tier graph, in the order
+// ExpandTierGraph() discovered them.
+typedef struct ExpandedTierGraph {
+    // Tiers and their child tiers.
+    TierGraphSnapshot tiers;
+
+    // Size of the tier group of each canonical tier, or -1 if not canonical.
+    Int64Array group_sizes;
+
+    // Index of each tier in TIERS.
+    TierHashMap index_of;
+} ExpandedTierGraph;
+
 // Reference to the API functions from tier_solver.
 static const TierSolverApi *api_internal;
 
@@ -105,6 +131,20 @@ static Tier largest_tier_group_parent;
 // Cached reverse tier graph of the game.
 static ReverseTierGraph reverse_tier_graph;
 
+// Whether the database keeps the child tiers loaded by the solver in memory
+// after each tier is solved. If so, REMAINING_PARENTS maps each canonical tier
+// to the number of canonical parent tiers that have not been processed yet,
+// after which it is evicted from the cache.
+static bool cache_tiers;
+static TierHashMap remaining_parents;
+
+// Tiers recorded while building the tier graph, saved to the snapshot file so
+// that later runs can skip building it.
+static TierGraphSnapshot snapshot;
+static char *snapshot_path;
+static char snapshot_game_name[kGameNameLengthMax + 1];
+static int snapshot_variant;
+
 static int64_t total_size;
 static int64_t total_tiers;
 static int64_t total_canonical_tiers;
@@ -117,22 +157,55 @@ static Analysis game_analysis;
 
 // Helper functions.
 
-static int InitGlobalVariables(int type);
+static int InitGlobalVariables(int type, bool force, bool use_snapshot);
 static TierArray PopParentTiers(Tier child);
 static TierArray GetParentTiers(Tier child);
 static void DestroyGlobalVariables(void);
 
-static int BuildTierGraph(int type);
-static int BuildTierGraphProcessChildren(Tier parent, TierStack *fringe,
+static int LoadTierGraph(int type);
+static bool SnapshotMatchesGame(const TierGraphSnapshot *loaded);
+static int RestoreTierGraph(const TierGraphSnapshot *loaded, int type);
+static void SaveTierGraph(void);
+static int ExpandTierGraph(ExpandedTierGraph *expanded);
+static void ExpandTier(Tier tier, TierGraphSnapshotNode *node,
+                       Tier children[static kTierSolverNumChildTiersMax],
+                       int64_t *group_size);
+static int BuildTierGraph(int type, bool use_snapshot);
+static int64_t GetTierGroupSize(const TierGraphSnapshotNode *node,
+                                const Tier *children);
+static int GetNumCanonicalChildTiers(
+    const Tier children[static kTierSolverNumChildTiersMax],
+    int num_children);
+static void PrintDuplicateChildTiers(
+    Tier parent, const Tier children[static kTierSolverNumChildTiersMax],
+    int num_children);
+static int BuildTierGraphProcessChildren(ExpandedTierGraph *expanded,
+                                         Tier parent, TierStack *fringe,
                                          int type);
-static void BuildTierGraphUpdateAnalysis(Tier parent);
+static void BuildTierGraphUpdateAnalysis(const TierGraphSnapshotNode *node,
+                                         int64_t group_size);
+static void FinishTierGraph(int type);
 static int EnqueuePrimitiveTiers(void);
 static void CreateTierGraphPrintError(int error);
 
 #ifndef USE_MPI
-static int SolveTierGraph(bool force, int verbose);
+static int SolveTierGraph(const TierSolverSolveOptions *options,
+                          intptr_t memlimit, intptr_t flush_budget,
+                          intptr_t cache_budget);
+static int DiscoverReachablePositions(int verbose, intptr_t memlimit);
+static int64_t CountCanonicalParentTiers(TierHashMap *num_parents);
+static void RemoveReachableMaps(void);
+static bool ReleaseFlushedTiers(bool wait, bool reachable_only,
+                                double *time_elapsed);
+static void EnableTierCache(intptr_t cache_budget, int verbose);
+static void DisableTierCache(void);
+static int GetCanonicalChildTiers(Tier parent,
+                                  Tier children[kTierSolverNumChildTiersMax]);
+static Tier PopReadyTier(void);
+static int64_t GetCachedChildSize(Tier tier);
+static void ReleaseChildTiers(Tier parent);
 #else   // USE_MPI
-static int SolveTierGraphMpi(bool force, int verbose);
+static int SolveTierGraphMpi(bool force, int verbose, bool subgame);
 static void SolveTierGraphMpiTerminateWorkers(void);
 static void SolveTierGraphMpiSolveAll(time_t begin_time, bool force,
                                       int verbose);
@@ -157,6 +230,7 @@ static bool TierGraphSetNumTiers(Tier tier, int num_tiers);
 static bool IncrementNumParentTiers(Tier tier);
 
 static bool IsCanonicalTier(Tier tier);
+static int GetCanonicalTiers(TierArray *tiers, Int64Array *sizes);
 
 static int DiscoverTierGraph(bool force, int verbose, intptr_t memlimit);
 static void PrintAnalyzed(Tier tier, const Analysis *analysis, int verbose);
@@ -169,10 +243,42 @@ static void PrintTestResult(double time_elapsed);
 
 // -----------------------------------------------------------------------------
 
-int TierManagerSolve(const TierSolverApi *api, bool force, int verbose) {
+int TierManagerInit(ReadOnlyString game_name, int variant,
+                    ReadOnlyString data_path) {
+    TierManagerFinalize();
+    if (strlen(game_name) > kGameNameLengthMax) return kIllegalArgumentError;
+
+    // path = "<data_path>/<game_name>/<variant>/tier_graph.snapshot"
+    static ConstantReadOnlyString kSnapshotFileName = "tier_graph.snapshot";
+    if (data_path == NULL) data_path = "data";
+    int path_length = (int)strlen(data_path) + 1;  // +1 for '/'.
+    path_length += (int)strlen(game_name) + 1;
+    path_length += kInt32Base10StringLengthMax + 1;
+    path_length += (int)strlen(kSnapshotFileName) + 1;  // +1 for '\0'.
+    snapshot_path = (char *)GamesmanMalloc(path_length);
+    if (snapshot_path == NULL) return kMallocFailureError;
+    snprintf(snapshot_path, path_length, "%s/%s/%d/%s", data_path, game_name,
+             variant, kSnapshotFileName);
+    SafeStrncpy(snapshot_game_name, game_name, sizeof(snapshot_game_name));
+    snapshot_variant = variant;
+
+    return kNoError;
+}
+
+void TierManagerFinalize(void) {
+    GamesmanFree(snapshot_path);
+    snapshot_path = NULL;
+}
+
+int TierManagerSolve(const TierSolverApi *api,
+                     const TierSolverSolveOptions *options, intptr_t memlimit,
+                     intptr_t flush_budget, intptr_t cache_budget) {
     time_t begin = time(NULL);
     api_internal = api;
-    int error = InitGlobalVariables(kTierSolving);
+    bool force = options->force;
+    int verbose = options->verbose;
+    // The snapshot only holds the tier graph rooted at the initial tier.
+    int error = InitGlobalVariables(kTierSolving, force, !options->subgame);
     if (error != 0) {
         fprintf(stderr,
                 "TierManagerSolve: initialization failed with code %d.\n",
@@ -181,9 +287,12 @@ int TierManagerSolve(const TierSolverApi *api, bool force, int verbose) {
     }
 
 #ifndef USE_MPI  // If not using MPI
-    int ret = SolveTierGraph(force, verbose);
+    int ret = SolveTierGraph(options, memlimit, flush_budget, cache_budget);
 #else   // Using MPI
-    int ret = SolveTierGraphMpi(force, verbose);
+    (void)memlimit;      // Worker processes have their own memory limits.
+    (void)flush_budget;  // Worker processes flush their own tiers.
+    (void)cache_budget;  // Worker processes load their own tiers.
+    int ret = SolveTierGraphMpi(force, verbose, options->subgame);
 #endif  // USE_MPI
     DestroyGlobalVariables();
 
@@ -198,7 +307,7 @@ int TierManagerSolve(const TierSolverApi *api, bool force, int verbose) {
 int TierManagerAnalyze(const TierSolverApi *api, bool force, int verbose,
                        intptr_t memlimit) {
     api_internal = api;
-    int error = InitGlobalVariables(kTierAnalyzing);
+    int error = InitGlobalVariables(kTierAnalyzing, force, true);
     if (error != 0) {
         fprintf(stderr,
                 "TierManagerAnalyze: initialization failed with code %d.\n",
@@ -214,7 +323,7 @@ int TierManagerAnalyze(const TierSolverApi *api, bool force, int verbose,
 
 int TierManagerTest(const TierSolverApi *api, long seed, int64_t test_size) {
     api_internal = api;
-    int error = InitGlobalVariables(kTierSolving);
+    int error = InitGlobalVariables(kTierSolving, false, true);
     if (error != 0) {
         fprintf(stderr,
                 "TierManagerTest: initialization failed with code %d.\n",
@@ -229,9 +338,82 @@ int TierManagerTest(const TierSolverApi *api, long seed, int64_t test_size) {
     return ret;
 }
 
+int TierManagerRebuildDbManifest(const TierSolverApi *api, int verbose) {
+    api_internal = api;
+    int error = InitGlobalVariables(kTierSolving, false, true);
+    if (error != 0) {
+        fprintf(stderr,
+                "TierManagerRebuildDbManifest: initialization failed with code "
+                "%d.\n",
+                error);
+        return error;
+    }
+
+    TierArray tiers;
+    Int64Array sizes;
+    error = GetCanonicalTiers(&tiers, &sizes);
+    if (error == kNoError) {
+        if (verbose > 0) {
+            printf("Rebuilding the database manifest from the files of %" PRId64
+                   " canonical tiers...\n",
+                   tiers.size);
+        }
+        error = DbManagerRebuildTierManifest(tiers.size, tiers.array,
+                                             sizes.array);
+    }
+    TierArrayDestroy(&tiers);
+    Int64ArrayDestroy(&sizes);
+    DestroyGlobalVariables();
+    if (error != kNoError) {
+        fprintf(stderr,
+                "TierManagerRebuildDbManifest: failed to rebuild the database "
+                "manifest (code %d)\n",
+                error);
+    } else if (verbose > 0) {
+        printf("Database manifest rebuilt.\n");
+    }
+
+    return error;
+}
+
+int TierManagerPackDb(const TierSolverApi *api, int verbose) {
+    api_internal = api;
+    int error = InitGlobalVariables(kTierSolving, false, true);
+    if (error != 0) {
+        fprintf(stderr,
+                "TierManagerPackDb: initialization failed with code %d.\n",
+                error);
+        return error;
+    }
+
+    TierArray tiers;
+    Int64Array sizes;
+    error = GetCanonicalTiers(&tiers, &sizes);
+    if (error == kNoError) {
+        if (verbose > 0) {
+            printf("Packing the database files of %" PRId64
+                   " canonical tiers...\n",
+                   tiers.size);
+        }
+        error = DbManagerPackTiers(tiers.size, tiers.array);
+    }
+    TierArrayDestroy(&tiers);
+    Int64ArrayDestroy(&sizes);
+    DestroyGlobalVariables();
+    if (error != kNoError) {
+        fprintf(stderr,
+                "TierManagerPackDb: failed to pack the database (code %d)\n",
+                error);
+    } else if (verbose > 0) {
+        printf("Database packed.\n");
+    }
+
+    return error;
+}
+
 // -----------------------------------------------------------------------------
 
-static int InitGlobalVariables(int type) {
+static int InitGlobalVariables(int type, bool force, bool use_snapshot) {
     max_tier_size = -1;
     largest_tier = kIllegalTier;
     max_tier_group_size = -1;
@@ -252,7 +434,13 @@ static int InitGlobalVariables(int type) {
         AnalysisSetHashSize(&game_analysis, 0);
     }
 
-    return BuildTierGraph(type);
+    // The snapshot is not trusted when forced, in case the tier graph of the
+    // game has changed since it was saved.
+    if (use_snapshot && !force && LoadTierGraph(type) == kNoError) {
+        return kNoError;
+    }
+
+    return BuildTierGraph(type, use_snapshot);
 }
 
 static TierArray PopParentTiers(Tier child) {
@@ -264,22 +452,283 @@ static TierArray GetParentTiers(Tier child) {
 }
 
 static void DestroyGlobalVariables(void) {
+    TierGraphSnapshotDestroy(&snapshot);
     TierHashMapDestroy(&tier_graph);
     ReverseTierGraphDestroy(&reverse_tier_graph);
     TierQueueDestroy(&pending_tiers);
 }
 
+/**
+ * @brief Rebuilds the tier graph from the snapshot file saved by a previous
+ * run, without calling any tier API functions except on the initial tier.
+ */
+static int LoadTierGraph(int type) {
+    if (snapshot_path == NULL) return kUseBeforeInitializationError;
+
+    TierGraphSnapshot loaded;
+    int error = TierGraphSnapshotLoad(&loaded, snapshot_path,
+                                      snapshot_game_name, snapshot_variant);
+    if (error == kFileSystemError) return error;  // No snapshot saved yet.
+    if (error == kNoError && !SnapshotMatchesGame(&loaded)) {
+        TierGraphSnapshotDestroy(&loaded);
+        error = kRuntimeError;
+    }
+    if (error == kNoError) {
+        error = RestoreTierGraph(&loaded, type);
+        TierGraphSnapshotDestroy(&loaded);
+    }
+    if (error != kNoError) {
+        printf("Ignoring invalid tier graph snapshot [%s]\n", snapshot_path);
+        TierHashMapDestroy(&tier_graph);
+        ReverseTierGraphDestroy(&reverse_tier_graph);
+        TierHashMapInit(&tier_graph, 0.5);
+        ReverseTierGraphInit(&reverse_tier_graph);
+        return error;
+    }
+    FinishTierGraph(type);
+
+    return kNoError;
+}
+
+/**
+ * @brief Returns whether the initial tier recorded in the \p loaded snapshot
+ * still agrees with the game. This catches snapshots of a different tier
+ * graph, but not changes to tiers deeper in the graph, which require a forced
+ * re-solve anyway.
+ */
+static bool SnapshotMatchesGame(const TierGraphSnapshot *loaded) {
+    if (loaded->num_nodes == 0) return false;
+
+    const TierGraphSnapshotNode *node = &loaded->nodes[0];
+    Tier children[kTierSolverNumChildTiersMax];
+    if (node->tier != api_internal->GetInitialTier() ||
+        node->canonical != api_internal->GetCanonicalTier(node->tier) ||
+        node->size != api_internal->GetTierSize(node->tier) ||
+        node->num_children != api_internal->GetChildTiers(node->tier,
+                                                          children)) {
+        return false;
+    }
+    const Tier *recorded = &loaded->children[node->children_offset];
+    for (int i = 0; i < node->num_children; ++i) {
+        if (recorded[i] != children[i]) return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Replays the tiers in the \p loaded snapshot in the order
+ * BuildTierGraph() visited them, which reproduces the same tier graph, reverse
+ * tier graph and hash map layout.
+ */
+static int RestoreTierGraph(const TierGraphSnapshot *loaded, int type) {
+    int64_t num_discovered = 1;
+    if (!TierGraphSetInitial(loaded->nodes[0].tier)) {
+        return kMallocFailureError;
+    }
+    for (int64_t i = 0; i < loaded->num_nodes; ++i) {
+        const TierGraphSnapshotNode *node = &loaded->nodes[i];
+        const Tier *children = &loaded->children[node->children_offset];
+        for (int j = 0; j < node->num_children; ++j) {
+            if (TierHashMapContains(&tier_graph, children[j])) continue;
+            if (!TierGraphSetInitial(children[j])) return kMallocFailureError;
+            ++num_discovered;
+        }
+
+        if (type == kTierSolving) {
+            if (!TierGraphSetNumTiers(node->tier,
+                                      node->num_canonical_children)) {
+                return kMallocFailureError;
+            }
+        } else {  // type == kTierAnalyzing
+            for (int j = 0; j < node->num_children; ++j) {
+                if (!IncrementNumParentTiers(children[j])) {
+                    return kMallocFailureError;
+                }
+            }
+        }
+
+        for (int j = 0; j < node->num_children; ++j) {
+            if (ReverseTierGraphAdd(&reverse_tier_graph, children[j],
+                                    node->tier) != 0) {
+                return kMallocFailureError;
+            }
+        }
+    }
+
+    // Every discovered tier must have been visited exactly once.
+    if (num_discovered != loaded->num_nodes) return kRuntimeError;
+    for (int64_t i = 0; i < loaded->num_nodes; ++i) {
+        if (GetStatus(loaded->nodes[i].tier) != kStatusNotVisited) {
+            return kRuntimeError;
+        }
+        if (!TierGraphSetStatus(loaded->nodes[i].tier, kStatusClosed)) {
+            return kMallocFailureError;
+        }
+    }
+
+    const TierGraphSnapshotStats *stats = &loaded->stats;
+    total_size = stats->total_size;
+    total_tiers = stats->total_tiers;
+    total_canonical_tiers = stats->total_canonical_tiers;
+    max_tier_size = stats->max_tier_size;
+    largest_tier = stats->largest_tier;
+    max_tier_group_size = stats->max_tier_group_size;
+    largest_tier_group_parent = stats->largest_tier_group_parent;
+
+    return kNoError;
+}
+
+/**
+ * @brief Saves the tiers recorded by BuildTierGraph() to the snapshot file.
+ * Failing to save the snapshot is not an error.
+ */
+static void SaveTierGraph(void) {
+    if (snapshot_path != NULL) {
+        snapshot.stats = (TierGraphSnapshotStats){
+            .total_size = total_size,
+            .total_tiers = total_tiers,
+            .total_canonical_tiers = total_canonical_tiers,
+            .max_tier_size = max_tier_size,
+            .largest_tier = largest_tier,
+            .max_tier_group_size = max_tier_group_size,
+            .largest_tier_group_parent = largest_tier_group_parent,
+        };
+        int error = TierGraphSnapshotSave(&snapshot, snapshot_path,
+                                          snapshot_game_name, snapshot_variant);
+        if (error != kNoError) {
+            fprintf(stderr,
+                    "SaveTierGraph: failed to save tier graph snapshot to "
+                    "[%s]\n",
+                    snapshot_path);
+        }
+    }
+    TierGraphSnapshotDestroy(&snapshot);
+}
+
+/**
+ * @brief Calls the tier API on every tier reachable from the initial tier,
+ * caching the results in \p expanded.
+ *
+ * @details Level-synchronous BFS. The tiers of each level are expanded in
+ * parallel in chunks of kExpandChunkSize, and their children are then merged
+ * into the next level serially, so the set of discovered tiers does not depend
+ * on the number of threads. Loops in the tier graph are not detected here.
+ */
+static int ExpandTierGraph(ExpandedTierGraph *expanded) {
+    int ret = kTierGraphOutOfMemory;
+    TierArray fringe, next;
+    TierArrayInit(&fringe);
+    TierArrayInit(&next);
+    TierGraphSnapshotNode *nodes = (TierGraphSnapshotNode *)GamesmanMalloc(
+        kExpandChunkSize * sizeof(TierGraphSnapshotNode));
+    Tier *children = (Tier *)GamesmanMalloc(
+        kExpandChunkSize * kTierSolverNumChildTiersMax * sizeof(Tier));
+    int64_t *group_sizes =
+        (int64_t *)GamesmanMalloc(kExpandChunkSize * sizeof(int64_t));
+    if (nodes == NULL || children == NULL || group_sizes == NULL) {
+        goto _bailout;
+    }
+
+    Tier initial_tier = api_internal->GetInitialTier();
+    if (!TierHashMapSet(&expanded->index_of, initial_tier, -1)) goto _bailout;
+    if (!TierArrayAppend(&fringe, initial_tier)) goto _bailout;
+    while (fringe.size > 0) {
+        for (int64_t begin = 0; begin < fringe.size;
+             begin += kExpandChunkSize) {
+            int64_t n = fringe.size - begin;
+            if (n > kExpandChunkSize) n = kExpandChunkSize;
+
+            PRAGMA_OMP_PARALLEL_FOR_SCHEDULE_DYNAMIC(1)
+            for (int64_t i = 0; i < n; ++i) {
+                ExpandTier(fringe.array[begin + i], &nodes[i],
+                           &children[i * kTierSolverNumChildTiersMax],
+                           &group_sizes[i]);
+            }
+
+            for (int64_t i = 0; i < n; ++i) {
+                const Tier *this_children =
+                    &children[i * kTierSolverNumChildTiersMax];
+                int64_t index = expanded->tiers.num_nodes;
+                if (!TierHashMapSet(&expanded->index_of, nodes[i].tier,
+                                    index) ||
+                    TierGraphSnapshotAppend(&expanded->tiers, &nodes[i],
+                                            this_children) != kNoError ||
+                    !Int64ArrayPushBack(&expanded->group_sizes,
+                                        group_sizes[i])) {
+                    goto _bailout;
+                }
+                for (int j = 0; j < nodes[i].num_children; ++j) {
+                    Tier child = this_children[j];
+                    if (TierHashMapContains(&expanded->index_of, child)) {
+                        continue;
+                    }
+                    if (!TierHashMapSet(&expanded->index_of, child, -1) ||
+                        !TierArrayAppend(&next, child)) {
+                        goto _bailout;
+                    }
+                }
+            }
+        }
+        TierArray tmp = fringe;
+        fringe = next;
+        next = tmp;
+        next.size = 0;
+    }
+    ret = kTierGraphNoError;
+
+_bailout:
+    TierArrayDestroy(&fringe);
+    TierArrayDestroy(&next);
+    GamesmanFree(nodes);
+    GamesmanFree(children);
+    GamesmanFree(group_sizes);
+
+    return ret;
+}
+
+/**
+ * @brief Calls the tier API on \p tier and stores the results in \p node,
+ * \p children and \p group_size. Safe to call from multiple threads.
+ */
+static void ExpandTier(Tier tier, TierGraphSnapshotNode *node,
+                       Tier children[static kTierSolverNumChildTiersMax],
+                       int64_t *group_size) {
+    *node = (TierGraphSnapshotNode){
+        .tier = tier,
+        .canonical = api_internal->GetCanonicalTier(tier),
+        .size = api_internal->GetTierSize(tier),
+        .type = api_internal->GetTierType(tier),
+    };
+    node->num_children = api_internal->GetChildTiers(tier, children);
+    node->num_canonical_children =
+        GetNumCanonicalChildTiers(children, node->num_children);
+    *group_size = node->canonical == tier ? GetTierGroupSize(node, children)
+                                          : -1;
+}
+
 /**
  * @brief DFS from initial tier with loop detection.
  *
  * @details Iterative topological sort using DFS and node coloring (status
- * marking). Algorithm by Ctrl, stackoverflow.com.
+ * marking). Algorithm by Ctrl, stackoverflow.com. The tier API is called by
+ * ExpandTierGraph() in parallel beforehand, so the DFS itself only does
+ * bookkeeping.
  * @link https://stackoverflow.com/a/73210346
  */
-static int BuildTierGraph(int type) {
+static int BuildTierGraph(int type, bool use_snapshot) {
     int ret = 1;
     TierStack fringe;
     TierStackInit(&fringe);
+    TierGraphSnapshotInit(&snapshot);
+    ExpandedTierGraph expanded;
+    TierGraphSnapshotInit(&expanded.tiers);
+    Int64ArrayInit(&expanded.group_sizes);
+    TierHashMapInit(&expanded.index_of, 0.5);
+    ret = ExpandTierGraph(&expanded);
+    if (ret != kTierGraphNoError) goto _bailout;
+
+    ret = 1;
     Tier initial_tier = api_internal->GetInitialTier();
     if (!TierStackPush(&fringe, initial_tier)) goto _bailout;
     if (!TierGraphSetInitial(initial_tier)) goto _bailout;
@@ -296,7 +745,8 @@ static int BuildTierGraph(int type) {
             continue;
         }
         if (!TierGraphSetStatus(parent, kStatusInProgress)) goto _bailout;
-        int error = BuildTierGraphProcessChildren(parent, &fringe, type);
+        int error =
+            BuildTierGraphProcessChildren(&expanded, parent, &fringe, type);
         if (error != kTierGraphNoError) {
             ret = error;
             goto _bailout;
@@ -306,59 +756,64 @@ static int BuildTierGraph(int type) {
 
 _bailout:
     TierStackDestroy(&fringe);
+    TierGraphSnapshotDestroy(&expanded.tiers);
+    Int64ArrayDestroy(&expanded.group_sizes);
+    TierHashMapDestroy(&expanded.index_of);
     if (ret != 0) {
+        TierGraphSnapshotDestroy(&snapshot);
         TierHashMapDestroy(&tier_graph);
         ReverseTierGraphDestroy(&reverse_tier_graph);
         CreateTierGraphPrintError(ret);
-    } else if (type == kTierSolving) {
-        EnqueuePrimitiveTiers();
-    } else {  // type == kTierAnalyzing
-        TierQueuePush(&pending_tiers, initial_tier);
+    } else {
+        if (use_snapshot) SaveTierGraph();
+        FinishTierGraph(type);
     }
 
     return ret;
 }
 
 /**
- * @brief Returns an array of unique canonical child tiers of tier \p parent.
- * Uniqueness enforced through deduplication of child tiers that are symmetric
- * to each other.
+ * @brief Returns the number of positions in the group of tiers consisting of
+ * canonical tier \p node and either all of its canonical child tiers or its
+ * largest canonical child tier, depending on its type. Children that are
+ * symmetric to each other are counted once.
  */
-static int GetCanonicalChildTiers(
-    Tier parent, Tier child_tiers[static kTierSolverNumChildTiersMax]) {
-    //
-    int ret = 0;
+static int64_t GetTierGroupSize(const TierGraphSnapshotNode *node,
+                                const Tier *children) {
+    int64_t ret = node->size;
+    int64_t largest_child_size = 0;
     TierHashSet dedup;
     TierHashSetInit(&dedup, 0.5);
-    Tier raw[kTierSolverNumChildTiersMax];
-    int num_raw = api_internal->GetChildTiers(parent, raw);
-    for (int i = 0; i < num_raw; ++i) {
-        Tier canonical = api_internal->GetCanonicalTier(raw[i]);
-        if (!TierHashSetContains(&dedup, canonical)) {
-            TierHashSetAdd(&dedup, canonical);
-            child_tiers[ret++] = canonical;
+    for (int i = 0; i < node->num_children; ++i) {
+        Tier canonical = api_internal->GetCanonicalTier(children[i]);
+        if (TierHashSetContains(&dedup, canonical)) continue;
+        TierHashSetAdd(&dedup, canonical);
+
+        int64_t this_child_size = api_internal->GetTierSize(canonical);
+        if (node->type != kTierTypeImmediateTransition) {
+            ret += this_child_size;
+        } else if (this_child_size > largest_child_size) {
+            largest_child_size = this_child_size;
         }
     }
     TierHashSetDestroy(&dedup);
 
-    return ret;
+    return ret + largest_child_size;
 }
 
 /**
- * @brief Returns the number of unique canonical child tiers of tier \p parent
- * in the array of tier \p children, or -1 if there is a duplicate in
- * \p children.
+ * @brief Returns the number of unique canonical child tiers in the array of
+ * tier \p children, or -1 if there is a duplicate in \p children.
  */
 static int GetNumCanonicalChildTiers(
-    Tier parent, const Tier children[static kTierSolverNumChildTiersMax],
+    const Tier children[static kTierSolverNumChildTiersMax],
     int num_children) {
     //
     int ret = 0;
     TierHashSet dedup, canonical_dedup;
     TierHashSetInit(&dedup, 0.5);
     TierHashSetInit(&canonical_dedup, 0.5);
-    int i;
-    for (i = 0; i < num_children; ++i) {  // For each child
+    for (int i = 0; i < num_children; ++i) {  // For each child
         if (TierHashSetContains(&dedup, children[i])) {
             ret = -1;
             break;
@@ -374,44 +829,69 @@ static int GetNumCanonicalChildTiers(
     TierHashSetDestroy(&dedup);
     TierHashSetDestroy(&canonical_dedup);
 
-    if (ret < 0) {
-        char name[kDbFileNameLengthMax + 1];
-        api_internal->GetTierName(parent, name);
-        printf("ERROR: tier [%s] (#%" PRITier
-               ") contains duplicate tier children\n",
-               name, parent);
-        api_internal->GetTierName(children[i], name);
-        printf("The duplicated child tier is [%s] (#%" PRITier ")\n", name,
-               children[i]);
-        printf("List of all child tiers:\n");
-        for (int j = 0; j < num_children; ++j) {
-            api_internal->GetTierName(children[j], name);
-            printf("[%s] (#%" PRITier ")\n", name, children[j]);
-        }
-        printf("\n");
+    return ret;
+}
+
+/**
+ * @brief Prints the first duplicate in the array of child tiers \p children of
+ * tier \p parent.
+ */
+static void PrintDuplicateChildTiers(
+    Tier parent, const Tier children[static kTierSolverNumChildTiersMax],
+    int num_children) {
+    //
+    TierHashSet dedup;
+    TierHashSetInit(&dedup, 0.5);
+    int i;
+    for (i = 0; i < num_children; ++i) {
+        if (TierHashSetContains(&dedup, children[i])) break;
+        TierHashSetAdd(&dedup, children[i]);
     }
+    TierHashSetDestroy(&dedup);
 
-    return ret;
+    char name[kDbFileNameLengthMax + 1];
+    api_internal->GetTierName(parent, name);
+    printf("ERROR: tier [%s] (#%" PRITier
+           ") contains duplicate tier children\n",
+           name, parent);
+    api_internal->GetTierName(children[i], name);
+    printf("The duplicated child tier is [%s] (#%" PRITier ")\n", name,
+           children[i]);
+    printf("List of all child tiers:\n");
+    for (int j = 0; j < num_children; ++j) {
+        api_internal->GetTierName(children[j], name);
+        printf("[%s] (#%" PRITier ")\n", name, children[j]);
+    }
+    printf("\n");
 }
 
-static int BuildTierGraphProcessChildren(Tier parent, TierStack *fringe,
+static int BuildTierGraphProcessChildren(ExpandedTierGraph *expanded,
+                                         Tier parent, TierStack *fringe,
                                          int type) {
+    TierHashMapIterator it = TierHashMapGet(&expanded->index_of, parent);
+    int64_t index = TierHashMapIteratorValue(&it);
+    const TierGraphSnapshotNode *node = &expanded->tiers.nodes[index];
+    const Tier *children = &expanded->tiers.children[node->children_offset];
+    int num_children = node->num_children;
+
     // Add tier size to total if it is canonical.
     ++total_tiers;
-    if (IsCanonicalTier(parent)) {
+    if (node->canonical == parent) {
         ++total_canonical_tiers;
-        total_size += api_internal->GetTierSize(parent);
+        total_size += node->size;
     }
 
-    Tier children[kTierSolverNumChildTiersMax];
-    int num_children = api_internal->GetChildTiers(parent, children);
-    BuildTierGraphUpdateAnalysis(parent);
-    int num_canonical_tier_children =
-        GetNumCanonicalChildTiers(parent, children, num_children);
-    if (num_canonical_tier_children < 0) return kIllegalGameTierGraphError;
+    BuildTierGraphUpdateAnalysis(node, expanded->group_sizes.array[index]);
+    if (node->num_canonical_children < 0) {
+        PrintDuplicateChildTiers(parent, children, num_children);
+        return kIllegalGameTierGraphError;
+    }
+    if (TierGraphSnapshotAppend(&snapshot, node, children) != kNoError) {
+        return kTierGraphOutOfMemory;
+    }
 
     if (type == kTierSolving) {
-        if (!TierGraphSetNumTiers(parent, num_canonical_tier_children)) {
+        if (!TierGraphSetNumTiers(parent, node->num_canonical_children)) {
             return kTierGraphOutOfMemory;
         }
     } else {  // type == kTierAnalyzing
@@ -442,41 +922,31 @@ static int BuildTierGraphProcessChildren(Tier parent, TierStack *fringe,
     return kTierGraphNoError;
 }
 
-static void BuildTierGraphUpdateAnalysis(Tier parent) {
+static void BuildTierGraphUpdateAnalysis(const TierGraphSnapshotNode *node,
+                                         int64_t group_size) {
     // If the parent tier is not canonical, then it is never solved.
     // So, there is no need to consider it in the analysis.
-    if (!IsCanonicalTier(parent)) return;
+    if (node->canonical != node->tier) return;
 
     // Check if this is the largest tier.
-    int64_t total_size = api_internal->GetTierSize(parent);
-    if (total_size > max_tier_size) {
-        max_tier_size = total_size;
-        largest_tier = parent;
+    if (node->size > max_tier_size) {
+        max_tier_size = node->size;
+        largest_tier = node->tier;
     }
 
     // Check if this is the largest group of tiers.
-    Tier canonical_children[kTierSolverNumChildTiersMax];
-    int num_canonical_children =
-        GetCanonicalChildTiers(parent, canonical_children);
-    if (api_internal->GetTierType(parent) == kTierTypeImmediateTransition) {
-        int64_t largest_child_size = 0;
-        for (int i = 0; i < num_canonical_children; ++i) {
-            int64_t this_child_size =
-                api_internal->GetTierSize(canonical_children[i]);
-            if (this_child_size > largest_child_size) {
-                largest_child_size = this_child_size;
-            }
-        }
-        total_size += largest_child_size;
-    } else {
-        for (int i = 0; i < num_canonical_children; ++i) {
-            total_size += api_internal->GetTierSize(canonical_children[i]);
-        }
+    if (group_size > max_tier_group_size) {
+        max_tier_group_size = group_size;
+        largest_tier_group_parent = node->tier;
     }
+}
 
-    if (total_size > max_tier_group_size) {
-        max_tier_group_size = total_size;
-        largest_tier_group_parent = parent;
+/** @brief Enqueues the tiers that are ready to be solved or analyzed. */
+static void FinishTierGraph(int type) {
+    if (type == kTierSolving) {
+        EnqueuePrimitiveTiers();
+    } else {  // type == kTierAnalyzing
+        TierQueuePush(&pending_tiers, api_internal->GetInitialTier());
     }
 }
 
@@ -519,12 +989,27 @@ static void CreateTierGraphPrintError(int error) {
 
 #ifndef USE_MPI
 
-static int SolveTierGraph(bool force, int verbose) {
-    TierWorkerSolveOptions options = {
+static int SolveTierGraph(const TierSolverSolveOptions *options,
+                          intptr_t memlimit, intptr_t flush_budget,
+                          intptr_t cache_budget) {
+    int verbose = options->verbose;
+    TierWorkerSolveOptions worker_options = {
         .compare = false,
-        .force = force,
+        .force = options->force,
         .verbose = verbose,
+        .histogram = options->histograms,
+        .reachable_only = options->reachable_only,
     };
+    if (worker_options.reachable_only) {
+        int error = DiscoverReachablePositions(verbose, memlimit);
+        if (error != kNoError) {
+            printf("Solving all legal positions, as the reachable positions "
+                   "could not be discovered (code %d)\n",
+                   error);
+            worker_options.reachable_only = false;
+        }
+    }
+
     double time_elapsed = 0.0;
     if (verbose > 0) {
         printf("Begin solving all %" PRId64 " tiers (%" PRId64
@@ -532,16 +1017,43 @@ static int SolveTierGraph(bool force, int verbose) {
                total_tiers, total_canonical_tiers, total_size);
     }
 
-    while (!TierQueueEmpty(&pending_tiers)) {
-        Tier tier = TierQueuePop(&pending_tiers);
+    bool async_flush = false;
+    if (flush_budget > 0) {
+        int error = DbManagerSetAsyncFlush(flush_budget);
+        async_flush = (error == kNoError);
+        if (!async_flush && verbose > 0) {
+            printf("Flushing tiers in the foreground (code %d)\n", error);
+        }
+    }
+    if (cache_budget > 0) EnableTierCache(cache_budget, verbose);
+
+    while (true) {
+        // Wait for a pending flush only if there is nothing else to solve, and
+        // finish only after every pending flush has been released.
+        if (async_flush) {
+            bool idle = TierQueueEmpty(&pending_tiers);
+            bool released = ReleaseFlushedTiers(
+                idle, worker_options.reachable_only, &time_elapsed);
+            if (released && idle) continue;
+        }
+        if (TierQueueEmpty(&pending_tiers)) break;
+
+        Tier tier = PopReadyTier();
         if (IsCanonicalTier(tier)) {  // Only solve canonical tiers.
             time_t begin = time(NULL);
             bool solved;
             TierType type = api_internal->GetTierType(tier);
             int error = TierWorkerSolve(GetMethodForTierType(type), tier,
-                                        &options, &solved);
-            if (error == 0) {
-                // Solve succeeded.
+                                        &worker_options, &solved);
+            if (cache_tiers) ReleaseChildTiers(tier);
+            if (error == 0 && async_flush && solved) {
+                // Parent tiers are released once the tier has been flushed.
+            } else if (error == 0) {
+                // Solve succeeded. A tier stored with all of its legal
+                // positions solved is no longer restricted.
+                if (solved && !worker_options.reachable_only) {
+                    StatManagerRemoveRestrictedMark(tier);
+                }
                 SolveUpdateTierGraph(tier);
                 ++processed_tiers;
             } else {
@@ -556,8 +1068,14 @@ static int SolveTierGraph(bool force, int verbose) {
             ++skipped_tiers;
         }
     }
+    if (async_flush) DbManagerSetAsyncFlush(0);
+    if (cache_tiers) DisableTierCache();
     if (verbose > 0) PrintSolverResult(time_elapsed);
-    if (failed_tiers == 0) {
+
+    // Solving a subgame or only the reachable positions leaves the rest of the
+    // game unsolved.
+    if (failed_tiers == 0 && !options->subgame &&
+        !worker_options.reachable_only) {
         int error = DbManagerSetGameSolved();
         if (error != kNoError) {
             fprintf(stderr,
@@ -571,9 +1089,271 @@ static int SolveTierGraph(bool force, int verbose) {
     return kNoError;
 }
 
+/**
+ * @brief Discovers the positions reachable from the initial position and saves
+ * the reachable map of each canonical tier for the tier workers. Canonical
+ * tiers are discovered parents first, so that each tier has received the
+ * positions discovered in all of its parent tiers. The reachable maps are
+ * removed on failure, as those of the tiers below the failed tier would miss
+ * positions.
+ */
+static int DiscoverReachablePositions(int verbose, intptr_t memlimit) {
+    TierHashMap num_parents;
+    TierHashMapInit(&num_parents, 0.5);
+    TierQueue ready;
+    TierQueueInit(&ready);
+    int64_t num_remaining = CountCanonicalParentTiers(&num_parents);
+    int error = kMallocFailureError;
+    if (num_remaining < 0) goto _bailout;
+    if (!TierAnalyzerInit(api_internal, memlimit)) goto _bailout;
+
+    if (verbose > 0) {
+        printf("Discovering reachable positions in %" PRId64
+               " canonical tiers... ",
+               num_remaining);
+        fflush(stdout);
+    }
+    Tier initial =
+        api_internal->GetCanonicalTier(api_internal->GetInitialTier());
+    if (!TierQueuePush(&ready, initial)) goto _finalize;
+    while (!TierQueueEmpty(&ready)) {
+        Tier tier = TierQueuePop(&ready);
+        error = TierAnalyzerDiscover(tier);
+        if (error != kNoError) goto _finalize;
+        --num_remaining;
+
+        Tier children[kTierSolverNumChildTiersMax];
+        int num_children = GetCanonicalChildTiers(tier, children);
+        for (int i = 0; i < num_children; ++i) {
+            TierHashMapIterator it = TierHashMapGet(&num_parents, children[i]);
+            int64_t remaining = TierHashMapIteratorValue(&it) - 1;
+            TierHashMapSet(&num_parents, children[i], remaining);
+            if (remaining == 0 && !TierQueuePush(&ready, children[i])) {
+                error = kMallocFailureError;
+                goto _finalize;
+            }
+        }
+    }
+
+    // Tiers left undiscovered are in a loop of symmetric tiers.
+    error = (num_remaining == 0) ? kNoError : kIllegalGameTierGraphError;
+    if (verbose > 0 && error == kNoError) printf("done\n");
+
+_finalize:
+    TierAnalyzerFinalize();
+
+_bailout:
+    TierQueueDestroy(&ready);
+    TierHashMapDestroy(&num_parents);
+    if (error != kNoError) RemoveReachableMaps();
+
+    return error;
+}
+
+/**
+ * @brief Sets the number of distinct canonical parent tiers of each canonical
+ * tier in NUM_PARENTS and returns the number of canonical tiers, or -1 if out
+ * of memory.
+ */
+static int64_t CountCanonicalParentTiers(TierHashMap *num_parents) {
+    int64_t num_canonical = 0;
+    TierHashMapIterator it = TierHashMapBegin(&tier_graph);
+    Tier tier;
+    int64_t value;
+    while (TierHashMapIteratorNext(&it, &tier, &value)) {
+        if (!IsCanonicalTier(tier)) continue;
+        ++num_canonical;
+        if (!TierHashMapContains(num_parents, tier) &&
+            !TierHashMapSet(num_parents, tier, 0)) {
+            return -1;
+        }
+
+        Tier children[kTierSolverNumChildTiersMax];
+        int num_children = GetCanonicalChildTiers(tier, children);
+        for (int i = 0; i < num_children; ++i) {
+            TierHashMapIterator child =
+                TierHashMapGet(num_parents, children[i]);
+            int64_t count = TierHashMapIteratorIsValid(&child)
+                                ? TierHashMapIteratorValue(&child)
+                                : 0;
+            if (!TierHashMapSet(num_parents, children[i], count + 1)) {
+                return -1;
+            }
+        }
+    }
+
+    return num_canonical;
+}
+
+static void RemoveReachableMaps(void) {
+    TierHashMapIterator it = TierHashMapBegin(&tier_graph);
+    Tier tier;
+    int64_t value;
+    while (TierHashMapIteratorNext(&it, &tier, &value)) {
+        if (IsCanonicalTier(tier)) StatManagerRemoveReachableMap(tier);
+    }
+}
+
+/**
+ * @brief Updates the tier graph for each tier that has been durably written to
+ * storage by the background flush of the database, which may enqueue their
+ * parent tiers. If WAIT is true, first waits for the next pending flush to
+ * finish. Unless REACHABLE_ONLY, the restricted marks of the flushed tiers are
+ * removed, as all of their legal positions have been stored. Adds the number
+ * of seconds spent to TIME_ELAPSED and returns whether any tier was released.
+ */
+static bool ReleaseFlushedTiers(bool wait, bool reachable_only,
+                                double *time_elapsed) {
+    time_t begin = time(NULL);
+    bool released = false;
+    Tier tier;
+    int error;
+    while (DbManagerPopFlushedTier(wait, &tier, &error)) {
+        wait = false;
+        released = true;
+        if (error == kNoError) {
+            if (!reachable_only) StatManagerRemoveRestrictedMark(tier);
+            SolveUpdateTierGraph(tier);
+            ++processed_tiers;
+        } else {
+            printf("Failed to flush tier %" PRITier ", code %d\n", tier,
+                   error);
+            ++failed_tiers;
+        }
+    }
+    *time_elapsed += difftime(time(NULL), begin);
+
+    return released;
+}
+
+/**
+ * @brief Lets the database keep up to CACHE_BUDGET bytes of loaded child tiers
+ * in memory between tiers, and counts the parents of each canonical tier that
+ * will load it so that it can be evicted once they have all been processed.
+ */
+static void EnableTierCache(intptr_t cache_budget, int verbose) {
+    int error = DbManagerSetTierCache(cache_budget);
+    if (error != kNoError) {
+        if (verbose > 0) printf("Not caching child tiers (code %d)\n", error);
+        return;
+    }
+
+    cache_tiers = true;
+    TierHashMapInit(&remaining_parents, 0.5);
+    TierHashMapIterator it = TierHashMapBegin(&tier_graph);
+    Tier parent;
+    int64_t value;
+    while (TierHashMapIteratorNext(&it, &parent, &value)) {
+        if (!IsCanonicalTier(parent)) continue;
+
+        Tier children[kTierSolverNumChildTiersMax];
+        int num_children = GetCanonicalChildTiers(parent, children);
+        for (int i = 0; i < num_children; ++i) {
+            TierHashMapIterator child =
+                TierHashMapGet(&remaining_parents, children[i]);
+            int64_t count = TierHashMapIteratorIsValid(&child)
+                                ? TierHashMapIteratorValue(&child)
+                                : 0;
+            if (!TierHashMapSet(&remaining_parents, children[i], count + 1)) {
+                // Fall back to loading each child tier from storage.
+                DisableTierCache();
+                return;
+            }
+        }
+    }
+}
+
+static void DisableTierCache(void) {
+    DbManagerSetTierCache(0);
+    TierHashMapDestroy(&remaining_parents);
+    cache_tiers = false;
+}
+
+/**
+ * @brief Stores the unique canonical child tiers of PARENT in CHILDREN, which
+ * are the tiers loaded by the tier worker when solving PARENT, and returns the
+ * number of them.
+ */
+static int GetCanonicalChildTiers(Tier parent,
+                                  Tier children[kTierSolverNumChildTiersMax]) {
+    Tier raw[kTierSolverNumChildTiersMax];
+    int num_raw = api_internal->GetChildTiers(parent, raw);
+    int num_children = 0;
+    for (int i = 0; i < num_raw; ++i) {
+        Tier canonical = api_internal->GetCanonicalTier(raw[i]);
+        bool duplicate = false;
+        for (int j = 0; j < num_children && !duplicate; ++j) {
+            duplicate = (children[j] == canonical);
+        }
+        if (!duplicate) children[num_children++] = canonical;
+    }
+
+    return num_children;
+}
+
+/**
+ * @brief Pops the next tier to solve. If the tier cache is enabled, picks the
+ * tier with the most child tier positions already in memory among the first
+ * kReadyTierScanMax ready tiers. Ties are broken in queue order.
+ */
+static Tier PopReadyTier(void) {
+    if (!cache_tiers) return TierQueuePop(&pending_tiers);
+
+    // Scan in place so that the other tiers keep their order in the queue.
+    int64_t num_scanned = TierQueueSize(&pending_tiers);
+    if (num_scanned > kReadyTierScanMax) num_scanned = kReadyTierScanMax;
+    int64_t best = 0, best_size = -1;
+    for (int64_t i = 0; i < num_scanned; ++i) {
+        int64_t size = GetCachedChildSize(TierQueueAt(&pending_tiers, i));
+        if (size > best_size) {
+            best_size = size;
+            best = i;
+        }
+    }
+
+    return TierQueueRemoveAt(&pending_tiers, best);
+}
+
+/**
+ * @brief Returns the total size of the canonical child tiers of TIER that are
+ * in memory, or 0 if TIER is not canonical.
+ */
+static int64_t GetCachedChildSize(Tier tier) {
+    if (!IsCanonicalTier(tier)) return 0;
+
+    Tier children[kTierSolverNumChildTiersMax];
+    int num_children = GetCanonicalChildTiers(tier, children);
+    int64_t ret = 0;
+    for (int i = 0; i < num_children; ++i) {
+        if (DbManagerIsTierCached(children[i])) {
+            ret += api_internal->GetTierSize(children[i]);
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Marks PARENT as processed, evicting each of its child tiers from the
+ * cache if none of their other parent tiers remains to be processed.
+ */
+static void ReleaseChildTiers(Tier parent) {
+    Tier children[kTierSolverNumChildTiersMax];
+    int num_children = GetCanonicalChildTiers(parent, children);
+    for (int i = 0; i < num_children; ++i) {
+        TierHashMapIterator it =
+            TierHashMapGet(&remaining_parents, children[i]);
+        if (!TierHashMapIteratorIsValid(&it)) continue;
+
+        int64_t count = TierHashMapIteratorValue(&it) - 1;
+        TierHashMapSet(&remaining_parents, children[i], count);
+        if (count <= 0) DbManagerEvictTier(children[i]);
+    }
+}
+
 #else  // USE_MPI
 
-static int SolveTierGraphMpi(bool force, int verbose) {
+static int SolveTierGraphMpi(bool force, int verbose, bool subgame) {
     if (verbose > 0) {
         printf("Begin solving all %" PRId64 " tiers (%" PRId64
                " canonical) of total size %" PRId64 " (positions)\n",
@@ -585,7 +1365,9 @@ static int SolveTierGraphMpi(bool force, int verbose) {
     SolveTierGraphMpiTerminateWorkers();
     double time_elapsed = difftime(time(NULL), begin_time);
     if (verbose > 0) PrintSolverResult(time_elapsed);
-    if (failed_tiers == 0) {
+
+    // Solving a subgame leaves the rest of the game unsolved.
+    if (failed_tiers == 0 && !subgame) {
         int error = DbManagerSetGameSolved();
         if (error != kNoError) {
             fprintf(
@@ -630,6 +1412,8 @@ static void SolveTierGraphMpiSolveAll(time_t begin_time, bool force,
                        worker_msg.error);
                 ++failed_tiers;
             } else {  // Successfully solved or loaded.
+                // MPI workers solve all legal positions.
+                if (solved) StatManagerRemoveRestrictedMark(tier);
                 SolveUpdateTierGraph(tier);
                 ++processed_tiers;
             }
@@ -822,6 +1606,28 @@ static bool IsCanonicalTier(Tier tier) {
     return api_internal->GetCanonicalTier(tier) == tier;
 }
 
+/**
+ * @brief Initializes TIERS and SIZES and fills them with the canonical tiers
+ * in the tier graph and their sizes. Only canonical tiers are solved into the
+ * database.
+ */
+static int GetCanonicalTiers(TierArray *tiers, Int64Array *sizes) {
+    TierArrayInit(tiers);
+    Int64ArrayInit(sizes);
+    TierHashMapIterator it = TierHashMapBegin(&tier_graph);
+    Tier tier;
+    int64_t value;
+    while (TierHashMapIteratorNext(&it, &tier, &value)) {
+        if (!IsCanonicalTier(tier)) continue;
+        if (!TierArrayAppend(tiers, tier) ||
+            !Int64ArrayPushBack(sizes, api_internal->GetTierSize(tier))) {
+            return kMallocFailureError;
+        }
+    }
+
+    return kNoError;
+}
+
 static int DiscoverTierGraph(bool force, int verbose, intptr_t memlimit) {
     TierAnalyzerInit(api_internal, memlimit);
     while (!TierQueueEmpty(&pending_tiers)) {
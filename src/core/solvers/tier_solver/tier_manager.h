@@ -37,22 +37,63 @@
 #define GAMESMANONE_CORE_SOLVERS_TIER_SOLVER_TIER_MANAGER_H_
 
 #include <stdbool.h>  // bool
-#include <stdint.h>   // int64_t
+#include <stdint.h>   // int64_t, intptr_t
 
 #include "core/solvers/tier_solver/tier_solver.h"
 
+/**
+ * @brief Initializes the Tier Manager for game GAME_NAME, variant VARIANT.
+ *
+ * @details The tier graph built by the Tier Manager is saved to a snapshot file
+ * in the data directory of the game variant and reloaded from it by later
+ * calls to TierManagerSolve(), TierManagerAnalyze() and TierManagerTest().
+ * Forced solving and analysis always rebuild the tier graph.
+ *
+ * @param game_name Internal name of the game.
+ * @param variant Index of the game variant as an integer.
+ * @param data_path Absolute or relative path to the data directory if non-NULL.
+ * The default path "data" will be used if set to NULL.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int TierManagerInit(ReadOnlyString game_name, int variant,
+                    ReadOnlyString data_path);
+
+/**
+ * @brief Finalizes the Tier Manager, freeing all dynamically allocated space.
+ */
+void TierManagerFinalize(void);
+
 /**
  * @brief Creates and solves the tier graph.
  *
  * @param api Tier solver API functions implemented by the current Game.
- * @param force If set to true, the solver will solve each tier regardless of
- * the current database status. Otherwise, the solving stage is skipped if Tier
- * Manager believes that the given tier has been correctly solved already.
- * @param verbose Set to 0 for quiet (only error messages will be printed,) 1
- * for default, and 2 for verbose.
+ * @param options Solver options. The solver solves each tier regardless of the
+ * current database status if OPTIONS->force is set. Otherwise, the solving
+ * stage is skipped if Tier Manager believes that the given tier has been
+ * correctly solved already. If OPTIONS->histograms is set, the histogram of
+ * each solved tier is recorded for TierManagerAnalyze(), which then skips
+ * loading the tier from the database if all of its legal positions are
+ * reachable. If OPTIONS->reachable_only is set, the positions reachable from
+ * the initial position are discovered before solving and only those are
+ * solved. Histograms and reachability are ignored when solving with more than
+ * one MPI process.
+ * @param memlimit Approximate heap memory limit in bytes for discovering the
+ * reachable positions. Ignored when solving with more than one MPI process.
+ * @param flush_budget If positive, solved tiers are written to storage in the
+ * background using at most FLUSH_BUDGET bytes of memory, and the next tier is
+ * solved in the meantime. The parents of a tier are not solved until the tier
+ * has been written. Set to 0 to write each tier before solving the next one.
+ * Ignored when solving with more than one MPI process.
+ * @param cache_budget If positive, the database keeps up to CACHE_BUDGET bytes
+ * of child tiers in memory after each tier is solved, and ready tiers whose
+ * child tiers are in memory are solved first. Set to 0 to load the child tiers
+ * of each tier from storage. Ignored when solving with more than one MPI
+ * process.
  * @return 0 on success, non-zero error code otherwise.
  */
-int TierManagerSolve(const TierSolverApi *api, bool force, int verbose);
+int TierManagerSolve(const TierSolverApi *api,
+                     const TierSolverSolveOptions *options, intptr_t memlimit,
+                     intptr_t flush_budget, intptr_t cache_budget);
 
 /**
  * @brief Creates and analyzes the tier graph.
@@ -82,4 +123,28 @@ int TierManagerAnalyze(const TierSolverApi *api, bool force, int verbose,
  */
 int TierManagerTest(const TierSolverApi *api, long seed, int64_t test_size);
 
+/**
+ * @brief Rebuilds the database's record of solved tiers from the tier files
+ * found in the database directory, which migrates databases solved before the
+ * record was introduced.
+ *
+ * @param api Tier solver API functions implemented by the current Game.
+ * @param verbose Set to 0 for quiet (only error messages will be printed,) 1
+ * for default, and 2 for verbose.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int TierManagerRebuildDbManifest(const TierSolverApi *api, int verbose);
+
+/**
+ * @brief Moves the database files of all solved tiers into the packed layout
+ * of the database, which stores many tiers per file. Tiers solved afterwards
+ * are also stored in the packed layout.
+ *
+ * @param api Tier solver API functions implemented by the current Game.
+ * @param verbose Set to 0 for quiet (only error messages will be printed,) 1
+ * for default, and 2 for verbose.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+int TierManagerPackDb(const TierSolverApi *api, int verbose);
+
 #endif  // GAMESMANONE_CORE_SOLVERS_TIER_SOLVER_TIER_MANAGER_H_
@@ -29,12 +29,13 @@
 
 #include "core/solvers/tier_solver/tier_solver.h"
 
-#include <assert.h>  // assert
-#include <stddef.h>  // NULL
-#include <stdint.h>  // int64_t, intptr_t
-#include <stdio.h>   // fprintf, stderr
-#include <stdlib.h>  // strtoll
-#include <string.h>  // memset, memcpy, strncmp
+#include <assert.h>    // assert, static_assert
+#include <inttypes.h>  // PRId64
+#include <stddef.h>    // NULL
+#include <stdint.h>    // int64_t, intptr_t
+#include <stdio.h>     // fprintf, stderr
+#include <stdlib.h>    // strtoll
+#include <string.h>    // memset, memcpy, strncmp
 #ifdef USE_MPI
 #include <mpi.h>
 #endif  // USE_MPI
@@ -42,10 +43,18 @@
 #include "core/analysis/stat_manager.h"
 #include "core/db/arraydb/arraydb.h"
 #include "core/db/db_manager.h"
+#include "core/gamesman_memory.h"
 #include "core/misc.h"
+#include "core/solvers/tier_solver/tier_analyzer.h"
 #include "core/solvers/tier_solver/tier_manager.h"
 #include "core/solvers/tier_solver/tier_worker.h"
 #include "core/types/gamesman_types.h"
+#include "core/types/tier_position_dedup.h"
+
+// The default canonical child generators rely on the allocation-free path.
+static_assert((int)kTierSolverNumMovesMax <=
+                  (int)kTierPositionDedupTableMax,
+              "default child deduplication may allocate");
 
 enum { kTierSolverNumOptions = 3 };
 
@@ -65,6 +74,14 @@ static const SolverConfig *TierSolverGetCurrentConfig(void);
 static int TierSolverSetOption(int option, int selection);
 static Value TierSolverGetValue(TierPosition tier_position);
 static int TierSolverGetRemoteness(TierPosition tier_position);
+static int TierSolverProbeInit(DbProbe *probe);
+static int TierSolverProbeDestroy(DbProbe *probe);
+static Value TierSolverProbeValueRemoteness(DbProbe *probe,
+                                            TierPosition tier_position,
+                                            int *remoteness);
+static int TierSolverProbeBatch(DbProbe *probe, int64_t n,
+                                const TierPosition *tier_positions,
+                                Value *values, int *remotenesses);
 
 /** @brief Tier Solver definition. */
 const Solver kTierSolver = {
@@ -86,6 +103,11 @@ const Solver kTierSolver = {
 
     .GetValue = &TierSolverGetValue,
     .GetRemoteness = &TierSolverGetRemoteness,
+
+    .ProbeInit = &TierSolverProbeInit,
+    .ProbeDestroy = &TierSolverProbeDestroy,
+    .ProbeValueRemoteness = &TierSolverProbeValueRemoteness,
+    .ProbeBatch = &TierSolverProbeBatch,
 };
 
 // Size of each uncompressed XZ block for ArrayDb compression. Smaller block
@@ -97,6 +119,14 @@ static const int64_t kArrayDbBlockSize = 1 << 20;  // 1 MiB.
 // treated as a constant, although its value is calculated at runtime.
 static int64_t kArrayDbRecordsPerBlock;
 
+// Fraction of the memory limit reserved for the record arrays of solved tiers
+// that are being flushed in the background, if enabled.
+static const intptr_t kAsyncFlushBudgetDivisor = 4;  // 25%.
+
+// Fraction of the remaining memory limit reserved for the child tiers kept in
+// memory between tiers, if enabled.
+static const intptr_t kTierCacheBudgetDivisor = 4;  // 25%.
+
 static ConstantReadOnlyString kChoices[] = {"On", "Off"};
 static const SolverOption kTierSymmetryRemoval = {
     .name = "Tier Symmetry Removal",
@@ -138,6 +168,10 @@ static bool read_only_db;
 // Solver status: 0 if not solved, 1 if solved.
 static TierSolverSolveStatus solver_status;
 
+// Root of the subgame being solved. The current API returns it as the initial
+// tier position while a subgame is being solved.
+static TierPosition subgame_start;
+
 // Helper Functions
 
 static bool RequiredApiFunctionsImplemented(const TierSolverApi *api);
@@ -153,6 +187,16 @@ static bool SetCurrentApi(const TierSolverApi *api);
 
 static int SetDb(ReadOnlyString game_name, int variant,
                  ReadOnlyString data_path);
+static int RebuildDbManifest(int verbose);
+static int PackDb(int verbose);
+static intptr_t ReserveBudget(bool enabled, intptr_t divisor,
+                              intptr_t *memlimit);
+static int SolveTierGraph(const TierSolverSolveOptions *options);
+
+static bool EnterSubgame(TierPosition start);
+static void LeaveSubgame(void);
+static Tier SubgameGetInitialTier(void);
+static Position SubgameGetInitialPosition(void);
 
 static TierPosition GetCanonicalTierPosition(TierPosition tier_position);
 
@@ -188,6 +232,9 @@ static int TierSolverInit(ReadOnlyString game_name, int variant,
     error = StatManagerInit(game_name, variant, data_path);
     if (error != kNoError) goto _bailout;
 
+    error = TierManagerInit(game_name, variant, data_path);
+    if (error != kNoError) goto _bailout;
+
     // Success.
     error = 0;
 
@@ -204,6 +251,7 @@ static int TierSolverFinalize(void) {
     read_only_db = false;
     solver_status = kTierSolverSolveStatusNotSolved;
     DbManagerFinalizeDb();
+    TierManagerFinalize();
     memset(&default_api, 0, sizeof(default_api));
     memset(&current_api, 0, sizeof(current_api));
     memset(&current_config, 0, sizeof(current_config));
@@ -312,37 +360,38 @@ static int TierSolverSolve(void *aux) {
     };
     const TierSolverSolveOptions *options = (TierSolverSolveOptions *)aux;
     if (options == NULL) options = &default_options;
+    if (options->rebuild_manifest) {
+        int error = RebuildDbManifest(options->verbose);
+        if (error != kNoError) return error;
+    }
+    if (options->pack) {
+        int error = PackDb(options->verbose);
+        if (error != kNoError) return error;
+    }
     if (!options->force && solver_status == kTierSolverSolveStatusSolved) {
         printf("%s\n", kTierSolverSolveSkipSolvedMsg);
         return kNoError;
     }
-#ifndef USE_MPI  // If not using MPI
-    TierWorkerInit(&current_api, kArrayDbRecordsPerBlock, options->memlimit);
-    return TierManagerSolve(&current_api, options->force, options->verbose);
-#else   // Using MPI
-    // Assumes MPI_Init or MPI_Init_thread has been called.
-    int process_id, cluster_size;
-    cluster_size = SafeMpiCommSize(MPI_COMM_WORLD);
-    process_id = SafeMpiCommRank(MPI_COMM_WORLD);
-    if (cluster_size < 1) {
-        NotReached("TierSolverSolve: cluster size smaller than 1");
-    } else if (cluster_size == 1) {  // Only one node is allocated.
-        TierWorkerInit(&current_api, kArrayDbRecordsPerBlock,
-                       options->memlimit);
-        return TierManagerSolve(&current_api, options->force, options->verbose);
-    } else {                    // cluster_size > 1
-        if (process_id == 0) {  // This is the manager node.
-            return TierManagerSolve(&current_api, options->force,
-                                    options->verbose);
-        } else {  // This is a worker node.
-            TierWorkerInit(&current_api, kArrayDbRecordsPerBlock,
-                           options->memlimit);
-            return TierWorkerMpiServe();
-        }
+    int error = kNoError;
+    if (!options->subgame) {
+        error = SolveTierGraph(options);
+    } else if (EnterSubgame(options->start)) {
+        error = SolveTierGraph(options);
+        LeaveSubgame();
+    } else {
+        fprintf(stderr,
+                "TierSolverSolve: cannot solve from illegal position %" PRId64
+                " in tier %" PRITier "\n",
+                options->start.position, options->start.tier);
+        return kIllegalGamePositionError;
     }
 
-    return kNotReachedError;
-#endif  // USE_MPI
+    // A forced solve supersedes the streams of the tiers it solved again.
+    if (error == kNoError && options->force && options->pack) {
+        error = PackDb(options->verbose);
+    }
+
+    return error;
 }
 
 static int TierSolverAnalyze(void *aux) {
@@ -428,6 +477,38 @@ static int TierSolverGetRemoteness(TierPosition tier_position) {
     return ret;
 }
 
+static int TierSolverProbeInit(DbProbe *probe) {
+    return DbManagerProbeInit(probe);
+}
+
+static int TierSolverProbeDestroy(DbProbe *probe) {
+    return DbManagerProbeDestroy(probe);
+}
+
+static Value TierSolverProbeValueRemoteness(DbProbe *probe,
+                                            TierPosition tier_position,
+                                            int *remoteness) {
+    TierPosition canonical = GetCanonicalTierPosition(tier_position);
+
+    return DbManagerProbeValueRemoteness(probe, canonical, remoteness);
+}
+
+static int TierSolverProbeBatch(DbProbe *probe, int64_t n,
+                                const TierPosition *tier_positions,
+                                Value *values, int *remotenesses) {
+    TierPosition *canonicals =
+        (TierPosition *)GamesmanMalloc(n * sizeof(TierPosition));
+    if (canonicals == NULL) return kMallocFailureError;
+
+    for (int64_t i = 0; i < n; ++i) {
+        canonicals[i] = GetCanonicalTierPosition(tier_positions[i]);
+    }
+    int ret = DbManagerProbeBatch(probe, n, canonicals, values, remotenesses);
+    GamesmanFree(canonicals);
+
+    return ret;
+}
+
 // Helper functions
 
 static bool RequiredApiFunctionsImplemented(const TierSolverApi *api) {
@@ -524,6 +605,10 @@ static bool SetCurrentApi(const TierSolverApi *api) {
         current_options[num_options++] = kUseRetrograde;
     }  // else, current_api.GetCanonicalParentPositions remains NULL.
 
+    // Canonical parents miss the non-canonical parents of positions in games
+    // with position symmetry, even if Position Symmetry Removal is turned off.
+    TierAnalyzerSetExactParents(!PositionSymmetryRemovalImplemented(api));
+
     if (current_api.GetNumberOfCanonicalChildPositions == NULL) {
         current_api.GetNumberOfCanonicalChildPositions =
             &DefaultGetNumberOfCanonicalChildPositions;
@@ -562,6 +647,121 @@ static int SetDb(ReadOnlyString game_name, int variant,
     return kNoError;
 }
 
+static int RebuildDbManifest(int verbose) {
+#ifdef USE_MPI
+    // Worker processes would not see the rebuilt manifest.
+    if (SafeMpiCommSize(MPI_COMM_WORLD) > 1) {
+        fprintf(stderr,
+                "TierSolverSolve: rebuilding the database manifest is only "
+                "supported in a single process.\n");
+        return kIllegalSolverOptionError;
+    }
+#endif  // USE_MPI
+
+    return TierManagerRebuildDbManifest(&current_api, verbose);
+}
+
+static int PackDb(int verbose) {
+#ifdef USE_MPI
+    // Worker processes would keep writing to the per-tier layout.
+    if (SafeMpiCommSize(MPI_COMM_WORLD) > 1) {
+        fprintf(stderr,
+                "TierSolverSolve: packing the database is only supported in a "
+                "single process.\n");
+        return kIllegalSolverOptionError;
+    }
+#endif  // USE_MPI
+
+    return TierManagerPackDb(&current_api, verbose);
+}
+
+/**
+ * @brief Returns the memory budget of an optional feature of the solver, which
+ * is 1/DIVISOR of MEMLIMIT if ENABLED, or 0 otherwise. The budget is taken out
+ * of MEMLIMIT, which is set to the default memory limit first if it is 0.
+ */
+static intptr_t ReserveBudget(bool enabled, intptr_t divisor,
+                              intptr_t *memlimit) {
+    if (!enabled) return 0;
+
+    if (*memlimit == 0) *memlimit = (intptr_t)GetPhysicalMemory() / 10 * 9;
+    intptr_t budget = *memlimit / divisor;
+    *memlimit -= budget;
+
+    return budget;
+}
+
+/**
+ * @brief Solves the tier graph rooted at the initial tier of the current API
+ * with OPTIONS.
+ */
+static int SolveTierGraph(const TierSolverSolveOptions *options) {
+#ifndef USE_MPI  // If not using MPI
+    intptr_t memlimit = options->memlimit;
+    intptr_t flush_budget = ReserveBudget(options->async_flush,
+                                          kAsyncFlushBudgetDivisor, &memlimit);
+    intptr_t cache_budget = ReserveBudget(options->cache_tiers,
+                                          kTierCacheBudgetDivisor, &memlimit);
+    TierWorkerInit(&current_api, kArrayDbRecordsPerBlock, memlimit);
+    return TierManagerSolve(&current_api, options, memlimit, flush_budget,
+                            cache_budget);
+#else   // Using MPI
+    // Assumes MPI_Init or MPI_Init_thread has been called.
+    int process_id, cluster_size;
+    cluster_size = SafeMpiCommSize(MPI_COMM_WORLD);
+    process_id = SafeMpiCommRank(MPI_COMM_WORLD);
+    if (cluster_size < 1) {
+        NotReached("SolveTierGraph: cluster size smaller than 1");
+    } else if (cluster_size == 1) {  // Only one node is allocated.
+        intptr_t memlimit = options->memlimit;
+        intptr_t flush_budget = ReserveBudget(
+            options->async_flush, kAsyncFlushBudgetDivisor, &memlimit);
+        intptr_t cache_budget = ReserveBudget(
+            options->cache_tiers, kTierCacheBudgetDivisor, &memlimit);
+        TierWorkerInit(&current_api, kArrayDbRecordsPerBlock, memlimit);
+        return TierManagerSolve(&current_api, options, memlimit, flush_budget,
+                                cache_budget);
+    } else {                    // cluster_size > 1
+        if (process_id == 0) {  // This is the manager node.
+            return TierManagerSolve(&current_api, options, 0, 0, 0);
+        } else {  // This is a worker node.
+            TierWorkerInit(&current_api, kArrayDbRecordsPerBlock,
+                           options->memlimit);
+            return TierWorkerMpiServe();
+        }
+    }
+
+    return kNotReachedError;
+#endif  // USE_MPI
+}
+
+/**
+ * @brief Makes START the initial tier position of the current API, or returns
+ * false without modifying the API if START is illegal.
+ */
+static bool EnterSubgame(TierPosition start) {
+    if (start.tier < 0 || start.position < 0) return false;
+    if (start.position >= current_api.GetTierSize(start.tier)) return false;
+    if (!current_api.IsLegalPosition(start)) return false;
+
+    subgame_start = start;
+    current_api.GetInitialTier = &SubgameGetInitialTier;
+    current_api.GetInitialPosition = &SubgameGetInitialPosition;
+
+    return true;
+}
+
+static void LeaveSubgame(void) {
+    current_api.GetInitialTier = default_api.GetInitialTier;
+    current_api.GetInitialPosition = default_api.GetInitialPosition;
+}
+
+static Tier SubgameGetInitialTier(void) { return subgame_start.tier; }
+
+static Position SubgameGetInitialPosition(void) {
+    return subgame_start.position;
+}
+
 static TierPosition GetCanonicalTierPosition(TierPosition tier_position) {
     TierPosition canonical;
 
@@ -604,43 +804,23 @@ static Position DefaultGetCanonicalPosition(TierPosition tier_position) {
 static int DefaultGetNumberOfCanonicalChildPositions(
     TierPosition tier_position) {
     //
-    TierPositionHashSet children;
-    TierPositionHashSetInit(&children, 0.5);
-    Move moves[kTierSolverNumMovesMax];
-    int num_moves = current_api.GenerateMoves(tier_position, moves);
-    for (int i = 0; i < num_moves; ++i) {
-        TierPosition child = current_api.DoMove(tier_position, moves[i]);
-        child = GetCanonicalTierPosition(child);
-        if (!TierPositionHashSetContains(&children, child)) {
-            TierPositionHashSetAdd(&children, child);
-        }
-    }
-    int num_children = (int)children.size;
-    TierPositionHashSetDestroy(&children);
-
-    return num_children;
+    TierPosition children[kTierSolverNumChildPositionsMax];
+    return DefaultGetCanonicalChildPositions(tier_position, children);
 }
 
 static int DefaultGetCanonicalChildPositions(
     TierPosition tier_position,
     TierPosition children[static kTierSolverNumChildPositionsMax]) {
     //
-    TierPositionHashSet dedup;
-    TierPositionHashSetInit(&dedup, 0.5);
     Move moves[kTierSolverNumMovesMax];
     int num_moves = current_api.GenerateMoves(tier_position, moves);
-    int ret = 0;
     for (int i = 0; i < num_moves; ++i) {
-        TierPosition child = current_api.DoMove(tier_position, moves[i]);
-        child = GetCanonicalTierPosition(child);
-        if (!TierPositionHashSetContains(&dedup, child)) {
-            TierPositionHashSetAdd(&dedup, child);
-            children[ret++] = child;
-        }
+        children[i] = GetCanonicalTierPosition(
+            current_api.DoMove(tier_position, moves[i]));
     }
-    TierPositionHashSetDestroy(&dedup);
 
-    return ret;
+    // Cannot fail since the number of moves never exceeds the table size.
+    return TierPositionDedup(children, num_moves);
 }
 
 static int DefaultGetTierName(Tier tier,
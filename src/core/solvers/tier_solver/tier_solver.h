@@ -384,6 +384,49 @@ typedef struct TierSolverSolveOptions {
     int verbose;       /**< Level of details to output. */
     bool force;        /**< Whether to force (re)solve the game. */
     intptr_t memlimit; /**< Approximate heap memory limit in bytes. */
+
+    /** Whether to rebuild the database's record of solved tiers from the tier
+     * files before solving. */
+    bool rebuild_manifest;
+
+    /** Whether to pack the database files into segment files before solving,
+     * which also stores the tiers solved afterwards in segment files. A forced
+     * solve packs the database again afterwards to reclaim the space taken by
+     * the tiers it solved again. */
+    bool pack;
+
+    /** Whether to flush solved tiers in the background while solving the next
+     * tier, which reserves part of the memory limit for the tiers being
+     * flushed. */
+    bool async_flush;
+
+    /** Whether to keep the child tiers loaded for each tier in memory for its
+     * sibling tiers, which reserves part of the memory limit for them. */
+    bool cache_tiers;
+
+    /** Whether to record the value and remoteness histogram of each solved
+     * tier, which lets the analyzer skip loading the tier from the database if
+     * all of its legal positions are reachable. */
+    bool histograms;
+
+    /** Whether to discover the positions reachable from the initial position
+     * before solving and solve only those. Unreachable positions are left
+     * undecided in the database. The tiers solved this way are solved again
+     * by later solves without this option, and the game is not marked as
+     * solved afterwards. */
+    bool reachable_only;
+
+    /** Whether to solve only the subgame rooted at START in place of the whole
+     * game. Only the tiers reachable from the tier of START are solved, and
+     * those already solved in the database are reused. The game is not marked
+     * as solved afterwards. If REACHABLE_ONLY is also set, reachability is
+     * discovered from START, and the tiers solved this way are solved again
+     * by later solves from a different position or without REACHABLE_ONLY. */
+    bool subgame;
+
+    /** Legal position to solve the subgame from. Ignored unless SUBGAME is
+     * set. */
+    TierPosition start;
 } TierSolverSolveOptions;
 
 /** @brief Analyzer options of the Tier Solver. */
@@ -35,6 +35,8 @@
 #include <stdbool.h>  // bool, true, false
 #include <stdint.h>   // int64_t, intptr_t
 
+#include "core/analysis/stat_manager.h"
+#include "core/db/db_manager.h"
 #include "core/misc.h"
 #include "core/solvers/tier_solver/tier_solver.h"
 #include "core/solvers/tier_solver/tier_worker/bi.h"
@@ -47,6 +49,8 @@ static const TierSolverApi *api_internal;
 static int64_t current_db_chunk_size;
 static intptr_t mem;
 
+static TierPosition GetInitialTierPosition(void);
+
 #ifdef USE_MPI
 #include <unistd.h>  // sleep
 
@@ -87,8 +91,27 @@ const TierWorkerSolveOptions kDefaultTierWorkerSolveOptions = {
     .compare = false,
     .force = false,
     .verbose = 1,
+    .histogram = false,
+    .reachable_only = false,
 };
 
+bool TierWorkerIsSolved(Tier tier, const TierWorkerSolveOptions *options) {
+    if (DbManagerTierStatus(tier) != kDbTierStatusSolved) return false;
+    if (!StatManagerHasRestrictedMark(tier)) return true;
+    if (!options->reachable_only) return false;
+
+    // A mark that cannot be read may have been left by any solve.
+    TierPosition root;
+    if (StatManagerLoadRestrictedMark(tier, &root) != kNoError) return false;
+    TierPosition current = GetInitialTierPosition();
+
+    return root.tier == current.tier && root.position == current.position;
+}
+
+int TierWorkerSaveRestrictedMark(Tier tier) {
+    return StatManagerSaveRestrictedMark(tier, GetInitialTierPosition());
+}
+
 int TierWorkerSolve(int method, Tier tier,
                     const TierWorkerSolveOptions *options, bool *solved) {
     if (options == NULL) options = &kDefaultTierWorkerSolveOptions;
@@ -151,3 +174,14 @@ int TierWorkerTest(Tier tier, const TierArray *parent_tiers, long seed,
     return TierWorkerTestInternal(api_internal, tier, parent_tiers, seed,
                                   test_size);
 }
+
+// -----------------------------------------------------------------------------
+
+static TierPosition GetInitialTierPosition(void) {
+    TierPosition ret = {
+        .tier = api_internal->GetInitialTier(),
+        .position = api_internal->GetInitialPosition(),
+    };
+
+    return ret;
+}
@@ -122,10 +122,38 @@ typedef struct TierWorkerSolveOptions {
     int verbose;
     bool force;
     bool compare;
+
+    /** Whether to record the histogram of each solved tier for the analyzer.
+     * The histogram left by a previous solve is removed otherwise. */
+    bool histogram;
+
+    /** Whether to solve only the positions marked in the reachable map of
+     * each tier. All legal positions are solved if a tier has no reachable
+     * map. Tiers solved this way are marked as restricted, and are solved
+     * again by solves without this option or from a different initial
+     * position. */
+    bool reachable_only;
 } TierWorkerSolveOptions;
 
 extern const TierWorkerSolveOptions kDefaultTierWorkerSolveOptions;
 
+/**
+ * @brief Returns whether \p tier has been solved and can be skipped by a solve
+ * with the given \p options. A tier solved for its reachable positions only
+ * is considered solved only if OPTIONS->reachable_only is also set and the
+ * reachable positions were discovered from the current initial position.
+ */
+bool TierWorkerIsSolved(Tier tier, const TierWorkerSolveOptions *options);
+
+/**
+ * @brief Marks \p tier as solved for its reachable positions only, which were
+ * discovered from the current initial position.
+ *
+ * @return kNoError on success, or
+ * @return non-zero error code otherwise.
+ */
+int TierWorkerSaveRestrictedMark(Tier tier);
+
 /**
  * @brief Solves the given \p tier using the given \p method.
  *
@@ -37,11 +37,14 @@
 #include <stdio.h>    // fprintf, stderr
 #include <string.h>   // memcpy
 
+#include "core/analysis/stat_manager.h"
 #include "core/concurrency.h"
 #include "core/constants.h"
+#include "core/data_structures/concurrent_bitset.h"
 #include "core/db/db_manager.h"
 #include "core/gamesman_memory.h"
 #include "core/solvers/tier_solver/tier_solver.h"
+#include "core/solvers/tier_solver/tier_worker/histogram.h"
 #include "core/solvers/tier_solver/tier_worker/frontier.h"
 #include "core/solvers/tier_solver/tier_worker/reverse_graph.h"
 #include "core/types/gamesman_types.h"
@@ -66,6 +69,9 @@ static int64_t current_db_chunk_size;
 // A frontier array will be created for each possible remoteness.
 static const int kFrontierSize = kRemotenessMax + 1;
 
+// Number of frontier positions decoded at a time by each thread.
+enum { kPushBlockSize = kFrontierBucketSampleInterval };
+
 static Tier this_tier;          // The tier being solved.
 static int64_t this_tier_size;  // Size of the tier being solved.
 
@@ -89,6 +95,10 @@ static AtomicChildPosCounterType *num_undecided_children = NULL;
 static ChildPosCounterType *num_undecided_children = NULL;
 #endif  // _OPENMP
 
+// Canonical positions of the current tier that are reachable from the initial
+// position, or NULL if all legal positions are solved.
+static ConcurrentBitset *reachable;
+
 // Cached reverse position graph of the current tier. This is only initialized
 // if the game does not implement Retrograde Analysis.
 static ReverseGraph reverse_graph;
@@ -155,8 +165,20 @@ static int TierGetCanonicalParentPositionsFromReverseGraph(
     return ret;
 }
 
+static bool Step0_2LoadReachableMap(bool reachable_only) {
+    if (!reachable_only) return true;
+
+    // Solve all legal positions if the tier has no reachable map.
+    int error = StatManagerLoadReachableMap(this_tier, this_tier_size, NULL,
+                                            &reachable);
+    if (error == kFileSystemError) return true;
+    if (error != kNoError) return false;
+
+    return TierWorkerSaveRestrictedMark(this_tier) == kNoError;
+}
+
 static bool Step0Initialize(const TierSolverApi *api, int64_t db_chunk_size,
-                            Tier tier) {
+                            Tier tier, bool reachable_only) {
     // Copy solver API function pointers and set db chunk size.
     memcpy(&current_api, api, sizeof(current_api));
     current_db_chunk_size = db_chunk_size;
@@ -183,7 +205,7 @@ static bool Step0Initialize(const TierSolverApi *api, int64_t db_chunk_size,
     // Initialize frontiers with size to hold all child tiers and this tier.
     if (!Step0_1InitFrontiers(num_child_tiers)) return false;
 
-    return true;
+    return Step0_2LoadReachableMap(reachable_only);
 }
 
 // ----------------------------- Step1LoadChildren -----------------------------
@@ -254,6 +276,25 @@ static bool Step1_0LoadTierHelper(int child_index) {
     return ConcurrentBoolLoad(&success);
 }
 
+/**
+ * @brief Compresses the positions that were added to all frontiers since they
+ * were last sealed.
+ */
+static bool SealFrontiers(void) {
+    ConcurrentBool success;
+    ConcurrentBoolInit(&success, true);
+    PRAGMA_OMP_PARALLEL_FOR_SCHEDULE_DYNAMIC(1)
+    for (int i = 0; i < num_threads; ++i) {
+        if (!FrontierSeal(&win_frontiers[i]) ||
+            !FrontierSeal(&lose_frontiers[i]) ||
+            !FrontierSeal(&tie_frontiers[i])) {
+            ConcurrentBoolStore(&success, false);
+        }
+    }
+
+    return ConcurrentBoolLoad(&success);
+}
+
 /**
  * @brief Load all non-drawing positions from all child tiers into frontier.
  */
@@ -263,8 +304,10 @@ static bool Step1LoadChildren(void) {
     // -1 because this_tier is the last element in child_tiers.
     for (int child_index = 0; child_index < num_child_tiers - 1;
          ++child_index) {
-        // Load child tier from disk.
+        // Load child tier from disk and compress the loaded positions before
+        // moving on to the next child tier.
         if (!Step1_0LoadTierHelper(child_index)) return false;
+        if (!SealFrontiers()) return false;
     }
 
     return true;
@@ -303,6 +346,11 @@ static bool IsCanonicalPosition(Position position) {
     return current_api.GetCanonicalPosition(tier_position) == position;
 }
 
+static bool IsReachable(Position position) {
+    return reachable == NULL ||
+           ConcurrentBitsetTest(reachable, position, memory_order_relaxed);
+}
+
 static ChildPosCounterType Step3_0CountChildren(Position position) {
     TierPosition tier_position = {.tier = this_tier, .position = position};
     if (!use_reverse_graph) {
@@ -347,8 +395,10 @@ static bool Step3ScanTier(void) {
             TierPosition tier_position = {.tier = this_tier,
                                           .position = position};
 
-            // Skip illegal positions and non-canonical positions.
-            if (!current_api.IsLegalPosition(tier_position) ||
+            // Skip unreachable, illegal and non-canonical positions. The
+            // frontiers never reach them as they have no undecided children.
+            if (!IsReachable(position) ||
+                !current_api.IsLegalPosition(tier_position) ||
                 !IsCanonicalPosition(position)) {
                 SetNumUndecidedChildren(position, 0);
                 continue;
@@ -382,7 +432,8 @@ static bool Step3ScanTier(void) {
         FrontierAccumulateDividers(&tie_frontiers[i]);
     }
 
-    return ConcurrentBoolLoad(&success);
+    // Compress the primitive positions.
+    return ConcurrentBoolLoad(&success) && SealFrontiers();
 }
 
 // ---------------------------- Step4PushFrontierUp ----------------------------
@@ -424,11 +475,12 @@ static void UpdateFrontierAndChildTierIds(int64_t i, const Frontier *frontiers,
 /**
  * @details The algorithm is as follows: first count the total number N of
  * positions that need to be processed and then run a parallel for loop that
- * ranges from 0 to N-1 to process each position. In order for threads to figure
- * out which tier a position belongs to, it must first figure out which frontier
- * that position was taken from, and then use the corresponding "dividers" array
- * together with the child_tiers array to figure out which tier that position
- * is from.
+ * ranges from 0 to N-1 to process each position. Positions are read from the
+ * frontiers in blocks of kPushBlockSize so that compressed frontier buckets
+ * are decoded sequentially. In order for threads to figure out which tier a
+ * position belongs to, it must first figure out which frontier that position
+ * was taken from, and then use the corresponding "dividers" array together
+ * with the child_tiers array to figure out which tier that position is from.
  *
  * This function first inspects all positions in the frontier (multiple
  * Frontier instances if multithreading) at the given remoteness that needs to
@@ -450,21 +502,37 @@ static bool PushFrontierHelper(
 
     ConcurrentBool success;
     ConcurrentBoolInit(&success, true);
+    int64_t num_positions = frontier_offsets[num_threads];
+    int64_t num_blocks = (num_positions + kPushBlockSize - 1) / kPushBlockSize;
     PRAGMA_OMP_PARALLEL {
         int frontier_id = 0, child_index = 0;
-        PRAGMA_OMP_FOR_SCHEDULE_MONOTONIC_DYNAMIC(16)
-        for (int64_t i = 0; i < frontier_offsets[num_threads]; ++i) {
-            UpdateFrontierAndChildTierIds(i, frontiers, &frontier_id,
-                                          &child_index, remoteness,
-                                          frontier_offsets);
-            int64_t index_in_frontier = i - frontier_offsets[frontier_id];
-            TierPosition tier_position = {
-                .tier = child_tiers[child_index],
-                .position = FrontierGetPosition(&frontiers[frontier_id],
-                                                remoteness, index_in_frontier),
-            };
-            if (!ProcessPosition(remoteness, tier_position)) {
-                ConcurrentBoolStore(&success, false);
+        Position positions[kPushBlockSize];
+        PRAGMA_OMP_FOR_SCHEDULE_MONOTONIC_DYNAMIC(1)
+        for (int64_t block = 0; block < num_blocks; ++block) {
+            int64_t begin = block * kPushBlockSize;
+            int64_t end = begin + kPushBlockSize;
+            if (end > num_positions) end = num_positions;
+            int64_t decoded_end = begin;  // Positions are decoded up to here.
+            for (int64_t i = begin; i < end; ++i) {
+                UpdateFrontierAndChildTierIds(i, frontiers, &frontier_id,
+                                              &child_index, remoteness,
+                                              frontier_offsets);
+                if (i == decoded_end) {
+                    // Decode up to the end of the block or the frontier.
+                    decoded_end = frontier_offsets[frontier_id + 1];
+                    if (decoded_end > end) decoded_end = end;
+                    FrontierGetPositions(
+                        &frontiers[frontier_id], remoteness,
+                        i - frontier_offsets[frontier_id], decoded_end - i,
+                        &positions[i - begin]);
+                }
+                TierPosition tier_position = {
+                    .tier = child_tiers[child_index],
+                    .position = positions[i - begin],
+                };
+                if (!ProcessPosition(remoteness, tier_position)) {
+                    ConcurrentBoolStore(&success, false);
+                }
             }
         }
     }
@@ -657,7 +725,15 @@ static void Step5MarkDrawPositions(void) {
 
 // ------------------------------ Step6SaveValues ------------------------------
 
-static void Step6SaveValues(void) {
+static void Step6SaveValues(bool histogram) {
+    int error = TierWorkerUpdateHistogram(&current_api, this_tier,
+                                          this_tier_size, histogram);
+    if (error != kNoError) {
+        fprintf(stderr,
+                "Step6SaveValues: failed to update the histogram of tier "
+                "%" PRITier ", code %d\n",
+                this_tier, error);
+    }
     if (DbManagerFlushSolvingTier(NULL) != 0) {
         fprintf(stderr,
                 "Step6SaveValues: an error has occurred while flushing of the "
@@ -729,6 +805,8 @@ static void Step7Cleanup(void) {
     DestroyFrontiers();
     GamesmanFree(num_undecided_children);
     num_undecided_children = NULL;
+    ConcurrentBitsetDestroy(reachable);
+    reachable = NULL;
     if (use_reverse_graph) {
         ReverseGraphDestroy(&reverse_graph);
         // Unset the local function pointer.
@@ -746,19 +824,21 @@ int TierWorkerSolveBIInternal(const TierSolverApi *api, int64_t db_chunk_size,
                               bool *solved) {
     if (solved != NULL) *solved = false;
     int ret = kRuntimeError;
-    if (!options->force && DbManagerTierStatus(tier) == kDbTierStatusSolved) {
+    if (!options->force && TierWorkerIsSolved(tier, options)) {
         ret = kNoError;  // Success.
         goto _bailout;
     }
 
     /* Solver main algorithm. */
-    if (!Step0Initialize(api, db_chunk_size, tier)) goto _bailout;
+    if (!Step0Initialize(api, db_chunk_size, tier, options->reachable_only)) {
+        goto _bailout;
+    }
     if (!Step1LoadChildren()) goto _bailout;
     if (!Step2SetupSolverArrays()) goto _bailout;
     if (!Step3ScanTier()) goto _bailout;
     if (!Step4PushFrontierUp()) goto _bailout;
     Step5MarkDrawPositions();
-    Step6SaveValues();
+    Step6SaveValues(options->histogram);
     if (options->compare && !CompareDb()) goto _bailout;
     if (solved != NULL) *solved = true;
     ret = kNoError;  // Success.
@@ -41,6 +41,7 @@
 #include "core/concurrency.h"
 #include "core/gamesman_memory.h"
 #include "core/misc.h"
+#include "core/solvers/tier_solver/tier_worker/frontier_bucket.h"
 #include "core/types/gamesman_types.h"
 
 #ifdef _OPENMP
@@ -49,7 +50,7 @@
 
 static bool FrontierAllocateBuckets(Frontier *frontier, int size) {
     frontier->f.buckets =
-        (PositionArray *)GamesmanCallocWhole(size, sizeof(PositionArray));
+        (FrontierBucket *)GamesmanCallocWhole(size, sizeof(FrontierBucket));
     if (frontier->f.buckets == NULL) {
         fprintf(stderr, "FrontierInit: failed to calloc buckets.\n");
         return false;
@@ -81,7 +82,7 @@ static bool FrontierAllocateDividers(Frontier *frontier, int frontier_size,
 
 static void FrontierInitAllFields(Frontier *frontier) {
     for (int i = 0; i < frontier->f.size; ++i) {
-        PositionArrayInit(&frontier->f.buckets[i]);
+        FrontierBucketInit(&frontier->f.buckets[i]);
     }
 }
 
@@ -118,7 +119,7 @@ void FrontierDestroy(Frontier *frontier) {
     // Buckets.
     if (frontier->f.buckets) {
         for (int i = 0; i < frontier->f.size; ++i) {
-            PositionArrayDestroy(&frontier->f.buckets[i]);
+            FrontierBucketDestroy(&frontier->f.buckets[i]);
         }
         GamesmanFree(frontier->f.buckets);
     }
@@ -151,7 +152,7 @@ bool FrontierAdd(Frontier *frontier, Position position, int remoteness,
 
     // Push position into frontier.
     bool success =
-        PositionArrayAppend(&frontier->f.buckets[remoteness], position);
+        FrontierBucketAdd(&frontier->f.buckets[remoteness], position);
     if (!success) return false;
 
     // Update divider.
@@ -170,13 +171,21 @@ void FrontierAccumulateDividers(Frontier *frontier) {
     }
 }
 
-Position FrontierGetPosition(const Frontier *frontier, int remoteness,
-                             int64_t i) {
-    return frontier->f.buckets[remoteness].array[i];
+bool FrontierSeal(Frontier *frontier) {
+    for (int remoteness = 0; remoteness < frontier->f.size; ++remoteness) {
+        if (!FrontierBucketSeal(&frontier->f.buckets[remoteness])) return false;
+    }
+
+    return true;
+}
+
+void FrontierGetPositions(const Frontier *frontier, int remoteness,
+                          int64_t begin, int64_t n, Position *dest) {
+    FrontierBucketGet(&frontier->f.buckets[remoteness], begin, n, dest);
 }
 
 void FrontierFreeRemoteness(Frontier *frontier, int remoteness) {
-    PositionArrayDestroy(&frontier->f.buckets[remoteness]);
+    FrontierBucketDestroy(&frontier->f.buckets[remoteness]);
     GamesmanFree(frontier->f.dividers[remoteness]);
     frontier->f.dividers[remoteness] = NULL;
 }
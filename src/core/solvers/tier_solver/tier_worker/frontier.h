@@ -37,6 +37,7 @@
 #include <stdint.h>   // int64_t
 
 #include "core/gamesman_memory.h"
+#include "core/solvers/tier_solver/tier_worker/frontier_bucket.h"
 #include "core/types/gamesman_types.h"
 
 /**
@@ -46,11 +47,12 @@ typedef struct FrontierInternal {
     /**
      * 2-dimensional Position array. The first dimension is fixed and set to
      * the frontier_size passed to the FrontierInit() function. This is usually
-     * set to the maximum remoteness supported by GAMESMAN plus one. The second
-     * dimension can be dynamically expanded if needed, and the expansion
-     * process is handled by the PositionArray type.
+     * set to the maximum remoteness supported by GAMESMAN plus one. Each
+     * bucket grows in fixed-size chunks as positions are added and can be
+     * compressed once all positions from a child tier have been added. See
+     * FrontierBucket for details.
      */
-    PositionArray *buckets;
+    FrontierBucket *buckets;
 
     /**
      * A 2-dimensional integer array storing the "divider" values. Both
@@ -68,7 +70,8 @@ typedef struct FrontierInternal {
      *
      * Note that for dividers to work, we must assume that child tiers are
      * processed sequentially so that positions loaded from each child tier are
-     * in consecutive chunks.
+     * in consecutive chunks. Sealing the frontier after each child tier keeps
+     * each compressed segment within a single chunk.
      *
      * The dividers are used by the tier solver to figure out which tier the
      * unprocess position was loaded from. Otherwise, we would have to store
@@ -87,9 +90,9 @@ typedef struct FrontierInternal {
  * @brief A Frontier is a dynamic data structure that stores solved
  * positions that have not been used to deduce the values of their parents.
  *
- * @details A Frontier object contains an array of PositionArray objects,
- * where the i-th PositionArray stores solved but unprocessed Positions
- * with remoteness i.
+ * @details A Frontier object contains an array of FrontierBucket objects,
+ * where the i-th bucket stores solved but unprocessed Positions with
+ * remoteness i.
  */
 typedef struct Frontier {
     FrontierInternal f; /**< Unpadded frontier object. */
@@ -139,18 +142,30 @@ bool FrontierAdd(Frontier *frontier, Position position, int remoteness,
 void FrontierAccumulateDividers(Frontier *frontier);
 
 /**
- * @brief Returns the \p i -th position of remoteness \p remoteness in
- * \p frontier.
+ * @brief Compresses all positions added to \p frontier since it was last
+ * sealed. This should be called after all positions have been loaded from a
+ * child tier and before any position from the next child tier is added.
+ *
+ * @param frontier Frontier to seal.
+ * @return \c true on success, or
+ * @return \c false on allocation failure.
+ */
+bool FrontierSeal(Frontier *frontier);
+
+/**
+ * @brief Copies the \p n positions of remoteness \p remoteness at indices
+ * \p begin to \p begin + \p n - 1 in \p frontier into \p dest. Reading
+ * positions in blocks amortizes the cost of decoding compressed buckets.
  *
  * @param frontier Source frontier.
- * @param remoteness Remoteness of the position.
- * @param i Index of the position of the given \p remoteness inside the
- * frontier, which is assumed to be valid.
- * @return The \p i -th position of remoteness \p remoteness in
- * \p frontier.
+ * @param remoteness Remoteness of the positions.
+ * @param begin Index of the first position of the given \p remoteness inside
+ * the frontier, which is assumed to be valid.
+ * @param n Number of positions to copy. The range is assumed to be valid.
+ * @param dest Destination array of at least \p n positions.
  */
-Position FrontierGetPosition(const Frontier *frontier, int remoteness,
-                             int64_t i);
+void FrontierGetPositions(const Frontier *frontier, int remoteness,
+                          int64_t begin, int64_t n, Position *dest);
 
 /**
  * @brief Returns the size of the bucket for the given \p remoteness.
@@ -161,7 +176,7 @@ Position FrontierGetPosition(const Frontier *frontier, int remoteness,
  */
 static inline int64_t FrontierGetBucketSize(const Frontier *frontier,
                                             int remoteness) {
-    return frontier->f.buckets[remoteness].size;
+    return FrontierBucketSize(&frontier->f.buckets[remoteness]);
 }
 
 /**
@@ -0,0 +1,515 @@
+/**
+ * @file frontier_bucket.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the compressible list of solved positions used as
+ * a bucket of the Frontier.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/solvers/tier_solver/tier_worker/frontier_bucket.h"
+
+#include <stdbool.h>  // bool, true, false
+#include <stddef.h>   // NULL, size_t
+#include <stdint.h>   // int64_t, uint8_t, uint64_t
+#include <string.h>   // memcpy, memset
+
+#include "core/data_structures/int64_segmented_array.h"
+#include "core/gamesman_memory.h"
+#include "core/types/gamesman_types.h"
+
+enum {
+    kSegmentsCapacityMin = 4,
+    kWordBits = 64,
+    kSuperblockWords = 8,  // Words per rank sample of a bitmap segment.
+};
+
+typedef enum SegmentType {
+    kSegmentRaw,
+    kSegmentVarint,
+    kSegmentBitmap,
+} SegmentType;
+
+struct FrontierBucketSegment {
+    SegmentType type;
+
+    /** Number of positions in the segment. */
+    int64_t size;
+
+    /**
+     * Varint: [value, byte offset of the next delta] for every
+     * kFrontierBucketSampleInterval-th position.
+     * Bitmap: number of set bits before each superblock.
+     */
+    int64_t *samples;
+    int64_t num_samples;
+
+    /** Varint: zigzag-encoded deltas. Bitmap: bit words. */
+    void *data;
+    int64_t data_bytes;
+
+    /** Bitmap: position represented by the lowest bit of the first word. */
+    Position base;
+
+    /** Raw: positions in insertion order. */
+    Int64SegmentedArray raw;
+};
+
+// ================================== Coding ==================================
+
+static uint64_t ZigzagEncode(Position value, Position prev) {
+    int64_t delta = (int64_t)((uint64_t)value - (uint64_t)prev);
+    return ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+}
+
+static Position ZigzagDecode(Position prev, uint64_t code) {
+    uint64_t delta = (code >> 1) ^ (~(code & 1) + 1);
+    return (Position)((uint64_t)prev + delta);
+}
+
+static int VarintLength(uint64_t code) {
+    int ret = 1;
+    while (code >= 0x80) {
+        code >>= 7;
+        ++ret;
+    }
+
+    return ret;
+}
+
+static int64_t VarintWrite(uint8_t *dest, int64_t offset, uint64_t code) {
+    while (code >= 0x80) {
+        dest[offset++] = (uint8_t)(code | 0x80);
+        code >>= 7;
+    }
+    dest[offset++] = (uint8_t)code;
+
+    return offset;
+}
+
+static uint64_t VarintRead(const uint8_t *src, int64_t *offset) {
+    uint64_t ret = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+        byte = src[(*offset)++];
+        ret |= (uint64_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    return ret;
+}
+
+// ============================= Segment Encoding =============================
+
+typedef struct TailStats {
+    Position min;
+    Position max;
+    int64_t varint_bytes;  // Excluding sampled positions.
+} TailStats;
+
+static TailStats GetTailStats(const Int64SegmentedArray *tail) {
+    TailStats ret = {
+        .min = Int64SegmentedArrayGet(tail, 0),
+        .max = Int64SegmentedArrayGet(tail, 0),
+        .varint_bytes = 0,
+    };
+    Position prev = 0;
+    int64_t i = 0;
+    for (int64_t c = 0; c < Int64SegmentedArrayNumChunks(tail); ++c) {
+        const Position *chunk = Int64SegmentedArrayChunk(tail, c);
+        int64_t length = Int64SegmentedArrayChunkLength(tail, c);
+        for (int64_t j = 0; j < length; ++j, ++i) {
+            Position position = chunk[j];
+            if (position < ret.min) ret.min = position;
+            if (position > ret.max) ret.max = position;
+            if (i % kFrontierBucketSampleInterval != 0) {
+                ret.varint_bytes += VarintLength(ZigzagEncode(position, prev));
+            }
+            prev = position;
+        }
+    }
+
+    return ret;
+}
+
+static int64_t NumVarintSamples(int64_t size) {
+    return (size + kFrontierBucketSampleInterval - 1) /
+           kFrontierBucketSampleInterval;
+}
+
+static int64_t NumBitmapWords(const TailStats *stats) {
+    return (stats->max - stats->min) / kWordBits + 1;
+}
+
+static int64_t NumBitmapSamples(int64_t num_words) {
+    return (num_words + kSuperblockWords - 1) / kSuperblockWords;
+}
+
+static size_t VarintSegmentBytes(const TailStats *stats, int64_t size) {
+    return (size_t)NumVarintSamples(size) * 2 * sizeof(int64_t) +
+           (size_t)stats->varint_bytes;
+}
+
+static size_t BitmapSegmentBytes(const TailStats *stats) {
+    int64_t num_words = NumBitmapWords(stats);
+
+    return (size_t)NumBitmapSamples(num_words) * sizeof(int64_t) +
+           (size_t)num_words * sizeof(uint64_t);
+}
+
+// Allocates the samples and the data of SEGMENT in one block.
+static bool AllocateEncoded(FrontierBucketSegment *segment, int64_t num_samples,
+                            int64_t sample_words, int64_t data_bytes) {
+    size_t samples_bytes = (size_t)(num_samples * sample_words) *
+                           sizeof(int64_t);
+    segment->samples = (int64_t *)GamesmanMalloc(samples_bytes + data_bytes);
+    if (segment->samples == NULL) return false;
+
+    segment->num_samples = num_samples;
+    segment->data = (uint8_t *)segment->samples + samples_bytes;
+    segment->data_bytes = data_bytes;
+
+    return true;
+}
+
+static bool EncodeVarint(FrontierBucketSegment *segment,
+                         const Int64SegmentedArray *tail,
+                         const TailStats *stats) {
+    int64_t size = Int64SegmentedArraySize(tail);
+    if (!AllocateEncoded(segment, NumVarintSamples(size), 2,
+                         stats->varint_bytes)) {
+        return false;
+    }
+
+    uint8_t *data = (uint8_t *)segment->data;
+    int64_t offset = 0, i = 0;
+    Position prev = 0;
+    for (int64_t c = 0; c < Int64SegmentedArrayNumChunks(tail); ++c) {
+        const Position *chunk = Int64SegmentedArrayChunk(tail, c);
+        int64_t length = Int64SegmentedArrayChunkLength(tail, c);
+        for (int64_t j = 0; j < length; ++j, ++i) {
+            Position position = chunk[j];
+            if (i % kFrontierBucketSampleInterval == 0) {
+                int64_t s = i / kFrontierBucketSampleInterval;
+                segment->samples[2 * s] = position;
+                segment->samples[2 * s + 1] = offset;
+            } else {
+                uint64_t code = ZigzagEncode(position, prev);
+                offset = VarintWrite(data, offset, code);
+            }
+            prev = position;
+        }
+    }
+    segment->type = kSegmentVarint;
+
+    return true;
+}
+
+static bool EncodeBitmap(FrontierBucketSegment *segment,
+                         const Int64SegmentedArray *tail,
+                         const TailStats *stats) {
+    int64_t num_words = NumBitmapWords(stats);
+    int64_t num_samples = NumBitmapSamples(num_words);
+    if (!AllocateEncoded(segment, num_samples, 1,
+                         num_words * (int64_t)sizeof(uint64_t))) {
+        return false;
+    }
+
+    uint64_t *words = (uint64_t *)segment->data;
+    memset(words, 0, num_words * sizeof(uint64_t));
+    for (int64_t c = 0; c < Int64SegmentedArrayNumChunks(tail); ++c) {
+        const Position *chunk = Int64SegmentedArrayChunk(tail, c);
+        int64_t length = Int64SegmentedArrayChunkLength(tail, c);
+        for (int64_t j = 0; j < length; ++j) {
+            int64_t bit = chunk[j] - stats->min;
+            words[bit / kWordBits] |= 1ULL << (bit % kWordBits);
+        }
+    }
+
+    int64_t rank = 0;
+    for (int64_t w = 0; w < num_words; ++w) {
+        if (w % kSuperblockWords == 0) {
+            segment->samples[w / kSuperblockWords] = rank;
+        }
+        rank += __builtin_popcountll(words[w]);
+    }
+    segment->base = stats->min;
+    segment->type = kSegmentBitmap;
+
+    return true;
+}
+
+// ============================= Segment Decoding =============================
+
+static void GetRaw(const FrontierBucketSegment *segment, int64_t begin,
+                   int64_t n, Position *dest) {
+    for (int64_t i = 0; i < n; ++i) {
+        dest[i] = Int64SegmentedArrayGet(&segment->raw, begin + i);
+    }
+}
+
+static void GetVarint(const FrontierBucketSegment *segment, int64_t begin,
+                      int64_t n, Position *dest) {
+    const uint8_t *data = (const uint8_t *)segment->data;
+    int64_t s = begin / kFrontierBucketSampleInterval;
+    Position value = segment->samples[2 * s];
+    int64_t offset = segment->samples[2 * s + 1];
+    for (int64_t i = s * kFrontierBucketSampleInterval; i < begin; ++i) {
+        value = ZigzagDecode(value, VarintRead(data, &offset));
+    }
+
+    dest[0] = value;
+    for (int64_t i = begin + 1; i < begin + n; ++i) {
+        if (i % kFrontierBucketSampleInterval == 0) {
+            s = i / kFrontierBucketSampleInterval;
+            value = segment->samples[2 * s];
+            offset = segment->samples[2 * s + 1];
+        } else {
+            value = ZigzagDecode(value, VarintRead(data, &offset));
+        }
+        dest[i - begin] = value;
+    }
+}
+
+static void GetBitmap(const FrontierBucketSegment *segment, int64_t begin,
+                      int64_t n, Position *dest) {
+    const uint64_t *words = (const uint64_t *)segment->data;
+
+    // Find the last superblock that begins at or before the begin-th set bit.
+    int64_t lo = 0, hi = segment->num_samples - 1;
+    while (lo < hi) {
+        int64_t mid = lo + (hi - lo + 1) / 2;
+        if (segment->samples[mid] <= begin) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    // Find the word containing the begin-th set bit.
+    int64_t w = lo * kSuperblockWords;
+    int64_t rank = segment->samples[lo];
+    int popcount = __builtin_popcountll(words[w]);
+    while (rank + popcount <= begin) {
+        rank += popcount;
+        popcount = __builtin_popcountll(words[++w]);
+    }
+
+    // Clear the set bits before it and start copying.
+    uint64_t bits = words[w];
+    for (int64_t i = rank; i < begin; ++i) bits &= bits - 1;
+    for (int64_t i = 0; i < n; ++i) {
+        while (bits == 0) bits = words[++w];
+        dest[i] = segment->base + w * kWordBits + __builtin_ctzll(bits);
+        bits &= bits - 1;
+    }
+}
+
+static void SegmentGet(const FrontierBucketSegment *segment, int64_t begin,
+                       int64_t n, Position *dest) {
+    switch (segment->type) {
+        case kSegmentRaw:
+            GetRaw(segment, begin, n, dest);
+            break;
+
+        case kSegmentVarint:
+            GetVarint(segment, begin, n, dest);
+            break;
+
+        case kSegmentBitmap:
+            GetBitmap(segment, begin, n, dest);
+            break;
+    }
+}
+
+static void SegmentDestroy(FrontierBucketSegment *segment) {
+    if (segment == NULL) return;
+    if (segment->type == kSegmentRaw) {
+        Int64SegmentedArrayDestroy(&segment->raw);
+    } else {
+        GamesmanFree(segment->samples);
+    }
+    GamesmanFree(segment);
+}
+
+// ================================ Public API ================================
+
+void FrontierBucketInit(FrontierBucket *bucket) {
+    bucket->segments = NULL;
+    bucket->segment_offsets = NULL;
+    bucket->num_segments = 0;
+    bucket->segments_capacity = 0;
+    bucket->sealed_size = 0;
+    Int64SegmentedArrayInit(&bucket->tail);
+}
+
+void FrontierBucketDestroy(FrontierBucket *bucket) {
+    for (int i = 0; i < bucket->num_segments; ++i) {
+        SegmentDestroy(bucket->segments[i]);
+    }
+    GamesmanFree(bucket->segments);
+    GamesmanFree(bucket->segment_offsets);
+    Int64SegmentedArrayDestroy(&bucket->tail);
+    FrontierBucketInit(bucket);
+}
+
+bool FrontierBucketAdd(FrontierBucket *bucket, Position position) {
+    return Int64SegmentedArrayPushBack(&bucket->tail, position);
+}
+
+static bool ExpandSegments(FrontierBucket *bucket) {
+    int new_capacity = bucket->segments_capacity == 0
+                           ? kSegmentsCapacityMin
+                           : bucket->segments_capacity * 2;
+    FrontierBucketSegment **new_segments = (FrontierBucketSegment **)
+        GamesmanMalloc(new_capacity * sizeof(FrontierBucketSegment *));
+    int64_t *new_offsets =
+        (int64_t *)GamesmanMalloc(new_capacity * sizeof(int64_t));
+    if (new_segments == NULL || new_offsets == NULL) {
+        GamesmanFree(new_segments);
+        GamesmanFree(new_offsets);
+        return false;
+    }
+
+    if (bucket->num_segments > 0) {
+        memcpy(new_segments, bucket->segments,
+               bucket->num_segments * sizeof(FrontierBucketSegment *));
+        memcpy(new_offsets, bucket->segment_offsets,
+               bucket->num_segments * sizeof(int64_t));
+    }
+    GamesmanFree(bucket->segments);
+    GamesmanFree(bucket->segment_offsets);
+    bucket->segments = new_segments;
+    bucket->segment_offsets = new_offsets;
+    bucket->segments_capacity = new_capacity;
+
+    return true;
+}
+
+bool FrontierBucketSeal(FrontierBucket *bucket) {
+    int64_t size = Int64SegmentedArraySize(&bucket->tail);
+    if (size == 0) return true;
+
+    if (bucket->num_segments == bucket->segments_capacity &&
+        !ExpandSegments(bucket)) {
+        return false;
+    }
+    FrontierBucketSegment *segment =
+        (FrontierBucketSegment *)GamesmanMalloc(sizeof(FrontierBucketSegment));
+    if (segment == NULL) return false;
+    memset(segment, 0, sizeof(*segment));
+    segment->size = size;
+
+    // Pick the smallest encoding. Falls back to keeping the positions as they
+    // are if the encoded segment cannot be allocated.
+    TailStats stats = GetTailStats(&bucket->tail);
+    size_t raw_bytes = (size_t)size * sizeof(Position);
+    size_t varint_bytes = VarintSegmentBytes(&stats, size);
+    size_t bitmap_bytes = BitmapSegmentBytes(&stats);
+    bool encoded = false;
+    if (bitmap_bytes < varint_bytes && bitmap_bytes < raw_bytes) {
+        encoded = EncodeBitmap(segment, &bucket->tail, &stats);
+    } else if (varint_bytes < raw_bytes) {
+        encoded = EncodeVarint(segment, &bucket->tail, &stats);
+    }
+
+    if (encoded) {
+        Int64SegmentedArrayClear(&bucket->tail);
+    } else {
+        segment->type = kSegmentRaw;
+        segment->raw = bucket->tail;
+        Int64SegmentedArrayInit(&bucket->tail);
+    }
+    bucket->segments[bucket->num_segments] = segment;
+    bucket->segment_offsets[bucket->num_segments] = bucket->sealed_size;
+    ++bucket->num_segments;
+    bucket->sealed_size += size;
+
+    return true;
+}
+
+// Returns the index of the segment containing the i-th position in BUCKET,
+// assuming that it is in a sealed segment.
+static int FindSegment(const FrontierBucket *bucket, int64_t i) {
+    int lo = 0, hi = bucket->num_segments - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (bucket->segment_offsets[mid] <= i) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    return lo;
+}
+
+void FrontierBucketGet(const FrontierBucket *bucket, int64_t begin, int64_t n,
+                       Position *dest) {
+    if (n > 0 && begin < bucket->sealed_size) {
+        int s = FindSegment(bucket, begin);
+        while (n > 0 && s < bucket->num_segments) {
+            const FrontierBucketSegment *segment = bucket->segments[s];
+            int64_t local = begin - bucket->segment_offsets[s];
+            int64_t count = segment->size - local;
+            if (count > n) count = n;
+            SegmentGet(segment, local, count, dest);
+            begin += count;
+            dest += count;
+            n -= count;
+            ++s;
+        }
+    }
+
+    for (int64_t i = 0; i < n; ++i) {
+        dest[i] = Int64SegmentedArrayGet(&bucket->tail,
+                                         begin + i - bucket->sealed_size);
+    }
+}
+
+static size_t SegmentedArrayMemUsage(const Int64SegmentedArray *array) {
+    size_t ret = (size_t)array->chunks_capacity * sizeof(int64_t *);
+    if (array->num_chunks > 0) {
+        ret += (size_t)array->head_capacity * sizeof(int64_t);
+        ret += (size_t)(array->num_chunks - 1) *
+               kInt64SegmentedArrayChunkSize * sizeof(int64_t);
+    }
+
+    return ret;
+}
+
+size_t FrontierBucketMemUsage(const FrontierBucket *bucket) {
+    size_t ret = (size_t)bucket->segments_capacity *
+                 (sizeof(FrontierBucketSegment *) + sizeof(int64_t));
+    for (int i = 0; i < bucket->num_segments; ++i) {
+        const FrontierBucketSegment *segment = bucket->segments[i];
+        ret += sizeof(FrontierBucketSegment);
+        if (segment->type == kSegmentRaw) {
+            ret += SegmentedArrayMemUsage(&segment->raw);
+        } else {
+            ret += (size_t)segment->data_bytes +
+                   (size_t)((uint8_t *)segment->data -
+                            (uint8_t *)segment->samples);
+        }
+    }
+
+    return ret + SegmentedArrayMemUsage(&bucket->tail);
+}
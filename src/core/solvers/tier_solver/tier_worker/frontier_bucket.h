@@ -0,0 +1,141 @@
+/**
+ * @file frontier_bucket.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Compressible list of solved positions of the same remoteness, used as
+ * a bucket of the Frontier.
+ * @details New positions are appended to an uncompressed tail. Sealing the
+ * bucket compresses the tail into an immutable segment using whichever of the
+ * following encodings is the smallest for its contents:
+ *  - a bitmap over the range of positions in the segment, which costs about
+ *    one bit per position in the range and suits dense segments;
+ *  - a list of zigzag-encoded deltas between consecutive positions stored as
+ *    variable-length integers, which costs one or two bytes per position when
+ *    positions are added in roughly ascending order, as they are when a child
+ *    tier is scanned; or
+ *  - the uncompressed positions, which are kept without copying.
+ *
+ * Sealing only guarantees that the segment holds the same set of positions;
+ * the order of the positions within a segment may change. Positions can be
+ * read back by index, in blocks, from any number of threads. Every
+ * \c kFrontierBucketSampleInterval -th position of a compressed segment is
+ * sampled so that reading from an arbitrary index decodes at most that many
+ * extra positions.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_SOLVERS_TIER_SOLVER_FRONTIER_BUCKET_H_
+#define GAMESMANONE_CORE_SOLVERS_TIER_SOLVER_FRONTIER_BUCKET_H_
+
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+#include <stdint.h>   // int64_t
+
+#include "core/data_structures/int64_segmented_array.h"
+#include "core/types/gamesman_types.h"
+
+enum {
+    /** Number of positions between two sampled positions in a segment. */
+    kFrontierBucketSampleInterval = 64,
+};
+
+/** @brief Immutable compressed segment of a FrontierBucket. */
+typedef struct FrontierBucketSegment FrontierBucketSegment;
+
+/** @brief Compressible list of positions. */
+typedef struct FrontierBucket {
+    /** Sealed segments in the order they were sealed. */
+    FrontierBucketSegment **segments;
+
+    /** Index of the first position of each segment in the bucket. */
+    int64_t *segment_offsets;
+
+    /** Number of sealed segments. */
+    int num_segments;
+
+    /** Capacity of the segments and segment_offsets arrays. */
+    int segments_capacity;
+
+    /** Total number of positions in the sealed segments. */
+    int64_t sealed_size;
+
+    /** Positions added since the bucket was last sealed. */
+    Int64SegmentedArray tail;
+} FrontierBucket;
+
+/** @brief Initializes \p bucket to an empty bucket. */
+void FrontierBucketInit(FrontierBucket *bucket);
+
+/** @brief Destroys \p bucket, freeing all allocated memory. */
+void FrontierBucketDestroy(FrontierBucket *bucket);
+
+/**
+ * @brief Appends \p position to the uncompressed tail of \p bucket.
+ *
+ * @param bucket Destination bucket.
+ * @param position Position to append.
+ * @return \c true on success, or
+ * @return \c false on allocation failure.
+ */
+bool FrontierBucketAdd(FrontierBucket *bucket, Position position);
+
+/**
+ * @brief Compresses the positions added to \p bucket since it was last sealed
+ * into a new segment. The positions in the tail must be unique. The order of
+ * the positions in the new segment may differ from the order in which they
+ * were added, but positions in earlier segments and the indices at which
+ * segments begin are not affected.
+ *
+ * @note If there is not enough memory to compress the positions, they are
+ * moved into an uncompressed segment instead.
+ *
+ * @param bucket Bucket to seal.
+ * @return \c true on success, or
+ * @return \c false on allocation failure, in which case \p bucket is
+ * unchanged.
+ */
+bool FrontierBucketSeal(FrontierBucket *bucket);
+
+/** @brief Returns the number of positions in \p bucket. */
+static inline int64_t FrontierBucketSize(const FrontierBucket *bucket) {
+    return bucket->sealed_size + Int64SegmentedArraySize(&bucket->tail);
+}
+
+/**
+ * @brief Copies the \p n positions at indices \p begin to \p begin + \p n - 1
+ * of \p bucket into \p dest. Thread-safe as long as \p bucket is not modified
+ * concurrently.
+ *
+ * @param bucket Source bucket.
+ * @param begin Index of the first position to read, which is assumed to be
+ * valid.
+ * @param n Number of positions to read. The range is assumed to be valid.
+ * @param dest Destination array of at least \p n positions.
+ */
+void FrontierBucketGet(const FrontierBucket *bucket, int64_t begin, int64_t n,
+                       Position *dest);
+
+/**
+ * @brief Returns the number of bytes of heap memory used by the contents of
+ * \p bucket, not including allocator overhead.
+ */
+size_t FrontierBucketMemUsage(const FrontierBucket *bucket);
+
+#endif  // GAMESMANONE_CORE_SOLVERS_TIER_SOLVER_FRONTIER_BUCKET_H_
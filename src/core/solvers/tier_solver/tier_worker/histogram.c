@@ -0,0 +1,110 @@
+/**
+ * @file histogram.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the per-tier histograms recorded by the tier
+ * workers.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/solvers/tier_solver/tier_worker/histogram.h"
+
+#include <stdbool.h>  // bool, true, false
+#include <stddef.h>   // NULL
+#include <stdint.h>   // int64_t
+
+#include "core/analysis/analysis.h"
+#include "core/analysis/stat_manager.h"
+#include "core/concurrency.h"
+#include "core/db/db_manager.h"
+#include "core/gamesman_memory.h"
+#include "core/solvers/tier_solver/tier_solver.h"
+#include "core/types/gamesman_types.h"
+
+static int CountPositions(const TierSolverApi *api, Tier tier, int64_t size,
+                          CacheAlignedAnalysis *parts);
+
+// -----------------------------------------------------------------------------
+
+int TierWorkerUpdateHistogram(const TierSolverApi *api, Tier tier,
+                              int64_t size, bool enabled) {
+    if (!enabled) return StatManagerRemoveHistogram(tier);
+
+    int num_threads = ConcurrencyGetOmpNumThreads();
+    CacheAlignedAnalysis *parts = (CacheAlignedAnalysis *)GamesmanMalloc(
+        num_threads * sizeof(CacheAlignedAnalysis));
+    Analysis *histogram = (Analysis *)GamesmanMalloc(sizeof(Analysis));
+    int error = kMallocFailureError;
+    if (parts == NULL || histogram == NULL) goto _bailout;
+
+    for (int i = 0; i < num_threads; ++i) {
+        AnalysisInit(&parts[i].data);
+    }
+    error = CountPositions(api, tier, size, parts);
+    if (error != kNoError) goto _bailout;
+
+    AnalysisInit(histogram);
+    AnalysisSetHashSize(histogram, size);
+    for (int i = 0; i < num_threads; ++i) {
+        AnalysisMergeCounts(histogram, &parts[i]);
+    }
+    error = StatManagerSaveHistogram(tier, histogram);
+
+_bailout:
+    GamesmanFree(parts);
+    GamesmanFree(histogram);
+    if (error != kNoError) StatManagerRemoveHistogram(tier);
+
+    return error;
+}
+
+// -----------------------------------------------------------------------------
+
+static int CountPositions(const TierSolverApi *api, Tier tier, int64_t size,
+                          CacheAlignedAnalysis *parts) {
+    ConcurrentBool success;
+    ConcurrentBoolInit(&success, true);
+    PRAGMA_OMP_PARALLEL {
+        int tid = ConcurrencyGetOmpThreadId();
+        PRAGMA_OMP_FOR_SCHEDULE_DYNAMIC(1024)
+        for (Position position = 0; position < size; ++position) {
+            if (!ConcurrentBoolLoad(&success)) continue;  // fail fast.
+            TierPosition tier_position = {.tier = tier, .position = position};
+            if (!api->IsLegalPosition(tier_position)) continue;
+
+            // Only canonical positions are solved.
+            Position canonical = api->GetCanonicalPosition(tier_position);
+            Value value = DbManagerGetValue(canonical);
+
+            // Positions left undecided are unreachable if the solve was
+            // restricted to reachable positions. Leaving them out keeps the
+            // histogram a superset of the reachable positions, so the analyzer
+            // may still use it when the counts match.
+            if (value == kUndecided) continue;
+            int remoteness = DbManagerGetRemoteness(canonical);
+            int error = AnalysisCount(&parts[tid].data, tier_position, value,
+                                      remoteness, position == canonical);
+            if (error != kNoError) ConcurrentBoolStore(&success, false);
+        }
+    }
+
+    return ConcurrentBoolLoad(&success) ? kNoError
+                                        : kIllegalGamePositionValueError;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file histogram.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Per-tier value and remoteness histograms recorded by the tier workers
+ * for the analyzer.
+ * @details Once a tier is solved, all of its values are in memory until the
+ * tier is flushed. Counting them at that point lets the analyzer skip loading
+ * the tier again from the database if every legal position in it turns out to
+ * be reachable.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_SOLVERS_TIER_SOLVER_TIER_WORKER_HISTOGRAM_H_
+#define GAMESMANONE_CORE_SOLVERS_TIER_SOLVER_TIER_WORKER_HISTOGRAM_H_
+
+#include <stdbool.h>  // bool
+#include <stdint.h>   // int64_t
+
+#include "core/solvers/tier_solver/tier_solver.h"
+#include "core/types/gamesman_types.h"
+
+/**
+ * @brief Records the histogram of the solving \p tier of size \p size if
+ * \p enabled, or removes the histogram left by a previous solve of \p tier
+ * otherwise.
+ *
+ * @note Must be called after all values of \p tier have been decided and
+ * before the solving tier is flushed. Positions are counted as the analyzer
+ * counts them: every legal position with the value and remoteness of its
+ * canonical position. Positions whose canonical position was left undecided
+ * are skipped.
+ *
+ * @param api Game-specific tier solver API functions.
+ * @param tier Tier being solved.
+ * @param size Size of \p tier.
+ * @param enabled Whether to record the histogram.
+ * @return \c kNoError on success, or
+ * @return non-zero error code otherwise, in which case no histogram is left
+ * for \p tier.
+ */
+int TierWorkerUpdateHistogram(const TierSolverApi *api, Tier tier,
+                              int64_t size, bool enabled);
+
+#endif  // GAMESMANONE_CORE_SOLVERS_TIER_SOLVER_TIER_WORKER_HISTOGRAM_H_
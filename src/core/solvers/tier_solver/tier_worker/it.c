@@ -31,13 +31,16 @@
 #include <stdint.h>   // intptr_t, int64_t
 #include <stdio.h>    // printf, fprintf, stderr
 
+#include "core/analysis/stat_manager.h"
 #include "core/concurrency.h"
 #include "core/constants.h"
 #include "core/data_structures/bitstream.h"
+#include "core/data_structures/concurrent_bitset.h"
 #include "core/db/db_manager.h"
 #include "core/gamesman_memory.h"
 #include "core/misc.h"
 #include "core/solvers/tier_solver/tier_solver.h"
+#include "core/solvers/tier_solver/tier_worker/histogram.h"
 #include "core/types/gamesman_types.h"
 
 // Include and use OpenMP if the _OPENMP flag is set.
@@ -57,6 +60,10 @@ static intptr_t mem;            // Heap memory remaining for loading tiers.
 static Tier this_tier;          // The tier being solved.
 static int64_t this_tier_size;  // Size of the tier being solved.
 
+// Canonical positions of the current tier that are reachable from the initial
+// position, or NULL if all legal positions are solved.
+static ConcurrentBitset *reachable;
+
 // Canonical child tiers of the tier being solved.
 static TierArray canonical_child_tiers;
 
@@ -92,8 +99,21 @@ static bool Step0_0SetupChildTiers(void) {
     return true;
 }
 
+static bool Step0_1LoadReachableMap(bool reachable_only) {
+    if (!reachable_only) return true;
+
+    // Solve all legal positions if the tier has no reachable map.
+    int error = StatManagerLoadReachableMap(this_tier, this_tier_size, NULL,
+                                            &reachable);
+    if (error == kFileSystemError) return true;
+    if (error != kNoError) return false;
+    mem -= ConcurrentBitsetMemRequired(this_tier_size);
+
+    return TierWorkerSaveRestrictedMark(this_tier) == kNoError;
+}
+
 static bool Step0Initialize(const TierSolverApi *api, Tier tier,
-                            intptr_t memlimit) {
+                            intptr_t memlimit, bool reachable_only) {
     api_internal = api;
     mem = memlimit ? memlimit : (intptr_t)GetPhysicalMemory() / 10 * 9;
     this_tier = tier;
@@ -106,6 +126,7 @@ static bool Step0Initialize(const TierSolverApi *api, Tier tier,
     mem -= DbManagerTierMemUsage(this_tier, this_tier_size);
     int error = DbManagerCreateSolvingTier(this_tier, this_tier_size);
     if (error != kNoError) return false;
+    if (!Step0_1LoadReachableMap(reachable_only)) return false;
 
     if (canonical_child_tiers.size > 0) {
         // Make sure that there is enough memory to load the largest child tier.
@@ -150,6 +171,11 @@ static bool IsCanonicalPosition(Position position) {
     return api_internal->GetCanonicalPosition(tier_position) == position;
 }
 
+static bool IsReachable(Position position) {
+    return reachable == NULL ||
+           ConcurrentBitsetTest(reachable, position, memory_order_relaxed);
+}
+
 static Value GetParentValue(Value child_value) {
     switch (child_value) {
         case kWin:
@@ -242,8 +268,9 @@ static bool Step1_1IterateOnePass(void) {
         if (!success) continue;  // Fail fast.
         TierPosition tier_position = {.tier = this_tier, .position = pos};
 
-        // Skip if illegal or non-canonical.
-        if (!api_internal->IsLegalPosition(tier_position) ||
+        // Skip if unreachable, illegal or non-canonical.
+        if (!IsReachable(pos) ||
+            !api_internal->IsLegalPosition(tier_position) ||
             !IsCanonicalPosition(pos)) {
             continue;
         }
@@ -309,7 +336,15 @@ _bailout:
 
 // ------------------------------- Step2FlushDb -------------------------------
 
-static void Step2FlushDb(void) {
+static void Step2FlushDb(bool histogram) {
+    int error = TierWorkerUpdateHistogram(api_internal, this_tier,
+                                          this_tier_size, histogram);
+    if (error != kNoError) {
+        fprintf(stderr,
+                "Step2FlushDb: failed to update the histogram of tier "
+                "%" PRITier ", code %d\n",
+                this_tier, error);
+    }
     if (DbManagerFlushSolvingTier(NULL) != 0) {
         fprintf(stderr,
                 "Step2FlushDb: an error has occurred while flushing of the "
@@ -376,6 +411,8 @@ _bailout:
 static void Step3Cleanup(void) {
     this_tier = kIllegalTier;
     this_tier_size = kIllegalSize;
+    ConcurrentBitsetDestroy(reachable);
+    reachable = NULL;
     for (int64_t i = 0; i < canonical_child_tiers.size; ++i) {
         Tier child_tier = canonical_child_tiers.array[i];
         if (DbManagerIsTierLoaded(child_tier)) DbManagerUnloadTier(child_tier);
@@ -394,14 +431,16 @@ int TierWorkerSolveITInternal(const TierSolverApi *api, Tier tier,
                               bool *solved) {
     if (solved != NULL) *solved = false;
     int ret = kRuntimeError;
-    if (!options->force && DbManagerTierStatus(tier) == kDbTierStatusSolved) {
+    if (!options->force && TierWorkerIsSolved(tier, options)) {
         goto _done;
     }
 
     /* Immediate transition main algorithm. */
-    if (!Step0Initialize(api, tier, memlimit)) goto _bailout;
+    if (!Step0Initialize(api, tier, memlimit, options->reachable_only)) {
+        goto _bailout;
+    }
     if (!Step1Iterate()) goto _bailout;
-    Step2FlushDb();
+    Step2FlushDb(options->histogram);
     if (options->compare && !CompareDb()) goto _bailout;
     if (solved != NULL) *solved = true;
 
@@ -164,7 +164,7 @@ static int TestCustomGetCanonicalChildrenFunctions(
     int ret = kTierSolverTestNoError;
 
     // Test if the sizes match.
-    if (num_children != ref.size) {
+    if (num_children != TierPositionHashSetSize(&ref)) {
         ret = kTierSolverTestGetCanonicalChildPositionsMismatch;
         goto _bailout;
     }
@@ -180,7 +180,7 @@ static int TestCustomGetCanonicalChildrenFunctions(
     // Test if the custom GetNumberOfCanonicalChildPositions is correct.
     int num_canonical =
         api_internal->GetNumberOfCanonicalChildPositions(parent);
-    if (num_canonical != ref.size) {
+    if (num_canonical != TierPositionHashSetSize(&ref)) {
         ret = kTierSolverTestGetNumberOfCanonicalChildPositionsMismatch;
         goto _bailout;
     }
@@ -31,11 +31,14 @@
 #include <stdint.h>   // int32_t, int64_t
 #include <stdio.h>    // puts, printf, fprintf, stderr
 
+#include "core/analysis/stat_manager.h"
 #include "core/concurrency.h"
 #include "core/constants.h"
+#include "core/data_structures/concurrent_bitset.h"
 #include "core/db/db_manager.h"
 #include "core/misc.h"
 #include "core/solvers/tier_solver/tier_solver.h"
+#include "core/solvers/tier_solver/tier_worker/histogram.h"
 #include "core/types/gamesman_types.h"
 #include "libs/lz4_utils/lz4_utils.h"
 
@@ -75,6 +78,10 @@ static int verbose;
 static Tier this_tier;          // The tier being solved.
 static int64_t this_tier_size;  // Size of the tier being solved.
 
+// Canonical positions of the current tier that are reachable from the initial
+// position, or NULL if all legal positions are solved.
+static ConcurrentBitset *reachable;
+
 // Child tiers of the tier being solved.
 static Tier child_tiers[kTierSolverNumChildTiersMax];
 static int num_child_tiers;  // Number of child tiers.
@@ -126,8 +133,20 @@ static double GetCheckpointSaveCostEstimate(void) {
                kTypicalHDDSpeed;
 }
 
+static bool Step0_1LoadReachableMap(bool reachable_only) {
+    if (!reachable_only) return true;
+
+    // Solve all legal positions if the tier has no reachable map.
+    int error = StatManagerLoadReachableMap(this_tier, this_tier_size, NULL,
+                                            &reachable);
+    if (error == kFileSystemError) return true;
+    if (error != kNoError) return false;
+
+    return TierWorkerSaveRestrictedMark(this_tier) == kNoError;
+}
+
 static bool Step0Initialize(const TierSolverApi *api, Tier tier,
-                            int verbosity) {
+                            int verbosity, bool reachable_only) {
     api_internal = api;
     this_tier = tier;
     verbose = verbosity;
@@ -138,7 +157,7 @@ static bool Step0Initialize(const TierSolverApi *api, Tier tier,
     max_tie_remoteness = 0;
     checkpoint_save_cost = GetCheckpointSaveCostEstimate();
 
-    return true;
+    return Step0_1LoadReachableMap(reachable_only);
 }
 
 // ----------------------------- Step1LoadChildren -----------------------------
@@ -209,15 +228,22 @@ static bool IsCanonicalPosition(Position position) {
     return api_internal->GetCanonicalPosition(tier_position) == position;
 }
 
+static bool IsReachable(Position position) {
+    return reachable == NULL ||
+           ConcurrentBitsetTest(reachable, position, memory_order_relaxed);
+}
+
 static void Step3ScanTier(void) {
     if (verbose > 1) PrintfAndFlush("Value iteration: scanning tier... ");
     PRAGMA_OMP_PARALLEL_FOR_SCHEDULE_DYNAMIC(256)
     for (Position pos = 0; pos < this_tier_size; ++pos) {
         TierPosition tier_position = {.tier = this_tier, .position = pos};
-        if (!api_internal->IsLegalPosition(tier_position) ||
+        if (!IsReachable(pos) ||
+            !api_internal->IsLegalPosition(tier_position) ||
             !IsCanonicalPosition(pos)) {
-            // Temporarily mark illegal and non-canonical positions as
-            // drawing. These values will be changed to undecided later.
+            // Temporarily mark unreachable, illegal and non-canonical
+            // positions as drawing. These values will be changed to undecided
+            // later.
             DbManagerSetValue(pos, kDraw);
             continue;
         }
@@ -475,7 +501,15 @@ static bool Step5MarkDrawPositions(void) {
 
 // ------------------------------- Step6FlushDb -------------------------------
 
-static void Step6FlushDb(void) {
+static void Step6FlushDb(bool histogram) {
+    int error = TierWorkerUpdateHistogram(api_internal, this_tier,
+                                          this_tier_size, histogram);
+    if (error != kNoError) {
+        fprintf(stderr,
+                "Step6FlushDb: failed to update the histogram of tier "
+                "%" PRITier ", code %d\n",
+                this_tier, error);
+    }
     if (verbose > 1) PrintfAndFlush("Value iteration: flusing DB... ");
     if (DbManagerFlushSolvingTier(NULL) != 0) {
         fprintf(stderr,
@@ -548,6 +582,8 @@ static bool Step7Cleanup(void) {
     }
     this_tier = kIllegalTier;
     this_tier_size = kIllegalSize;
+    ConcurrentBitsetDestroy(reachable);
+    reachable = NULL;
     for (int64_t i = 0; i < num_child_tiers; ++i) {
         Tier child_tier = child_tiers[i];
         if (DbManagerIsTierLoaded(child_tier)) DbManagerUnloadTier(child_tier);
@@ -567,13 +603,16 @@ int TierWorkerSolveVIInternal(const TierSolverApi *api, Tier tier,
                               bool *solved) {
     if (solved != NULL) *solved = false;
     int ret = kRuntimeError;
-    if (!options->force && DbManagerTierStatus(tier) == kDbTierStatusSolved) {
+    if (!options->force && TierWorkerIsSolved(tier, options)) {
         ret = kNoError;  // Success.
         goto _bailout;
     }
 
     /* Value Iteration main algorithm. */
-    if (!Step0Initialize(api, tier, options->verbose)) goto _bailout;
+    if (!Step0Initialize(api, tier, options->verbose,
+                         options->reachable_only)) {
+        goto _bailout;
+    }
     if (!Step1LoadChildren()) goto _bailout;
     CheckpointStatus ct = {.step = kNotStarted, .remoteness = -1};
     if (!Step2SetupSolvingTier(&ct)) goto _bailout;
@@ -584,7 +623,7 @@ int TierWorkerSolveVIInternal(const TierSolverApi *api, Tier tier,
         goto _bailout;
     }
     if (!Step5MarkDrawPositions()) goto _bailout;
-    Step6FlushDb();
+    Step6FlushDb(options->histogram);
     if (options->compare && !CompareDb()) goto _bailout;
     if (solved != NULL) *solved = true;
     ret = kNoError;  // Success.
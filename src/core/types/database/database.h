@@ -134,6 +134,40 @@ typedef struct Database {
      */
     int (*FreeSolvingTier)(void);
 
+    /**
+     * @brief Enables flushing solved tiers in the background if BUDGET is
+     * positive, or disables it otherwise. In background mode,
+     * FlushSolvingTier() hands the solving tier over to a background stage
+     * that holds at most BUDGET bytes of records and returns immediately, and
+     * each flushed tier is reported by PopFlushedTier() once it has been
+     * durably written. Disabling background mode waits for all pending
+     * flushes, and tiers not yet reported are no longer reported.
+     * @note This function is part of the Solving API. This function is
+     * optional. If set to NULL, the Database Manager returns
+     * kNotImplementedError and the caller should flush in the foreground.
+     *
+     * @return kNoError on success, or
+     * @return non-zero error code on failure.
+     */
+    int (*SetAsyncFlush)(intptr_t budget);
+
+    /**
+     * @brief Reports the next tier flushed in the background, which is durably
+     * stored if ERROR is set to kNoError.
+     * @note This function is part of the Solving API. This function is
+     * optional and must be set if SetAsyncFlush() is set.
+     *
+     * @param wait Whether to wait for a pending flush to finish if no flushed
+     * tier is ready to be reported.
+     * @param tier (Output parameter) The flushed tier.
+     * @param error (Output parameter) kNoError if TIER has been durably
+     * stored, or the error that occurred while flushing TIER.
+     * @return true if a flushed tier is reported, or
+     * @return false if no flushed tier is ready and WAIT is false, or if there
+     * are no pending flushes.
+     */
+    bool (*PopFlushedTier)(bool wait, Tier *tier, int *error);
+
     /**
      * @brief Sets the current game as solved.
      *
@@ -261,6 +295,33 @@ typedef struct Database {
      */
     bool (*IsTierLoaded)(Tier tier);
 
+    /**
+     * @brief Keeps tiers unloaded using UnloadTier() in memory, up to a total
+     * of BUDGET bytes, so that loading them again does not have to read them
+     * from storage. Disables the cache if BUDGET is 0.
+     * @note This function is optional. If set to NULL, the Database Manager
+     * returns kNotImplementedError.
+     *
+     * @return kNoError on success, or
+     * @return non-zero error code on failure.
+     */
+    int (*SetTierCache)(intptr_t budget);
+
+    /**
+     * @brief Returns whether TIER is in memory, either loaded or cached.
+     * @note This function is optional and must be set if SetTierCache() is
+     * set.
+     */
+    bool (*IsTierCached)(Tier tier);
+
+    /**
+     * @brief Frees TIER if it is cached but not loaded. Called by the solver
+     * once TIER will not be loaded again.
+     * @note This function is optional and must be set if SetTierCache() is
+     * set.
+     */
+    void (*EvictTier)(Tier tier);
+
     /**
      * @brief Returns the value of position \p position in tier \p tier if
      * \p tier has been loaded. Returns \c kErrorValue otherwise.
@@ -331,6 +392,54 @@ typedef struct Database {
      */
     int (*ProbeRemoteness)(DbProbe *probe, TierPosition tier_position);
 
+    /**
+     * @brief Probes both the value and the remoteness of TIER_POSITION from
+     * permanent storage using PROBE in a single lookup, storing the remoteness
+     * in REMOTENESS and returning the value.
+     *
+     * @note This function is optional. If set to NULL, the Database Manager
+     * falls back to calling ProbeValue() and ProbeRemoteness().
+     *
+     * @param probe Database probe initialized using the ProbeInit() function.
+     * @param tier_position Probe this TierPosition.
+     * @param remoteness (Output parameter) Remoteness of TIER_POSITION, or
+     * kErrorRemoteness if TIER_POSITION is not found.
+     *
+     * @return Value of TIER_POSITION probed from permanent storage, or
+     * kErrorValue if TIER_POSITION is not found.
+     */
+    Value (*ProbeValueRemoteness)(DbProbe *probe, TierPosition tier_position,
+                                  int *remoteness);
+
+    /**
+     * @brief Probes the values and remotenesses of the N tier positions in
+     * TIER_POSITIONS from permanent storage using PROBE, storing the results
+     * in VALUES and REMOTENESSES in the same order as TIER_POSITIONS. The
+     * implementation is free to visit the tier positions in any order, which
+     * allows it to read each tier file and each block within it only once.
+     *
+     * @note This function is optional. If set to NULL, the Database Manager
+     * falls back to probing the tier positions one at a time.
+     *
+     * @param probe Database probe initialized using the ProbeInit() function.
+     * @param n Number of tier positions to probe.
+     * @param tier_positions Array of N tier positions, possibly unsorted and
+     * with duplicates.
+     * @param values (Output parameter) Array of size at least N, to which the
+     * values are written. Tier positions that are not found are assigned
+     * kErrorValue.
+     * @param remotenesses (Output parameter) Array of size at least N, to which
+     * the remotenesses are written. Tier positions that are not found are
+     * assigned kErrorRemoteness.
+     *
+     * @return kNoError on success, or
+     * @return non-zero error code if the batch cannot be processed, in which
+     * case the contents of VALUES and REMOTENESSES are unspecified.
+     */
+    int (*ProbeBatch)(DbProbe *probe, int64_t n,
+                      const TierPosition *tier_positions, Value *values,
+                      int *remotenesses);
+
     /**
      * @brief Probes the current data path and returns the solving status of the
      * given TIER.
@@ -345,6 +454,45 @@ typedef struct Database {
      */
     int (*TierStatus)(Tier tier);
 
+    /**
+     * @brief Rebuilds the record of solved tiers that the database keeps to
+     * answer TierStatus() by checking permanent storage for each of the N
+     * tiers in TIERS, whose sizes in number of positions are given in SIZES.
+     * This migrates databases solved before the record was introduced or
+     * whose files have been modified by hand.
+     *
+     * @note This function is optional. If set to NULL, the database keeps no
+     * such record and the Database Manager does nothing.
+     *
+     * @param n Number of tiers to check.
+     * @param tiers Array of N tiers to check.
+     * @param sizes Array of the sizes of the N tiers in TIERS.
+     *
+     * @return kNoError on success, or
+     * @return non-zero error code on failure.
+     */
+    int (*RebuildTierManifest)(int64_t n, const Tier *tiers,
+                               const int64_t *sizes);
+
+    /**
+     * @brief Moves the solved tiers among the N tiers in TIERS into a packed
+     * layout that stores many tiers per file, which avoids creating one file
+     * per tier. Tiers solved after the call are also stored in the packed
+     * layout. Calling this function on a database that is already packed
+     * moves any tier files left behind by an interrupted call, and reclaims
+     * the space taken by tiers that have been solved again since.
+     *
+     * @note This function is optional. If set to NULL, the database has no
+     * packed layout and the Database Manager returns kNotImplementedError.
+     *
+     * @param n Number of tiers to pack.
+     * @param tiers Array of N tiers to pack.
+     *
+     * @return kNoError on success, or
+     * @return non-zero error code on failure.
+     */
+    int (*PackTiers)(int64_t n, const Tier *tiers);
+
     /**
      * @brief Probes the current data path and returns the solving status of the
      * current game.
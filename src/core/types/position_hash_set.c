@@ -3,7 +3,7 @@
  * @author Robert Shi (robertyishi@berkeley.edu)
  * @author GamesCrafters Research Group, UC Berkeley
  *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
- * @brief Linear-probing Position hash set implementation.
+ * @brief Open addressing Position hash set implementation.
  * @version 1.1.0
  * @date 2025-03-13
  *
@@ -3,7 +3,7 @@
  * @author Robert Shi (robertyishi@berkeley.edu)
  * @author GamesCrafters Research Group, UC Berkeley
  *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
- * @brief Linear-probing Position hash set.
+ * @brief Open addressing Position hash set.
  * @version 1.1.0
  * @date 2025-03-13
  *
@@ -31,7 +31,7 @@
 #include "core/types/base.h"
 
 /**
- * @brief Linear-probing Position hash set using Int64HashSet as underlying
+ * @brief Open addressing Position hash set using Int64HashSet as underlying
  * type.
  */
 typedef Int64HashSet PositionHashSet;
@@ -28,6 +28,7 @@
 #define GAMESMANONE_CORE_TYPES_SOLVER_SOLVER_H_
 
 #include "core/types/base.h"
+#include "core/types/database/db_probe.h"
 #include "core/types/solver/solver_config.h"
 
 enum SolverConstants {
@@ -154,6 +155,64 @@ typedef struct Solver {
      * @return Remoteness of TIER_POSITION.
      */
     int (*GetRemoteness)(TierPosition tier_position);
+
+    // Probing sessions. The following three functions are optional and must
+    // be either all implemented or all set to NULL. GetValue and GetRemoteness
+    // are used instead if they are not implemented.
+
+    /**
+     * @brief Initializes PROBE for a probing session. A probe keeps database
+     * files and read-ahead buffers open between calls to ProbeValueRemoteness,
+     * so consecutive queries of nearby positions share the same disk reads.
+     *
+     * @return 0 on success, non-zero error code otherwise.
+     */
+    int (*ProbeInit)(DbProbe *probe);
+
+    /**
+     * @brief Ends the probing session of PROBE, freeing all allocated memory.
+     *
+     * @return 0 on success, non-zero error code otherwise.
+     */
+    int (*ProbeDestroy)(DbProbe *probe);
+
+    /**
+     * @brief Probes both the value and the remoteness of TIER_POSITION using
+     * PROBE, which is initialized with ProbeInit(). Results in undefined
+     * behavior if the TIER_POSITION has not been solved, or if TIER_POSITION
+     * is invalid or unreachable.
+     *
+     * @param probe Probe initialized with ProbeInit().
+     * @param tier_position Tier position to probe.
+     * @param remoteness (Output parameter) Remoteness of TIER_POSITION.
+     *
+     * @return Value of TIER_POSITION.
+     */
+    Value (*ProbeValueRemoteness)(DbProbe *probe, TierPosition tier_position,
+                                  int *remoteness);
+
+    /**
+     * @brief Probes the values and remotenesses of the N tier positions in
+     * TIER_POSITIONS using PROBE, storing them in VALUES and REMOTENESSES in
+     * the same order. Results in undefined behavior if any of the tier
+     * positions has not been solved, or is invalid or unreachable.
+     *
+     * @note This function is optional even if the other probing session
+     * functions are implemented. ProbeValueRemoteness is called on each tier
+     * position instead if it is not implemented.
+     *
+     * @param probe Probe initialized with ProbeInit().
+     * @param n Number of tier positions to probe.
+     * @param tier_positions Array of N tier positions to probe.
+     * @param values (Output parameter) Array of size at least N for the values.
+     * @param remotenesses (Output parameter) Array of size at least N for the
+     * remotenesses.
+     *
+     * @return 0 on success, non-zero error code otherwise.
+     */
+    int (*ProbeBatch)(DbProbe *probe, int64_t n,
+                      const TierPosition *tier_positions, Value *values,
+                      int *remotenesses);
 } Solver;
 
 #endif  // GAMESMANONE_CORE_TYPES_SOLVER_SOLVER_H_
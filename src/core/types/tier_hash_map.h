@@ -3,7 +3,7 @@
  * @author Robert Shi (robertyishi@berkeley.edu)
  * @author GamesCrafters Research Group, UC Berkeley
  *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
- * @brief Linear-probing Tier hash map that maps Tiers to 64-bit signed
+ * @brief Open addressing Tier hash map that maps Tiers to 64-bit signed
  * integers.
  * @version 1.0.1
  * @date 2024-09-02
@@ -34,7 +34,7 @@
 #include "core/data_structures/int64_hash_map.h"
 #include "core/types/base.h"
 
-/** @brief Linear-probing Tier to int64_t hash map using Int64HashMap. */
+/** @brief Open addressing Tier to int64_t hash map using Int64HashMap. */
 typedef Int64HashMap TierHashMap;
 
 /** @brief Iterator for TierHashMap. */
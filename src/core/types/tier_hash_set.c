@@ -3,7 +3,7 @@
  * @author Robert Shi (robertyishi@berkeley.edu)
  * @author GamesCrafters Research Group, UC Berkeley
  *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
- * @brief Linear-probing Tier hash set implementation.
+ * @brief Open addressing Tier hash set implementation.
  * @version 1.0.2
  * @date 2024-11-28
  *
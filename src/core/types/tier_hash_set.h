@@ -3,7 +3,7 @@
  * @author Robert Shi (robertyishi@berkeley.edu)
  * @author GamesCrafters Research Group, UC Berkeley
  *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
- * @brief Linear-probing Tier hash set.
+ * @brief Open addressing Tier hash set.
  * @version 1.0.2
  * @date 2024-11-28
  *
@@ -30,7 +30,7 @@
 #include "core/data_structures/int64_hash_set.h"
 #include "core/types/base.h"
 
-/** @brief Linear-probing Tier hash set using Int64HashSet as underlying type.
+/** @brief Open addressing Tier hash set using Int64HashSet as underlying type.
  */
 typedef Int64HashSet TierHashSet;
 
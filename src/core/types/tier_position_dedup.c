@@ -0,0 +1,139 @@
+/**
+ * @file tier_position_dedup.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the allocation-free in-place deduplication of small
+ * TierPosition arrays.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/types/tier_position_dedup.h"
+
+#include <stdbool.h>  // bool
+#include <stdint.h>   // uint32_t, uint64_t
+#include <string.h>   // memset
+
+#include "core/data_structures/swiss_table.h"
+#include "core/types/base.h"
+#include "core/types/tier_position_hash_set.h"
+
+enum {
+    kTableSize = 2 * kTierPositionDedupTableMax,
+    kTableMask = kTableSize - 1,
+};
+
+/**
+ * @brief Thread-local open-addressing table. A slot is occupied in the current
+ * call iff its stamp equals the current generation, which makes clearing the
+ * table between calls unnecessary.
+ */
+typedef struct DedupTable {
+    TierPosition keys[kTableSize];
+    uint32_t stamps[kTableSize];
+    uint32_t generation;
+} DedupTable;
+
+static _Thread_local DedupTable table;
+
+static bool TierPositionLess(TierPosition a, TierPosition b) {
+    return a.tier < b.tier || (a.tier == b.tier && a.position < b.position);
+}
+
+static bool TierPositionEqual(TierPosition a, TierPosition b) {
+    return a.tier == b.tier && a.position == b.position;
+}
+
+static int SortUnique(TierPosition *tier_positions, int n) {
+    // Insertion sort, which beats everything else at these sizes.
+    for (int i = 1; i < n; ++i) {
+        TierPosition key = tier_positions[i];
+        int j = i - 1;
+        while (j >= 0 && TierPositionLess(key, tier_positions[j])) {
+            tier_positions[j + 1] = tier_positions[j];
+            --j;
+        }
+        tier_positions[j + 1] = key;
+    }
+
+    int ret = (n > 0);
+    for (int i = 1; i < n; ++i) {
+        if (!TierPositionEqual(tier_positions[i], tier_positions[ret - 1])) {
+            tier_positions[ret++] = tier_positions[i];
+        }
+    }
+
+    return ret;
+}
+
+static uint64_t Hash(TierPosition key) {
+    uint64_t h = (uint64_t)key.tier * 0x9E3779B97F4A7C15ULL;
+    return SwissTableMix64(h + (uint64_t)key.position);
+}
+
+static int TableUnique(TierPosition *tier_positions, int n) {
+    if (++table.generation == 0) {
+        // Stamps from 2^32 calls ago would alias the new generation.
+        memset(table.stamps, 0, sizeof(table.stamps));
+        table.generation = 1;
+    }
+
+    int ret = 0;
+    for (int i = 0; i < n; ++i) {
+        TierPosition key = tier_positions[i];
+        int slot = (int)(Hash(key) & kTableMask);
+        while (table.stamps[slot] == table.generation &&
+               !TierPositionEqual(table.keys[slot], key)) {
+            slot = (slot + 1) & kTableMask;
+        }
+        if (table.stamps[slot] == table.generation) continue;  // Duplicate.
+
+        table.stamps[slot] = table.generation;
+        table.keys[slot] = key;
+        tier_positions[ret++] = key;
+    }
+
+    return ret;
+}
+
+static int HashSetUnique(TierPosition *tier_positions, int n) {
+    TierPositionHashSet dedup;
+    TierPositionHashSetInit(&dedup, 0.5);
+    if (!TierPositionHashSetReserve(&dedup, n)) return -1;
+
+    int ret = 0;
+    for (int i = 0; i < n; ++i) {
+        if (TierPositionHashSetContains(&dedup, tier_positions[i])) continue;
+        if (!TierPositionHashSetAdd(&dedup, tier_positions[i])) {
+            ret = -1;
+            break;
+        }
+        tier_positions[ret++] = tier_positions[i];
+    }
+    TierPositionHashSetDestroy(&dedup);
+
+    return ret;
+}
+
+int TierPositionDedup(TierPosition *tier_positions, int n) {
+    if (n <= kTierPositionDedupSortMax) return SortUnique(tier_positions, n);
+    if (n <= kTierPositionDedupTableMax) return TableUnique(tier_positions, n);
+
+    return HashSetUnique(tier_positions, n);
+}
@@ -0,0 +1,63 @@
+/**
+ * @file tier_position_dedup.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Allocation-free in-place deduplication of small TierPosition arrays.
+ * @details Designed for deduplicating the canonical child positions of a
+ * single position, which happens once per position in every scan of every
+ * tier. Arrays of up to \c kTierPositionDedupSortMax items are sorted in place
+ * and uniqued. Larger arrays of up to \c kTierPositionDedupTableMax items are
+ * filtered through a thread-local open-addressing table that is reused across
+ * calls without being cleared. Neither path touches the heap. Arrays larger
+ * than that fall back to a TierPositionHashSet.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_CORE_TYPES_TIER_POSITION_DEDUP_H_
+#define GAMESMANONE_CORE_TYPES_TIER_POSITION_DEDUP_H_
+
+#include "core/types/base.h"
+
+enum {
+    /** Arrays of up to this many items are deduplicated by sorting. */
+    kTierPositionDedupSortMax = 32,
+
+    /**
+     * Arrays of up to this many items are deduplicated using the thread-local
+     * table, which has twice as many slots.
+     */
+    kTierPositionDedupTableMax = 1024,
+};
+
+/**
+ * @brief Removes duplicate tier positions from the first \p n items of
+ * \p tier_positions in place and returns the number of unique items, which are
+ * moved to the front of the array. The order of the unique items is
+ * unspecified. Thread-safe.
+ *
+ * @param tier_positions Array of tier positions.
+ * @param n Number of items in \p tier_positions.
+ * @return Number of unique tier positions, or
+ * @return -1 if \p n is greater than \c kTierPositionDedupTableMax and the
+ * fallback hash set failed to allocate memory.
+ */
+int TierPositionDedup(TierPosition *tier_positions, int n);
+
+#endif  // GAMESMANONE_CORE_TYPES_TIER_POSITION_DEDUP_H_
@@ -3,9 +3,9 @@
  * @author Robert Shi (robertyishi@berkeley.edu)
  * @author GamesCrafters Research Group, UC Berkeley
  *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
- * @brief Linear-probing TierPosition hash set implementation.
- * @version 1.1.0
- * @date 2025-03-13
+ * @brief Open addressing TierPosition hash set implementation.
+ * @version 1.2.0
+ * @date 2026-10-18
  *
  * @copyright This file is part of GAMESMAN, The Finite, Two-person
  * Perfect-Information Game Generator released under the GPL:
@@ -26,104 +26,42 @@
 
 #include "core/types/tier_position_hash_set.h"
 
-#include <math.h>     // INFINITY
 #include <stdbool.h>  // bool
 #include <stddef.h>   // NULL
 #include <stdint.h>   // int64_t
-#include <stdlib.h>   // free, calloc
 
-#include "core/misc.h"
+#include "core/data_structures/swiss_table.h"
 #include "core/types/base.h"
 
 void TierPositionHashSetInit(TierPositionHashSet *set, double max_load_factor) {
-    set->entries = NULL;
-    set->capacity = 0;
-    set->size = 0;
     if (max_load_factor > 0.75) max_load_factor = 0.75;
     if (max_load_factor < 0.25) max_load_factor = 0.25;
-    set->max_load_factor = max_load_factor;
-}
-
-static int64_t TierPositionHashSetHash(TierPosition key, int64_t capacity) {
-    int64_t a = (int64_t)key.tier;
-    int64_t b = (int64_t)key.position;
-    uint64_t cantor_pairing = (a + b) * (a + b + 1) / 2 + a;
-    return (int64_t)(cantor_pairing % capacity);
-}
-
-static bool TierPositionHashSetExpand(TierPositionHashSet *set,
-                                      int64_t new_capacity) {
-    TierPositionHashSetEntry *new_entries = (TierPositionHashSetEntry *)calloc(
-        new_capacity, sizeof(TierPositionHashSetEntry));
-    if (new_entries == NULL) return false;
-    for (int64_t i = 0; i < set->capacity; ++i) {
-        if (set->entries[i].used) {
-            int64_t new_index =
-                TierPositionHashSetHash(set->entries[i].key, new_capacity);
-            while (new_entries[new_index].used) {
-                new_index = (new_index + 1) % new_capacity;
-            }
-            new_entries[new_index] = set->entries[i];
-        }
-    }
-    free(set->entries);
-    set->entries = new_entries;
-    set->capacity = new_capacity;
-    return true;
+    SwissTableInit(&set->table, 2, 0, max_load_factor);
 }
 
 bool TierPositionHashSetReserve(TierPositionHashSet *set, int64_t size) {
-    int64_t target_capacity =
-        NextPrime((int64_t)((double)size / set->max_load_factor));
-    if (target_capacity <= set->capacity) return true;
-
-    return TierPositionHashSetExpand(set, target_capacity);
+    return SwissTableReserve(&set->table, size);
 }
 
 void TierPositionHashSetDestroy(TierPositionHashSet *set) {
-    free(set->entries);
-    set->entries = NULL;
-    set->capacity = 0;
-    set->size = 0;
+    SwissTableDestroy(&set->table);
 }
 
 bool TierPositionHashSetContains(TierPositionHashSet *set, TierPosition key) {
-    int64_t capacity = set->capacity;
-    // Edge case: return false if set is empty.
-    if (set->capacity == 0) return false;
-    int64_t index = TierPositionHashSetHash(key, capacity);
-    while (set->entries[index].used) {
-        TierPosition this_key = set->entries[index].key;
-        if (this_key.tier == key.tier && this_key.position == key.position) {
-            return true;
-        }
-        index = (index + 1) % capacity;
-    }
-    return false;
+    const int64_t words[2] = {key.tier, key.position};
+    return SwissTableFind(&set->table, words) >= 0;
 }
 
 bool TierPositionHashSetAdd(TierPositionHashSet *set, TierPosition key) {
-    // Check if resizing is needed.
-    double load_factor = (set->capacity == 0)
-                             ? INFINITY
-                             : (double)(set->size + 1) / (double)set->capacity;
-    if (set->capacity == 0 || load_factor > set->max_load_factor) {
-        int64_t new_capacity = NextPrime(set->capacity * 2);
-        if (!TierPositionHashSetExpand(set, new_capacity)) return false;
-    }
+    const int64_t words[2] = {key.tier, key.position};
+    return SwissTableInsert(&set->table, words, NULL) >= 0;
+}
+
+bool TierPositionHashSetRemove(TierPositionHashSet *set, TierPosition key) {
+    const int64_t words[2] = {key.tier, key.position};
+    return SwissTableRemove(&set->table, words);
+}
 
-    // Set value at key.
-    int64_t capacity = set->capacity;
-    int64_t index = TierPositionHashSetHash(key, capacity);
-    while (set->entries[index].used) {
-        TierPosition this_key = set->entries[index].key;
-        if (this_key.tier == key.tier && this_key.position == key.position) {
-            return true;
-        }
-        index = (index + 1) % capacity;
-    }
-    set->entries[index].key = key;
-    set->entries[index].used = true;
-    ++set->size;
-    return true;
+int64_t TierPositionHashSetSize(const TierPositionHashSet *set) {
+    return set->table.size;
 }
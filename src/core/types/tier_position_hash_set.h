@@ -3,9 +3,9 @@
  * @author Robert Shi (robertyishi@berkeley.edu)
  * @author GamesCrafters Research Group, UC Berkeley
  *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
- * @brief Linear-probing TierPosition hash set.
- * @version 1.1.0
- * @date 2025-03-13
+ * @brief Open addressing TierPosition hash set.
+ * @version 1.2.0
+ * @date 2026-10-18
  *
  * @copyright This file is part of GAMESMAN, The Finite, Two-person
  * Perfect-Information Game Generator released under the GPL:
@@ -30,20 +30,16 @@
 #include <stdbool.h>  // bool
 #include <stdint.h>   // int64_t
 
+#include "core/data_structures/swiss_table.h"
 #include "core/types/base.h"
 
-/** @brief Entry in a TierPositionHashSet. */
-typedef struct TierPositionHashSetEntry {
-    TierPosition key; /**< Item, which is also used as key for lookup. */
-    bool used;        /**< True if bucket is full, false if empty. */
-} TierPositionHashSetEntry;
-
-/** @brief Linear-probing TierPosition hash set. */
+/**
+ * @brief Open addressing TierPosition hash set built on the SwissTable core,
+ * using the tier and the position as a two-word key.
+ */
 typedef struct TierPositionHashSet {
-    TierPositionHashSetEntry *entries; /**< Array of buckets. */
-    int64_t capacity;                  /**< Number of buckets allocated. */
-    int64_t size;           /**< Number of items stored in the set. */
-    double max_load_factor; /**< Maximum load factor of the set. */
+    /** Underlying table of two key words and no value words per slot. */
+    SwissTable table;
 } TierPositionHashSet;
 
 /**
@@ -94,4 +90,17 @@ bool TierPositionHashSetContains(TierPositionHashSet *set, TierPosition key);
  */
 bool TierPositionHashSetAdd(TierPositionHashSet *set, TierPosition key);
 
+/**
+ * @brief Removes KEY from the TierPosition hash set SET.
+ *
+ * @param set Target TierPosition hash set.
+ * @param key Tier position to remove.
+ * @return true if KEY was removed, or
+ * @return false if SET does not contain KEY.
+ */
+bool TierPositionHashSetRemove(TierPositionHashSet *set, TierPosition key);
+
+/** @brief Returns the number of tier positions in SET. */
+int64_t TierPositionHashSetSize(const TierPositionHashSet *set);
+
 #endif  // GAMESMANONE_CORE_TYPES_TIER_POSITION_HASH_SET_H_
@@ -44,3 +44,11 @@ bool TierQueuePush(TierQueue *queue, Tier tier) {
 Tier TierQueuePop(TierQueue *queue) { return Int64QueuePop(queue); }
 
 Tier TierQueueFront(const TierQueue *queue) { return Int64QueueFront(queue); }
+
+Tier TierQueueAt(const TierQueue *queue, int64_t index) {
+    return Int64QueueAt(queue, index);
+}
+
+Tier TierQueueRemoveAt(TierQueue *queue, int64_t index) {
+    return Int64QueueRemoveAt(queue, index);
+}
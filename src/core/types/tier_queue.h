@@ -59,4 +59,16 @@ Tier TierQueuePop(TierQueue *queue);
 /** @brief Returns the tier at the front of the QUEUE without popping it. */
 Tier TierQueueFront(const TierQueue *queue);
 
+/**
+ * @brief Returns the tier at position INDEX of the QUEUE without popping it,
+ * where the front of the QUEUE is at position 0.
+ */
+Tier TierQueueAt(const TierQueue *queue, int64_t index);
+
+/**
+ * @brief Removes the tier at position INDEX of the QUEUE and returns it. The
+ * other tiers keep their order.
+ */
+Tier TierQueueRemoveAt(TierQueue *queue, int64_t index);
+
 #endif  // GAMESMANONE_CORE_TYPES_TIER_QUEUE_H_
@@ -633,7 +633,7 @@ static int QuixoGetNumberOfCanonicalChildPositions(TierPosition tier_position) {
         if (TierPositionHashSetContains(&dedup, child)) continue;
         TierPositionHashSetAdd(&dedup, child);
     }
-    int ret = (int)dedup.size;
+    int ret = (int)TierPositionHashSetSize(&dedup);
     TierPositionHashSetDestroy(&dedup);
 
     return ret;
@@ -27,12 +27,23 @@
 #include "libs/xzra/xzra.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <inttypes.h>
 #include <lzma.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "libs/xzra/xzra_reader.h"
+
+// Size of each read issued while decompressing a whole stream.
+static const size_t kReadChunkSize = 1 << 20;
+
+// Maximum number of reads in flight while decompressing a whole stream.
+static const int kReadQueueDepth = 8;
 
 // ========================= Common Helper Functions ==========================
 
@@ -348,25 +359,28 @@ static const char *DecompressHelperLzmaCodeRetDesc(lzma_ret ret) {
     return "Unknown error, possibly a bug";
 }
 
-static bool DecompressFileHelper(lzma_stream *strm, FILE *infile, uint8_t *dest,
-                                 size_t size) {
+// Decompresses all bytes read by READER.
+static bool DecompressFileHelper(lzma_stream *strm, XzraReader *reader,
+                                 uint8_t *dest, size_t size) {
     lzma_action action = LZMA_RUN;
-    uint8_t inbuf[BUFSIZ];
     strm->next_in = NULL;
     strm->avail_in = 0;
     strm->next_out = dest;
     strm->avail_out = size;
     while (true) {
-        if (strm->avail_in == 0 && !feof(infile)) {
-            strm->next_in = inbuf;
-            strm->avail_in = fread(inbuf, 1, sizeof(inbuf), infile);
-            if (ferror(infile)) {
+        if (strm->avail_in == 0 && action == LZMA_RUN) {
+            const uint8_t *chunk = NULL;
+            int64_t count = XzraReaderNext(reader, &chunk);
+            if (count < 0) {
+                char buf[BUFSIZ];
                 strm->next_in = NULL;
-                strerror_r(errno, (char *)inbuf, sizeof(inbuf));
-                fprintf(stderr, "Read error: %s\n", inbuf);
+                strerror_r(errno, buf, sizeof(buf));
+                fprintf(stderr, "Read error: %s\n", buf);
                 return false;
             }
-            if (feof(infile)) action = LZMA_FINISH;
+            strm->next_in = chunk;
+            strm->avail_in = (size_t)count;
+            if (count == 0) action = LZMA_FINISH;
         }
         lzma_ret ret = lzma_code(strm, action);
         if (ret == LZMA_STREAM_END || strm->avail_out == 0) {
@@ -384,22 +398,36 @@ static bool DecompressFileHelper(lzma_stream *strm, FILE *infile, uint8_t *dest,
 
 int64_t XzraDecompressFile(uint8_t *dest, size_t size, int num_threads,
                            uint64_t memlimit, const char *filename) {
+    return XzraDecompressFileRange(dest, size, num_threads, memlimit, filename,
+                                   0, -1);
+}
+
+int64_t XzraDecompressFileRange(uint8_t *dest, size_t size, int num_threads,
+                                uint64_t memlimit, const char *filename,
+                                int64_t offset, int64_t length) {
     lzma_stream strm = LZMA_STREAM_INIT;
     if (!InitDecoder(&strm, num_threads, memlimit)) return -1;
-    FILE *infile = fopen(filename, "rb");
-    if (infile == NULL) {
+    int fd = open(filename, O_RDONLY);
+    XzraReader *reader =
+        fd < 0 ? NULL
+               : XzraReaderOpen(fd, offset, length, kReadChunkSize,
+                                kReadQueueDepth);
+    if (reader == NULL) {
         char buf[BUFSIZ];
         strerror_r(errno, buf, sizeof(buf));
         fprintf(stderr, "XzraDecompressFile: error opening %s: %s\n", filename,
                 buf);
+        if (fd >= 0) close(fd);
+        lzma_end(&strm);
         return -2;
     }
-    bool success = DecompressFileHelper(&strm, infile, dest, size);
-    bool fclose_success = fclose(infile) == 0;
+    bool success = DecompressFileHelper(&strm, reader, dest, size);
+    XzraReaderClose(reader);
+    bool close_success = close(fd) == 0;
     int64_t total_out = (int64_t)strm.total_out;
     lzma_end(&strm);
     if (!success) return -3;
-    if (!fclose_success) return -4;
+    if (!close_success) return -4;
 
     return total_out;
 }
@@ -423,6 +451,8 @@ typedef struct XzraBlock {
 /** @brief Read-only XZ file with random access ability. */
 struct XzraFile {
     FILE *file;        /**< Kept open until the XzraFile is closed. */
+    int64_t base;      /**< Offset of the XZ stream in FILE. */
+    int64_t end;       /**< Offset of the end of the XZ stream in FILE. */
     lzma_index *index; /**< XZ file index, valid while the XzraFile is open. */
     lzma_index_iter iter; /**< XZ block iterator. */
     XzraBlock block; /**< Cached XZ block. Uninitialized until first read. */
@@ -447,12 +477,12 @@ static const char *LzmaStreamFooterDecodeRetDesc(lzma_ret ret) {
     return "Unknown error, possibly a bug";
 }
 
-static lzma_vli GetBackwardSize(FILE *f) {
+static lzma_vli GetBackwardSize(FILE *f, int64_t end) {
     // The footer is always the same length as the header, which is 12 bytes
     // long according to the xz file format:
     // https://github.com/tukaani-project/xz/blob/master/doc/xz-file-format.txt.
     uint8_t buf[LZMA_STREAM_HEADER_SIZE];
-    fseek(f, -LZMA_STREAM_HEADER_SIZE, SEEK_END);  // Seek to the footer.
+    fseeko(f, (off_t)(end - LZMA_STREAM_HEADER_SIZE), SEEK_SET);  // Footer.
     size_t count = fread(buf, 1, LZMA_STREAM_HEADER_SIZE,
                          f);  // Read the footer into the buffer.
     if (count != LZMA_STREAM_HEADER_SIZE) {
@@ -490,11 +520,12 @@ static const char *LzmaIndexBufferDecodeRetDesc(lzma_ret ret) {
     return "Unknown error, possibly a bug";
 }
 
-static int XzraGetIndex(lzma_index **index, FILE *f) {
-    lzma_vli backward_size = GetBackwardSize(f);
+static int XzraGetIndex(lzma_index **index, FILE *f, int64_t end) {
+    lzma_vli backward_size = GetBackwardSize(f, end);
     if (backward_size == LZMA_VLI_UNKNOWN) return 1;
 
-    fseek(f, -LZMA_STREAM_HEADER_SIZE - (int64_t)backward_size, SEEK_END);
+    fseeko(f, (off_t)(end - LZMA_STREAM_HEADER_SIZE - (int64_t)backward_size),
+           SEEK_SET);
     uint8_t *buf = (uint8_t *)malloc(backward_size * sizeof(uint8_t));
     if (buf == NULL) return 2;
 
@@ -535,6 +566,11 @@ static const char *XzraGetIndexErrorDesc(int error) {
 }
 
 XzraFile *XzraFileOpen(const char *filename) {
+    return XzraFileOpenRange(filename, 0, -1);
+}
+
+XzraFile *XzraFileOpenRange(const char *filename, int64_t offset,
+                            int64_t length) {
     // Allocate memory for the return value.
     XzraFile *ret = (XzraFile *)calloc(1, sizeof(XzraFile));
     if (ret == NULL) {
@@ -550,8 +586,20 @@ XzraFile *XzraFileOpen(const char *filename) {
         return NULL;
     }
 
+    // Locate the end of the XZ stream.
+    ret->base = offset;
+    if (length >= 0) {
+        ret->end = offset + length;
+    } else if (fseeko(ret->file, 0, SEEK_END) == 0) {
+        ret->end = (int64_t)ftello(ret->file);
+    } else {
+        ret->end = -1;
+    }
+
     // Load XZ index.
-    int error = XzraGetIndex(&ret->index, ret->file);
+    int error = ret->end >= LZMA_STREAM_HEADER_SIZE
+                    ? XzraGetIndex(&ret->index, ret->file, ret->end)
+                    : 1;
     if (error != 0) {
         fprintf(stderr, "XzraFileOpen: failed to load index of %s due to %s\n",
                 filename, XzraGetIndexErrorDesc(error));
@@ -671,17 +719,18 @@ static bool DecodeBlock(uint8_t *out, lzma_block *block,
     return true;
 }
 
-static int XzraDecodeBlock(uint8_t *out, const lzma_index_iter *iter, FILE *f) {
-    // Seek to block.
-    fseek(f, (int64_t)iter->block.compressed_file_offset, SEEK_SET);
-
+static int XzraDecodeBlock(uint8_t *out, const lzma_index_iter *iter, FILE *f,
+                           int64_t base) {
     // Allocate space for compressed block.
     uint8_t *block_buf = (uint8_t *)malloc(iter->block.total_size);
     if (block_buf == NULL) return 2;
 
-    // Read compressed block into buffer.
-    size_t count = fread(block_buf, 1, iter->block.total_size, f);
-    if (count != iter->block.total_size) {
+    // Read compressed block into buffer. A positional read leaves the file
+    // position alone, which is shared by all users of F.
+    int64_t count = XzraPreadFull(
+        fileno(f), block_buf, iter->block.total_size,
+        base + (int64_t)iter->block.compressed_file_offset);
+    if (count != (int64_t)iter->block.total_size) {
         free(block_buf);
         return 3;
     }
@@ -739,7 +788,7 @@ static int XzraFileFillBlockBuffer(XzraFile *file, bool next) {
     }
 
     return XzraDecodeBlock(file->block.uncompressed_data, &file->iter,
-                           file->file);
+                           file->file, file->base);
 }
 
 static size_t MinSize(size_t a, size_t b) { return a < b ? a : b; }
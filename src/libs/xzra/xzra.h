@@ -191,6 +191,19 @@ uint64_t XzraDecompressionMemUsage(uint64_t block_size, uint32_t level,
 int64_t XzraDecompressFile(uint8_t *dest, size_t size, int num_threads,
                            uint64_t memlimit, const char *filename);
 
+/**
+ * @brief Same as \c XzraDecompressFile, except that the XZ stream is read from
+ * the \p length bytes of file \p filename starting at byte \p offset. This
+ * allows XZ streams to be stored back to back in a larger file.
+ *
+ * @param offset Offset of the XZ stream in the file in bytes.
+ * @param length Length of the XZ stream in bytes, or -1 if the XZ stream
+ * extends to the end of the file.
+ */
+int64_t XzraDecompressFileRange(uint8_t *dest, size_t size, int num_threads,
+                                uint64_t memlimit, const char *filename,
+                                int64_t offset, int64_t length);
+
 /** @brief Read-only XZ file with random access ability. */
 typedef struct XzraFile XzraFile;
 
@@ -210,6 +223,21 @@ enum XzraSeekOrigin {
  */
 XzraFile *XzraFileOpen(const char *filename);
 
+/**
+ * @brief Opens the XZ stream stored in the \p length bytes of file
+ * \p filename starting at byte \p offset as a read-only \c XzraFile.
+ *
+ * @param filename Name of the file containing the XZ stream.
+ * @param offset Offset of the XZ stream in the file in bytes.
+ * @param length Length of the XZ stream in bytes, or -1 if the XZ stream
+ * extends to the end of the file.
+ * @return Pointer to the opened file, which must be closed using the provided
+ * \c XzraFileClose function;
+ * @return \c NULL if the XZ stream cannot be opened.
+ */
+XzraFile *XzraFileOpenRange(const char *filename, int64_t offset,
+                            int64_t length);
+
 /**
  * @brief Closes the given \c XzraFile. Does nothing if \p file is \c NULL.
  *
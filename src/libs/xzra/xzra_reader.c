@@ -0,0 +1,385 @@
+/**
+ * @file xzra_reader.c
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Implementation of the read-ahead reader used by the XZRA
+ * decompressor.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "libs/xzra/xzra_reader.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#ifdef XZRA_USE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif  // XZRA_USE_IO_URING
+
+// A chunk whose read has been submitted but has not completed.
+static const int64_t kChunkPending = -2;
+
+#ifdef XZRA_USE_IO_URING
+/** @brief Minimal io_uring instance, set up without liburing. */
+typedef struct XzraUring {
+    int ring_fd;
+    void *sq_ring;
+    size_t sq_ring_size;
+    void *cq_ring;
+    size_t cq_ring_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+    unsigned *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_cqe *cqes;
+} XzraUring;
+#endif  // XZRA_USE_IO_URING
+
+struct XzraReader {
+    int fd;
+    int64_t next_offset; /**< Offset of the next chunk to submit. */
+    int64_t end;         /**< End of the range in the file. */
+    size_t chunk_size;
+    int depth; /**< Number of chunk buffers. */
+
+    uint8_t *buffers;  /**< DEPTH buffers of CHUNK_SIZE bytes each. */
+    int64_t *offsets;  /**< File offset of the chunk in each buffer. */
+    size_t *lengths;   /**< Requested length of the chunk in each buffer. */
+    int64_t *results;  /**< Bytes read into each buffer, or kChunkPending. */
+    int64_t submitted; /**< Number of chunks submitted. */
+    int64_t consumed;  /**< Number of chunks returned. */
+    bool failed;       /**< True once a read has failed. */
+
+#ifdef XZRA_USE_IO_URING
+    XzraUring *uring; /**< NULL if reads fall back to pread. */
+    bool sync;        /**< True if new reads bypass URING. */
+    bool ring_broken; /**< True if completions can no longer be reaped. */
+#endif  // XZRA_USE_IO_URING
+};
+
+// ============================== Blocking Reads ==============================
+
+int64_t XzraPreadFull(int fd, void *buf, size_t size, int64_t offset) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t count = pread(fd, (uint8_t *)buf + total, size - total,
+                              (off_t)(offset + (int64_t)total));
+        if (count < 0 && errno == EINTR) continue;
+        if (count < 0) return -1;
+        if (count == 0) break;  // End of file.
+        total += (size_t)count;
+    }
+
+    return (int64_t)total;
+}
+
+// ================================= io_uring =================================
+
+#ifdef XZRA_USE_IO_URING
+static void UringDestroy(XzraUring *uring) {
+    if (uring == NULL) return;
+
+    if (uring->sqes != NULL) munmap(uring->sqes, uring->sqes_size);
+    if (uring->cq_ring != NULL && uring->cq_ring != uring->sq_ring) {
+        munmap(uring->cq_ring, uring->cq_ring_size);
+    }
+    if (uring->sq_ring != NULL) munmap(uring->sq_ring, uring->sq_ring_size);
+    close(uring->ring_fd);
+    free(uring);
+}
+
+static void *UringMap(int ring_fd, size_t size, off_t offset) {
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+
+    return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+// Returns NULL if io_uring is unavailable, e.g., disabled by a seccomp filter
+// or by the kernel.io_uring_disabled sysctl.
+static XzraUring *UringCreate(unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int ring_fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (ring_fd < 0) return NULL;
+
+    XzraUring *uring = (XzraUring *)calloc(1, sizeof(XzraUring));
+    if (uring == NULL) {
+        close(ring_fd);
+        return NULL;
+    }
+    uring->ring_fd = ring_fd;
+    uring->sq_ring_size =
+        params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    uring->cq_ring_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap && uring->cq_ring_size > uring->sq_ring_size) {
+        uring->sq_ring_size = uring->cq_ring_size;
+    }
+    uring->sq_ring = UringMap(ring_fd, uring->sq_ring_size, IORING_OFF_SQ_RING);
+    if (uring->sq_ring == NULL) goto _bailout;
+
+    uring->cq_ring = single_mmap ? uring->sq_ring
+                                 : UringMap(ring_fd, uring->cq_ring_size,
+                                            IORING_OFF_CQ_RING);
+    if (uring->cq_ring == NULL) goto _bailout;
+
+    uring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    uring->sqes = (struct io_uring_sqe *)UringMap(ring_fd, uring->sqes_size,
+                                                  IORING_OFF_SQES);
+    if (uring->sqes == NULL) goto _bailout;
+
+    uint8_t *sq = (uint8_t *)uring->sq_ring;
+    uint8_t *cq = (uint8_t *)uring->cq_ring;
+    uring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    uring->sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+    uring->sq_array = (unsigned *)(sq + params.sq_off.array);
+    uring->cq_head = (unsigned *)(cq + params.cq_off.head);
+    uring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    uring->cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+    uring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    return uring;
+
+_bailout:
+    UringDestroy(uring);
+    return NULL;
+}
+
+static int UringEnter(const XzraUring *uring, unsigned to_submit,
+                      unsigned min_complete, unsigned flags) {
+    int ret;
+    do {
+        ret = (int)syscall(__NR_io_uring_enter, uring->ring_fd, to_submit,
+                           min_complete, flags, NULL, 0);
+    } while (ret < 0 && errno == EINTR);
+
+    return ret;
+}
+
+static bool UringSubmitRead(XzraUring *uring, int fd, void *buf, size_t size,
+                            int64_t offset, uint64_t user_data) {
+    // This thread is the only producer, so the tail can be read plainly.
+    unsigned tail = *uring->sq_tail;
+    unsigned index = tail & *uring->sq_mask;
+    struct io_uring_sqe *sqe = &uring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->off = (uint64_t)offset;
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = (uint32_t)size;
+    sqe->user_data = user_data;
+    uring->sq_array[index] = index;
+    __atomic_store_n(uring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    return UringEnter(uring, 1, 0, 0) == 1;
+}
+
+static bool UringWaitCompletion(XzraUring *uring, uint64_t *user_data,
+                                int32_t *res) {
+    while (true) {
+        unsigned head = *uring->cq_head;
+        if (head != __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE)) {
+            const struct io_uring_cqe *cqe =
+                &uring->cqes[head & *uring->cq_mask];
+            *user_data = cqe->user_data;
+            *res = cqe->res;
+            __atomic_store_n(uring->cq_head, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+        if (UringEnter(uring, 0, 1, IORING_ENTER_GETEVENTS) < 0) return false;
+    }
+}
+#endif  // XZRA_USE_IO_URING
+
+// ================================ XzraReader ================================
+
+static int SlotOf(const XzraReader *reader, int64_t chunk) {
+    return (int)(chunk % reader->depth);
+}
+
+static uint8_t *SlotBuffer(const XzraReader *reader, int slot) {
+    return reader->buffers + (size_t)slot * reader->chunk_size;
+}
+
+// Reads the part of the chunk in SLOT that has not been read yet using pread,
+// which completes short reads and reads rejected by io_uring.
+static void FinishSlot(XzraReader *reader, int slot, int64_t done) {
+    if (done < 0) done = 0;
+    int64_t count = XzraPreadFull(
+        reader->fd, SlotBuffer(reader, slot) + done,
+        reader->lengths[slot] - (size_t)done, reader->offsets[slot] + done);
+    reader->results[slot] = count < 0 ? -1 : done + count;
+}
+
+static void SubmitChunks(XzraReader *reader) {
+    while (!reader->failed && reader->next_offset < reader->end &&
+           reader->submitted - reader->consumed < reader->depth) {
+        int slot = SlotOf(reader, reader->submitted);
+        int64_t remaining = reader->end - reader->next_offset;
+        reader->offsets[slot] = reader->next_offset;
+        reader->lengths[slot] = (int64_t)reader->chunk_size < remaining
+                                    ? reader->chunk_size
+                                    : (size_t)remaining;
+        reader->results[slot] = kChunkPending;
+#ifdef XZRA_USE_IO_URING
+        if (reader->uring != NULL && !reader->sync &&
+            UringSubmitRead(reader->uring, reader->fd,
+                            SlotBuffer(reader, slot), reader->lengths[slot],
+                            reader->offsets[slot], (uint64_t)slot)) {
+            reader->next_offset += (int64_t)reader->lengths[slot];
+            ++reader->submitted;
+            continue;
+        }
+        // No ring, or the ring rejected the read. Reads already in flight are
+        // still reaped from the ring, but no more reads are submitted to it.
+        reader->sync = true;
+#endif  // XZRA_USE_IO_URING
+        FinishSlot(reader, slot, 0);
+        reader->next_offset += (int64_t)reader->lengths[slot];
+        ++reader->submitted;
+    }
+}
+
+// Waits until the chunk in SLOT has been read.
+static void WaitSlot(XzraReader *reader, int slot) {
+#ifdef XZRA_USE_IO_URING
+    while (reader->results[slot] == kChunkPending) {
+        uint64_t user_data;
+        int32_t res;
+        if (!UringWaitCompletion(reader->uring, &user_data, &res)) {
+            // Cannot reap completions. Reads still in flight may write to the
+            // buffers, so they must never be freed while the ring is alive.
+            reader->ring_broken = true;
+            reader->failed = true;
+            reader->results[slot] = -1;
+            return;
+        }
+        int done_slot = (int)user_data;
+        if (res == (int32_t)reader->lengths[done_slot]) {
+            reader->results[done_slot] = res;
+        } else {
+            FinishSlot(reader, done_slot, res);
+        }
+    }
+#else   // XZRA_USE_IO_URING not defined
+    (void)reader;
+    (void)slot;
+#endif  // XZRA_USE_IO_URING
+}
+
+XzraReader *XzraReaderOpen(int fd, int64_t offset, int64_t length,
+                           size_t chunk_size, int depth) {
+    if (length < 0) {
+        struct stat st;
+        if (fstat(fd, &st) != 0) return NULL;
+        length = (int64_t)st.st_size - offset;
+        if (length < 0) length = 0;
+    }
+
+    XzraReader *reader = (XzraReader *)calloc(1, sizeof(XzraReader));
+    if (reader == NULL) return NULL;
+
+    reader->fd = fd;
+    reader->next_offset = offset;
+    reader->end = offset + length;
+    if ((int64_t)chunk_size > length) chunk_size = (size_t)length;
+    if (chunk_size == 0) chunk_size = 1;
+    reader->chunk_size = chunk_size;
+
+    // No point in allocating more buffers than there are chunks.
+    int64_t num_chunks =
+        (length + (int64_t)chunk_size - 1) / (int64_t)chunk_size;
+    if (num_chunks < depth) depth = (int)num_chunks;
+    if (depth < 1) depth = 1;
+#ifdef XZRA_USE_IO_URING
+    if (depth > 1) reader->uring = UringCreate((unsigned)depth);
+    if (reader->uring == NULL) depth = 1;  // Blocking reads one at a time.
+#else   // XZRA_USE_IO_URING not defined
+    depth = 1;
+#endif  // XZRA_USE_IO_URING
+    reader->depth = depth;
+
+    reader->buffers = (uint8_t *)malloc((size_t)depth * chunk_size);
+    reader->offsets = (int64_t *)calloc(depth, sizeof(int64_t));
+    reader->lengths = (size_t *)calloc(depth, sizeof(size_t));
+    reader->results = (int64_t *)calloc(depth, sizeof(int64_t));
+    if (reader->buffers == NULL || reader->offsets == NULL ||
+        reader->lengths == NULL || reader->results == NULL) {
+        XzraReaderClose(reader);
+        return NULL;
+    }
+
+    return reader;
+}
+
+void XzraReaderClose(XzraReader *reader) {
+    if (reader == NULL) return;
+
+#ifdef XZRA_USE_IO_URING
+    if (reader->uring != NULL && !reader->ring_broken) {
+        // Reap the reads still in flight before freeing their buffers.
+        for (int64_t i = reader->consumed; i < reader->submitted; ++i) {
+            WaitSlot(reader, SlotOf(reader, i));
+        }
+    }
+    if (reader->ring_broken) {
+        // The kernel may still write to the buffers. Leak them rather than
+        // risk memory corruption.
+        reader->buffers = NULL;
+    }
+    UringDestroy(reader->uring);
+#endif  // XZRA_USE_IO_URING
+    free(reader->buffers);
+    free(reader->offsets);
+    free(reader->lengths);
+    free(reader->results);
+    free(reader);
+}
+
+int64_t XzraReaderNext(XzraReader *reader, const uint8_t **chunk) {
+    // The chunk returned by the previous call is no longer in use, so its
+    // buffer may take the next read.
+    SubmitChunks(reader);
+    if (reader->failed) return -1;
+    if (reader->consumed == reader->submitted) return 0;
+
+    int slot = SlotOf(reader, reader->consumed);
+    WaitSlot(reader, slot);
+    int64_t result = reader->results[slot];
+    if (result < 0) {
+        reader->failed = true;
+        return -1;
+    }
+    ++reader->consumed;
+    *chunk = SlotBuffer(reader, slot);
+
+    return result;
+}
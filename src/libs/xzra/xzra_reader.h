@@ -0,0 +1,81 @@
+/**
+ * @file xzra_reader.h
+ * @author GamesCrafters Research Group, UC Berkeley
+ *         Supervised by Dan Garcia <ddgarcia@cs.berkeley.edu>
+ * @brief Read-ahead reader of a byte range of a file, used by the XZRA
+ * decompressor to keep several reads in flight while earlier chunks are being
+ * decompressed.
+ * @details Reads are submitted through io_uring if XZRA was built with
+ * \c XZRA_USE_IO_URING and the kernel allows it, and fall back to blocking
+ * \c pread calls one chunk at a time otherwise.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright This file is part of GAMESMAN, The Finite, Two-person
+ * Perfect-Information Game Generator released under the GPL:
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMESMANONE_LIB_XZRA_XZRA_READER_H_
+#define GAMESMANONE_LIB_XZRA_XZRA_READER_H_
+
+#include <stdint.h>  // int64_t, uint8_t
+#include <stdlib.h>  // size_t
+
+/** @brief Read-ahead reader of a byte range of a file. */
+typedef struct XzraReader XzraReader;
+
+/**
+ * @brief Reads exactly \p size bytes at \p offset of file descriptor \p fd
+ * into \p buf using \c pread, retrying on short reads and interrupts.
+ *
+ * @return Number of bytes read, which is less than \p size only if the end of
+ * file is reached;
+ * @return -1 on read error, with \c errno set.
+ */
+int64_t XzraPreadFull(int fd, void *buf, size_t size, int64_t offset);
+
+/**
+ * @brief Opens a reader of the \p length bytes of file descriptor \p fd
+ * starting at byte \p offset, which reads chunks of at most \p chunk_size bytes
+ * and keeps up to \p depth reads in flight. The reader does not take ownership
+ * of \p fd.
+ *
+ * @param length Number of bytes to read, or -1 to read until the end of file.
+ * @return Pointer to the opened reader, which must be closed using
+ * \c XzraReaderClose;
+ * @return \c NULL if out of memory or if the size of the file cannot be
+ * determined.
+ */
+XzraReader *XzraReaderOpen(int fd, int64_t offset, int64_t length,
+                           size_t chunk_size, int depth);
+
+/** @brief Closes \p reader, waiting for its reads in flight to complete. */
+void XzraReaderClose(XzraReader *reader);
+
+/**
+ * @brief Returns the next chunk of the range in file order, waiting for its
+ * read to complete, and submits the read of a later chunk in its place.
+ *
+ * @param reader Reader to read from.
+ * @param chunk (Output parameter) Set to the start of the chunk, which remains
+ * valid until the next call.
+ * @return Size of the chunk in bytes;
+ * @return 0 if the end of the range or of the file has been reached;
+ * @return -1 on read error, with \c errno set.
+ */
+int64_t XzraReaderNext(XzraReader *reader, const uint8_t **chunk);
+
+#endif  // GAMESMANONE_LIB_XZRA_XZRA_READER_H_
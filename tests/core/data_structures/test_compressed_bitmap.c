@@ -0,0 +1,329 @@
+/**
+ * @file test_compressed_bitmap.c
+ * @brief Unit tests for the CompressedBitmap module.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "core/concurrency.h"
+#include "core/data_structures/compressed_bitmap.h"
+#include "core/data_structures/concurrent_bitset.h"
+#include "core/gamesman_memory.h"
+
+static const memory_order kRelaxed = memory_order_relaxed;
+
+enum { kChunkBits = 1 << 16, kNumThreads = 8 };
+
+/* Sizes around container boundaries. */
+static const int64_t kSizes[] = {
+    1, 63, 1000, kChunkBits - 1, kChunkBits + 1, 3 * kChunkBits + 517,
+};
+enum { kNumSizes = sizeof(kSizes) / sizeof(kSizes[0]) };
+
+static uint64_t Next(uint64_t *state) {
+    /* xorshift64 */
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/* Returns whether B and S have exactly the same bits set. */
+static bool SameBits(const CompressedBitmap *b, ConcurrentBitset *s) {
+    int64_t size = ConcurrentBitsetGetNumBits(s);
+    if (CompressedBitmapGetNumBits(b) != size) return false;
+    for (int64_t i = 0; i < size; ++i) {
+        bool expected = ConcurrentBitsetTest(s, i, kRelaxed);
+        if (CompressedBitmapContains(b, i) != expected) return false;
+    }
+
+    return CompressedBitmapCount(b) == ConcurrentBitsetCount(s);
+}
+
+/* Adds roughly one in every PERIOD bits to both B and S. */
+static bool AddRandom(CompressedBitmap *b, ConcurrentBitset *s, int period,
+                      uint64_t seed) {
+    uint64_t state = seed;
+    int64_t size = ConcurrentBitsetGetNumBits(s);
+    for (int64_t i = 0; i < size; ++i) {
+        /* Add in a scattered order to exercise sorted array inserts. */
+        int64_t bit = (int64_t)(Next(&state) % (uint64_t)size);
+        if (i % period != 0) continue;
+        if (!CompressedBitmapAdd(b, bit)) return false;
+        ConcurrentBitsetSet(s, bit, kRelaxed);
+    }
+
+    return true;
+}
+
+static int TestAddAndContains(void) {
+    for (int k = 0; k < kNumSizes; ++k) {
+        /* Periods from dense bitmap containers to sparse array containers. */
+        for (int period = 1; period <= 1000; period *= 10) {
+            CompressedBitmap *b = CompressedBitmapCreate(kSizes[k], NULL);
+            ConcurrentBitset *s = ConcurrentBitsetCreate(kSizes[k]);
+            if (b == NULL || s == NULL) return 1;
+            if (!AddRandom(b, s, period, k + period)) return 1;
+            if (!SameBits(b, s)) return 1;
+
+            /* Adding the same bits again changes nothing. */
+            if (!AddRandom(b, s, period, k + period)) return 1;
+            if (!SameBits(b, s)) return 1;
+            CompressedBitmapDestroy(b);
+            ConcurrentBitsetDestroy(s);
+        }
+    }
+
+    return 0;
+}
+
+static int TestOptimizeRuns(void) {
+    int64_t size = 3 * kChunkBits + 517;
+    CompressedBitmap *b = CompressedBitmapCreate(size, NULL);
+    ConcurrentBitset *s = ConcurrentBitsetCreate(size);
+    if (b == NULL || s == NULL) return 1;
+
+    /* Long runs crossing chunk boundaries, and a full last chunk. */
+    for (int64_t i = 0; i < size; ++i) {
+        if (i % 1000 < 300 || i >= 3 * kChunkBits) {
+            if (!CompressedBitmapAdd(b, i)) return 1;
+            ConcurrentBitsetSet(s, i, kRelaxed);
+        }
+    }
+    size_t before = CompressedBitmapGetSerializedSize(b);
+    if (!CompressedBitmapOptimize(b)) return 1;
+    if (!SameBits(b, s)) return 1;
+    if (CompressedBitmapGetSerializedSize(b) >= before) return 1;
+
+    /* Adding to a run container still works. */
+    if (!CompressedBitmapAdd(b, 500)) return 1;
+    ConcurrentBitsetSet(s, 500, kRelaxed);
+    if (!SameBits(b, s)) return 1;
+    CompressedBitmapDestroy(b);
+    ConcurrentBitsetDestroy(s);
+
+    return 0;
+}
+
+static int TestOr(void) {
+    for (int k = 0; k < kNumSizes; ++k) {
+        CompressedBitmap *dest = CompressedBitmapCreate(kSizes[k], NULL);
+        CompressedBitmap *src = CompressedBitmapCreate(kSizes[k], NULL);
+        ConcurrentBitset *expected = ConcurrentBitsetCreate(kSizes[k]);
+        if (dest == NULL || src == NULL || expected == NULL) return 1;
+        if (!AddRandom(dest, expected, 7, 12345)) return 1;
+        if (!AddRandom(src, expected, 2, 67890)) return 1;
+        if (!CompressedBitmapOr(dest, src)) return 1;
+        if (!SameBits(dest, expected)) return 1;
+        CompressedBitmapDestroy(dest);
+        CompressedBitmapDestroy(src);
+        ConcurrentBitsetDestroy(expected);
+    }
+
+    return 0;
+}
+
+static int TestBitsetConversion(void) {
+    for (int k = 0; k < kNumSizes; ++k) {
+        CompressedBitmap *b = CompressedBitmapCreate(kSizes[k], NULL);
+        ConcurrentBitset *s = ConcurrentBitsetCreate(kSizes[k]);
+        if (b == NULL || s == NULL) return 1;
+        if (!AddRandom(b, s, 3, k + 1)) return 1;
+
+        CompressedBitmap *from = CompressedBitmapCreateFromBitset(s, NULL);
+        ConcurrentBitset *to = ConcurrentBitsetCreate(kSizes[k]);
+        if (from == NULL || to == NULL) return 1;
+        if (!SameBits(from, s)) return 1;
+        CompressedBitmapToBitset(b, to);
+        if (!SameBits(b, to)) return 1;
+        CompressedBitmapDestroy(b);
+        CompressedBitmapDestroy(from);
+        ConcurrentBitsetDestroy(s);
+        ConcurrentBitsetDestroy(to);
+    }
+
+    return 0;
+}
+
+static int TestSerialization(void) {
+    int64_t size = 3 * kChunkBits + 517;
+    CompressedBitmap *b = CompressedBitmapCreate(size, NULL);
+    ConcurrentBitset *s = ConcurrentBitsetCreate(size);
+    if (b == NULL || s == NULL) return 1;
+
+    /* One chunk of each container type and an empty one. */
+    for (int64_t i = 0; i < kChunkBits; i += 101) {
+        if (!CompressedBitmapAdd(b, i)) return 1;
+        ConcurrentBitsetSet(s, i, kRelaxed);
+    }
+    for (int64_t i = 2 * kChunkBits; i < size; ++i) {
+        if (i % 3 == 0 || i > 3 * kChunkBits) {
+            if (!CompressedBitmapAdd(b, i)) return 1;
+            ConcurrentBitsetSet(s, i, kRelaxed);
+        }
+    }
+    if (!CompressedBitmapOptimize(b)) return 1;
+
+    size_t buf_size = CompressedBitmapGetSerializedSize(b);
+    char *buf = (char *)malloc(buf_size);
+    if (buf == NULL) return 1;
+    CompressedBitmapSerialize(b, buf);
+    if (CompressedBitmapGetSerializedSizeFromHeader(buf) != buf_size) return 1;
+
+    GamesmanAllocatorOptions options;
+    GamesmanAllocatorOptionsSetDefaults(&options);
+    GamesmanAllocator *allocator = GamesmanAllocatorCreate(&options);
+    if (allocator == NULL) return 1;
+    CompressedBitmap *copy =
+        CompressedBitmapDeserialize(buf, buf_size, size, allocator);
+    if (copy == NULL || !SameBits(copy, s)) return 1;
+    CompressedBitmapDestroy(copy);
+    GamesmanAllocatorRelease(allocator);
+
+    /* Truncated buffers, wrong sizes, and corrupt content are rejected. */
+    if (CompressedBitmapDeserialize(buf, buf_size - 8, size, NULL)) return 1;
+    if (CompressedBitmapDeserialize(buf, buf_size, size + 1, NULL)) return 1;
+    buf[0] ^= 1; /* Magic number. */
+    if (CompressedBitmapDeserialize(buf, buf_size, size, NULL)) return 1;
+    buf[0] ^= 1;
+    uint32_t type;
+    memcpy(&type, buf + kCompressedBitmapHeaderSize + 4, sizeof(type));
+    uint32_t bad_type = 7; /* Type of the first container. */
+    memcpy(buf + kCompressedBitmapHeaderSize + 4, &bad_type, sizeof(type));
+    if (CompressedBitmapDeserialize(buf, buf_size, size, NULL)) return 1;
+    memcpy(buf + kCompressedBitmapHeaderSize + 4, &type, sizeof(type));
+
+    /* Other corruptions are either rejected or decoded safely. */
+    for (size_t offset = 0; offset < buf_size; offset += 97) {
+        char saved = buf[offset];
+        buf[offset] = (char)0xFF;
+        CompressedBitmapDestroy(
+            CompressedBitmapDeserialize(buf, buf_size, size, NULL));
+        buf[offset] = saved;
+    }
+    free(buf);
+    CompressedBitmapDestroy(b);
+    ConcurrentBitsetDestroy(s);
+
+    return 0;
+}
+
+static int TestOutOfMemory(void) {
+    GamesmanAllocatorOptions options;
+    GamesmanAllocatorOptionsSetDefaults(&options);
+    options.pool_size = CompressedBitmapMemRequired(4 * kChunkBits) + 256;
+    GamesmanAllocator *allocator = GamesmanAllocatorCreate(&options);
+    if (allocator == NULL) return 1;
+    CompressedBitmap *b = CompressedBitmapCreate(4 * kChunkBits, allocator);
+    if (b == NULL) return 1;
+
+    /* Bits stop being added once the pool is used up. */
+    bool failed = false;
+    for (int64_t i = 0; i < 4 * kChunkBits && !failed; i += 2) {
+        failed = !CompressedBitmapAdd(b, i);
+        if (!failed && !CompressedBitmapContains(b, i)) return 1;
+    }
+    if (!failed) return 1;
+    CompressedBitmapDestroy(b);
+    GamesmanAllocatorRelease(allocator);
+
+    return 0;
+}
+
+/* Returns whether bit I is one of the bits added concurrently. Chunks are
+ * filled at different densities so that containers are converted while
+ * other threads add to them. */
+static bool IsConcurrentBit(int64_t i) {
+    static const int kPeriods[] = {64, 2, 1, 1000};
+    uint64_t state = (uint64_t)i + 1;
+    int period = kPeriods[(i / kChunkBits) % 4];
+    return Next(&state) % (uint64_t)period == 0;
+}
+
+/* Adds the concurrent bits of B twice from multiple threads, and records the
+ * ones added successfully in S. Returns whether all of them were added. */
+static bool AddConcurrently(CompressedBitmap *b, ConcurrentBitset *s) {
+    int64_t size = ConcurrentBitsetGetNumBits(s);
+    atomic_bool success;
+    atomic_init(&success, true);
+#ifdef _OPENMP
+    omp_set_num_threads(kNumThreads);
+#endif
+    PRAGMA_OMP_PARALLEL_FOR_SCHEDULE_DYNAMIC(64)
+    for (int64_t i = 0; i < 2 * size; ++i) {
+        int64_t bit = i % size;
+        if (!IsConcurrentBit(bit)) continue;
+        if (CompressedBitmapAdd(b, bit)) {
+            ConcurrentBitsetSet(s, bit, kRelaxed);
+        } else {
+            atomic_store_explicit(&success, false, kRelaxed);
+        }
+    }
+
+    return atomic_load_explicit(&success, kRelaxed);
+}
+
+static int TestConcurrentAdd(void) {
+    int64_t size = 4 * kChunkBits + 517;
+    CompressedBitmap *b = CompressedBitmapCreate(size, NULL);
+    ConcurrentBitset *s = ConcurrentBitsetCreate(size);
+    if (b == NULL || s == NULL) return 1;
+    if (!AddConcurrently(b, s)) return 1;
+    if (!SameBits(b, s)) return 1;
+
+    /* No bit was missed. */
+    for (int64_t i = 0; i < size; ++i) {
+        if (IsConcurrentBit(i) != CompressedBitmapContains(b, i)) return 1;
+    }
+    CompressedBitmapDestroy(b);
+    ConcurrentBitsetDestroy(s);
+
+    return 0;
+}
+
+static int TestConcurrentOutOfMemory(void) {
+    int64_t size = 4 * kChunkBits + 517;
+    GamesmanAllocatorOptions options;
+    GamesmanAllocatorOptionsSetDefaults(&options);
+    options.pool_size = CompressedBitmapMemRequired(size) + kChunkBits / 4;
+    GamesmanAllocator *allocator = GamesmanAllocatorCreate(&options);
+    if (allocator == NULL) return 1;
+    CompressedBitmap *b = CompressedBitmapCreate(size, allocator);
+    ConcurrentBitset *s = ConcurrentBitsetCreate(size);
+    if (b == NULL || s == NULL) return 1;
+
+    /* Some bits fail to be added, but the ones that were are all there. */
+    if (AddConcurrently(b, s)) return 1;
+    if (!SameBits(b, s)) return 1;
+
+    /* Everything is returned to the pool. */
+    CompressedBitmapDestroy(b);
+    ConcurrentBitsetDestroy(s);
+    if (GamesmanAllocatorGetRemainingPoolSize(allocator) != options.pool_size) {
+        return 1;
+    }
+    GamesmanAllocatorRelease(allocator);
+
+    return 0;
+}
+
+int main(void) {
+    if (TestAddAndContains()) return EXIT_FAILURE;
+    if (TestOptimizeRuns()) return EXIT_FAILURE;
+    if (TestOr()) return EXIT_FAILURE;
+    if (TestBitsetConversion()) return EXIT_FAILURE;
+    if (TestSerialization()) return EXIT_FAILURE;
+    if (TestOutOfMemory()) return EXIT_FAILURE;
+    if (TestConcurrentAdd()) return EXIT_FAILURE;
+    if (TestConcurrentOutOfMemory()) return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
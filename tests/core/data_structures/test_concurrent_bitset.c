@@ -0,0 +1,164 @@
+/**
+ * @file test_concurrent_bitset.c
+ * @brief Unit tests for the set-bit iteration and bulk operations of the
+ * ConcurrentBitset module.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "core/data_structures/concurrent_bitset.h"
+
+static const memory_order kRelaxed = memory_order_relaxed;
+
+/* Sizes around block and chunk boundaries. */
+static const int64_t kSizes[] = {
+    1, 63, 64, 65, 1000, kConcurrentBitsetChunkBits - 1,
+    kConcurrentBitsetChunkBits + 1, 3 * kConcurrentBitsetChunkBits + 517,
+};
+enum { kNumSizes = sizeof(kSizes) / sizeof(kSizes[0]) };
+
+static uint64_t Next(uint64_t *state) {
+    /* xorshift64 */
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/* Sets roughly one in every PERIOD bits of S. */
+static ConcurrentBitset *MakeRandom(int64_t size, int period, uint64_t seed) {
+    ConcurrentBitset *s = ConcurrentBitsetCreate(size);
+    if (s == NULL) return NULL;
+    uint64_t state = seed;
+    for (int64_t i = 0; i < size; ++i) {
+        if (Next(&state) % period == 0) ConcurrentBitsetSet(s, i, kRelaxed);
+    }
+
+    return s;
+}
+
+static int CheckIteration(ConcurrentBitset *s, bool set) {
+    int64_t size = ConcurrentBitsetGetNumBits(s);
+    int64_t expected = 0;
+    int64_t (*find)(ConcurrentBitset *, int64_t, int64_t, memory_order) =
+        set ? ConcurrentBitsetFindNextSet : ConcurrentBitsetFindNextUnset;
+
+    /* Iterate over the whole bitset with an end past the last bit. */
+    int64_t end = size + 100;
+    for (int64_t i = find(s, 0, end, kRelaxed); i < end;
+         i = find(s, i + 1, end, kRelaxed)) {
+        while (ConcurrentBitsetTest(s, expected, kRelaxed) != set) ++expected;
+        if (i != expected++) return 1;
+    }
+    while (expected < size) {
+        if (ConcurrentBitsetTest(s, expected++, kRelaxed) == set) return 1;
+    }
+
+    /* Iterate chunk by chunk. */
+    int64_t count = 0;
+    for (int64_t c = 0; c < ConcurrentBitsetNumChunks(s); ++c) {
+        int64_t chunk_end = (c + 1) * kConcurrentBitsetChunkBits;
+        for (int64_t i = find(s, c * kConcurrentBitsetChunkBits, chunk_end,
+                              kRelaxed);
+             i < chunk_end; i = find(s, i + 1, chunk_end, kRelaxed)) {
+            if (i >= size || ConcurrentBitsetTest(s, i, kRelaxed) != set) {
+                return 1;
+            }
+            ++count;
+        }
+    }
+    int64_t num_set = ConcurrentBitsetCount(s);
+    if (count != (set ? num_set : size - num_set)) return 1;
+
+    return 0;
+}
+
+static int TestIterationAndCount(void) {
+    for (int k = 0; k < kNumSizes; ++k) {
+        for (int period = 1; period <= 1000; period *= 10) {
+            ConcurrentBitset *s = MakeRandom(kSizes[k], period, k + period);
+            if (s == NULL) return 1;
+
+            int64_t count = 0;
+            for (int64_t i = 0; i < kSizes[k]; ++i) {
+                count += ConcurrentBitsetTest(s, i, kRelaxed);
+            }
+            if (ConcurrentBitsetCount(s) != count) return 1;
+            if (CheckIteration(s, true)) return 1;
+            if (CheckIteration(s, false)) return 1;
+            ConcurrentBitsetDestroy(s);
+        }
+    }
+
+    return 0;
+}
+
+static int TestEmptyRanges(void) {
+    ConcurrentBitset *s = ConcurrentBitsetCreate(100);
+    if (s == NULL) return 1;
+    if (ConcurrentBitsetFindNextSet(s, 0, 100, kRelaxed) != 100) return 1;
+
+    ConcurrentBitsetSet(s, 42, kRelaxed);
+    if (ConcurrentBitsetFindNextSet(s, 0, 42, kRelaxed) != 42) return 1;
+    if (ConcurrentBitsetFindNextSet(s, 43, 100, kRelaxed) != 100) return 1;
+    if (ConcurrentBitsetFindNextSet(s, 42, 42, kRelaxed) != 42) return 1;
+    if (ConcurrentBitsetFindNextSet(s, 200, 300, kRelaxed) != 300) return 1;
+    if (ConcurrentBitsetFindNextUnset(s, 42, 100, kRelaxed) != 43) return 1;
+    ConcurrentBitsetDestroy(s);
+
+    return 0;
+}
+
+typedef enum { kAnd, kOr, kAndNot } Op;
+
+static int CheckBulk(int64_t size, Op op) {
+    ConcurrentBitset *dest = MakeRandom(size, 3, 12345);
+    ConcurrentBitset *copy = ConcurrentBitsetCreateCopy(dest);
+    ConcurrentBitset *src = MakeRandom(size, 2, 67890);
+    if (dest == NULL || copy == NULL || src == NULL) return 1;
+
+    switch (op) {
+        case kAnd:
+            ConcurrentBitsetAnd(dest, src);
+            break;
+        case kOr:
+            ConcurrentBitsetOr(dest, src);
+            break;
+        case kAndNot:
+            ConcurrentBitsetAndNot(dest, src);
+            break;
+    }
+
+    for (int64_t i = 0; i < size; ++i) {
+        bool a = ConcurrentBitsetTest(copy, i, kRelaxed);
+        bool b = ConcurrentBitsetTest(src, i, kRelaxed);
+        bool expected = op == kAnd ? (a && b) : op == kOr ? (a || b) : (a && !b);
+        if (ConcurrentBitsetTest(dest, i, kRelaxed) != expected) return 1;
+    }
+    ConcurrentBitsetDestroy(dest);
+    ConcurrentBitsetDestroy(copy);
+    ConcurrentBitsetDestroy(src);
+
+    return 0;
+}
+
+static int TestBulkOperations(void) {
+    for (int k = 0; k < kNumSizes; ++k) {
+        if (CheckBulk(kSizes[k], kAnd)) return 1;
+        if (CheckBulk(kSizes[k], kOr)) return 1;
+        if (CheckBulk(kSizes[k], kAndNot)) return 1;
+    }
+
+    return 0;
+}
+
+int main(void) {
+    if (TestIterationAndCount()) return EXIT_FAILURE;
+    if (TestEmptyRanges()) return EXIT_FAILURE;
+    if (TestBulkOperations()) return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
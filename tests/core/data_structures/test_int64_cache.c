@@ -0,0 +1,108 @@
+/**
+ * @file test_int64_cache.c
+ * @brief Unit tests for the Int64Cache module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/data_structures/int64_cache.h"
+
+enum { kEntrySize = 100, kCapacity = 10 * kEntrySize };
+
+static bool PutFilled(Int64Cache *cache, int64_t key) {
+    char *data = (char *)Int64CachePut(cache, key, kEntrySize);
+    if (data == NULL) return false;
+    memset(data, (int)(key & 0x7F), kEntrySize);
+
+    return true;
+}
+
+static bool HasFilled(Int64Cache *cache, int64_t key) {
+    size_t size = 0;
+    const char *data = (const char *)Int64CacheGet(cache, key, &size);
+    if (data == NULL || size != kEntrySize) return false;
+    for (int i = 0; i < kEntrySize; ++i) {
+        if (data[i] != (char)(key & 0x7F)) return false;
+    }
+
+    return true;
+}
+
+static int TestPutAndGet(void) {
+    Int64Cache *cache = Int64CacheInit(kCapacity, NULL);
+    if (cache == NULL) return 1;
+
+    for (int64_t key = -5; key < 5; ++key) {
+        if (!PutFilled(cache, key * 1000003)) return 1;
+    }
+    for (int64_t key = -5; key < 5; ++key) {
+        if (!HasFilled(cache, key * 1000003)) return 1;
+    }
+    if (Int64CacheGet(cache, 7, NULL) != NULL) return 1;
+    if (Int64CacheUsage(cache) != kCapacity) return 1;
+
+    /* Replacing an entry frees its previous buffer. */
+    if (Int64CachePut(cache, 0, 1) == NULL) return 1;
+    if (Int64CacheUsage(cache) != kCapacity - kEntrySize + 1) return 1;
+    Int64CacheDestroy(cache);
+
+    return 0;
+}
+
+static int TestEviction(void) {
+    Int64Cache *cache = Int64CacheInit(kCapacity, NULL);
+    if (cache == NULL) return 1;
+
+    for (int64_t key = 0; key < 10; ++key) {
+        if (!PutFilled(cache, key)) return 1;
+    }
+
+    /* Key 0 becomes the most recently used, so key 1 is evicted first. */
+    if (!HasFilled(cache, 0)) return 1;
+    if (!PutFilled(cache, 10)) return 1;
+    if (Int64CacheContains(cache, 1)) return 1;
+    if (!Int64CacheContains(cache, 0)) return 1;
+
+    /* A buffer larger than one entry evicts as many entries as needed. */
+    if (Int64CachePut(cache, 11, 3 * kEntrySize) == NULL) return 1;
+    if (Int64CacheContains(cache, 2) || Int64CacheContains(cache, 3) ||
+        Int64CacheContains(cache, 4)) {
+        return 1;
+    }
+    if (!Int64CacheContains(cache, 5)) return 1;
+    if (Int64CacheUsage(cache) > kCapacity) return 1;
+
+    /* Buffers larger than the cache are rejected. */
+    if (Int64CachePut(cache, 12, kCapacity + 1) != NULL) return 1;
+    Int64CacheDestroy(cache);
+
+    return 0;
+}
+
+static int TestManyKeys(void) {
+    Int64Cache *cache = Int64CacheInit(kCapacity, NULL);
+    if (cache == NULL) return 1;
+
+    /* Only the 10 most recent keys survive, in any bucket layout. */
+    for (int64_t key = 0; key < 100000; ++key) {
+        if (!PutFilled(cache, key * 64)) return 1;
+    }
+    for (int64_t key = 100000 - 10; key < 100000; ++key) {
+        if (!HasFilled(cache, key * 64)) return 1;
+    }
+    if (Int64CacheContains(cache, (100000 - 11) * 64)) return 1;
+    Int64CacheDestroy(cache);
+
+    return 0;
+}
+
+int main(void) {
+    if (TestPutAndGet()) return EXIT_FAILURE;
+    if (TestEviction()) return EXIT_FAILURE;
+    if (TestManyKeys()) return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file test_int64_segmented_array.c
+ * @brief Unit tests for the Int64SegmentedArray module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "core/data_structures/int64_segmented_array.h"
+#include "core/gamesman_memory.h"
+
+enum { kNumItems = 5 * kInt64SegmentedArrayChunkSize + 123 };
+
+static int64_t ItemOf(int64_t i) { return i * 7919 - 3; }
+
+static int TestPushBackAndGet(void) {
+    Int64SegmentedArray array;
+    Int64SegmentedArrayInit(&array);
+    if (Int64SegmentedArraySize(&array) != 0) return 1;
+
+    int64_t *first_chunk = NULL;
+    for (int64_t i = 0; i < kNumItems; ++i) {
+        if (!Int64SegmentedArrayPushBack(&array, ItemOf(i))) return 1;
+
+        /* Items are never moved once the first chunk is full. */
+        if (i == kInt64SegmentedArrayChunkSize) {
+            first_chunk = Int64SegmentedArrayChunk(&array, 0);
+        } else if (first_chunk != NULL &&
+                   Int64SegmentedArrayChunk(&array, 0) != first_chunk) {
+            return 1;
+        }
+    }
+    if (Int64SegmentedArraySize(&array) != kNumItems) return 1;
+    for (int64_t i = 0; i < kNumItems; ++i) {
+        if (Int64SegmentedArrayGet(&array, i) != ItemOf(i)) return 1;
+    }
+    Int64SegmentedArrayDestroy(&array);
+
+    return 0;
+}
+
+static int TestChunkIteration(void) {
+    Int64SegmentedArray array;
+    Int64SegmentedArrayInit(&array);
+    for (int64_t i = 0; i < kNumItems; ++i) {
+        if (!Int64SegmentedArrayPushBack(&array, ItemOf(i))) return 1;
+    }
+
+    int64_t num_chunks = Int64SegmentedArrayNumChunks(&array);
+    if (num_chunks != kNumItems / kInt64SegmentedArrayChunkSize + 1) return 1;
+    int64_t count = 0;
+    for (int64_t c = 0; c < num_chunks; ++c) {
+        const int64_t *chunk = Int64SegmentedArrayChunk(&array, c);
+        int64_t length = Int64SegmentedArrayChunkLength(&array, c);
+        for (int64_t j = 0; j < length; ++j) {
+            if (chunk[j] != ItemOf(count++)) return 1;
+        }
+        Int64SegmentedArrayReleaseChunk(&array, c);
+    }
+    if (count != kNumItems) return 1;
+
+    /* The array is reusable after being cleared. */
+    Int64SegmentedArrayClear(&array);
+    if (Int64SegmentedArraySize(&array) != 0) return 1;
+    if (!Int64SegmentedArrayPushBack(&array, 42)) return 1;
+    if (Int64SegmentedArrayGet(&array, 0) != 42) return 1;
+    Int64SegmentedArrayDestroy(&array);
+
+    return 0;
+}
+
+static int TestAllocatorPool(void) {
+    GamesmanAllocatorOptions options;
+    GamesmanAllocatorOptionsSetDefaults(&options);
+    options.pool_size = 3 * kInt64SegmentedArrayChunkSize * sizeof(int64_t);
+    GamesmanAllocator *allocator = GamesmanAllocatorCreate(&options);
+    if (allocator == NULL) return 1;
+
+    Int64SegmentedArray array;
+    Int64SegmentedArrayInitAllocator(&array, allocator);
+    int64_t size = 0;
+    while (Int64SegmentedArrayPushBack(&array, size)) ++size;
+
+    /* A failed append leaves the array intact. */
+    if (size == 0 || Int64SegmentedArraySize(&array) != size) return 1;
+    if (Int64SegmentedArrayGet(&array, size - 1) != size - 1) return 1;
+
+    /* All memory is returned to the pool. */
+    Int64SegmentedArrayDestroy(&array);
+    if (GamesmanAllocatorGetRemainingPoolSize(allocator) != options.pool_size) {
+        return 1;
+    }
+    GamesmanAllocatorRelease(allocator);
+
+    return 0;
+}
+
+int main(void) {
+    if (TestPushBackAndGet()) return EXIT_FAILURE;
+    if (TestChunkIteration()) return EXIT_FAILURE;
+    if (TestAllocatorPool()) return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file test_swiss_table.c
+ * @brief Unit tests for the SwissTable core and the hash containers built on
+ * top of it.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/data_structures/int64_hash_map.h"
+#include "core/data_structures/int64_hash_set.h"
+#include "core/data_structures/swiss_table.h"
+
+enum { kKeyRange = 1 << 14, kNumOps = 200000 };
+
+static uint64_t rng_state = 0x2545F4914F6CDD1DULL;
+
+static uint64_t NextRandom(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/* Maps random keys to a sparse, signed key space so that many keys collide in
+ * their lower bits. */
+static int64_t KeyOf(int64_t i) { return (i - kKeyRange / 2) << 20; }
+
+static int TestInt64HashMapAgainstReference(void) {
+    int64_t *reference = malloc(sizeof(int64_t) * kKeyRange);
+    bool *present = calloc(kKeyRange, sizeof(bool));
+    if (reference == NULL || present == NULL) return 1;
+
+    Int64HashMap map;
+    Int64HashMapInit(&map, 0.75);
+    int64_t size = 0;
+    int ret = 1;
+    for (int i = 0; i < kNumOps; ++i) {
+        int64_t k = (int64_t)(NextRandom() % kKeyRange);
+        int64_t key = KeyOf(k);
+        switch (NextRandom() % 4) {
+            case 0:
+            case 1: {
+                int64_t value = (int64_t)NextRandom();
+                if (!Int64HashMapSet(&map, key, value)) goto _bailout;
+                size += !present[k];
+                present[k] = true;
+                reference[k] = value;
+                break;
+            }
+            case 2: {
+                bool removed = Int64HashMapRemove(&map, key);
+                if (removed != present[k]) goto _bailout;
+                size -= present[k];
+                present[k] = false;
+                break;
+            }
+            case 3: {
+                Int64HashMapIterator it = Int64HashMapGet(&map, key);
+                if (Int64HashMapIteratorIsValid(&it) != present[k]) {
+                    goto _bailout;
+                }
+                if (present[k] &&
+                    Int64HashMapIteratorValue(&it) != reference[k]) {
+                    goto _bailout;
+                }
+                break;
+            }
+        }
+        if (Int64HashMapSize(&map) != size) goto _bailout;
+    }
+
+    /* Iteration must visit every present key exactly once. */
+    Int64HashMapIterator it = Int64HashMapBegin(&map);
+    int64_t key, value, visited = 0;
+    while (Int64HashMapIteratorNext(&it, &key, &value)) {
+        int64_t k = (key >> 20) + kKeyRange / 2;
+        if (k < 0 || k >= kKeyRange || !present[k]) goto _bailout;
+        if (reference[k] != value) goto _bailout;
+        ++visited;
+    }
+    if (visited != size) goto _bailout;
+    ret = 0;
+
+_bailout:
+    Int64HashMapDestroy(&map);
+    free(reference);
+    free(present);
+    return ret;
+}
+
+static int TestInt64HashSetReserve(void) {
+    Int64HashSet set;
+    Int64HashSetInit(&set, 0.5);
+    if (!Int64HashSetReserve(&set, 1000)) return 1;
+    int64_t capacity = set.table.capacity;
+    for (int64_t i = 0; i < 1000; ++i) {
+        if (!Int64HashSetAdd(&set, i * 7)) return 1;
+    }
+    if (set.table.capacity != capacity) return 1; /* Must not have expanded. */
+    if (Int64HashSetSize(&set) != 1000) return 1;
+    for (int64_t i = 0; i < 7000; ++i) {
+        if (Int64HashSetContains(&set, i) != (i % 7 == 0)) return 1;
+    }
+    Int64HashSetDestroy(&set);
+
+    return 0;
+}
+
+static int TestSwissTableChurn(void) {
+    /* Repeated insertion and removal must not degrade the table or make it
+     * grow, since removal leaves no tombstones. */
+    SwissTable table;
+    SwissTableInit(&table, 2, 1, 0.875);
+    for (int64_t round = 0; round < 1000; ++round) {
+        for (int64_t i = 0; i < 100; ++i) {
+            int64_t key[2] = {round, i};
+            bool inserted;
+            int64_t index = SwissTableInsert(&table, key, &inserted);
+            if (index < 0 || !inserted) return 1;
+            if (SwissTableSlot(&table, index)[2] != 0) return 1;
+            SwissTableSlot(&table, index)[2] = round + i;
+        }
+        for (int64_t i = 0; i < 100; ++i) {
+            int64_t key[2] = {round, i};
+            int64_t index = SwissTableFind(&table, key);
+            if (index < 0) return 1;
+            if (SwissTableSlot(&table, index)[2] != round + i) return 1;
+            if (!SwissTableRemove(&table, key)) return 1;
+            if (SwissTableFind(&table, key) >= 0) return 1;
+        }
+        if (table.size != 0) return 1;
+    }
+    if (table.capacity > 128) return 1;
+    SwissTableDestroy(&table);
+
+    return 0;
+}
+
+int main(void) {
+    if (TestInt64HashMapAgainstReference()) return EXIT_FAILURE;
+    if (TestInt64HashSetReserve()) return EXIT_FAILURE;
+    if (TestSwissTableChurn()) return EXIT_FAILURE;
+
+    return 0;
+}
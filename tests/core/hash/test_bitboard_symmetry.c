@@ -0,0 +1,229 @@
+/**
+ * @file test_bitboard_symmetry.c
+ * @brief Unit tests for the BitboardSymmetry module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "core/hash/bitboard_symmetry.h"
+
+enum { kNumSymmetries = 8, kNumSamples = 4096 };
+
+/* Dihedral group of a SIDE x SIDE board. Slot (r, c) is moved to the slot
+ * returned in (*r_out, *c_out) under symmetry S. */
+static void DihedralMap(int side, int s, int r, int c, int *r_out,
+                        int *c_out) {
+    if (s & 1) {
+        int t = r;
+        r = c;
+        c = t;
+    }
+    if (s & 2) r = side - 1 - r;
+    if (s & 4) c = side - 1 - c;
+    *r_out = r;
+    *c_out = c;
+}
+
+static void BuildMatrix(int side, int matrix[kNumSymmetries][64]) {
+    for (int s = 0; s < kNumSymmetries; ++s) {
+        for (int r = 0; r < side; ++r) {
+            for (int c = 0; c < side; ++c) {
+                int r2, c2;
+                DihedralMap(side, s, r, c, &r2, &c2);
+                matrix[s][r * side + c] = r2 * side + c2;
+            }
+        }
+    }
+}
+
+static uint64_t NaiveApply(const BitboardSymmetryOptions *options, int s,
+                           uint64_t board) {
+    uint64_t ret = 0;
+    for (int p = 0; p < options->num_planes; ++p) {
+        for (int i = 0; i < options->board_size; ++i) {
+            int src = options->slot_to_bit ? options->slot_to_bit[i] : i;
+            int dest = options->symmetry_matrix[s][i];
+            if (options->slot_to_bit) dest = options->slot_to_bit[dest];
+            src += p * options->plane_stride;
+            dest += p * options->plane_stride;
+            if ((board >> src) & 1) ret |= 1ULL << dest;
+        }
+    }
+
+    return ret;
+}
+
+static uint64_t RandomBoard(const BitboardSymmetryOptions *options) {
+    uint64_t ret = 0;
+    for (int p = 0; p < options->num_planes; ++p) {
+        for (int i = 0; i < options->board_size; ++i) {
+            if (rand() % 3 != 0) continue;
+            int bit = options->slot_to_bit ? options->slot_to_bit[i] : i;
+            ret |= 1ULL << (bit + p * options->plane_stride);
+        }
+    }
+
+    return ret;
+}
+
+static int CheckAgainstNaive(const BitboardSymmetryOptions *options,
+                             const BitboardSymmetry *symmetry) {
+    for (int k = 0; k < kNumSamples; ++k) {
+        uint64_t board = RandomBoard(options);
+        uint64_t min_board = UINT64_MAX;
+        int min_index = -1;
+        for (int s = 0; s < kNumSymmetries; ++s) {
+            uint64_t expected = NaiveApply(options, s, board);
+            if (BitboardSymmetryApply(symmetry, board, s) != expected) {
+                return 1;
+            }
+            if (expected < min_board) {
+                min_board = expected;
+                min_index = s;
+            }
+        }
+
+        int index;
+        if (BitboardSymmetryGetCanonical(symmetry, board, &index) !=
+            min_board) {
+            return 1;
+        }
+        if (index != min_index) return 1;
+    }
+
+    return 0;
+}
+
+/* Two-piece hash layout: row-major 3x3 slots, O in the lower 32 bits and X in
+ * the upper 32 bits. None of the symmetries are grid operations. */
+static int TestTwoPieceLayout(void) {
+    int matrix[kNumSymmetries][64];
+    BuildMatrix(3, matrix);
+    const int *rows[kNumSymmetries];
+    for (int s = 0; s < kNumSymmetries; ++s) rows[s] = matrix[s];
+
+    BitboardSymmetryOptions options;
+    BitboardSymmetryOptionsSetDefaults(&options);
+    options.board_size = 9;
+    options.symmetry_matrix = rows;
+    options.num_symmetries = kNumSymmetries;
+    options.num_planes = 2;
+    options.plane_stride = 32;
+
+    BitboardSymmetry symmetry;
+    if (BitboardSymmetryInit(&symmetry, &options) != 0) return 1;
+    if (symmetry.kernels[0] != kBitboardSymmetryKernelIdentity) return 1;
+    int ret = CheckAgainstNaive(&options, &symmetry);
+    BitboardSymmetryDestroy(&symmetry);
+
+    return ret;
+}
+
+/* x86 SIMD two-piece layout: a 5x5 board in the bottom right corner of an 8x8
+ * grid. All symmetries should compile to grid kernels. */
+static int TestGridLayout(void) {
+    int matrix[kNumSymmetries][64], slot_to_bit[25];
+    BuildMatrix(5, matrix);
+    const int *rows[kNumSymmetries];
+    for (int s = 0; s < kNumSymmetries; ++s) rows[s] = matrix[s];
+    for (int i = 0; i < 25; ++i) slot_to_bit[i] = (i / 5) * 8 + i % 5;
+
+    BitboardSymmetryOptions options;
+    BitboardSymmetryOptionsSetDefaults(&options);
+    options.board_size = 25;
+    options.symmetry_matrix = rows;
+    options.num_symmetries = kNumSymmetries;
+    options.slot_to_bit = slot_to_bit;
+
+    BitboardSymmetry symmetry;
+    if (BitboardSymmetryInit(&symmetry, &options) != 0) return 1;
+    if (symmetry.tables != NULL) return 1;
+    for (int s = 1; s < kNumSymmetries; ++s) {
+        if (symmetry.kernels[s] != kBitboardSymmetryKernelGrid) return 1;
+    }
+    int ret = CheckAgainstNaive(&options, &symmetry);
+
+    /* Pair canonicalization compares the second word first. */
+    for (int k = 0; k < kNumSamples && ret == 0; ++k) {
+        uint64_t board[2] = {RandomBoard(&options), RandomBoard(&options)};
+        uint64_t min_board[2] = {UINT64_MAX, UINT64_MAX}, canonical[2];
+        for (int s = 0; s < kNumSymmetries; ++s) {
+            uint64_t lo = NaiveApply(&options, s, board[0]);
+            uint64_t hi = NaiveApply(&options, s, board[1]);
+            if (hi < min_board[1] || (hi == min_board[1] && lo < min_board[0])) {
+                min_board[0] = lo;
+                min_board[1] = hi;
+            }
+        }
+        BitboardSymmetryGetCanonicalPair(&symmetry, board, canonical);
+        if (canonical[0] != min_board[0] || canonical[1] != min_board[1]) {
+            ret = 1;
+        }
+    }
+    BitboardSymmetryDestroy(&symmetry);
+
+    return ret;
+}
+
+static int TestBatch(void) {
+    int matrix[kNumSymmetries][64];
+    BuildMatrix(4, matrix);
+    const int *rows[kNumSymmetries];
+    for (int s = 0; s < kNumSymmetries; ++s) rows[s] = matrix[s];
+
+    BitboardSymmetryOptions options;
+    BitboardSymmetryOptionsSetDefaults(&options);
+    options.board_size = 16;
+    options.symmetry_matrix = rows;
+    options.num_symmetries = kNumSymmetries;
+    options.num_planes = 2;
+    options.plane_stride = 32;
+
+    BitboardSymmetry symmetry;
+    if (BitboardSymmetryInit(&symmetry, &options) != 0) return 1;
+
+    /* Not a multiple of the internal block size. */
+    enum { kBatchSize = 1000 };
+    uint64_t boards[kBatchSize], canonical[kBatchSize];
+    int8_t indices[kBatchSize];
+    for (int i = 0; i < kBatchSize; ++i) boards[i] = RandomBoard(&options);
+    BitboardSymmetryGetCanonicalBatch(&symmetry, boards, kBatchSize, canonical,
+                                      indices);
+    int ret = 0;
+    for (int i = 0; i < kBatchSize; ++i) {
+        int index;
+        uint64_t expected =
+            BitboardSymmetryGetCanonical(&symmetry, boards[i], &index);
+        if (canonical[i] != expected || indices[i] != index) ret = 1;
+    }
+    BitboardSymmetryDestroy(&symmetry);
+
+    return ret;
+}
+
+static int TestInvalidOptions(void) {
+    int matrix[2][4] = {{0, 1, 2, 3}, {0, 0, 2, 3}}; /* Not a permutation. */
+    const int *rows[2] = {matrix[0], matrix[1]};
+
+    BitboardSymmetryOptions options;
+    BitboardSymmetryOptionsSetDefaults(&options);
+    options.board_size = 4;
+    options.symmetry_matrix = rows;
+    options.num_symmetries = 2;
+
+    BitboardSymmetry symmetry;
+    if (BitboardSymmetryInit(&symmetry, &options) == 0) return 1;
+
+    return 0;
+}
+
+int main(void) {
+    if (TestTwoPieceLayout()) return EXIT_FAILURE;
+    if (TestGridLayout()) return EXIT_FAILURE;
+    if (TestBatch()) return EXIT_FAILURE;
+    if (TestInvalidOptions()) return EXIT_FAILURE;
+
+    return 0;
+}
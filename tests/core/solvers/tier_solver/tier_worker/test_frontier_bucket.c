@@ -0,0 +1,130 @@
+/**
+ * @file test_frontier_bucket.c
+ * @brief Unit tests for the FrontierBucket module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "core/solvers/tier_solver/tier_worker/frontier_bucket.h"
+
+enum { kMaxSegmentSize = 100000 };
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t NextRandom(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static int CompareInt64(const void *a, const void *b) {
+    int64_t lhs = *(const int64_t *)a, rhs = *(const int64_t *)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+/* Fills DEST with N unique positions in [0, range), shuffled in runs so that
+ * the positions are only roughly ascending, as in a multithreaded scan. */
+static void MakeSegment(Position *dest, int64_t n, int64_t range) {
+    int64_t stride = range / n;
+    for (int64_t i = 0; i < n; ++i) {
+        dest[i] = i * stride + (int64_t)(NextRandom() % (uint64_t)stride);
+    }
+    for (int64_t i = 0; i + 1 < n; i += 2) {
+        if (NextRandom() % 3 == 0) {
+            Position tmp = dest[i];
+            dest[i] = dest[i + 1];
+            dest[i + 1] = tmp;
+        }
+    }
+}
+
+/* Checks that the positions of a segment read back from BUCKET in blocks of
+ * various sizes are a permutation of EXPECTED. */
+static int CheckSegment(const FrontierBucket *bucket, int64_t offset,
+                        Position *expected, int64_t n, Position *buffer) {
+    int64_t begin = 0;
+    while (begin < n) {
+        int64_t count = 1 + (int64_t)(NextRandom() % 200);
+        if (begin + count > n) count = n - begin;
+        FrontierBucketGet(bucket, offset + begin, count, &buffer[begin]);
+        begin += count;
+    }
+    qsort(buffer, n, sizeof(Position), CompareInt64);
+    qsort(expected, n, sizeof(Position), CompareInt64);
+    for (int64_t i = 0; i < n; ++i) {
+        if (buffer[i] != expected[i]) return 1;
+    }
+
+    return 0;
+}
+
+static int TestSealedSegments(void) {
+    /* Dense, sparse, and very sparse segments followed by an unsealed tail. */
+    static const int64_t kSizes[4] = {kMaxSegmentSize, 5000, 300, 777};
+    static const int64_t kRanges[4] = {3 * kMaxSegmentSize, 1 << 20,
+                                       INT64_C(1) << 60, 1 << 16};
+    Position *segments[4];
+    Position *buffer = malloc(sizeof(Position) * kMaxSegmentSize);
+    if (buffer == NULL) return 1;
+
+    FrontierBucket bucket;
+    FrontierBucketInit(&bucket);
+    size_t raw_bytes = 0;
+    for (int s = 0; s < 4; ++s) {
+        segments[s] = malloc(sizeof(Position) * kSizes[s]);
+        if (segments[s] == NULL) return 1;
+        MakeSegment(segments[s], kSizes[s], kRanges[s]);
+        for (int64_t i = 0; i < kSizes[s]; ++i) {
+            if (!FrontierBucketAdd(&bucket, segments[s][i])) return 1;
+        }
+        raw_bytes += sizeof(Position) * kSizes[s];
+        if (s < 3 && !FrontierBucketSeal(&bucket)) return 1;
+    }
+
+    /* The dense and sparse segments must have been compressed. */
+    if (FrontierBucketMemUsage(&bucket) * 2 > raw_bytes) return 1;
+
+    int64_t offset = 0;
+    for (int s = 0; s < 4; ++s) {
+        if (CheckSegment(&bucket, offset, segments[s], kSizes[s], buffer)) {
+            return 1;
+        }
+        offset += kSizes[s];
+        free(segments[s]);
+    }
+    if (FrontierBucketSize(&bucket) != offset) return 1;
+
+    FrontierBucketDestroy(&bucket);
+    if (FrontierBucketSize(&bucket) != 0) return 1;
+    free(buffer);
+
+    return 0;
+}
+
+static int TestSmallSegments(void) {
+    FrontierBucket bucket;
+    FrontierBucketInit(&bucket);
+    if (!FrontierBucketSeal(&bucket)) return 1; /* Sealing an empty tail. */
+    for (Position p = 0; p < 10; ++p) {
+        if (!FrontierBucketAdd(&bucket, p * p)) return 1;
+        if (!FrontierBucketSeal(&bucket)) return 1;
+    }
+    Position positions[10];
+    FrontierBucketGet(&bucket, 0, 10, positions);
+    for (Position p = 0; p < 10; ++p) {
+        if (positions[p] != p * p) return 1;
+    }
+    FrontierBucketDestroy(&bucket);
+
+    return 0;
+}
+
+int main(void) {
+    if (TestSealedSegments()) return EXIT_FAILURE;
+    if (TestSmallSegments()) return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}